@@ -0,0 +1,181 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <bench/bench.h>
+#include <bench/pocketdb_data.h>
+
+#include <pocketdb/consensus/Helper.h>
+#include <pocketdb/pocketnet.h>
+#include <pocketdb/repositories/web/FeedRepository.h>
+#include <pocketdb/services/ChainPostProcessing.h>
+#include <pocketdb/services/Serializer.h>
+#include <streams.h>
+#include <test/util/setup_common.h>
+#include <version.h>
+
+#include <cassert>
+#include <functional>
+#include <vector>
+
+using benchmark::pocketdb::SocialBlock;
+using benchmark::pocketdb::SocialDataGenerator;
+using benchmark::pocketdb::SocialDataScale;
+
+// Activity of every block is scaled by -asymptote values, 1 by default
+static std::vector<SocialBlock> GenerateChain(benchmark::Bench& bench)
+{
+    double factor = bench.complexityN() > 0 ? bench.complexityN() : 1;
+    return SocialDataGenerator(SocialDataScale{}.Scaled(factor)).Generate();
+}
+
+static void ConnectBlock(const SocialBlock& block)
+{
+    PocketDb::TransRepoInst.InsertTransactions(*block.pocket_block);
+    PocketServices::ChainPostProcessing::Index(block.block, block.height);
+}
+
+// Every epoch processes the next block of the chain, so state changes like on the live node
+static void RunPerBlock(benchmark::Bench& bench, size_t blocks, const std::function<void(size_t)>& func)
+{
+    size_t i = 0;
+    bench.epochs(blocks).epochIterations(1).run([&] {
+        func(i++);
+    });
+}
+
+static void PocketDbInsertTransactions(benchmark::Bench& bench)
+{
+    TestingSetup test_setup{CBaseChainParams::REGTEST, {"-nodebuglogfile", "-nodebug"}};
+    auto chain = GenerateChain(bench);
+
+    RunPerBlock(bench, chain.size(), [&](size_t i) {
+        PocketDb::TransRepoInst.InsertTransactions(*chain[i].pocket_block);
+    });
+}
+
+static void PocketDbChainIndex(benchmark::Bench& bench)
+{
+    TestingSetup test_setup{CBaseChainParams::REGTEST, {"-nodebuglogfile", "-nodebug"}};
+    auto chain = GenerateChain(bench);
+
+    // Accounts block is not timed
+    ConnectBlock(chain[0]);
+    for (size_t i = 1; i < chain.size(); i++)
+        PocketDb::TransRepoInst.InsertTransactions(*chain[i].pocket_block);
+
+    RunPerBlock(bench, chain.size() - 1, [&](size_t i) {
+        const auto& block = chain[i + 1];
+        PocketServices::ChainPostProcessing::Index(block.block, block.height);
+    });
+}
+
+static void PocketDbChainRollback(benchmark::Bench& bench)
+{
+    TestingSetup test_setup{CBaseChainParams::REGTEST, {"-nodebuglogfile", "-nodebug"}};
+    auto chain = GenerateChain(bench);
+
+    for (const auto& block : chain)
+        ConnectBlock(block);
+
+    // Disconnect from the tip down to the accounts block
+    RunPerBlock(bench, chain.size() - 1, [&](size_t i) {
+        PocketServices::ChainPostProcessing::Rollback(chain[chain.size() - 1 - i].height);
+    });
+}
+
+static void PocketDbSocialValidate(benchmark::Bench& bench)
+{
+    TestingSetup test_setup{CBaseChainParams::REGTEST, {"-nodebuglogfile", "-nodebug"}};
+    auto chain = GenerateChain(bench);
+
+    // Validate the middle block against the chain before it
+    size_t target = chain.size() / 2;
+    for (size_t i = 0; i < target; i++)
+        ConnectBlock(chain[i]);
+
+    const auto& block = chain[target];
+    auto blockView = std::make_shared<PocketHelpers::PocketBlockView>(block.pocket_block);
+
+    // Each transaction on its own: block validation stops at the first rejected one
+    bench.run([&] {
+        for (size_t i = 0; i < block.block.vtx.size(); i++)
+            PocketConsensus::SocialConsensusHelper::Validate(block.block.vtx[i], (*block.pocket_block)[i], blockView, block.height);
+    });
+}
+
+static void RunFeeds(benchmark::Bench& bench, bool materialized)
+{
+    TestingSetup test_setup{CBaseChainParams::REGTEST, {"-nodebuglogfile", "-nodebug"}};
+    auto chain = GenerateChain(bench);
+
+    for (const auto& block : chain)
+        ConnectBlock(block);
+
+    if (materialized) {
+        PocketDb::FeedRepository feedRepository(PocketDb::SQLiteDbInst);
+        feedRepository.Rebuild();
+    }
+    PocketDb::FeedRepository::SetReady(materialized);
+
+    PocketDb::WebRpcRepository webRpcRepository(PocketDb::SQLiteDbInst);
+    int height = chain.back().height;
+    std::vector<int> contentTypes{PocketTx::CONTENT_POST, PocketTx::CONTENT_VIDEO, PocketTx::CONTENT_ARTICLE};
+
+    bench.run([&] {
+        webRpcRepository.GetHistoricalFeed(10, 0, height, "en", {}, contentTypes, {}, {}, {}, "", -50);
+        webRpcRepository.GetHierarchicalFeed(10, 0, height, "en", {}, contentTypes, {}, {}, {}, "", -50);
+        webRpcRepository.GetHotPosts(10, (int)chain.size(), height, "en", contentTypes, "", -50);
+    });
+
+    PocketDb::FeedRepository::SetReady(false);
+}
+
+static void PocketDbWebFeed(benchmark::Bench& bench)
+{
+    RunFeeds(bench, false);
+}
+
+static void PocketDbWebFeedMaterialized(benchmark::Bench& bench)
+{
+    RunFeeds(bench, true);
+}
+
+static void PocketDbSerializerJson(benchmark::Bench& bench)
+{
+    BasicTestingSetup test_setup{CBaseChainParams::REGTEST};
+    auto chain = GenerateChain(bench);
+    const auto& block = chain[chain.size() / 2];
+
+    bench.run([&] {
+        CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+        stream << PocketServices::Serializer::SerializeBlock(*block.pocket_block)->write();
+
+        auto [ok, pocketBlock] = PocketServices::Serializer::DeserializeBlock(block.block, stream);
+        assert(ok && pocketBlock.size() == block.pocket_block->size());
+    });
+}
+
+static void PocketDbSerializerBinary(benchmark::Bench& bench)
+{
+    BasicTestingSetup test_setup{CBaseChainParams::REGTEST};
+    auto chain = GenerateChain(bench);
+    const auto& block = chain[chain.size() / 2];
+
+    bench.run([&] {
+        CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+        stream << PocketServices::Serializer::SerializeBlockBinary(*block.pocket_block);
+
+        auto [ok, pocketBlock] = PocketServices::Serializer::DeserializeBlock(block.block, stream);
+        assert(ok && pocketBlock.size() == block.pocket_block->size());
+    });
+}
+
+BENCHMARK(PocketDbInsertTransactions);
+BENCHMARK(PocketDbChainIndex);
+BENCHMARK(PocketDbChainRollback);
+BENCHMARK(PocketDbSocialValidate);
+BENCHMARK(PocketDbWebFeed);
+BENCHMARK(PocketDbWebFeedMaterialized);
+BENCHMARK(PocketDbSerializerJson);
+BENCHMARK(PocketDbSerializerBinary);
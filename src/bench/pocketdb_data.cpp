@@ -0,0 +1,244 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <bench/pocketdb_data.h>
+
+#include <consensus/merkle.h>
+#include <key_io.h>
+#include <pocketdb/services/Serializer.h>
+#include <script/standard.h>
+#include <tinyformat.h>
+#include <util/strencodings.h>
+
+#include <cassert>
+#include <cmath>
+#include <iterator>
+
+namespace benchmark {
+namespace pocketdb {
+
+static const char* WORDS[] = {
+    "pocket", "net", "block", "chain", "post", "video", "music", "news", "photo", "travel",
+    "crypto", "bitcoin", "freedom", "speech", "node", "peer", "media", "social", "article", "share",
+};
+
+static const char* LANGS[] = {"en", "ru", "de"};
+
+static int Scale(int value, double factor)
+{
+    return std::max(1, (int)std::lround(value * factor));
+}
+
+SocialDataScale SocialDataScale::Scaled(double factor) const
+{
+    SocialDataScale result = *this;
+    result.accounts = Scale(accounts, factor);
+    result.posts = Scale(posts, factor);
+    result.comments = Scale(comments, factor);
+    result.scores = Scale(scores, factor);
+    result.comment_scores = Scale(comment_scores, factor);
+    result.subscribes = Scale(subscribes, factor);
+    result.blockings = Scale(blockings, factor);
+    return result;
+}
+
+SocialDataGenerator::SocialDataGenerator(const SocialDataScale& scale, int start_height)
+    : m_scale(scale), m_height(start_height), m_time(1600000000)
+{
+}
+
+std::vector<SocialBlock> SocialDataGenerator::Generate()
+{
+    std::vector<SocialBlock> result;
+
+    // Accounts
+    for (int i = 0; i < m_scale.accounts; i++)
+        m_accounts.push_back(EncodeDestination(PKHash(uint160(m_rand.randbytes(20)))));
+
+    std::vector<PendingTx> users;
+    for (int i = 0; i < m_scale.accounts; i++)
+        users.push_back(MakeUser(i));
+    result.push_back(MakeBlock(users));
+
+    // Activity referencing only data of previous blocks
+    for (int b = 0; b < m_scale.blocks; b++) {
+        std::vector<PendingTx> txs;
+        std::vector<Content> posts;
+        std::vector<Content> comments;
+
+        for (int i = 0; i < m_scale.posts; i++) {
+            txs.push_back(MakePost(RandomAccount()));
+            posts.push_back({txs.back().tx->GetHash().GetHex(), txs.back().author});
+        }
+
+        for (int i = 0; i < m_scale.subscribes; i++) {
+            int from = RandomAccount(), to = RandomAccount();
+            if (from == to || IsBlocked(from, to) || !m_subscribes.emplace(from, to).second) continue;
+            txs.push_back(MakeSubscribe(from, to));
+        }
+
+        for (int i = 0; i < m_scale.blockings; i++) {
+            int from = RandomAccount(), to = RandomAccount();
+            if (from == to || m_subscribes.count({from, to}) || !m_blockings.emplace(from, to).second) continue;
+            txs.push_back(MakeBlocking(from, to));
+        }
+
+        for (int i = 0; i < m_scale.comments && !m_posts.empty(); i++) {
+            const auto& post = m_posts[m_rand.randrange(m_posts.size())];
+            int author = RandomAccount();
+            if (IsBlocked(author, post.author)) continue;
+            txs.push_back(MakeComment(author, post));
+            comments.push_back({txs.back().tx->GetHash().GetHex(), author});
+        }
+
+        for (int i = 0; i < m_scale.scores && !m_posts.empty(); i++) {
+            const auto& post = m_posts[m_rand.randrange(m_posts.size())];
+            int author = RandomAccount();
+            if (author == post.author || IsBlocked(author, post.author) || !m_scores.emplace(author, post.hash).second) continue;
+            txs.push_back(MakeScore(author, post));
+        }
+
+        for (int i = 0; i < m_scale.comment_scores && !m_comments.empty(); i++) {
+            const auto& comment = m_comments[m_rand.randrange(m_comments.size())];
+            int author = RandomAccount();
+            if (author == comment.author || IsBlocked(author, comment.author) || !m_scores.emplace(author, comment.hash).second) continue;
+            txs.push_back(MakeCommentScore(author, comment));
+        }
+
+        result.push_back(MakeBlock(txs));
+
+        m_posts.insert(m_posts.end(), posts.begin(), posts.end());
+        m_comments.insert(m_comments.end(), comments.begin(), comments.end());
+    }
+
+    return result;
+}
+
+SocialBlock SocialDataGenerator::MakeBlock(const std::vector<PendingTx>& txs)
+{
+    SocialBlock result;
+    result.height = m_height++;
+    result.pocket_block = std::make_shared<PocketHelpers::PocketBlock>();
+
+    for (const auto& pending : txs) {
+        auto [ok, ptx] = PocketServices::Serializer::DeserializeTransactionRpc(pending.tx, pending.data);
+        assert(ok && ptx);
+        ptx->SetAddress(m_accounts[pending.author]);
+
+        result.block.vtx.push_back(pending.tx);
+        result.pocket_block->push_back(ptx);
+    }
+
+    result.block.nVersion = 4;
+    result.block.hashPrevBlock = m_prev_block;
+    result.block.nTime = m_time;
+    result.block.hashMerkleRoot = BlockMerkleRoot(result.block);
+    m_prev_block = result.block.GetHash();
+
+    m_time += 60;
+    return result;
+}
+
+SocialDataGenerator::PendingTx SocialDataGenerator::MakeTransaction(const std::string& op_return, int author)
+{
+    CMutableTransaction mtx;
+    mtx.nTime = m_time + m_rand.randrange(60);
+    mtx.vin.emplace_back(COutPoint(m_rand.rand256(), 0));
+    mtx.vout.emplace_back(0, CScript() << OP_RETURN << ParseHex(op_return) << m_rand.randbytes(32));
+    mtx.vout.emplace_back(COIN, GetScriptForDestination(DecodeDestination(m_accounts[author])));
+
+    return {MakeTransactionRef(std::move(mtx)), UniValue(UniValue::VOBJ), author};
+}
+
+std::string SocialDataGenerator::RandomText(size_t words)
+{
+    std::string result;
+    for (size_t i = 0; i < words; i++) {
+        if (i) result += ' ';
+        result += WORDS[m_rand.randrange(std::size(WORDS))];
+    }
+    return result;
+}
+
+int SocialDataGenerator::RandomAccount()
+{
+    // Skewed to a few popular accounts as on the real network
+    auto a = m_rand.randrange(m_accounts.size());
+    auto b = m_rand.randrange(m_accounts.size());
+    return (int)std::min(a, b);
+}
+
+bool SocialDataGenerator::IsBlocked(int from, int to) const
+{
+    return m_blockings.count({to, from}) || m_blockings.count({from, to});
+}
+
+SocialDataGenerator::PendingTx SocialDataGenerator::MakeUser(int author)
+{
+    auto result = MakeTransaction(OR_USERINFO, author);
+    result.data.pushKV("n", strprintf("user%d", author));
+    result.data.pushKV("l", LANGS[author % std::size(LANGS)]);
+    result.data.pushKV("a", RandomText(12));
+    result.data.pushKV("i", "https://i.imgur.com/avatar.jpg");
+    result.data.pushKV("k", HexStr(m_rand.randbytes(33)));
+    return result;
+}
+
+SocialDataGenerator::PendingTx SocialDataGenerator::MakePost(int author)
+{
+    UniValue tags(UniValue::VARR);
+    for (int i = 0; i < 3; i++)
+        tags.push_back(RandomText(1));
+
+    auto result = MakeTransaction(OR_POST, author);
+    result.data.pushKV("l", LANGS[author % std::size(LANGS)]);
+    result.data.pushKV("c", RandomText(6));
+    result.data.pushKV("m", RandomText(60));
+    result.data.pushKV("t", tags.write());
+    result.data.pushKV("u", "https://pocketnet.app/" + RandomText(1));
+    return result;
+}
+
+SocialDataGenerator::PendingTx SocialDataGenerator::MakeComment(int author, const Content& post)
+{
+    auto result = MakeTransaction(OR_COMMENT, author);
+    result.data.pushKV("postid", post.hash);
+    result.data.pushKV("parentid", "");
+    result.data.pushKV("answerid", "");
+    result.data.pushKV("msg", RandomText(20));
+    return result;
+}
+
+SocialDataGenerator::PendingTx SocialDataGenerator::MakeScore(int author, const Content& post)
+{
+    auto result = MakeTransaction(OR_SCORE, author);
+    result.data.pushKV("share", post.hash);
+    result.data.pushKV("value", (int64_t)m_rand.randrange(5) + 1);
+    return result;
+}
+
+SocialDataGenerator::PendingTx SocialDataGenerator::MakeCommentScore(int author, const Content& comment)
+{
+    auto result = MakeTransaction(OR_COMMENT_SCORE, author);
+    result.data.pushKV("commentid", comment.hash);
+    result.data.pushKV("value", m_rand.randbool() ? 1 : -1);
+    return result;
+}
+
+SocialDataGenerator::PendingTx SocialDataGenerator::MakeSubscribe(int author, int to)
+{
+    auto result = MakeTransaction(OR_SUBSCRIBE, author);
+    result.data.pushKV("address", m_accounts[to]);
+    return result;
+}
+
+SocialDataGenerator::PendingTx SocialDataGenerator::MakeBlocking(int author, int to)
+{
+    auto result = MakeTransaction(OR_BLOCKING, author);
+    result.data.pushKV("address", m_accounts[to]);
+    return result;
+}
+
+} // namespace pocketdb
+} // namespace benchmark
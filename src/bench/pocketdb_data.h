@@ -0,0 +1,101 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETCOIN_BENCH_POCKETDB_DATA_H
+#define POCKETCOIN_BENCH_POCKETDB_DATA_H
+
+#include <pocketdb/helpers/TransactionHelper.h>
+#include <primitives/block.h>
+#include <random.h>
+
+#include <univalue.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace benchmark {
+namespace pocketdb {
+
+/** Size of synthetic social data. Counts of activity are per generated block. */
+struct SocialDataScale {
+    int accounts{500};
+    int blocks{20};
+    int posts{20};
+    int comments{40};
+    int scores{80};
+    int comment_scores{40};
+    int subscribes{20};
+    int blockings{4};
+
+    //! Same data shape with all counts multiplied
+    SocialDataScale Scaled(double factor) const;
+};
+
+struct SocialBlock {
+    CBlock block;
+    PocketHelpers::PocketBlockRef pocket_block;
+    int height;
+};
+
+/**
+ * Deterministic generator of social transactions with the payloads the node stores.
+ * The first block registers all accounts, following blocks mix posts, comments, scores,
+ * subscriptions and blockings referencing only data of previous blocks, so the chain
+ * can be inserted and indexed block by block. Obvious consensus rules are respected
+ * (no self scores, no duplicate subscriptions or blockings, no actions of blocked
+ * accounts), time-based limits are not.
+ */
+class SocialDataGenerator
+{
+public:
+    explicit SocialDataGenerator(const SocialDataScale& scale, int start_height = 1);
+
+    //! Block with account registrations followed by scale.blocks activity blocks
+    std::vector<SocialBlock> Generate();
+
+private:
+    struct Content {
+        std::string hash;
+        int author;
+    };
+
+    struct PendingTx {
+        CTransactionRef tx;
+        UniValue data;
+        int author;
+    };
+
+    SocialDataScale m_scale;
+    int m_height;
+    int64_t m_time;
+    uint256 m_prev_block;
+    FastRandomContext m_rand{true};
+
+    std::vector<std::string> m_accounts;
+    std::vector<Content> m_posts;
+    std::vector<Content> m_comments;
+    std::set<std::pair<int, int>> m_subscribes;
+    std::set<std::pair<int, int>> m_blockings;
+    std::set<std::pair<int, std::string>> m_scores;
+
+    SocialBlock MakeBlock(const std::vector<PendingTx>& txs);
+    PendingTx MakeTransaction(const std::string& op_return, int author);
+    std::string RandomText(size_t words);
+    int RandomAccount();
+    bool IsBlocked(int from, int to) const;
+
+    PendingTx MakeUser(int author);
+    PendingTx MakePost(int author);
+    PendingTx MakeComment(int author, const Content& post);
+    PendingTx MakeScore(int author, const Content& post);
+    PendingTx MakeCommentScore(int author, const Content& comment);
+    PendingTx MakeSubscribe(int author, int to);
+    PendingTx MakeBlocking(int author, int to);
+};
+
+} // namespace pocketdb
+} // namespace benchmark
+
+#endif // POCKETCOIN_BENCH_POCKETDB_DATA_H
@@ -19,6 +19,7 @@
 #include <deque>
 #include <future>
 #include <rpc/register.h>
+#include <rpc/cache.h>
 #include <walletinitinterface.h>
 
 #ifdef EVENT__HAVE_NETINET_IN_H
@@ -78,10 +79,6 @@ public:
     /** Thread function */
     void Run(bool selfDbConnection)
     {
-        DbConnectionRef sqliteConnection;
-        if (selfDbConnection)
-            sqliteConnection = std::make_shared<PocketDb::SQLiteConnection>();
-
         while (true)
         {
             std::unique_ptr<WorkItem> i;
@@ -94,6 +91,23 @@ public:
                 i = std::move(queue.front());
                 queue.pop_front();
             }
+
+            // Connection leased for this request only and returned to pool after it
+            DbConnectionRef sqliteConnection;
+            if (selfDbConnection)
+            {
+                try
+                {
+                    sqliteConnection = PocketDb::SQLiteConnectionPoolInst.Checkout();
+                }
+                catch (const std::exception& e)
+                {
+                    LogPrintf("HTTP: failed checkout sqlite connection: %s\n", e.what());
+                    i->Reject(HTTP_SERVICE_UNAVAILABLE, "Database connection unavailable");
+                    continue;
+                }
+            }
+
             (*i)(sqliteConnection);
         }
     }
@@ -782,15 +796,39 @@ bool HTTPSocket::HTTPReq(HTTPRequest* req, const util::Ref& context, CRPCTable&
             LogPrint(BCLog::RPC, "RPC started method %s%s (%s) with params: %s\n",
                 uri, method, rpcKey, prms);
 
-            UniValue result = table.execute(jreq);
+            // Deterministic methods are answered from cache until the chain tip changes
+            string cacheKey;
+            string cached;
+            uint64_t cacheGeneration = 0;
+            bool cacheable = g_rpc_cache.IsEnabled(method);
+            if (cacheable)
+            {
+                cacheKey = RPCCache::MakeKey(table, jreq);
+                cacheGeneration = g_rpc_cache.Generation();
+            }
 
-            auto execute = gStatEngineInstance.GetCurrentSystemTime();
+            if (cacheable && g_rpc_cache.Get(method, cacheKey, cached))
+            {
+                LogPrint(BCLog::RPC, "RPC cached method %s%s (%s)\n", uri, method, rpcKey);
 
-            LogPrint(BCLog::RPC, "RPC executed method %s%s (%s) > %.2fms\n",
-                uri, method, rpcKey, (execute.count() - start.count()));
+                strReply = JSONRPCReplySerialized(cached, jreq.id);
+            }
+            else
+            {
+                UniValue result = table.execute(jreq);
 
-            // Send reply
-            strReply = JSONRPCReply(result, NullUniValue, jreq.id);
+                auto execute = gStatEngineInstance.GetCurrentSystemTime();
+
+                LogPrint(BCLog::RPC, "RPC executed method %s%s (%s) > %.2fms\n",
+                    uri, method, rpcKey, (execute.count() - start.count()));
+
+                // Send reply
+                string serialized = result.write();
+                if (cacheable)
+                    g_rpc_cache.Put(cacheKey, serialized, cacheGeneration);
+
+                strReply = JSONRPCReplySerialized(serialized, jreq.id);
+            }
         }
         else
         {
@@ -827,7 +865,7 @@ bool HTTPSocket::HTTPReq(HTTPRequest* req, const util::Ref& context, CRPCTable&
 
         gStatEngineInstance.AddSample(
             Statistic::RequestSample{
-                uri,
+                uri + method,
                 req->Created,
                 start,
                 finish,
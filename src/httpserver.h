@@ -18,7 +18,7 @@
 #include <support/events.h>
 #include "rpc/server.h"
 #include "init.h"
-#include "pocketdb/SQLiteConnection.h"
+#include "pocketdb/SQLiteConnectionPool.h"
 
 static const int DEFAULT_HTTP_THREADS = 4;
 static const int DEFAULT_HTTP_POST_THREADS = 4;
@@ -154,6 +154,8 @@ class HTTPClosure
 {
 public:
     virtual void operator()(DbConnectionRef& sqliteConnection) = 0;
+    /** Reply with error instead of running the closure */
+    virtual void Reject(int nStatus, const std::string& strReply) = 0;
     virtual ~HTTPClosure() {}
 };
 
@@ -258,6 +260,11 @@ public:
         // }
     }
 
+    void Reject(int nStatus, const std::string& strReply) override
+    {
+        req->WriteReply(nStatus, strReply);
+    }
+
     std::unique_ptr<HTTPRequest> req;
 
 private:
@@ -39,6 +39,7 @@
 #include <policy/settings.h>
 #include <protocol.h>
 #include <rpc/blockchain.h>
+#include <rpc/cache.h>
 #include <rpc/register.h>
 #include <rpc/server.h>
 #include <rpc/util.h>
@@ -68,8 +69,11 @@
 
 #include <websocket/ws.h>
 #include "pocketdb/SQLiteDatabase.h"
+#include "pocketdb/SQLiteConnectionPool.h"
 #include "pocketdb/pocketnet.h"
 #include "pocketdb/services/ChainPostProcessing.h"
+#include "pocketdb/services/BulkSync.h"
+#include "pocketdb/consensus/ValidationPool.h"
 #include "pocketdb/migrations/base.h"
 #include "pocketdb/migrations/main.h"
 #include "pocketdb/migrations/web.h"
@@ -218,13 +222,17 @@ void Shutdown(NodeContext& node)
     LogPrintf("%s: In progress...\n", __func__);
     Assert(node.args);
 
+    PocketServices::BulkSyncInst.Interrupt();
     PocketServices::WebPostProcessorInst.Stop();
+    PocketServices::WsNotifierInst.Stop();
+    PocketConsensus::ValidationPoolInst.Stop();
     gStatEngineInstance.Stop();
 
     StopHTTPRPC();
     StopREST();
     StopRPC();
     StopHTTPServer();
+    PocketDb::SQLiteConnectionPoolInst.Stop();
 
     /// Note: Shutdown() must be able to handle cases in which initialization failed part of the way,
     /// for example if the data directory was found to be locked.
@@ -329,6 +337,7 @@ void Shutdown(NodeContext& node)
         client->stop();
     }
 
+    PocketServices::BulkSyncInst.Stop();
     ShutdownPocketServices();
 
 #if ENABLE_ZMQ
@@ -462,6 +471,8 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-minimumchainwork=<hex>", strprintf("Minimum work assumed to exist on a valid chain in hex (default: %s, testnet: %s, signet: %s)", defaultChainParams->GetConsensus().nMinimumChainWork.GetHex(), testnetChainParams->GetConsensus().nMinimumChainWork.GetHex(), signetChainParams->GetConsensus().nMinimumChainWork.GetHex()), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
     argsman.AddArg("-par=<n>", strprintf("Set the number of script verification threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)",
         -GetNumCores(), MAX_SCRIPTCHECK_THREADS, DEFAULT_SCRIPTCHECK_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-pocketvalidationthreads=<n>", strprintf("Set the number of threads validating social transactions of connected blocks (0 to %d, 0 = disabled, default: %d)",
+        PocketConsensus::MAX_POCKET_VALIDATION_THREADS, PocketConsensus::DEFAULT_POCKET_VALIDATION_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-persistmempool", strprintf("Whether to save the mempool on shutdown and load on restart (default: %u)", DEFAULT_PERSIST_MEMPOOL), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-pid=<file>", strprintf("Specify pid file. Relative paths will be prefixed by a net-specific datadir location. (default: %s)", POCKETCOIN_PID_FILENAME), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-prune=<n>", strprintf("Reduce storage requirements by enabling pruning (deleting) of old blocks. This allows the pruneblockchain RPC to be called to delete specific blocks, and enables automatic pruning of old blocks if a target size in MiB is provided. This mode is incompatible with -txindex and -rescan. "
@@ -626,6 +637,10 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-rpcpassword=<pw>", "Password for JSON-RPC connections", ArgsManager::ALLOW_ANY | ArgsManager::SENSITIVE, OptionsCategory::RPC);
     argsman.AddArg("-rpcport=<port>", strprintf("Listen for JSON-RPC connections on <port> (default: %u, testnet: %u, signet: %u, regtest: %u)", defaultBaseParams->RPCPort(), testnetBaseParams->RPCPort(), signetBaseParams->RPCPort(), regtestBaseParams->RPCPort()), ArgsManager::ALLOW_ANY | ArgsManager::NETWORK_ONLY, OptionsCategory::RPC);
     argsman.AddArg("-wsport=<port>", strprintf("Listen for WebSocket connections on <port> (default: %u)", 8087), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-wsnotifythreads=<n>", strprintf("Number of threads sending WebSocket notifications (default: %d)", PocketServices::DEFAULT_WS_NOTIFY_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-rpccachesize=<n>", strprintf("Maximum size of public RPC results cache in megabytes, 0 to disable (default: %d)", DEFAULT_RPC_CACHE_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-webqueuesize=<n>", strprintf("Maximum number of connected blocks waiting for the web database; block connection waits while the queue is full (default: %d)", PocketServices::DEFAULT_WEB_QUEUE_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-wsclientqueue=<n>", strprintf("Maximum number of unsent WebSocket notifications per client before it is disconnected (default: %d)", PocketServices::DEFAULT_WS_CLIENT_QUEUE), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-publicrpcport=<port>", strprintf("Listen for public JSON-RPC connections on <port> (default: %u, testnet: %u, regtest: %u)", defaultBaseParams->PublicRPCPort(), testnetBaseParams->PublicRPCPort(), regtestBaseParams->PublicRPCPort()), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-staticrpcport=<port>", strprintf("Listen for static JSON-RPC connections on <port> (default: %u, testnet: %u, regtest: %u)", defaultBaseParams->StaticRPCPort(), testnetBaseParams->StaticRPCPort(), regtestBaseParams->StaticRPCPort()), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-restport=<port>", strprintf("Listen for static REST connections on <port> (default: %u, testnet: %u, regtest: %u)", defaultBaseParams->RestPort(), testnetBaseParams->RestPort(), regtestBaseParams->RestPort()), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
@@ -650,7 +665,16 @@ void SetupServerArgs(NodeContext& node)
     // SQLite
     argsman.AddArg("-sqltimeout", strprintf("Timeout for ReadOnly sql querys (default: %ds)", 10), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
     argsman.AddArg("-sqlsharedcache", strprintf("Experimental: enable shared cache for sqlite connections (default: disabled)"), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
-    argsman.AddArg("-sqlcachesize", strprintf("Experimental: Cache size for SQLite connection in megabytes (default: %d mb)", 5), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-sqlcachesize", strprintf("Page cache size for each read-only RPC connection in megabytes (default: %d mb)", PocketDb::DEFAULT_SQL_CACHE_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-sqlmmapsize=<n>", strprintf("Memory-mapped I/O size for each read-only RPC connection in megabytes, 0 to disable (default: %d)", PocketDb::DEFAULT_SQL_MMAP_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-sqltempstorememory", "Keep temporary tables and indices of read-only RPC connections in memory (default: disabled)", ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-sqlpoolmin=<n>", strprintf("Number of read-only RPC connections kept open (default: %d)", PocketDb::DEFAULT_SQL_POOL_MIN), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-sqlpoolmax=<n>", strprintf("Maximum number of read-only RPC connections, 0 = one per busy worker (default: %d)", PocketDb::DEFAULT_SQL_POOL_MAX), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-pocketblockcache=<n>", strprintf("Maximum size of serialized Pocket block payloads cache for serving peers in megabytes (default: %d)", PocketServices::DEFAULT_POCKET_BLOCK_CACHE_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-pocketbulksync", strprintf("Index blocks to Pocket DB in batches and build RPC indexes after sync while far behind the network (default: %u)", PocketServices::DEFAULT_POCKET_BULK_SYNC), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-pocketbulksyncbatch=<n>", strprintf("Number of blocks committed to Pocket DB in one transaction during bulk sync (default: %d)", PocketServices::DEFAULT_POCKET_BULK_SYNC_BATCH), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-pocketundodepth=<n>", strprintf("Number of recent blocks keeping Pocket DB undo journal for fast rollback (default: %d)", PocketDb::DEFAULT_POCKET_UNDO_DEPTH), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-sqlstatementcache=<n>", strprintf("Maximum number of prepared statements cached per SQLite connection, 0 to disable (default: %d)", PocketDb::DEFAULT_SQL_STATEMENT_CACHE_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
 
 
 #if HAVE_DECL_DAEMON
@@ -858,41 +882,9 @@ static void ThreadImport(ChainstateManager& chainman, const util::Ref& context,
         // .. only web DB
         if (fReindex == 5 && args.GetBoolArg("-api", true))
         {
-            LogPrintf("Building a Web database: 0%%\n");
-
-            int i = 0;
-            int percent = ChainActive().Height() / 100;
-            int64_t startTime = GetTimeMicros();
-            while (i <= ChainActive().Height() && !ShutdownRequested())
-            {
-                CBlockIndex* pblockindex = ChainActive()[i];
-                if (!pblockindex)
-                {
-                    LogPrintf("ERROR: Block not found in chainActive[%d]\n", i);
-                    StartShutdown();
-                    break;
-                }
-
-                try
-                {
-                    PocketServices::WebPostProcessorInst.ProcessTags(pblockindex->GetBlockHash().GetHex());
-                    PocketServices::WebPostProcessorInst.ProcessSearchContent(pblockindex->GetBlockHash().GetHex());
-                }
-                catch (std::exception& ex)
-                {
-                    LogPrintf("ERROR: Process web db building failed - block:%s height:%d what:%s\n", pblockindex->GetBlockHash().GetHex(), pblockindex->nHeight, ex.what());
-                    StartShutdown();
-                    break;
-                }
-
-                if (i % percent == 0)
-                {
-                    int64_t time = GetTimeMicros();
-                    LogPrintf("Building a Web database: %d%% (%.2fm)\n", (i / percent), (0.000001 * (time - startTime)) / 60.0);
-                }
-
-                i += 1;
-            }
+            // Built by WebPostProcessor with set-based SQL in ranges of blocks
+            LogPrintf("Building a Web database for %d blocks\n", ChainActive().Height() + 1);
+            PocketServices::WebPostProcessorInst.EnqueueRange(0, ChainActive().Height());
         }
 
         // TODO (losty-fur): seems good
@@ -1621,11 +1613,27 @@ bool AppInitMain(const util::Ref& context, NodeContext& node, interfaces::BlockA
 
     PocketDb::InitSQLite(GetDataDir() / "pocketdb");
     PocketDb::InitSQLiteCheckpoints(GetDataDir()  / "checkpoints");
+    PocketServices::BulkSyncInst.Start(threadGroup,
+        args.GetBoolArg("-pocketbulksync", PocketServices::DEFAULT_POCKET_BULK_SYNC),
+        args.GetArg("-pocketbulksyncbatch", PocketServices::DEFAULT_POCKET_BULK_SYNC_BATCH));
+    PocketDb::SQLiteConnectionPoolInst.Start(
+        args.GetArg("-sqlpoolmin", PocketDb::DEFAULT_SQL_POOL_MIN),
+        args.GetArg("-sqlpoolmax", PocketDb::DEFAULT_SQL_POOL_MAX));
+
+    PocketConsensus::ValidationPoolInst.Start(threadGroup, args.GetArg("-pocketvalidationthreads", PocketConsensus::DEFAULT_POCKET_VALIDATION_THREADS));
 
     PocketWeb::PocketFrontendInst.Init();
 
+    g_rpc_cache.SetLimit(std::max<int64_t>(0, args.GetArg("-rpccachesize", DEFAULT_RPC_CACHE_SIZE)) * 1024 * 1024);
+    PocketServices::BlockPayloadCacheInst.SetLimit(std::max<int64_t>(0, args.GetArg("-pocketblockcache", PocketServices::DEFAULT_POCKET_BLOCK_CACHE_SIZE)) * 1024 * 1024);
+
     if (args.GetBoolArg("-api", true))
-        PocketServices::WebPostProcessorInst.Start(threadGroup);
+    {
+        PocketServices::WebPostProcessorInst.Start(threadGroup, args.GetArg("-webqueuesize", PocketServices::DEFAULT_WEB_QUEUE_SIZE));
+        PocketServices::WsNotifierInst.Start(threadGroup,
+            args.GetArg("-wsnotifythreads", PocketServices::DEFAULT_WS_NOTIFY_THREADS),
+            args.GetArg("-wsclientqueue", PocketServices::DEFAULT_WS_CLIENT_QUEUE));
+    }
 
     // ********************************************************* Step 4b: Additional settings
 
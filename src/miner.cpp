@@ -124,6 +124,8 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const Optional<CS
     CBlockIndex* pindexPrev = ::ChainActive().Tip();
     assert(pindexPrev != nullptr);
     nHeight = pindexPrev->nHeight + 1;
+    m_tipHash = pindexPrev->GetBlockHash().GetHex();
+    m_pocketBlockView = make_shared<PocketBlockView>(pblocktemplate->pocketBlock);
 
     pblock->nVersion = ComputeBlockVersion(pindexPrev, chainparams.GetConsensus());
     // -regtest only: allow overriding block.nVersion with
@@ -232,9 +234,9 @@ void BlockAssembler::onlyUnconfirmed(CTxMemPool::setEntries& testSet)
     }
 }
 
-bool BlockAssembler::TestTransaction(const CTransactionRef& tx, PocketBlockRef& pblockTemplate, PocketBlockRef& pblock)
+bool BlockAssembler::TestTransaction(const CTransactionRef& tx)
 {
-    auto ptx = PocketDb::TransRepoInst.Get(tx->GetHash().GetHex(), true);
+    auto ptx = PocketConsensus::MempoolValidationCacheInst.GetPayload(m_tipHash, tx->GetHash().GetHex());
 
     // Payload should be in operative table Transactions
     if (!ptx)
@@ -246,7 +248,7 @@ bool BlockAssembler::TestTransaction(const CTransactionRef& tx, PocketBlockRef&
     }
 
     // Check consensus
-    if (auto[ok, result] = PocketConsensus::SocialConsensusHelper::Check(tx, ptx, ChainActive().Height() + 1); !ok)
+    if (auto[ok, result] = PocketConsensus::MempoolValidationCacheInst.Check(m_tipHash, tx, ptx, nHeight); !ok)
     {
         LogPrint(BCLog::CONSENSUS, "Warning: build block skip transaction %s with check result %d\n",
             tx->GetHash().GetHex(), (int) result);
@@ -255,7 +257,7 @@ bool BlockAssembler::TestTransaction(const CTransactionRef& tx, PocketBlockRef&
     }
 
     // Validate consensus
-    if (auto[ok, result] = PocketConsensus::SocialConsensusHelper::Validate(tx, ptx, pblockTemplate, ChainActive().Height() + 1); !ok)
+    if (auto[ok, result] = PocketConsensus::MempoolValidationCacheInst.Validate(m_tipHash, tx, ptx, m_pocketBlockView, nHeight); !ok)
     {
         LogPrint(BCLog::CONSENSUS, "Warning: build block skip transaction %s with validate result %d\n",
             tx->GetHash().GetHex(), (int) result);
@@ -264,8 +266,7 @@ bool BlockAssembler::TestTransaction(const CTransactionRef& tx, PocketBlockRef&
     }
 
     // All is good - save for descendants
-    pblockTemplate->push_back(ptx);
-    pblock->push_back(ptx);
+    m_pocketBlockView->Add(ptx);
     return true;
 }
 
@@ -524,17 +525,13 @@ void BlockAssembler::addPackageTxs(int& nPackagesSelected, int& nDescendantsUpda
         SortForBlock(ancestors, sortedEntries);
 
         // Test pocketnet part for all ancestors
+        // Tested transactions are added to the template at once, so descendants see them
         bool testPocketnetPart = true;
-
-        // Temporary pocketblock object for test all transactions
-        PocketBlockRef pblock = make_shared<PocketBlock>(PocketBlock{});
-        PocketBlockRef pblockTemplate = make_shared<PocketBlock>(PocketBlock{});
-        for (const auto& it : *pblocktemplate->pocketBlock)
-            pblockTemplate->push_back(it);
+        size_t pocketBlockSize = pblocktemplate->pocketBlock->size();
 
         for (CTxMemPool::txiter it : sortedEntries)
         {
-            if (!TestTransaction(it->GetSharedTx(), pblockTemplate, pblock))
+            if (!TestTransaction(it->GetSharedTx()))
             {
                 if (fUsingModified)
                 {
@@ -547,11 +544,16 @@ void BlockAssembler::addPackageTxs(int& nPackagesSelected, int& nDescendantsUpda
             }
         }
         if (!testPocketnetPart)
+        {
+            // Drop transactions of the failed package from the template
+            if (pblocktemplate->pocketBlock->size() != pocketBlockSize)
+            {
+                pblocktemplate->pocketBlock->resize(pocketBlockSize);
+                m_pocketBlockView = make_shared<PocketBlockView>(pblocktemplate->pocketBlock);
+            }
+
             continue;
-        
-        // Move tested pocketnet transactions to template block
-        for (const auto& it : *pblock)
-            pblocktemplate->pocketBlock->push_back(it);
+        }
 
         // This transaction will make it in; reset the failed counter.
         nConsecutiveFailed = 0;
@@ -18,6 +18,7 @@
 
 #include "pocketdb/helpers/TransactionHelper.h"
 #include "pocketdb/consensus/Helper.h"
+#include "pocketdb/consensus/MempoolValidationCache.h"
 
 using namespace PocketHelpers;
 
@@ -145,10 +146,13 @@ private:
     uint64_t nBlockSigOpsCost;
     CAmount nFees;
     CTxMemPool::setEntries inBlock;
+    // Index of the pocketBlock of the template for social consensus of added transactions
+    PocketBlockViewRef m_pocketBlockView;
 
     // Chain context for the block
     int nHeight;
     int64_t nLockTimeCutoff;
+    std::string m_tipHash;
     const CChainParams& chainparams;
     const CTxMemPool& m_mempool;
 
@@ -186,7 +190,7 @@ private:
     void onlyUnconfirmed(CTxMemPool::setEntries& testSet);
 
     // Check transaction with AntiBot
-    bool TestTransaction(const CTransactionRef& tx, PocketBlockRef& pblockTemplate, PocketBlockRef& pblock);
+    bool TestTransaction(const CTransactionRef& tx);
 
     /** Test if a new package would "fit" in the block */
     bool TestPackage(uint64_t packageSize, int64_t packageSigOpsCost) const;
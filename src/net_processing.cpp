@@ -1455,16 +1455,26 @@ void PeerManager::NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_
     uint256 hashBlock(pblock->GetHash());
 
     // Get PocketData for transactions from this block
-    std::string pocketBlockData;
-    if (pocketBlock)
-        pocketBlockData = PocketServices::Serializer::SerializeBlock(*pocketBlock)->write();
-
-    if (pocketBlockData.empty() && !PocketServices::Accessor::GetBlock(*pblock, pocketBlockData))
+    // Both encodings are prepared once - peers receive binary or JSON depending on protocol version
+    PocketBlockRef pocketBlockSrc = pocketBlock;
+    if (!pocketBlockSrc && !PocketServices::Accessor::GetBlock(*pblock, pocketBlockSrc))
     {
         LogPrintf("Error: Failed get block payload from sqlite db %s\n", pblock->GetHash().GetHex());
         return;
     }
 
+    std::string pocketBlockData;
+    std::string pocketBlockDataBinary;
+    if (pocketBlockSrc)
+    {
+        pocketBlockData = PocketServices::Serializer::SerializeBlock(*pocketBlockSrc)->write();
+        pocketBlockDataBinary = PocketServices::Serializer::SerializeBlockBinary(*pocketBlockSrc);
+
+        // Peers will request this block right after announcement
+        PocketServices::BlockPayloadCacheInst.Put(hashBlock, false, pocketBlockData);
+        PocketServices::BlockPayloadCacheInst.Put(hashBlock, true, pocketBlockDataBinary);
+    }
+
     {
         LOCK(cs_most_recent_block);
         most_recent_block_hash = hashBlock;
@@ -1473,7 +1483,7 @@ void PeerManager::NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_
         fWitnessesPresentInMostRecentCompactBlock = fWitnessEnabled;
     }
 
-    m_connman.ForEachNode([this, &pcmpctblock, pindex, &msgMaker, fWitnessEnabled, &hashBlock, pocketBlockData](CNode* pnode) EXCLUSIVE_LOCKS_REQUIRED(::cs_main) {
+    m_connman.ForEachNode([this, &pcmpctblock, pindex, &msgMaker, fWitnessEnabled, &hashBlock, &pocketBlockData, &pocketBlockDataBinary](CNode* pnode) EXCLUSIVE_LOCKS_REQUIRED(::cs_main) {
         AssertLockHeld(::cs_main);
 
         // TODO: Avoid the repeated-serialization here
@@ -1488,7 +1498,8 @@ void PeerManager::NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_
 
             LogPrint(BCLog::NET, "%s sending header-and-ids %s to peer=%d\n", "PeerManager::NewPoWValidBlock",
                     hashBlock.ToString(), pnode->GetId());
-            m_connman.PushMessage(pnode, msgMaker.Make(NetMsgType::CMPCTBLOCK, *pcmpctblock, pocketBlockData));
+            bool binaryPayload = pnode->GetCommonVersion() >= POCKET_BINARY_PAYLOAD_VERSION;
+            m_connman.PushMessage(pnode, msgMaker.Make(NetMsgType::CMPCTBLOCK, *pcmpctblock, binaryPayload ? pocketBlockDataBinary : pocketBlockData));
             state.pindexBestHeaderSent = pindex;
         }
     });
@@ -1748,7 +1759,7 @@ void static ProcessGetBlockData(CNode& pfrom, const CChainParams& chainparams, c
             }
 
             std::string pocketBlockData;
-            if (!PocketServices::Accessor::GetBlock(block, pocketBlockData))
+            if (!PocketServices::Accessor::GetBlock(block, pocketBlockData, pfrom.GetCommonVersion() >= POCKET_BINARY_PAYLOAD_VERSION))
             {
                 LogPrintf("WARNING! Cannot load block payload from sqlite db: %s\n", block.GetHash().GetHex());
                 return;
@@ -1765,7 +1776,7 @@ void static ProcessGetBlockData(CNode& pfrom, const CChainParams& chainparams, c
         }
         if (pblock) {
             std::string pocketBlockData;
-            if (!PocketServices::Accessor::GetBlock(*pblock, pocketBlockData))
+            if (!PocketServices::Accessor::GetBlock(*pblock, pocketBlockData, pfrom.GetCommonVersion() >= POCKET_BINARY_PAYLOAD_VERSION))
             {
                 LogPrintf("WARNING! Cannot load block payload from sqlite db: %s\n", pblock->GetHash().GetHex());
                 return;
@@ -1897,7 +1908,7 @@ void static ProcessGetData(CNode& pfrom, Peer& peer, const CChainParams& chainpa
             int nSendFlags = (inv.IsMsgTx() ? SERIALIZE_TRANSACTION_NO_WITNESS : 0);
             // Join PocketNet data from PocketDB to transaction stream
             std::string txPayloadData;
-            if (PocketServices::Accessor::GetTransaction(*tx, txPayloadData)) {
+            if (PocketServices::Accessor::GetTransaction(*tx, txPayloadData, pfrom.GetCommonVersion() >= POCKET_BINARY_PAYLOAD_VERSION)) {
                 connman.PushMessage(&pfrom, msgMaker.Make(nSendFlags, NetMsgType::TX, *tx, txPayloadData));
                 mempool.RemoveUnbroadcastTx(tx->GetHash());
                 std::vector<uint256> parent_ids_to_add;
@@ -1986,7 +1997,7 @@ void PeerManager::SendBlockTransactions(CNode& pfrom, const CBlock& block, const
     }
 
     std::string pocketBlockData;
-    if (!PocketServices::Accessor::GetBlock(block, pocketBlockData))
+    if (!PocketServices::Accessor::GetBlock(block, pocketBlockData, pfrom.GetCommonVersion() >= POCKET_BINARY_PAYLOAD_VERSION))
     {
         LogPrintf("Error get block data for %s from sqlite db\n", block.GetHash().GetHex());
         return;
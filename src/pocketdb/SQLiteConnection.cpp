@@ -14,6 +14,8 @@ namespace PocketDb
         SQLiteDbInst->Init(dbBasePath, "main");
         SQLiteDbInst->AttachDatabase("web");
 
+        ApplyPragmas();
+
         WebRpcRepoInst = make_shared<WebRpcRepository>(*SQLiteDbInst);
         ExplorerRepoInst = make_shared<ExplorerRepository>(*SQLiteDbInst);
         SearchRepoInst = make_shared<SearchRepository>(*SQLiteDbInst);
@@ -35,5 +37,38 @@ namespace PocketDb
         SQLiteDbInst->m_connection_mutex.unlock();
     }
 
+    bool SQLiteConnection::IsHealthy()
+    {
+        lock_guard<mutex> lock(SQLiteDbInst->m_connection_mutex);
+        return SQLiteDbInst->m_db && sqlite3_exec(SQLiteDbInst->m_db, "select 1;", nullptr, nullptr, nullptr) == SQLITE_OK;
+    }
+
+    void SQLiteConnection::ApplyPragmas()
+    {
+        vector<string> pragmas;
+
+        // Negative cache_size is in KiB and does not depend on page size
+        int64_t cacheSize = gArgs.GetArg("-sqlcachesize", DEFAULT_SQL_CACHE_SIZE);
+        if (cacheSize > 0)
+        {
+            pragmas.push_back(strprintf("PRAGMA main.cache_size = %d;", -cacheSize * 1024));
+            pragmas.push_back(strprintf("PRAGMA web.cache_size = %d;", -cacheSize * 1024));
+        }
+
+        int64_t mmapSize = gArgs.GetArg("-sqlmmapsize", DEFAULT_SQL_MMAP_SIZE);
+        if (mmapSize > 0)
+        {
+            pragmas.push_back(strprintf("PRAGMA main.mmap_size = %d;", mmapSize * 1024 * 1024));
+            pragmas.push_back(strprintf("PRAGMA web.mmap_size = %d;", mmapSize * 1024 * 1024));
+        }
+
+        if (gArgs.GetBoolArg("-sqltempstorememory", false))
+            pragmas.emplace_back("PRAGMA temp_store = memory;");
+
+        for (const auto& pragma : pragmas)
+            if (sqlite3_exec(SQLiteDbInst->m_db, pragma.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK)
+                LogPrintf("%s: failed apply `%s`: %s\n", __func__, pragma, sqlite3_errmsg(SQLiteDbInst->m_db));
+    }
+
 
 } // namespace PocketDb
\ No newline at end of file
@@ -25,11 +25,16 @@ namespace PocketDb
 
         SQLiteDatabaseRef SQLiteDbInst;
 
+        void ApplyPragmas();
+
     public:
 
         SQLiteConnection();
         virtual ~SQLiteConnection();
 
+        // Connection is open and able to execute queries
+        bool IsHealthy();
+
         WebRpcRepositoryRef WebRpcRepoInst;
         ExplorerRepositoryRef ExplorerRepoInst;
         SearchRepositoryRef SearchRepoInst;
@@ -0,0 +1,193 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/SQLiteConnectionPool.h"
+
+namespace PocketDb
+{
+    SQLiteConnectionPool SQLiteConnectionPoolInst;
+
+    void SQLiteConnectionPool::Start(int minSize, int maxSize)
+    {
+        {
+            LOCK(m_mutex);
+
+            m_max = max(0, maxSize);
+            m_min = max(0, m_max > 0 ? min(minSize, m_max) : minSize);
+            m_stopped = false;
+        }
+
+        Fill();
+
+        LogPrintf("SQLiteConnectionPool: started with %d connections (max: %d)\n", m_min, m_max);
+    }
+
+    void SQLiteConnectionPool::Stop()
+    {
+        vector<Entry> idle;
+
+        {
+            LOCK(m_mutex);
+
+            m_stopped = true;
+            idle.swap(m_idle);
+            m_cond.notify_all();
+        }
+
+        // Leased connections are closed when returned
+    }
+
+    DbConnectionRef SQLiteConnectionPool::Checkout()
+    {
+        int64_t nTime1 = GetTimeMicros();
+        bool waited = false;
+        Entry entry;
+        shared_ptr<SQLiteConnection> stale;
+
+        {
+            WAIT_LOCK(m_mutex, lock);
+
+            while (!m_stopped && m_idle.empty() && m_max > 0 && m_in_use >= m_max)
+            {
+                waited = true;
+                m_cond.wait(lock);
+            }
+
+            if (m_stopped)
+                return nullptr;
+
+            m_in_use++;
+            if (!m_idle.empty())
+            {
+                entry = std::move(m_idle.back());
+                m_idle.pop_back();
+            }
+
+            if (entry.Connection && entry.Generation != m_generation)
+            {
+                stale = std::move(entry.Connection);
+                m_stats.Recycled++;
+            }
+
+            entry.Generation = m_generation;
+
+            int64_t waitTime = GetTimeMicros() - nTime1;
+            m_stats.Checkouts++;
+            m_stats.WaitTime += waitTime;
+            m_stats.MaxWaitTime = max(m_stats.MaxWaitTime, waitTime);
+            if (waited) m_stats.Waits++;
+        }
+
+        try
+        {
+            // Close outside of pool lock
+            stale = nullptr;
+
+            if (entry.Connection && !entry.Connection->IsHealthy())
+            {
+                LogPrintf("SQLiteConnectionPool: drop unhealthy connection\n");
+                entry.Connection = nullptr;
+
+                LOCK(m_mutex);
+                m_stats.Unhealthy++;
+            }
+
+            if (!entry.Connection)
+            {
+                entry.Connection = make_shared<SQLiteConnection>();
+
+                LOCK(m_mutex);
+                m_stats.Opened++;
+            }
+        }
+        catch (...)
+        {
+            LOCK(m_mutex);
+            m_in_use--;
+            m_cond.notify_one();
+            throw;
+        }
+
+        auto connection = entry.Connection.get();
+        return DbConnectionRef(connection, [this, entry](SQLiteConnection*) mutable { Checkin(entry); });
+    }
+
+    void SQLiteConnectionPool::Checkin(Entry& entry)
+    {
+        shared_ptr<SQLiteConnection> expired;
+
+        {
+            LOCK(m_mutex);
+
+            m_in_use--;
+            if (m_stopped || entry.Generation != m_generation)
+            {
+                expired = std::move(entry.Connection);
+                m_stats.Recycled++;
+            }
+            else
+            {
+                m_idle.emplace_back(std::move(entry));
+            }
+
+            m_cond.notify_one();
+        }
+
+        // Close outside of pool lock
+        expired = nullptr;
+    }
+
+    void SQLiteConnectionPool::Recycle()
+    {
+        LOCK(m_mutex);
+        m_generation++;
+    }
+
+    void SQLiteConnectionPool::Fill()
+    {
+        while (true)
+        {
+            uint64_t generation;
+
+            {
+                LOCK(m_mutex);
+                if (m_stopped || (int) m_idle.size() + m_in_use >= m_min)
+                    return;
+
+                generation = m_generation;
+            }
+
+            Entry entry;
+            try
+            {
+                entry.Connection = make_shared<SQLiteConnection>();
+                entry.Generation = generation;
+            }
+            catch (const std::exception& ex)
+            {
+                LogPrintf("SQLiteConnectionPool: failed open connection: %s\n", ex.what());
+                return;
+            }
+
+            LOCK(m_mutex);
+            m_stats.Opened++;
+            if (m_stopped || entry.Generation != m_generation)
+                return;
+
+            m_idle.emplace_back(std::move(entry));
+            m_cond.notify_one();
+        }
+    }
+
+    SQLiteConnectionPoolStats SQLiteConnectionPool::GetStats()
+    {
+        LOCK(m_mutex);
+
+        SQLiteConnectionPoolStats stats = m_stats;
+        stats.Idle = (int) m_idle.size();
+        stats.InUse = m_in_use;
+        return stats;
+    }
+
+} // namespace PocketDb
@@ -0,0 +1,76 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETDB_SQLITECONNECTIONPOOL_H
+#define POCKETDB_SQLITECONNECTIONPOOL_H
+
+#include "sync.h"
+#include "pocketdb/SQLiteConnection.h"
+
+namespace PocketDb
+{
+    using namespace std;
+
+    static const int DEFAULT_SQL_POOL_MIN = 2;
+    static const int DEFAULT_SQL_POOL_MAX = 0;
+
+    struct SQLiteConnectionPoolStats
+    {
+        int Idle = 0;
+        int InUse = 0;
+        int64_t Checkouts = 0;
+        int64_t Waits = 0;
+        int64_t WaitTime = 0;
+        int64_t MaxWaitTime = 0;
+        int64_t Opened = 0;
+        int64_t Recycled = 0;
+        int64_t Unhealthy = 0;
+    };
+
+    // Read-only connections shared by all HTTP worker queues.
+    // A connection is leased for one request and returns to the pool when the last
+    // reference to it is released. Connections opened before the last connected block
+    // are closed on return or reopened by the next Checkout instead of being reused.
+    class SQLiteConnectionPool
+    {
+    public:
+        // maxSize 0 - not limited, every waiting worker gets own connection
+        void Start(int minSize, int maxSize);
+        void Stop();
+
+        // Blocks while maxSize connections are in use; nullptr after Stop
+        DbConnectionRef Checkout();
+
+        // Mark all connections stale. Cheap enough for the block connecting thread:
+        // stale connections are closed and reopened by the request threads.
+        void Recycle();
+
+        SQLiteConnectionPoolStats GetStats();
+
+    private:
+        struct Entry
+        {
+            shared_ptr<SQLiteConnection> Connection;
+            uint64_t Generation = 0;
+        };
+
+        Mutex m_mutex;
+        std::condition_variable m_cond;
+        vector<Entry> m_idle;
+        int m_min = 0;
+        int m_max = DEFAULT_SQL_POOL_MAX;
+        int m_in_use = 0;
+        uint64_t m_generation = 0;
+        bool m_stopped = false;
+        SQLiteConnectionPoolStats m_stats;
+
+        void Checkin(Entry& entry);
+        void Fill();
+    };
+
+    extern SQLiteConnectionPool SQLiteConnectionPoolInst;
+
+} // namespace PocketDb
+
+#endif // POCKETDB_SQLITECONNECTIONPOOL_H
@@ -94,7 +94,7 @@ namespace PocketDb
         SQLiteDbCheckpointInst.Init((path / "checkpoints").string(), checkpointDbName);
     }
 
-    SQLiteDatabase::SQLiteDatabase(bool readOnly) : isReadOnlyConnect(readOnly)
+    SQLiteDatabase::SQLiteDatabase(bool readOnly, bool queryTimeouts) : isReadOnlyConnect(readOnly), isQueryTimeouts(queryTimeouts)
     {
     }
 
@@ -143,10 +143,13 @@ namespace PocketDb
 
     bool SQLiteDatabase::IsReadOnly() const { return isReadOnlyConnect; }
 
+    bool SQLiteDatabase::IsQueryTimeouts() const { return isReadOnlyConnect && isQueryTimeouts; }
+
     void SQLiteDatabase::Init(const std::string& dbBasePath, const std::string& dbName, const PocketDbMigrationRef& migration, bool drop)
     {
         m_db_migration = migration;
         m_db_path = dbBasePath;
+        m_statement_cache_limit = (size_t) max((int64_t) 0, gArgs.GetArg("-sqlstatementcache", DEFAULT_SQL_STATEMENT_CACHE_SIZE));
         fs::path dbPath(m_db_path);
         m_file_path = dbName + ".sqlite3";
 
@@ -210,6 +213,10 @@ namespace PocketDb
             if (!isReadOnlyConnect && sqlite3_db_readonly(m_db, dbName.c_str()) == 1)
                 throw std::runtime_error("Database opened in readonly");
 
+            // Deadlines are checked in place on the querying thread
+            if (IsQueryTimeouts())
+                sqlite3_progress_handler(m_db, SQL_DEADLINE_PROGRESS_STEPS, &SQLiteDatabase::ProgressHandler, this);
+
             if (!isReadOnlyConnect)
             {
                 if (sqlite3_exec(m_db, "PRAGMA journal_mode = wal;", nullptr, nullptr, nullptr) != 0)
@@ -259,6 +266,16 @@ namespace PocketDb
 
             if (!BulkExecute(m_db_migration->Indexes()))
                 throw std::runtime_error(strprintf("%s: Failed to create database `%s` structure\n", __func__, m_file_path));
+
+            // Deferred indexes are built after the interrupted bulk load is completed
+            if (!m_db_migration->DeferredIndexes().empty() && !IsIndexesDeferred())
+            {
+                std::string deferredIndexes;
+                for (const auto& index : m_db_migration->DeferredIndexes())
+                    deferredIndexes += index + "\n";
+                if (!BulkExecute(deferredIndexes))
+                    throw std::runtime_error(strprintf("%s: Failed to create database `%s` structure\n", __func__, m_file_path));
+            }
         }
         catch (const std::exception& ex)
         {
@@ -270,6 +287,9 @@ namespace PocketDb
     {
         std::string indexesDropSql;
 
+        // Cached statements can refer to indexes by name
+        ClearStatementCache();
+
         // Get all indexes in DB
         try
         {
@@ -304,6 +324,8 @@ namespace PocketDb
 
     void SQLiteDatabase::Close()
     {
+        ClearStatementCache();
+
         int res = sqlite3_close(m_db);
         if (res != SQLITE_OK)
             LogPrintf("Error: %s: %d; Failed to close database %s: %s\n", __func__, res, m_file_path, sqlite3_errstr(res));
@@ -315,6 +337,16 @@ namespace PocketDb
     {
         m_connection_mutex.lock();
 
+        if (m_batch)
+        {
+            if (!m_db || sqlite3_get_autocommit(m_db) != 0) return false;
+            int res = sqlite3_exec(m_db, "SAVEPOINT step", nullptr, nullptr, nullptr);
+            if (res != SQLITE_OK)
+                LogPrintf("%s: %d; Failed to begin the savepoint: %s\n", __func__, res, sqlite3_errstr(res));
+
+            return res == SQLITE_OK;
+        }
+
         if (!m_db || sqlite3_get_autocommit(m_db) == 0) return false;
         int res = sqlite3_exec(m_db, "BEGIN TRANSACTION", nullptr, nullptr, nullptr);
         if (res != SQLITE_OK)
@@ -326,7 +358,7 @@ namespace PocketDb
     bool SQLiteDatabase::CommitTransaction()
     {
         if (!m_db || sqlite3_get_autocommit(m_db) != 0) return false;
-        int res = sqlite3_exec(m_db, "COMMIT TRANSACTION", nullptr, nullptr, nullptr);
+        int res = sqlite3_exec(m_db, m_batch ? "RELEASE step" : "COMMIT TRANSACTION", nullptr, nullptr, nullptr);
         if (res != SQLITE_OK)
             LogPrintf("%s: %d; Failed to commit the transaction: %s\n", __func__, res, sqlite3_errstr(res));
 
@@ -338,7 +370,12 @@ namespace PocketDb
     bool SQLiteDatabase::AbortTransaction()
     {
         if (!m_db || sqlite3_get_autocommit(m_db) != 0) return false;
-        int res = sqlite3_exec(m_db, "ROLLBACK TRANSACTION", nullptr, nullptr, nullptr);
+
+        // Statements left unreleased by failed repository code must not hold the transaction
+        ReleaseBusyStatements();
+
+        // Only the failed step is undone, previous blocks of the batch stay
+        int res = sqlite3_exec(m_db, m_batch ? "ROLLBACK TO step; RELEASE step" : "ROLLBACK TRANSACTION", nullptr, nullptr, nullptr);
         if (res != SQLITE_OK)
             LogPrintf("%s: %d; Failed to abort the transaction: %s\n", __func__, res, sqlite3_errstr(res));
 
@@ -347,12 +384,239 @@ namespace PocketDb
         return res == SQLITE_OK;
     }
 
+    bool SQLiteDatabase::BeginBatch()
+    {
+        lock_guard<mutex> lock(m_connection_mutex);
+
+        if (m_batch)
+            return true;
+
+        if (!m_db || sqlite3_get_autocommit(m_db) == 0) return false;
+        int res = sqlite3_exec(m_db, "BEGIN TRANSACTION", nullptr, nullptr, nullptr);
+        if (res != SQLITE_OK)
+        {
+            LogPrintf("%s: %d; Failed to begin the batch: %s\n", __func__, res, sqlite3_errstr(res));
+            return false;
+        }
+
+        m_batch = true;
+        return true;
+    }
+
+    bool SQLiteDatabase::CommitBatch()
+    {
+        lock_guard<mutex> lock(m_connection_mutex);
+
+        if (!m_batch)
+            return true;
+
+        m_batch = false;
+
+        // Transaction can be rolled back by SQLite itself, e.g. on disk full
+        if (!m_db || sqlite3_get_autocommit(m_db) != 0)
+        {
+            LogPrintf("%s: batch transaction of `%s` is lost\n", __func__, m_file_path);
+            return false;
+        }
+
+        int res = sqlite3_exec(m_db, "COMMIT TRANSACTION", nullptr, nullptr, nullptr);
+        if (res != SQLITE_OK)
+        {
+            LogPrintf("%s: %d; Failed to commit the batch: %s\n", __func__, res, sqlite3_errstr(res));
+            sqlite3_exec(m_db, "ROLLBACK TRANSACTION", nullptr, nullptr, nullptr);
+        }
+
+        return res == SQLITE_OK;
+    }
+
+    bool SQLiteDatabase::AbortBatch()
+    {
+        lock_guard<mutex> lock(m_connection_mutex);
+
+        if (!m_batch)
+            return true;
+
+        m_batch = false;
+
+        if (!m_db || sqlite3_get_autocommit(m_db) != 0)
+            return true;
+
+        ReleaseBusyStatements();
+
+        int res = sqlite3_exec(m_db, "ROLLBACK TRANSACTION", nullptr, nullptr, nullptr);
+        if (res != SQLITE_OK)
+            LogPrintf("%s: %d; Failed to abort the batch: %s\n", __func__, res, sqlite3_errstr(res));
+
+        return res == SQLITE_OK;
+    }
+
+    bool SQLiteDatabase::InBatch() const
+    {
+        return m_batch;
+    }
+
+    bool SQLiteDatabase::BeginSnapshot()
+    {
+        if (!BeginBatch())
+            return false;
+
+        // Deferred transaction takes its snapshot on the first read
+        lock_guard<mutex> lock(m_connection_mutex);
+
+        int res = sqlite3_exec(m_db, "SELECT count(*) FROM sqlite_master", nullptr, nullptr, nullptr);
+        if (res != SQLITE_OK)
+        {
+            LogPrintf("%s: %d; Failed to begin the snapshot: %s\n", __func__, res, sqlite3_errstr(res));
+            sqlite3_exec(m_db, "ROLLBACK TRANSACTION", nullptr, nullptr, nullptr);
+            m_batch = false;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool SQLiteDatabase::EndSnapshot()
+    {
+        return CommitBatch();
+    }
+
+    void SQLiteDatabase::SetWalAutoCheckpoint(int pages)
+    {
+        lock_guard<mutex> lock(m_connection_mutex);
+
+        int res = sqlite3_wal_autocheckpoint(m_db, pages);
+        if (res != SQLITE_OK)
+            LogPrintf("%s: %d; Failed to set WAL autocheckpoint: %s\n", __func__, res, sqlite3_errstr(res));
+    }
+
+    void SQLiteDatabase::SetSynchronous(bool full)
+    {
+        lock_guard<mutex> lock(m_connection_mutex);
+
+        int res = sqlite3_exec(m_db, full ? "PRAGMA synchronous = FULL" : "PRAGMA synchronous = NORMAL", nullptr, nullptr, nullptr);
+        if (res != SQLITE_OK)
+            LogPrintf("%s: %d; Failed to set synchronous: %s\n", __func__, res, sqlite3_errstr(res));
+    }
+
+    string SQLiteDatabase::DeferredIndexName(const string& sql) const
+    {
+        static const string prefix = "create index if not exists ";
+
+        auto begin = sql.find(prefix);
+        if (begin == string::npos)
+            throw std::runtime_error(strprintf("%s: unexpected index definition: %s\n", __func__, sql));
+
+        begin += prefix.size();
+        return sql.substr(begin, sql.find(' ', begin) - begin);
+    }
+
+    bool SQLiteDatabase::IsIndexesDeferred()
+    {
+        lock_guard<mutex> lock(m_connection_mutex);
+
+        sqlite3_stmt* stmt;
+        string sql = "select Value from Settings where Key = 'IndexesDeferred'";
+        if (sqlite3_prepare_v2(m_db, sql.c_str(), (int) sql.size(), &stmt, nullptr) != SQLITE_OK)
+            return false;
+
+        bool deferred = sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_int(stmt, 0) != 0;
+        sqlite3_finalize(stmt);
+
+        return deferred;
+    }
+
+    void SQLiteDatabase::DeferIndexes()
+    {
+        // Cached statements can refer to indexes by name
+        ClearStatementCache();
+
+        // State is saved first: crash in the middle leaves indexes to be built later
+        string sql = "insert or replace into Settings (Key, Value) values ('IndexesDeferred', 1);\n";
+        for (const auto& index : m_db_migration->DeferredIndexes())
+            sql += "drop index if exists " + DeferredIndexName(index) + ";\n";
+
+        if (!BulkExecute(sql))
+            throw std::runtime_error(strprintf("%s: Failed drop deferred indexes\n", __func__));
+
+        LogPrintf("Deferred indexes of database `%s` dropped\n", m_file_path);
+    }
+
+    bool SQLiteDatabase::BuildDeferredIndexes(const atomic<bool>& interrupt)
+    {
+        const auto& indexes = m_db_migration->DeferredIndexes();
+
+        for (size_t i = 0; i < indexes.size(); i++)
+        {
+            if (interrupt)
+                return false;
+
+            int64_t nTime1 = GetTimeMicros();
+
+            if (!BulkExecute(indexes[i]))
+                throw std::runtime_error(strprintf("%s: Failed create index %s\n", __func__, DeferredIndexName(indexes[i])));
+
+            LogPrintf("Building deferred indexes of database `%s`: %d/%d %s (%.2fs)\n",
+                m_file_path, i + 1, indexes.size(), DeferredIndexName(indexes[i]), 0.000001 * (GetTimeMicros() - nTime1));
+
+            // std::mutex is not fair: without a pause the next index can take the connection again
+            if (i + 1 < indexes.size())
+                UninterruptibleSleep(chrono::milliseconds{SQL_DEFERRED_INDEX_PAUSE_MS});
+        }
+
+        if (!BulkExecute("delete from Settings where Key = 'IndexesDeferred';"))
+            throw std::runtime_error(strprintf("%s: Failed save deferred indexes state\n", __func__));
+
+        return true;
+    }
+
     void SQLiteDatabase::InterruptQuery()
     {
         if (m_db)
             sqlite3_interrupt(m_db);
     }
 
+    static int64_t SteadyMicros()
+    {
+        return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    int SQLiteDatabase::ProgressHandler(void* context)
+    {
+        auto db = static_cast<SQLiteDatabase*>(context);
+        if (db->m_deadline == 0 || SteadyMicros() < db->m_deadline)
+            return 0;
+
+        db->m_deadline_expired = true;
+        return 1;
+    }
+
+    void SQLiteDatabase::SetDeadline(chrono::microseconds timeout)
+    {
+        m_deadline_expired = false;
+        m_deadline = SteadyMicros() + timeout.count();
+    }
+
+    bool SQLiteDatabase::ClearDeadline()
+    {
+        m_deadline = 0;
+        return m_deadline_expired;
+    }
+
+    static Mutex g_query_timeouts_mutex;
+    static map<string, int64_t> g_query_timeouts GUARDED_BY(g_query_timeouts_mutex);
+
+    void RegisterQueryTimeout(const string& func)
+    {
+        LOCK(g_query_timeouts_mutex);
+        g_query_timeouts[func]++;
+    }
+
+    map<string, int64_t> GetQueryTimeouts()
+    {
+        LOCK(g_query_timeouts_mutex);
+        return g_query_timeouts;
+    }
+
     void SQLiteDatabase::AttachDatabase(const string& dbName)
     {
         assert(m_db);
@@ -367,6 +631,8 @@ namespace PocketDb
     {
         assert(m_db);
 
+        ClearStatementCache();
+
         fs::path dbPath(m_db_path);
         string cmnd = "detach " + dbName + ";";
         if (sqlite3_exec(m_db, cmnd.c_str(), nullptr, nullptr, nullptr) != 0)
@@ -382,5 +648,120 @@ namespace PocketDb
         CreateStructure();
     }
 
+    int SQLiteDatabase::PrepareStatement(const string& sql, sqlite3_stmt** stmt)
+    {
+        {
+            lock_guard<mutex> lock(m_statement_cache_mutex);
+
+            auto found = m_statement_cache.find(sql);
+            if (found != m_statement_cache.end() && !m_statement_busy[found->second.Stmt])
+            {
+                m_statement_busy[found->second.Stmt] = true;
+                m_statement_lru.splice(m_statement_lru.begin(), m_statement_lru, found->second.Lru);
+                m_statement_cache_hits += 1;
+                *stmt = found->second.Stmt;
+                return SQLITE_OK;
+            }
+
+            m_statement_cache_misses += 1;
+        }
+
+        int res = sqlite3_prepare_v2(m_db, sql.c_str(), (int) sql.size(), stmt, nullptr);
+        if (res != SQLITE_OK)
+            return res;
+
+        // Same SQL already in use (nested query) - this copy stays uncached.
+        // Full cache gives place of the least recently used idle statement,
+        // so one-off SQL (e.g. IN lists of variable length) does not hold the cache forever
+        lock_guard<mutex> lock(m_statement_cache_mutex);
+        if (m_statement_cache_limit == 0 || m_statement_cache.find(sql) != m_statement_cache.end())
+            return res;
+
+        if (m_statement_cache.size() >= m_statement_cache_limit && !EvictStatement())
+            return res;
+
+        m_statement_lru.push_front(sql);
+        m_statement_cache.emplace(sql, CachedStatement{*stmt, m_statement_lru.begin()});
+        m_statement_busy.emplace(*stmt, true);
+
+        return res;
+    }
+
+    bool SQLiteDatabase::EvictStatement()
+    {
+        for (auto it = m_statement_lru.rbegin(); it != m_statement_lru.rend(); it++)
+        {
+            auto found = m_statement_cache.find(*it);
+            if (m_statement_busy[found->second.Stmt])
+                continue;
+
+            sqlite3_finalize(found->second.Stmt);
+            m_statement_busy.erase(found->second.Stmt);
+            m_statement_lru.erase(found->second.Lru);
+            m_statement_cache.erase(found);
+            m_statement_cache_evictions += 1;
+            return true;
+        }
+
+        return false;
+    }
+
+    int SQLiteDatabase::ReleaseStatement(sqlite3_stmt* stmt)
+    {
+        {
+            lock_guard<mutex> lock(m_statement_cache_mutex);
+
+            auto found = m_statement_busy.find(stmt);
+            if (found != m_statement_busy.end())
+            {
+                int res = sqlite3_reset(stmt);
+                sqlite3_clear_bindings(stmt);
+                found->second = false;
+                return res;
+            }
+        }
+
+        return sqlite3_finalize(stmt);
+    }
+
+    void SQLiteDatabase::ReleaseBusyStatements()
+    {
+        lock_guard<mutex> lock(m_statement_cache_mutex);
+
+        for (auto& [stmt, busy] : m_statement_busy)
+        {
+            if (!busy)
+                continue;
+
+            sqlite3_reset(stmt);
+            sqlite3_clear_bindings(stmt);
+            busy = false;
+        }
+    }
+
+    void SQLiteDatabase::ClearStatementCache()
+    {
+        lock_guard<mutex> lock(m_statement_cache_mutex);
+
+        for (auto& [sql, cached] : m_statement_cache)
+            sqlite3_finalize(cached.Stmt);
+
+        m_statement_cache.clear();
+        m_statement_busy.clear();
+        m_statement_lru.clear();
+    }
+
+    StatementCacheStats SQLiteDatabase::GetStatementCacheStats()
+    {
+        lock_guard<mutex> lock(m_statement_cache_mutex);
+
+        StatementCacheStats stats;
+        stats.Hits = m_statement_cache_hits;
+        stats.Misses = m_statement_cache_misses;
+        stats.Evictions = m_statement_cache_evictions;
+        stats.Size = m_statement_cache.size();
+        return stats;
+    }
+
 } // namespace PocketDb
 
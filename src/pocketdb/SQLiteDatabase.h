@@ -11,7 +11,12 @@
 #include "fs.h"
 
 #include <sqlite3.h>
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <list>
+#include <map>
+#include <unordered_map>
 
 #include "pocketdb/migrations/base.h"
 #include "pocketdb/migrations/main.h"
@@ -25,6 +30,28 @@ namespace PocketDb
 
     void InitSQLiteCheckpoints(fs::path path);
 
+    static const int DEFAULT_SQL_STATEMENT_CACHE_SIZE = 512;
+    static const int DEFAULT_SQL_CACHE_SIZE = 5;
+    static const int DEFAULT_SQL_MMAP_SIZE = 0;
+
+    // Number of virtual machine instructions between query deadline checks
+    static const int SQL_DEADLINE_PROGRESS_STEPS = 1000;
+
+    // Pause between deferred indexes, lets block connection waiting for the connection go first
+    static const int SQL_DEFERRED_INDEX_PAUSE_MS = 100;
+
+    // Timeouted queries of all connections by repository function
+    void RegisterQueryTimeout(const string& func);
+    map<string, int64_t> GetQueryTimeouts();
+
+    struct StatementCacheStats
+    {
+        int64_t Hits = 0;
+        int64_t Misses = 0;
+        int64_t Evictions = 0;
+        size_t Size = 0;
+    };
+
     class SQLiteDatabase
     {
     private:
@@ -32,6 +59,39 @@ namespace PocketDb
         string m_file_path;
         string m_db_path;
         bool isReadOnlyConnect;
+        bool isQueryTimeouts;
+
+        // Prepared statements cache keyed by SQL text.
+        // Busy flag is set while statement is owned by repository code
+        struct CachedStatement
+        {
+            sqlite3_stmt* Stmt;
+            list<string>::iterator Lru;
+        };
+        mutex m_statement_cache_mutex;
+        unordered_map<string, CachedStatement> m_statement_cache;
+        unordered_map<sqlite3_stmt*, bool> m_statement_busy;
+        // SQL of cached statements, most recently used first
+        list<string> m_statement_lru;
+        size_t m_statement_cache_limit{DEFAULT_SQL_STATEMENT_CACHE_SIZE};
+        int64_t m_statement_cache_hits{0};
+        int64_t m_statement_cache_misses{0};
+        int64_t m_statement_cache_evictions{0};
+
+        // Finalize least recently used statement not owned by repository code
+        bool EvictStatement();
+
+        // Deadline of the running query in steady clock microseconds, 0 - not limited.
+        // Set and checked by the thread holding m_connection_mutex
+        int64_t m_deadline{0};
+        bool m_deadline_expired{false};
+
+        // Outer transaction of the bulk load; steps of repositories run in savepoints
+        bool m_batch{false};
+
+        static int ProgressHandler(void* context);
+
+        string DeferredIndexName(const string& sql) const;
 
         bool BulkExecute(string sql);
 
@@ -39,10 +99,13 @@ namespace PocketDb
         sqlite3* m_db{nullptr};
         mutex m_connection_mutex;
 
-        explicit SQLiteDatabase(bool readOnly);
+        explicit SQLiteDatabase(bool readOnly, bool queryTimeouts = true);
 
         bool IsReadOnly() const;
 
+        // Read-only connections interrupt long queries unless created without timeouts
+        bool IsQueryTimeouts() const;
+
         void Init(const std::string& dbBasePath, const string& dbName, const PocketDbMigrationRef& migration = nullptr, bool drop = false);
 
         void CreateStructure();
@@ -59,12 +122,59 @@ namespace PocketDb
 
         bool AbortTransaction();
 
+        // Keep changes of many BeginTransaction..CommitTransaction steps in one transaction.
+        // Other connections see nothing of the batch until CommitBatch.
+        bool BeginBatch();
+        bool CommitBatch();
+        // Drop all changes of the batch
+        bool AbortBatch();
+        bool InBatch() const;
+
+        // Hold one read snapshot of the database for many BeginTransaction..CommitTransaction steps.
+        // Changes committed by other connections after BeginSnapshot are not visible until EndSnapshot.
+        bool BeginSnapshot();
+        bool EndSnapshot();
+
+        // Checkpoint WAL less often while bulk loading
+        void SetWalAutoCheckpoint(int pages);
+
+        // FULL syncs WAL to disk on every commit, NORMAL only on checkpoints:
+        // commits since the last checkpoint can be lost on power failure
+        void SetSynchronous(bool full);
+
+        // Deferred indexes of the migration are dropped for bulk load and built again
+        // after it. The state is kept in the database, so startup after a crash does not
+        // build them while the bulk load is not completed.
+        bool IsIndexesDeferred();
+        void DeferIndexes();
+        // Stops between indexes when interrupted and returns false, the rest is built on next start.
+        // Connection is held while one index is built only.
+        bool BuildDeferredIndexes(const atomic<bool>& interrupt);
+
         void InterruptQuery();
 
+        // Interrupt statements of this connection running longer than timeout
+        void SetDeadline(chrono::microseconds timeout);
+        // Returns true if a statement was interrupted since SetDeadline
+        bool ClearDeadline();
+
         void DetachDatabase(const string& dbName);
         void AttachDatabase(const string& dbName);
 
         void RebuildIndexes();
+
+        // Return cached statement (reset, bindings cleared) or prepare new one
+        int PrepareStatement(const string& sql, sqlite3_stmt** stmt);
+
+        // Return statement to cache or finalize it if not cached
+        int ReleaseStatement(sqlite3_stmt* stmt);
+
+        // Reset all cached statements still marked as busy (e.g. after exception)
+        void ReleaseBusyStatements();
+
+        void ClearStatementCache();
+
+        StatementCacheStats GetStatementCacheStats();
     };
 
     typedef shared_ptr<SQLiteDatabase> SQLiteDatabaseRef;
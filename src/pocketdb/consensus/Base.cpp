@@ -6,6 +6,18 @@
 
 namespace PocketConsensus
 {
+    static thread_local ConsensusRepository* g_thread_consensus_repo = nullptr;
+
+    ConsensusRepository& ConsensusRepo()
+    {
+        return g_thread_consensus_repo ? *g_thread_consensus_repo : ConsensusRepoInst;
+    }
+
+    void SetThreadConsensusRepo(ConsensusRepository* repo)
+    {
+        g_thread_consensus_repo = repo;
+    }
+
     BaseConsensus::BaseConsensus() = default;
 
     BaseConsensus::BaseConsensus(int height) : BaseConsensus()
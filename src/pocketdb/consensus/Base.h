@@ -10,6 +10,8 @@
 #include "pocketdb/pocketnet.h"
 #include "pocketdb/models/base/Base.h"
 
+#include <boost/thread/shared_mutex.hpp>
+
 namespace PocketConsensus
 {
     using namespace std;
@@ -1079,6 +1081,13 @@ namespace PocketConsensus
         },
     };
 
+    /*********************************************************************************************/
+    // Repository for chain state reads in consensus rules.
+    // Parallel validation workers bind their own read-only connection for the thread,
+    // every other thread reads through the shared ConsensusRepoInst.
+    ConsensusRepository& ConsensusRepo();
+    void SetThreadConsensusRepo(ConsensusRepository* repo);
+
     /*********************************************************************************************/
     class BaseConsensus
     {
@@ -1087,6 +1096,7 @@ namespace PocketConsensus
         explicit BaseConsensus(int height);
         virtual ~BaseConsensus() = default;
         int64_t GetConsensusLimit(ConsensusLimit type) const;
+        int GetHeight() const { return Height; }
     protected:
         int Height = 0;
     };
@@ -1109,6 +1119,95 @@ namespace PocketConsensus
 
             return m_main_height;
         }
+
+        [[nodiscard]] int Height(NetworkId networkId) const
+        {
+            return networkId == NetworkTest ? m_test_height : m_main_height;
+        }
+    };
+
+    /*********************************************************************************************/
+    // Selects rules version by height.
+    // Checkpoint heights are resolved once per network into a plain array and
+    // rules instances are shared: one immutable instance per requested height, so validating
+    // a block costs one allocation per rules type instead of one per transaction.
+    // A few recent heights are kept, so the block being connected and the mempool
+    // validated at the next height do not replace each other's instances.
+    static const size_t CONSENSUS_FACTORY_INSTANCES = 8;
+
+    template<class T>
+    class BaseConsensusFactory
+    {
+    public:
+        explicit BaseConsensusFactory(vector<ConsensusCheckpoint<T>> rules)
+            : m_rules(move(rules)), m_heights(m_rules.size())
+        {
+        }
+
+        shared_ptr<T> Instance(int height)
+        {
+            // Parallel validation workers mostly hit instances of a few recent heights
+            {
+                boost::shared_lock<boost::shared_mutex> lock(m_mutex);
+
+                if (m_network == (int) Params().NetworkID())
+                    if (auto it = m_instances.find(height); it != m_instances.end())
+                        return it->second;
+            }
+
+            boost::unique_lock<boost::shared_mutex> lock(m_mutex);
+
+            auto epoch = Epoch(height);
+            if (auto it = m_instances.find(height); it != m_instances.end())
+                return it->second;
+
+            // Heights grow with the chain - the lowest one is needed least
+            if (m_instances.size() >= CONSENSUS_FACTORY_INSTANCES)
+                m_instances.erase(m_instances.begin());
+
+            auto instance = m_rules[epoch].m_func(height);
+            m_instances.emplace(height, instance);
+            return instance;
+        }
+
+    protected:
+        // New instance, for rules that keep state between calls
+        shared_ptr<T> Create(int height)
+        {
+            size_t epoch;
+            {
+                boost::unique_lock<boost::shared_mutex> lock(m_mutex);
+                epoch = Epoch(height);
+            }
+
+            return m_rules[epoch].m_func(height);
+        }
+
+    private:
+        const vector<ConsensusCheckpoint<T>> m_rules;
+
+        // Guards heights, instances and network
+        boost::shared_mutex m_mutex;
+        vector<int> m_heights;
+        map<int, shared_ptr<T>> m_instances;
+        int m_network = -1;
+
+        // Caller holds unique lock of m_mutex
+        size_t Epoch(int height)
+        {
+            auto networkId = Params().NetworkID();
+            if (m_network != (int) networkId)
+            {
+                for (size_t i = 0; i < m_rules.size(); i++)
+                    m_heights[i] = m_rules[i].Height(networkId);
+
+                m_instances.clear();
+                m_network = (int) networkId;
+            }
+
+            int epochHeight = (height > 0 ? height : 0);
+            return (--upper_bound(m_heights.begin(), m_heights.end(), epochHeight)) - m_heights.begin();
+        }
     };
 
     /*********************************************************************************************/
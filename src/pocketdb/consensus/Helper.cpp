@@ -27,25 +27,55 @@ namespace PocketConsensus
 
     tuple<bool, SocialConsensusResult> SocialConsensusHelper::Validate(const CBlock& block, const PocketBlockRef& pBlock, int height)
     {
+        auto blockView = make_shared<PocketBlockView>(pBlock);
+
+        // We have to verify all transactions using consensus
+        // The presence of data in pBlock is checked in the `check` function
+        vector<pair<CTransactionRef, PTransactionRef>> txs;
+        txs.reserve(block.vtx.size());
         for (const auto& tx : block.vtx)
+            if (auto ptx = blockView->Find(tx->GetHash().GetHex()); ptx)
+                txs.emplace_back(tx, ptx);
+
+        // Rules read only the chain state before this block and the immutable block view,
+        // so transactions are independent and can be validated in any order.
+        // The result is taken from the first failed transaction in block order
+        // so it does not depend on scheduling.
+        vector<SocialConsensusResult> results(txs.size(), SocialConsensusResult_Success);
+        vector<exception_ptr> errors(txs.size());
+        atomic<size_t> firstFailed{txs.size()};
+
+        ValidationPoolInst.Run(txs.size(), [&](size_t i)
         {
-            // We have to verify all transactions using consensus
-            // The presence of data in pBlock is checked in the `check` function
-            auto txHash = tx->GetHash().GetHex();
-            auto it = find_if(pBlock->begin(), pBlock->end(), [&](PTransactionRef const& ptx) { return *ptx == txHash; });
+            if (i > firstFailed)
+                return;
 
-            // Validate founded data
-            if (it != pBlock->end())
+            try
+            {
+                if (auto[ok, result] = validate(txs[i].first, txs[i].second, blockView, height); !ok)
+                    results[i] = result;
+                else
+                    return;
+            }
+            catch (...)
             {
-                if (auto[ok, result] = validate(tx, *it, pBlock, height); !ok)
-                {
-                    LogPrint(BCLog::CONSENSUS,
-                        "Warning: SocialConsensus type:%d validate tx:%s blk:%s failed with result:%d at height:%d\n",
-                        (int) *(*it)->GetType(), txHash, block.GetHash().GetHex(), (int) result, height);
-
-                    return {false, result};
-                }
+                errors[i] = current_exception();
             }
+
+            size_t current = firstFailed;
+            while (i < current && !firstFailed.compare_exchange_weak(current, i));
+        });
+
+        if (size_t i = firstFailed; i < txs.size())
+        {
+            if (errors[i])
+                rethrow_exception(errors[i]);
+
+            LogPrint(BCLog::CONSENSUS,
+                "Warning: SocialConsensus type:%d validate tx:%s blk:%s failed with result:%d at height:%d\n",
+                (int) *txs[i].second->GetType(), *txs[i].second->GetHash(), block.GetHash().GetHex(), (int) results[i], height);
+
+            return {false, results[i]};
         }
 
         return {true, SocialConsensusResult_Success};
@@ -70,7 +100,12 @@ namespace PocketConsensus
 
     tuple<bool, SocialConsensusResult> SocialConsensusHelper::Validate(const CTransactionRef& tx, const PTransactionRef& ptx, PocketBlockRef& pBlock, int height)
     {
-        if (auto[ok, result] = validate(tx, ptx, pBlock, height); !ok)
+        return Validate(tx, ptx, pBlock ? make_shared<PocketBlockView>(pBlock) : nullptr, height);
+    }
+
+    tuple<bool, SocialConsensusResult> SocialConsensusHelper::Validate(const CTransactionRef& tx, const PTransactionRef& ptx, const PocketBlockViewRef& blockView, int height)
+    {
+        if (auto[ok, result] = validate(tx, ptx, blockView, height); !ok)
         {
             LogPrint(BCLog::CONSENSUS, "Warning: SocialConsensus type:%d validate tx:%s failed with result:%d for block construction at height:%d\n",
                 (int)*ptx->GetType(), *ptx->GetHash(), (int)result, height);
@@ -98,6 +133,8 @@ namespace PocketConsensus
             return tx->IsCoinStake();
         }) != block.vtx.end();
 
+        PocketBlockView blockView(pBlock);
+
         // Check all transactions in block and payload block
         for (const auto& tx : block.vtx)
         {
@@ -110,8 +147,8 @@ namespace PocketConsensus
 
             // Maybe payload not exists?
             auto txHash = tx->GetHash().GetHex();
-            auto it = find_if(pBlock->begin(), pBlock->end(), [&](PTransactionRef const& ptx) { return *ptx == txHash; });
-            if (it == pBlock->end())
+            auto ptx = blockView.Find(txHash);
+            if (!ptx)
             {
                 LogPrint(BCLog::CONSENSUS, "Warning: SocialConsensus type:%d check failed with result:%d for tx:%s in blk:%s at height:%d\n",
                     (int)txType, (int)SocialConsensusResult_PocketDataNotFound, tx->GetHash().GetHex(), block.GetHash().GetHex(), height);
@@ -120,7 +157,7 @@ namespace PocketConsensus
             }
 
             // Check founded payload
-            if (auto[ok, result] = check(tx, *it, height); !ok)
+            if (auto[ok, result] = check(tx, ptx, height); !ok)
             {
                 LogPrint(BCLog::CONSENSUS, "Warning: SocialConsensus check type:%d failed with result:%d for tx:%s in blk:%s at height:%d\n",
                     (int)txType, (int)result, tx->GetHash().GetHex(), block.GetHash().GetHex(), height);
@@ -206,7 +243,7 @@ namespace PocketConsensus
         }
     }
 
-    tuple<bool, SocialConsensusResult> SocialConsensusHelper::validate(const CTransactionRef& tx, const PTransactionRef& ptx, const PocketBlockRef& pBlock, int height)
+    tuple<bool, SocialConsensusResult> SocialConsensusHelper::validate(const CTransactionRef& tx, const PTransactionRef& ptx, const PocketBlockViewRef& pBlock, int height)
     {
         if (!isConsensusable(*ptx->GetType()))
             return {true, SocialConsensusResult_Success};
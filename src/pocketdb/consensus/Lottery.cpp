@@ -55,11 +55,12 @@ namespace PocketConsensus
         map<string, int> commentCandidates;
         map <string, string> commentReferrersCandidates;
 
+        // Get destination address and score value
+        // In lottery allowed only likes to posts and comments
+        // Also in lottery allowed only positive scores
+        vector<string> scoreTxHashes;
         for (const auto& tx : block.vtx)
         {
-            // Get destination address and score value
-            // In lottery allowed only likes to posts and comments
-            // Also in lottery allowed only positive scores
             auto[parseScoreOk, scoreTxData] = TransactionHelper::ParseScore(tx);
             if (!parseScoreOk)
                 continue;
@@ -72,13 +73,23 @@ namespace PocketConsensus
                 && scoreTxData->ScoreValue != 4 && scoreTxData->ScoreValue != 5)
                 continue;
 
-            auto scoreData = PocketDb::ConsensusRepoInst.GetScoreData(tx->GetHash().GetHex());
-            if (!scoreData)
+            scoreTxHashes.push_back(tx->GetHash().GetHex());
+        }
+
+        // Score data of all block scores at once, usually already loaded by ratings indexing
+        auto scoresData = ScoreDataCacheInst.Get(block.GetHash().GetHex(), scoreTxHashes);
+
+        for (const auto& scoreTxHash : scoreTxHashes)
+        {
+            auto it = scoresData.find(scoreTxHash);
+            if (it == scoresData.end())
             {
-                LogPrintf("%s: Failed get score data for tx: %s\n", __func__, tx->GetHash().GetHex());
+                LogPrintf("%s: Failed get score data for tx: %s\n", __func__, scoreTxHash);
                 continue;
             }
 
+            auto& scoreData = it->second;
+
             if (!reputationConsensus->AllowModifyReputation(
                 scoreData,
                 true
@@ -140,7 +151,7 @@ namespace PocketConsensus
         if (refs.find(scoreData->ContentAddressHash) != refs.end())
             return;
 
-        auto[ok, referrer] = PocketDb::ConsensusRepoInst.GetReferrer(scoreData->ContentAddressHash);
+        auto[ok, referrer] = ConsensusRepo().GetReferrer(scoreData->ContentAddressHash);
         if (!ok || referrer == scoreData->ScoreAddressHash) return;
 
         refs.emplace(scoreData->ContentAddressHash, referrer);
@@ -167,10 +178,10 @@ namespace PocketConsensus
         if (refs.find(scoreData->ContentAddressHash) != refs.end())
             return;
 
-        auto regTime = PocketDb::ConsensusRepoInst.GetAccountRegistrationTime(scoreData->ContentAddressId);
+        auto regTime = ConsensusRepo().GetAccountRegistrationTime(scoreData->ContentAddressId);
         if (regTime < (scoreData->ScoreTime - GetConsensusLimit(ConsensusLimit_lottery_referral_depth))) return;
 
-        auto[ok, referrer] = PocketDb::ConsensusRepoInst.GetReferrer(scoreData->ContentAddressHash);
+        auto[ok, referrer] = ConsensusRepo().GetReferrer(scoreData->ContentAddressHash);
         if (!ok || referrer == scoreData->ScoreAddressHash) return;
 
         refs.emplace(scoreData->ContentAddressHash, referrer);
@@ -225,7 +236,7 @@ namespace PocketConsensus
             if (find(winners.begin(), winners.end(), addr) == winners.end())
                 winners.push_back(addr);
 
-        auto referrers = PocketDb::ConsensusRepoInst.GetReferrers(winners, Height - GetConsensusLimit(ConsensusLimit_lottery_referral_depth));
+        auto referrers = ConsensusRepo().GetReferrers(winners, Height - GetConsensusLimit(ConsensusLimit_lottery_referral_depth));
         if (referrers->empty()) return;
 
         for (const auto& it : *referrers)
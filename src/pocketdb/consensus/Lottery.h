@@ -9,6 +9,7 @@
 #include <boost/algorithm/string.hpp>
 #include "pocketdb/consensus/Reputation.h"
 #include "pocketdb/consensus/Base.h"
+#include "pocketdb/consensus/ScoreDataCache.h"
 #include "pocketdb/helpers/TransactionHelper.h"
 
 namespace PocketConsensus
@@ -99,26 +100,21 @@ namespace PocketConsensus
 
     // ---------------------------------------
     // Lottery factory for select actual rules version
-    class LotteryConsensusFactory
+    class LotteryConsensusFactory : public BaseConsensusFactory<LotteryConsensus>
     {
-    private:
-        const vector<ConsensusCheckpoint < LotteryConsensus>> m_rules = {
+    public:
+        LotteryConsensusFactory() : BaseConsensusFactory<LotteryConsensus>({
             {0,       -1, [](int height) { return make_shared<LotteryConsensus>(height); }},
             {514185,  -1, [](int height) { return make_shared<LotteryConsensus_checkpoint_514185>(height); }},
             {1035000, -1, [](int height) { return make_shared<LotteryConsensus_checkpoint_1035000>(height); }},
             {1124000, -1, [](int height) { return make_shared<LotteryConsensus_checkpoint_1124000>(height); }},
             {1180000, 0,  [](int height) { return make_shared<LotteryConsensus_checkpoint_1180000>(height); }},
-        };
-    public:
+        }) {}
+
+        // Lottery collects winners inside the instance, so it is never shared
         shared_ptr<LotteryConsensus> Instance(int height)
         {
-            int m_height = (height > 0 ? height : 0);
-            return (--upper_bound(m_rules.begin(), m_rules.end(), m_height,
-                [&](int target, const ConsensusCheckpoint<LotteryConsensus>& itm)
-                {
-                    return target < itm.Height(Params().NetworkIDString());
-                }
-            ))->m_func(height);
+            return Create(height);
         }
     };
 
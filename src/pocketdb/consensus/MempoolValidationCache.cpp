@@ -0,0 +1,139 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/consensus/MempoolValidationCache.h"
+
+namespace PocketConsensus
+{
+    MempoolValidationCache MempoolValidationCacheInst;
+
+    PTransactionRef MempoolValidationCache::GetPayload(const string& tipHash, const string& txHash)
+    {
+        {
+            LOCK(m_mutex);
+            SetTip(tipHash);
+
+            if (auto it = m_payloads.find(txHash); it != m_payloads.end())
+                return it->second;
+        }
+
+        auto ptx = PocketDb::TransRepoInst.Get(txHash, true);
+        if (!ptx)
+            return nullptr;
+
+        LOCK(m_mutex);
+        if (m_tip_hash == tipHash)
+            m_payloads.emplace(txHash, ptx);
+
+        return ptx;
+    }
+
+    tuple<bool, SocialConsensusResult> MempoolValidationCache::Check(const string& tipHash, const CTransactionRef& tx,
+        const PTransactionRef& ptx, int height)
+    {
+        auto txHash = tx->GetHash().GetHex();
+
+        {
+            LOCK(m_mutex);
+            SetTip(tipHash);
+
+            if (auto it = m_checks.find(txHash); it != m_checks.end())
+                return it->second;
+        }
+
+        auto result = SocialConsensusHelper::Check(tx, ptx, height);
+
+        LOCK(m_mutex);
+        if (m_tip_hash == tipHash)
+            m_checks.emplace(txHash, result);
+
+        return result;
+    }
+
+    tuple<bool, SocialConsensusResult> MempoolValidationCache::Validate(const string& tipHash, const CTransactionRef& tx,
+        const PTransactionRef& ptx, const PocketBlockViewRef& blockView, int height)
+    {
+        if (!blockView)
+            return SocialConsensusHelper::Validate(tx, ptx, blockView, height);
+
+        return Validate(tipHash, tx->GetHash().GetHex(), *blockView, [&]()
+        {
+            return SocialConsensusHelper::Validate(tx, ptx, blockView, height);
+        });
+    }
+
+    tuple<bool, SocialConsensusResult> MempoolValidationCache::Validate(const string& tipHash, const string& txHash,
+        PocketBlockView& blockView, const function<tuple<bool, SocialConsensusResult>()>& validate)
+    {
+        {
+            LOCK(m_mutex);
+            SetTip(tipHash);
+
+            if (auto it = m_verdicts.find(txHash); it != m_verdicts.end() && !Conflicts(it->second.Lookups, blockView))
+                return it->second.Result;
+        }
+
+        // Remember what the validation looked for in the block under construction
+        PocketBlockView::Lookups lookups;
+        blockView.Record(&lookups);
+
+        tuple<bool, SocialConsensusResult> result;
+        try
+        {
+            result = validate();
+        }
+        catch (...)
+        {
+            blockView.Record(nullptr);
+            throw;
+        }
+
+        blockView.Record(nullptr);
+
+        // Verdict depending on transactions of the block is not kept - they differ between templates
+        if (lookups.Found)
+            return result;
+
+        LOCK(m_mutex);
+        if (m_tip_hash == tipHash)
+            m_verdicts[txHash] = Verdict{result, move(lookups)};
+
+        return result;
+    }
+
+    void MempoolValidationCache::Clear()
+    {
+        LOCK(m_mutex);
+
+        m_tip_hash.clear();
+        m_payloads.clear();
+        m_checks.clear();
+        m_verdicts.clear();
+    }
+
+    void MempoolValidationCache::SetTip(const string& tipHash)
+    {
+        if (m_tip_hash == tipHash)
+            return;
+
+        m_tip_hash = tipHash;
+        m_payloads.clear();
+        m_checks.clear();
+        m_verdicts.clear();
+    }
+
+    bool MempoolValidationCache::Conflicts(const PocketBlockView::Lookups& lookups, const PocketBlockView& blockView)
+    {
+        for (const auto& value : lookups.String1)
+            if (!blockView.ByString1(value).empty())
+                return true;
+
+        for (const auto& value : lookups.String2)
+            if (!blockView.ByString2(value).empty())
+                return true;
+
+        return false;
+    }
+
+} // namespace PocketConsensus
@@ -0,0 +1,69 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETCONSENSUS_MEMPOOL_VALIDATION_CACHE_H
+#define POCKETCONSENSUS_MEMPOOL_VALIDATION_CACHE_H
+
+#include <functional>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+#include "sync.h"
+
+#include "pocketdb/consensus/Helper.h"
+
+namespace PocketConsensus
+{
+    using namespace std;
+    using namespace PocketTx;
+    using namespace PocketHelpers;
+
+    // Payloads and consensus verdicts of mempool transactions for block construction on top of one tip.
+    // The staker builds templates from the same mempool many times for every tip, so transactions
+    // are read and validated against the chain once per tip.
+    // A verdict of validation is kept only when the block under construction had no transactions
+    // for the keys looked up by the validation, and reused while it still has none for them.
+    // Everything is dropped when the tip changes.
+    class MempoolValidationCache
+    {
+    public:
+        // Payload of mempool transaction, nullptr if not found. Missed payloads are not kept.
+        PTransactionRef GetPayload(const string& tipHash, const string& txHash);
+
+        tuple<bool, SocialConsensusResult> Check(const string& tipHash, const CTransactionRef& tx,
+            const PTransactionRef& ptx, int height);
+
+        tuple<bool, SocialConsensusResult> Validate(const string& tipHash, const CTransactionRef& tx,
+            const PTransactionRef& ptx, const PocketBlockViewRef& blockView, int height);
+
+        // Verdict of validate for transaction, validate looks transactions up in blockView
+        tuple<bool, SocialConsensusResult> Validate(const string& tipHash, const string& txHash,
+            PocketBlockView& blockView, const function<tuple<bool, SocialConsensusResult>()>& validate);
+
+        // Called when chain state can return to a tip seen before (reorg) and when mempool is reloaded
+        void Clear();
+
+    private:
+        struct Verdict
+        {
+            tuple<bool, SocialConsensusResult> Result;
+            PocketBlockView::Lookups Lookups;
+        };
+
+        Mutex m_mutex;
+        string m_tip_hash GUARDED_BY(m_mutex);
+        unordered_map<string, PTransactionRef> m_payloads GUARDED_BY(m_mutex);
+        unordered_map<string, tuple<bool, SocialConsensusResult>> m_checks GUARDED_BY(m_mutex);
+        unordered_map<string, Verdict> m_verdicts GUARDED_BY(m_mutex);
+
+        void SetTip(const string& tipHash) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+        static bool Conflicts(const PocketBlockView::Lookups& lookups, const PocketBlockView& blockView);
+    };
+
+    extern MempoolValidationCache MempoolValidationCacheInst;
+
+} // namespace PocketConsensus
+
+#endif // POCKETCONSENSUS_MEMPOOL_VALIDATION_CACHE_H
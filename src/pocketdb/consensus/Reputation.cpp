@@ -18,12 +18,12 @@ namespace PocketConsensus
     bool ReputationConsensus::AllowModifyReputation(int addressId)
     {
         auto minUserReputation = GetConsensusLimit(ConsensusLimit_threshold_reputation_score);
-        auto userReputation = PocketDb::ConsensusRepoInst.GetUserReputation(addressId);
+        auto userReputation = ConsensusRepo().GetUserReputation(addressId);
         if (userReputation < minUserReputation)
             return false;
 
         auto minLikersCount = GetMinLikers(addressId);
-        auto userLikers = PocketDb::ConsensusRepoInst.GetUserLikersCount(addressId);
+        auto userLikers = ConsensusRepo().GetUserLikersCount(addressId);
         if (userLikers < minLikersCount)
             return false;
 
@@ -66,7 +66,7 @@ namespace PocketConsensus
             values.push_back(5);
         }
 
-        auto scores_one_to_one_count = PocketDb::ConsensusRepoInst.GetScoreContentCount(
+        auto scores_one_to_one_count = ConsensusRepo().GetScoreContentCount(
             Height, scoreData, values, _scores_one_to_one_depth);
 
         if (scores_one_to_one_count >= _max_scores_one_to_one)
@@ -97,7 +97,7 @@ namespace PocketConsensus
             values.push_back(1);
         }
 
-        auto scores_one_to_one_count = PocketDb::ConsensusRepoInst.GetScoreCommentCount(
+        auto scores_one_to_one_count = ConsensusRepo().GetScoreCommentCount(
             Height, scoreData, values, _scores_one_to_one_depth);
 
         if (scores_one_to_one_count >= _max_scores_one_to_one)
@@ -115,10 +115,10 @@ namespace PocketConsensus
         else
             return AccountMode_Trial;
     }
-    tuple<AccountMode, int, int64_t> ReputationConsensus::GetAccountMode(string& address)
+    tuple<AccountMode, int, int64_t> ReputationConsensus::GetAccountMode(const string& address)
     {
-        auto reputation = PocketDb::ConsensusRepoInst.GetUserReputation(address);
-        auto balance = PocketDb::ConsensusRepoInst.GetUserBalance(address);
+        auto reputation = ConsensusRepo().GetUserReputation(address);
+        auto balance = ConsensusRepo().GetUserBalance(address);
 
         return {GetAccountMode(reputation, balance), reputation, balance};
     }
@@ -175,7 +175,7 @@ namespace PocketConsensus
     int64_t ReputationConsensus_checkpoint_1180000::GetMinLikers(int addressId)
     {
         auto minLikersCount = GetConsensusLimit(ConsensusLimit_threshold_likers_count);
-        auto accountRegistrationHeight = PocketDb::ConsensusRepoInst.GetAccountRegistrationHeight(addressId);
+        auto accountRegistrationHeight = ConsensusRepo().GetAccountRegistrationHeight(addressId);
         if (Height - accountRegistrationHeight > GetConsensusLimit(ConsensusLimit_threshold_low_likers_depth))
             minLikersCount = GetConsensusLimit(ConsensusLimit_threshold_low_likers_count);
 
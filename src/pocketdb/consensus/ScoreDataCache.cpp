@@ -0,0 +1,49 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/consensus/ScoreDataCache.h"
+#include "pocketdb/consensus/Base.h"
+
+namespace PocketConsensus
+{
+    ScoreDataCache ScoreDataCacheInst;
+
+    map<string, ScoreDataDtoRef> ScoreDataCache::Get(const string& blockHash, const vector<string>& txHashes)
+    {
+        LOCK(m_mutex);
+
+        if (m_block_hash != blockHash)
+        {
+            m_block_hash = blockHash;
+            m_data.clear();
+        }
+
+        vector<string> missed;
+        for (const auto& txHash : txHashes)
+            if (m_data.find(txHash) == m_data.end())
+                missed.push_back(txHash);
+
+        if (!missed.empty())
+        {
+            auto found = ConsensusRepo().GetScoreData(missed);
+            m_data.insert(found.begin(), found.end());
+        }
+
+        map<string, ScoreDataDtoRef> result;
+        for (const auto& txHash : txHashes)
+            if (auto it = m_data.find(txHash); it != m_data.end())
+                result.emplace(it->first, it->second);
+
+        return result;
+    }
+
+    void ScoreDataCache::Clear()
+    {
+        LOCK(m_mutex);
+
+        m_block_hash.clear();
+        m_data.clear();
+    }
+
+} // namespace PocketConsensus
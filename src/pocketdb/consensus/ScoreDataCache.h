@@ -0,0 +1,42 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETCONSENSUS_SCORE_DATA_CACHE_H
+#define POCKETCONSENSUS_SCORE_DATA_CACHE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "sync.h"
+
+#include "pocketdb/models/base/ReturnDtoModels.h"
+
+namespace PocketConsensus
+{
+    using namespace std;
+    using namespace PocketTx;
+
+    // Score data of one block. Ratings are indexed when the block is connected
+    // and the lottery of the next block reads the same scores again.
+    // Only found scores are kept - score data of the block changes only by rollback.
+    class ScoreDataCache
+    {
+    public:
+        // Score data by score tx hash; scores without data are absent in result
+        map<string, ScoreDataDtoRef> Get(const string& blockHash, const vector<string>& txHashes);
+
+        void Clear();
+
+    private:
+        Mutex m_mutex;
+        string m_block_hash;
+        map<string, ScoreDataDtoRef> m_data;
+    };
+
+    extern ScoreDataCache ScoreDataCacheInst;
+
+} // namespace PocketConsensus
+
+#endif // POCKETCONSENSUS_SCORE_DATA_CACHE_H
@@ -30,7 +30,7 @@ namespace PocketConsensus
         SocialConsensus(int height) : BaseConsensus(height) {}
 
         // Validate transaction in block for miner & network full block sync
-        virtual ConsensusValidateResult Validate(const CTransactionRef& tx, const shared_ptr<T>& ptx, const PocketBlockRef& block)
+        virtual ConsensusValidateResult Validate(const CTransactionRef& tx, const shared_ptr<T>& ptx, const PocketBlockViewRef& block)
         {
             // TODO (team): optimize algorithm
             // Account must be registered
@@ -44,7 +44,7 @@ namespace PocketConsensus
                     for (const string& address : addresses)
                     {
                         bool inBlock = false;
-                        for (auto& blockTx: *block)
+                        for (auto& blockTx : block->ByString1(address))
                         {
                             if (!TransactionHelper::IsIn(*blockTx->GetType(), {ACCOUNT_USER}))
                                 continue;
@@ -67,7 +67,7 @@ namespace PocketConsensus
 
                 // Check registrations in DB
                 if (!addressesForCheck.empty() &&
-                    !PocketDb::ConsensusRepoInst.ExistsUserRegistrations(addressesForCheck, false))
+                    !ConsensusRepo().ExistsUserRegistrations(addressesForCheck, false))
                     return {false, SocialConsensusResult_NotRegistered};
             }
 
@@ -87,7 +87,7 @@ namespace PocketConsensus
     protected:
         ConsensusValidateResult Success{true, SocialConsensusResult_Success};
 
-        virtual ConsensusValidateResult ValidateLimits(const shared_ptr<T>& ptx, const PocketBlockRef& block)
+        virtual ConsensusValidateResult ValidateLimits(const shared_ptr<T>& ptx, const PocketBlockViewRef& block)
         {
             if (block)
                 return ValidateBlock(ptx, block);
@@ -95,7 +95,7 @@ namespace PocketConsensus
                 return ValidateMempool(ptx);
         }
 
-        virtual ConsensusValidateResult ValidateBlock(const shared_ptr<T>& ptx, const PocketBlockRef& block) = 0;
+        virtual ConsensusValidateResult ValidateBlock(const shared_ptr<T>& ptx, const PocketBlockViewRef& block) = 0;
 
         virtual ConsensusValidateResult ValidateMempool(const shared_ptr<T>& ptx) = 0;
 
@@ -118,17 +118,17 @@ namespace PocketConsensus
         virtual vector<string> GetAddressesForCheckRegistration(const shared_ptr<T>& tx) = 0;
 
         // Check empty pointer
-        bool IsEmpty(const shared_ptr<string>& ptr) const
+        bool IsEmpty(const string* ptr) const
         {
             return !ptr || (*ptr).empty();
         }
 
-        bool IsEmpty(const shared_ptr<int>& ptr) const
+        bool IsEmpty(const int* ptr) const
         {
             return !ptr;
         }
 
-        bool IsEmpty(const shared_ptr<int64_t>& ptr) const
+        bool IsEmpty(const int64_t* ptr) const
         {
             return !ptr;
         }
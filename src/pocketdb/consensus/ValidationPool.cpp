@@ -0,0 +1,203 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/consensus/ValidationPool.h"
+#include "pocketdb/consensus/Base.h"
+#include "pocketdb/pocketnet.h"
+
+namespace PocketConsensus
+{
+    ValidationPool ValidationPoolInst;
+
+    ValidationPool::ValidationPool() = default;
+
+    void ValidationPool::Start(boost::thread_group& threadGroup, int threads)
+    {
+        threads = min(threads, MAX_POCKET_VALIDATION_THREADS);
+        if (threads <= 0)
+            return;
+
+        shutdown = false;
+        workers = threads;
+
+        for (int i = 0; i < threads; i++)
+            threadGroup.create_thread([this] { Worker(); });
+    }
+
+    void ValidationPool::Stop()
+    {
+        // Signal workers; a batch in progress is finished by the workers joined it
+        // or by the calling thread if no worker joined
+        {
+            LOCK(_batch_mutex);
+
+            shutdown = true;
+            _batch_cond.notify_all();
+        }
+
+        // Wait all worker connections closed
+        WAIT_LOCK(_batch_mutex, lock);
+        while (workers > 0)
+            _done_cond.wait(lock);
+    }
+
+    int ValidationPool::Size() const
+    {
+        return shutdown ? 0 : workers.load();
+    }
+
+    void ValidationPool::Run(size_t count, const function<void(size_t)>& job)
+    {
+        if (count == 0)
+            return;
+
+        LOCK(_run_mutex);
+
+        // Worker connections do not see blocks of an uncommitted bulk load batch
+        if (count == 1 || Size() == 0 || SQLiteDbInst.InBatch())
+        {
+            for (size_t i = 0; i < count; i++)
+                job(i);
+
+            return;
+        }
+
+        auto batch = make_shared<Batch>();
+        batch->Job = &job;
+        batch->Count = count;
+
+        {
+            // The main connection is the only writer of the main database - nothing is
+            // committed while it is locked, so all workers open the same snapshot
+            lock_guard<mutex> dbLock(SQLiteDbInst.m_connection_mutex);
+
+            WAIT_LOCK(_batch_mutex, lock);
+
+            _batch = batch;
+            _batch_id++;
+            _batch_cond.notify_all();
+
+            while (batch->Ready < workers)
+                _done_cond.wait(lock);
+        }
+
+        // No worker could open the snapshot - validate on the calling thread
+        bool serial = false;
+        {
+            LOCK(_batch_mutex);
+            serial = batch->Opened == 0;
+        }
+
+        if (serial)
+            Execute(*batch);
+
+        WAIT_LOCK(_batch_mutex, lock);
+        while (batch->Done < count)
+            _done_cond.wait(lock);
+
+        _batch = nullptr;
+    }
+
+    void ValidationPool::Execute(Batch& batch)
+    {
+        while (true)
+        {
+            size_t i = batch.Next++;
+            if (i >= batch.Count)
+                break;
+
+            (*batch.Job)(i);
+
+            if (++batch.Done == batch.Count)
+            {
+                LOCK(_batch_mutex);
+                _done_cond.notify_all();
+            }
+        }
+    }
+
+    void ValidationPool::Worker()
+    {
+        LogPrintf("ValidationPool: starting thread worker\n");
+
+        // Own read-only connection without query timeouts: consensus reads must never be interrupted
+        SQLiteDatabaseRef sqliteDbInst;
+        shared_ptr<ConsensusRepository> consensusRepoInst;
+
+        try
+        {
+            auto dbBasePath = (GetDataDir() / "pocketdb").string();
+
+            sqliteDbInst = make_shared<SQLiteDatabase>(true, false);
+            sqliteDbInst->Init(dbBasePath, "main");
+
+            consensusRepoInst = make_shared<ConsensusRepository>(*sqliteDbInst);
+            SetThreadConsensusRepo(consensusRepoInst.get());
+        }
+        catch (const std::exception& ex)
+        {
+            LogPrintf("ValidationPool: failed open database: %s\n", ex.what());
+            sqliteDbInst = nullptr;
+        }
+
+        uint64_t lastBatchId = 0;
+        while (sqliteDbInst)
+        {
+            shared_ptr<Batch> batch;
+
+            {
+                WAIT_LOCK(_batch_mutex, lock);
+
+                while (!shutdown && (!_batch || _batch_id == lastBatchId))
+                    _batch_cond.wait(lock);
+
+                if (shutdown) break;
+
+                batch = _batch;
+                lastBatchId = _batch_id;
+            }
+
+            bool opened = sqliteDbInst->BeginSnapshot();
+
+            {
+                LOCK(_batch_mutex);
+
+                batch->Ready++;
+                if (opened) batch->Opened++;
+                _done_cond.notify_all();
+            }
+
+            if (!opened)
+                continue;
+
+            Execute(*batch);
+
+            sqliteDbInst->EndSnapshot();
+        }
+
+        // Shutdown DB
+        SetThreadConsensusRepo(nullptr);
+        if (sqliteDbInst)
+        {
+            sqliteDbInst->m_connection_mutex.lock();
+
+            consensusRepoInst->Destroy();
+            consensusRepoInst = nullptr;
+
+            sqliteDbInst->Close();
+
+            sqliteDbInst->m_connection_mutex.unlock();
+            sqliteDbInst = nullptr;
+        }
+
+        {
+            LOCK(_batch_mutex);
+            workers--;
+            _done_cond.notify_all();
+        }
+
+        LogPrintf("ValidationPool: thread worker exit\n");
+    }
+
+} // namespace PocketConsensus
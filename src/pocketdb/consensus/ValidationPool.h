@@ -0,0 +1,76 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETCONSENSUS_VALIDATION_POOL_H
+#define POCKETCONSENSUS_VALIDATION_POOL_H
+
+#include <boost/thread.hpp>
+#include <atomic>
+#include <functional>
+
+#include "sync.h"
+
+#include "pocketdb/SQLiteDatabase.h"
+#include "pocketdb/repositories/ConsensusRepository.h"
+
+namespace PocketConsensus
+{
+    using namespace std;
+    using namespace PocketDb;
+
+    static const int DEFAULT_POCKET_VALIDATION_THREADS = 0;
+    static const int MAX_POCKET_VALIDATION_THREADS = 16;
+
+    // Worker threads for validating block social transactions in parallel.
+    // Every worker owns its own read-only database connection and binds a ConsensusRepository
+    // to itself, so consensus reads do not contend for the shared connection mutex.
+    // Only one batch runs at a time. All workers read one committed snapshot of the database
+    // taken while the main connection is locked; the calling thread only waits for the batch.
+    class ValidationPool
+    {
+    public:
+        ValidationPool();
+        void Start(boost::thread_group& threadGroup, int threads);
+        void Stop();
+
+        // Number of running workers, 0 when parallel validation is disabled
+        int Size() const;
+
+        // Calls job(i) for every i in [0, count) and returns after all calls completed.
+        // Jobs must not throw - exceptions are the caller's responsibility.
+        void Run(size_t count, const function<void(size_t)>& job);
+
+    private:
+        struct Batch
+        {
+            const function<void(size_t)>* Job = nullptr;
+            size_t Count = 0;
+            atomic<size_t> Next{0};
+            atomic<size_t> Done{0};
+
+            // Workers joined the batch and workers holding the batch snapshot
+            int Ready = 0;
+            int Opened = 0;
+        };
+
+        atomic<bool> shutdown{false};
+        atomic<int> workers{0};
+        int threads = 0;
+
+        Mutex _run_mutex;
+        Mutex _batch_mutex;
+        std::condition_variable _batch_cond;
+        std::condition_variable _done_cond;
+        shared_ptr<Batch> _batch;
+        uint64_t _batch_id = 0;
+
+        void Worker();
+        void Execute(Batch& batch);
+    };
+
+    extern ValidationPool ValidationPoolInst;
+
+} // namespace PocketConsensus
+
+#endif // POCKETCONSENSUS_VALIDATION_POOL_H
@@ -20,7 +20,7 @@ namespace PocketConsensus
     {
     public:
         AccountSettingConsensus(int height) : SocialConsensus<AccountSetting>(height) {}
-        ConsensusValidateResult Validate(const CTransactionRef& tx, const AccountSettingRef& ptx, const PocketBlockRef& block) override
+        ConsensusValidateResult Validate(const CTransactionRef& tx, const AccountSettingRef& ptx, const PocketBlockViewRef& block) override
         {
             // Base validation with calling block or mempool check
             if (auto[baseValidate, baseValidateCode] = SocialConsensus::Validate(tx, ptx, block); !baseValidate)
@@ -48,10 +48,10 @@ namespace PocketConsensus
         }
 
     protected:
-        ConsensusValidateResult ValidateBlock(const AccountSettingRef& ptx, const PocketBlockRef& block) override
+        ConsensusValidateResult ValidateBlock(const AccountSettingRef& ptx, const PocketBlockViewRef& block) override
         {
             // Only one transaction allowed in block
-            for (auto& blockTx : *block)
+            for (auto& blockTx : block->ByString1(*ptx->GetAddress()))
             {
                 if (!TransactionHelper::IsIn(*blockTx->GetType(), {ACCOUNT_SETTING}))
                     continue;
@@ -70,7 +70,7 @@ namespace PocketConsensus
         }
         ConsensusValidateResult ValidateMempool(const AccountSettingRef& ptx) override
         {
-            if (ConsensusRepoInst.CountMempoolAccountSetting(*ptx->GetAddress()) > 0)
+            if (ConsensusRepo().CountMempoolAccountSetting(*ptx->GetAddress()) > 0)
                 return {false, SocialConsensusResult_AccountSettingsDouble};
 
             int count = GetChainCount(ptx);
@@ -91,7 +91,7 @@ namespace PocketConsensus
         }
         virtual int GetChainCount(const AccountSettingRef& ptx)
         {
-            return ConsensusRepoInst.CountChainAccountSetting(
+            return ConsensusRepo().CountChainAccountSetting(
                 *ptx->GetAddress(),
                 Height - (int)GetConsensusLimit(ConsensusLimit_depth)
             );
@@ -108,23 +108,12 @@ namespace PocketConsensus
     /*******************************************************************************************************************
     *  Factory for select actual rules version
     *******************************************************************************************************************/
-    class AccountSettingConsensusFactory
+    class AccountSettingConsensusFactory : public BaseConsensusFactory<AccountSettingConsensus>
     {
-    private:
-        const vector<ConsensusCheckpoint<AccountSettingConsensus>> m_rules = {
-            { 0, 0, [](int height) { return make_shared<AccountSettingConsensus>(height); }},
-        };
     public:
-        shared_ptr<AccountSettingConsensus> Instance(int height)
-        {
-            int m_height = (height > 0 ? height : 0);
-            return (--upper_bound(m_rules.begin(), m_rules.end(), m_height,
-                [&](int target, const ConsensusCheckpoint<AccountSettingConsensus>& itm)
-                {
-                    return target < itm.Height(Params().NetworkIDString());
-                }
-            ))->m_func(height);
-        }
+        AccountSettingConsensusFactory() : BaseConsensusFactory<AccountSettingConsensus>({
+            { 0, 0, [](int height) { return make_shared<AccountSettingConsensus>(height); }},
+        }) {}
     };
 
 } // namespace PocketConsensus
@@ -21,7 +21,7 @@ namespace PocketConsensus
     {
     public:
         ArticleConsensus(int height) : SocialConsensus<Article>(height) {}
-        tuple<bool, SocialConsensusResult> Validate(const CTransactionRef& tx, const ArticleRef& ptx, const PocketBlockRef& block) override
+        tuple<bool, SocialConsensusResult> Validate(const CTransactionRef& tx, const ArticleRef& ptx, const PocketBlockViewRef& block) override
         {
             // Base validation with calling block or mempool check
             if (auto[baseValidate, baseValidateCode] = SocialConsensus::Validate(tx, ptx, block); !baseValidate)
@@ -62,7 +62,7 @@ namespace PocketConsensus
             return mode >= AccountMode_Full ? GetConsensusLimit(ConsensusLimit_full_article) : GetConsensusLimit(ConsensusLimit_trial_article);
         }
 
-        tuple<bool, SocialConsensusResult> ValidateBlock(const ArticleRef& ptx, const PocketBlockRef& block) override
+        tuple<bool, SocialConsensusResult> ValidateBlock(const ArticleRef& ptx, const PocketBlockViewRef& block) override
         {
             // Edit articles
             if (ptx->IsEdit())
@@ -75,7 +75,7 @@ namespace PocketConsensus
             int count = GetChainCount(ptx);
 
             // Get count from block
-            for (const auto& blockTx : *block)
+            for (const auto& blockTx : block->ByString1(*ptx->GetAddress()))
             {
                 if (!TransactionHelper::IsIn(*blockTx->GetType(), { CONTENT_ARTICLE }))
                     continue;
@@ -109,7 +109,7 @@ namespace PocketConsensus
             int count = GetChainCount(ptx);
 
             // Get count from mempool
-            count += ConsensusRepoInst.CountMempoolArticle(*ptx->GetAddress());
+            count += ConsensusRepo().CountMempoolArticle(*ptx->GetAddress());
 
             return ValidateLimit(ptx, count);
         }
@@ -120,7 +120,7 @@ namespace PocketConsensus
 
         virtual tuple<bool, SocialConsensusResult> ValidateEdit(const ArticleRef& ptx)
         {
-            auto[lastContentOk, lastContent] = PocketDb::ConsensusRepoInst.GetLastContent(
+            auto[lastContentOk, lastContent] = ConsensusRepo().GetLastContent(
                 *ptx->GetRootTxHash(),
                 { CONTENT_ARTICLE }
             );
@@ -128,7 +128,7 @@ namespace PocketConsensus
                 return {false, SocialConsensusResult_NotFound};
 
             // First get original post transaction
-            auto[originalTxOk, originalTx] = PocketDb::ConsensusRepoInst.GetFirstContent(*ptx->GetRootTxHash());
+            auto[originalTxOk, originalTx] = ConsensusRepo().GetFirstContent(*ptx->GetRootTxHash());
             if (!originalTxOk)
                 return {false, SocialConsensusResult_NotFound};
 
@@ -164,7 +164,7 @@ namespace PocketConsensus
 
         virtual bool AllowEditWindow(const ArticleRef& ptx, const ContentRef& originalPtx)
         {
-            auto[ok, originalPtxHeight] = ConsensusRepoInst.GetTransactionHeight(*originalPtx->GetHash());
+            auto[ok, originalPtxHeight] = ConsensusRepo().GetTransactionHeight(*originalPtx->GetHash());
             if (!ok)
                 return false;
 
@@ -172,15 +172,15 @@ namespace PocketConsensus
         }
         virtual int GetChainCount(const ArticleRef& ptx)
         {
-            return ConsensusRepoInst.CountChainArticle(
+            return ConsensusRepo().CountChainArticle(
                 *ptx->GetAddress(),
                 Height - (int)GetConsensusLimit(ConsensusLimit_depth)
             );
         }
-        virtual tuple<bool, SocialConsensusResult> ValidateEditBlock(const ArticleRef& ptx, const PocketBlockRef& block)
+        virtual tuple<bool, SocialConsensusResult> ValidateEditBlock(const ArticleRef& ptx, const PocketBlockViewRef& block)
         {
             // Double edit in block not allowed
-            for (auto& blockTx : *block)
+            for (auto& blockTx : block->ByString2(*ptx->GetRootTxHash()))
             {
                 if (!TransactionHelper::IsIn(*blockTx->GetType(), {CONTENT_ARTICLE, CONTENT_DELETE}))
                     continue;
@@ -199,7 +199,7 @@ namespace PocketConsensus
         }
         virtual tuple<bool, SocialConsensusResult> ValidateEditMempool(const ArticleRef& ptx)
         {
-            if (ConsensusRepoInst.CountMempoolArticleEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
+            if (ConsensusRepo().CountMempoolArticleEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
                 return {false, SocialConsensusResult_DoubleContentEdit};
 
             // Check edit limit
@@ -207,7 +207,7 @@ namespace PocketConsensus
         }
         virtual tuple<bool, SocialConsensusResult> ValidateEditOneLimit(const ArticleRef& ptx)
         {
-            int count = ConsensusRepoInst.CountChainArticleEdit(*ptx->GetAddress(), *ptx->GetRootTxHash());
+            int count = ConsensusRepo().CountChainArticleEdit(*ptx->GetAddress(), *ptx->GetRootTxHash());
             if (count >= GetConsensusLimit(ConsensusLimit_article_edit_count))
                 return {false, SocialConsensusResult_ContentEditLimit};
 
@@ -266,24 +266,13 @@ namespace PocketConsensus
     /*******************************************************************************************************************
     *  Factory for select actual rules version
     *******************************************************************************************************************/
-    class ArticleConsensusFactory
+    class ArticleConsensusFactory : public BaseConsensusFactory<ArticleConsensus>
     {
-    protected:
-        const vector<ConsensusCheckpoint < ArticleConsensus>> m_rules = {
+    public:
+        ArticleConsensusFactory() : BaseConsensusFactory<ArticleConsensus>({
             {       0,      0, [](int height) { return make_shared<ArticleConsensus>(height); }},
             { 1586000, 528000, [](int height) { return make_shared<ArticleConsensus_checkpoint_accept>(height); }},
-        };
-    public:
-        shared_ptr<ArticleConsensus> Instance(int height)
-        {
-            int m_height = (height > 0 ? height : 0);
-            return (--upper_bound(m_rules.begin(), m_rules.end(), m_height,
-                [&](int target, const ConsensusCheckpoint<ArticleConsensus>& itm)
-                {
-                    return target < itm.Height(Params().NetworkIDString());
-                }
-            ))->m_func(height);
-        }
+        }) {}
     };
 } // namespace PocketConsensus
 
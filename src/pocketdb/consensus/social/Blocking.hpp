@@ -20,14 +20,14 @@ namespace PocketConsensus
     {
     public:
         BlockingConsensus(int height) : SocialConsensus<Blocking>(height) {}
-        ConsensusValidateResult Validate(const CTransactionRef& tx, const BlockingRef& ptx, const PocketBlockRef& block) override
+        ConsensusValidateResult Validate(const CTransactionRef& tx, const BlockingRef& ptx, const PocketBlockViewRef& block) override
         {
             // Base validation with calling block or mempool check
             if (auto[baseValidate, baseValidateCode] = SocialConsensus::Validate(tx, ptx, block); !baseValidate)
                 return {false, baseValidateCode};
 
             // Double blocking in chain
-            if (auto[existsBlocking, blockingType] = PocketDb::ConsensusRepoInst.GetLastBlockingType(
+            if (auto[existsBlocking, blockingType] = ConsensusRepo().GetLastBlockingType(
                     *ptx->GetAddress(),
                     *ptx->GetAddressTo()
                 ); existsBlocking && blockingType == ACTION_BLOCKING)
@@ -55,9 +55,9 @@ namespace PocketConsensus
         }
 
     protected:
-        ConsensusValidateResult ValidateBlock(const BlockingRef& ptx, const PocketBlockRef& block) override
+        ConsensusValidateResult ValidateBlock(const BlockingRef& ptx, const PocketBlockViewRef& block) override
         {
-            for (auto& blockTx : *block)
+            for (auto& blockTx : block->ByString1(*ptx->GetAddress()))
             {
                 if (!TransactionHelper::IsIn(*blockTx->GetType(), {ACTION_BLOCKING, ACTION_BLOCKING_CANCEL}))
                     continue;
@@ -75,7 +75,7 @@ namespace PocketConsensus
         }
         ConsensusValidateResult ValidateMempool(const BlockingRef& ptx) override
         {
-            if (ConsensusRepoInst.CountMempoolBlocking(*ptx->GetAddress(), *ptx->GetAddressTo()) > 0)
+            if (ConsensusRepo().CountMempoolBlocking(*ptx->GetAddress(), *ptx->GetAddressTo()) > 0)
                 return {false, SocialConsensusResult_ManyTransactions};
 
             return Success;
@@ -89,23 +89,12 @@ namespace PocketConsensus
     /*******************************************************************************************************************
     *  Factory for select actual rules version
     *******************************************************************************************************************/
-    class BlockingConsensusFactory
+    class BlockingConsensusFactory : public BaseConsensusFactory<BlockingConsensus>
     {
-    private:
-        const vector<ConsensusCheckpoint < BlockingConsensus>> m_rules = {
-            { 0, 0, [](int height) { return make_shared<BlockingConsensus>(height); }},
-        };
     public:
-        shared_ptr<BlockingConsensus> Instance(int height)
-        {
-            int m_height = (height > 0 ? height : 0);
-            return (--upper_bound(m_rules.begin(), m_rules.end(), m_height,
-                [&](int target, const ConsensusCheckpoint<BlockingConsensus>& itm)
-                {
-                    return target < itm.Height(Params().NetworkIDString());
-                }
-            ))->m_func(height);
-        }
+        BlockingConsensusFactory() : BaseConsensusFactory<BlockingConsensus>({
+            { 0, 0, [](int height) { return make_shared<BlockingConsensus>(height); }},
+        }) {}
     };
 }
 
@@ -21,14 +21,14 @@ namespace PocketConsensus
     public:
         BoostContentConsensus(int height) : SocialConsensus<BoostContent>(height) {}
 
-        ConsensusValidateResult Validate(const CTransactionRef& tx, const BoostContentRef& ptx, const PocketBlockRef& block) override
+        ConsensusValidateResult Validate(const CTransactionRef& tx, const BoostContentRef& ptx, const PocketBlockViewRef& block) override
         {
             // Base validation with calling block or mempool check
             if (auto[baseValidate, baseValidateCode] = SocialConsensus::Validate(tx, ptx, block); !baseValidate)
                 return {false, baseValidateCode};
 
             // Check exists content transaction
-            auto[contentOk, contentTx] = PocketDb::ConsensusRepoInst.GetLastContent(*ptx->GetContentTxHash(), { CONTENT_POST, CONTENT_VIDEO, CONTENT_ARTICLE, CONTENT_DELETE });
+            auto[contentOk, contentTx] = ConsensusRepo().GetLastContent(*ptx->GetContentTxHash(), { CONTENT_POST, CONTENT_VIDEO, CONTENT_ARTICLE, CONTENT_DELETE });
             if (!contentOk)
                 return {false, SocialConsensusResult_NotFound};
 
@@ -54,7 +54,7 @@ namespace PocketConsensus
         {
             return {false, SocialConsensusResult_NotAllowed};
         }
-        ConsensusValidateResult ValidateBlock(const BoostContentRef& ptx, const PocketBlockRef& block) override
+        ConsensusValidateResult ValidateBlock(const BoostContentRef& ptx, const PocketBlockViewRef& block) override
         {
             return Success;
         }
@@ -82,24 +82,13 @@ namespace PocketConsensus
         }
     };
 
-    class BoostContentConsensusFactory
+    class BoostContentConsensusFactory : public BaseConsensusFactory<BoostContentConsensus>
     {
-    private:
-        const vector<ConsensusCheckpoint<BoostContentConsensus>> m_rules = {
+    public:
+        BoostContentConsensusFactory() : BaseConsensusFactory<BoostContentConsensus>({
             {       0,      0, [](int height) { return make_shared<BoostContentConsensus>(height); }},
             { 1586000, 528100, [](int height) { return make_shared<BoostContentConsensus_checkpoint_accept>(height); }},
-        };
-    public:
-        shared_ptr<BoostContentConsensus> Instance(int height)
-        {
-            int m_height = (height > 0 ? height : 0);
-            return (--upper_bound(m_rules.begin(), m_rules.end(), m_height,
-                [&](int target, const ConsensusCheckpoint<BoostContentConsensus>& itm)
-                {
-                    return target < itm.Height(Params().NetworkIDString());
-                }
-            ))->m_func(height);
-        }
+        }) {}
     };
 }
 
@@ -22,7 +22,7 @@ namespace PocketConsensus
     {
     public:
         CommentConsensus(int height) : SocialConsensus<Comment>(height) {}
-        ConsensusValidateResult Validate(const CTransactionRef& tx, const CommentRef& ptx, const PocketBlockRef& block) override
+        ConsensusValidateResult Validate(const CTransactionRef& tx, const CommentRef& ptx, const PocketBlockViewRef& block) override
         {
             // Base validation with calling block or mempool check
             if (auto[baseValidate, baseValidateCode] = SocialConsensus::Validate(tx, ptx, block); !baseValidate)
@@ -32,7 +32,7 @@ namespace PocketConsensus
             if (!IsEmpty(ptx->GetParentTxHash()))
             {
                 // TODO (brangr): replace to check exists not deleted comment
-                auto[ok, parentTx] = ConsensusRepoInst.GetLastContent(
+                auto[ok, parentTx] = ConsensusRepo().GetLastContent(
                     *ptx->GetParentTxHash(),
                     { CONTENT_COMMENT, CONTENT_COMMENT_EDIT }
                 );
@@ -45,7 +45,7 @@ namespace PocketConsensus
             if (!IsEmpty(ptx->GetAnswerTxHash()))
             {
                 // TODO (brangr): replace to check exists not deleted comment
-                auto[ok, answerTx] = ConsensusRepoInst.GetLastContent(
+                auto[ok, answerTx] = ConsensusRepo().GetLastContent(
                     *ptx->GetAnswerTxHash(),
                     { CONTENT_COMMENT, CONTENT_COMMENT_EDIT }
                 );
@@ -55,7 +55,7 @@ namespace PocketConsensus
             }
 
             // Check exists content transaction
-            auto[contentOk, contentTx] = PocketDb::ConsensusRepoInst.GetLastContent(
+            auto[contentOk, contentTx] = ConsensusRepo().GetLastContent(
                 *ptx->GetPostTxHash(),
                 { CONTENT_POST, CONTENT_VIDEO, CONTENT_ARTICLE, CONTENT_DELETE }
             );
@@ -68,7 +68,7 @@ namespace PocketConsensus
 
             // TODO (brangr): convert to Content base class
             // Check Blocking
-            if (auto[existsBlocking, blockingType] = PocketDb::ConsensusRepoInst.GetLastBlockingType(
+            if (auto[existsBlocking, blockingType] = ConsensusRepo().GetLastBlockingType(
                     *contentTx->GetString1(), *ptx->GetAddress()
                 ); existsBlocking && blockingType == ACTION_BLOCKING)
                 return {false, SocialConsensusResult_Blocking};
@@ -98,10 +98,10 @@ namespace PocketConsensus
         }
 
     protected:
-        ConsensusValidateResult ValidateBlock(const CommentRef& ptx, const PocketBlockRef& block) override
+        ConsensusValidateResult ValidateBlock(const CommentRef& ptx, const PocketBlockViewRef& block) override
         {
             int count = GetChainCount(ptx);
-            for (auto& blockTx : *block)
+            for (auto& blockTx : block->ByString1(*ptx->GetAddress()))
             {
                 if (!TransactionHelper::IsIn(*blockTx->GetType(), {CONTENT_COMMENT}))
                     continue;
@@ -123,7 +123,7 @@ namespace PocketConsensus
         ConsensusValidateResult ValidateMempool(const CommentRef& ptx) override
         {
             int count = GetChainCount(ptx);
-            count += ConsensusRepoInst.CountMempoolComment(*ptx->GetAddress());
+            count += ConsensusRepo().CountMempoolComment(*ptx->GetAddress());
             return ValidateLimit(ptx, count);
         }
         vector<string> GetAddressesForCheckRegistration(const CommentRef& ptx) override
@@ -151,7 +151,7 @@ namespace PocketConsensus
         }
         virtual int GetChainCount(const CommentRef& ptx)
         {
-            return ConsensusRepoInst.CountChainCommentTime(
+            return ConsensusRepo().CountChainCommentTime(
                 *ptx->GetAddress(),
                 *ptx->GetTime() - GetConsensusLimit(ConsensusLimit_depth)
             );
@@ -191,7 +191,7 @@ namespace PocketConsensus
     protected:
         int GetChainCount(const CommentRef& ptx) override
         {
-            return ConsensusRepoInst.CountChainCommentHeight(
+            return ConsensusRepo().CountChainCommentHeight(
                 *ptx->GetAddress(),
                 Height - (int)GetConsensusLimit(ConsensusLimit_depth)
             );
@@ -201,25 +201,14 @@ namespace PocketConsensus
     /*******************************************************************************************************************
     *  Factory for select actual rules version
     *******************************************************************************************************************/
-    class CommentConsensusFactory
+    class CommentConsensusFactory : public BaseConsensusFactory<CommentConsensus>
     {
-    private:
-        const vector<ConsensusCheckpoint < CommentConsensus>> m_rules = {
+    public:
+        CommentConsensusFactory() : BaseConsensusFactory<CommentConsensus>({
             { 0, -1, [](int height) { return make_shared<CommentConsensus>(height); }},
             { 1124000, -1, [](int height) { return make_shared<CommentConsensus_checkpoint_1124000>(height); }},
             { 1180000, 0, [](int height) { return make_shared<CommentConsensus_checkpoint_1180000>(height); }},
-        };
-    public:
-        shared_ptr<CommentConsensus> Instance(int height)
-        {
-            int m_height = (height > 0 ? height : 0);
-            return (--upper_bound(m_rules.begin(), m_rules.end(), m_height,
-                [&](int target, const ConsensusCheckpoint<CommentConsensus>& itm)
-                {
-                    return target < itm.Height(Params().NetworkIDString());
-                }
-            ))->m_func(height);
-        }
+        }) {}
     };
 }
 
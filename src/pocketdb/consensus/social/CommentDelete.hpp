@@ -21,14 +21,14 @@ namespace PocketConsensus
     public:
         CommentDeleteConsensus(int height) : SocialConsensus<CommentDelete>(height) {}
 
-        ConsensusValidateResult Validate(const CTransactionRef& tx, const CommentDeleteRef& ptx, const PocketBlockRef& block) override
+        ConsensusValidateResult Validate(const CTransactionRef& tx, const CommentDeleteRef& ptx, const PocketBlockViewRef& block) override
         {
             // Base validation with calling block or mempool check
             if (auto[baseValidate, baseValidateCode] = SocialConsensus::Validate(tx, ptx, block); !baseValidate)
                 return {false, baseValidateCode};
 
             // Actual comment not deleted
-            auto[actuallTxOk, actuallTx] = ConsensusRepoInst.GetLastContent(
+            auto[actuallTxOk, actuallTx] = ConsensusRepo().GetLastContent(
                 *ptx->GetRootTxHash(),
                 { CONTENT_COMMENT, CONTENT_COMMENT_EDIT, CONTENT_COMMENT_DELETE }
             );
@@ -36,7 +36,7 @@ namespace PocketConsensus
                 return {false, SocialConsensusResult_NotFound};
 
             // Original comment exists
-            auto[originalTxOk, originalTx] = PocketDb::ConsensusRepoInst.GetFirstContent(*ptx->GetRootTxHash());
+            auto[originalTxOk, originalTx] = ConsensusRepo().GetFirstContent(*ptx->GetRootTxHash());
             if (!actuallTxOk || !originalTxOk)
                 return {false, SocialConsensusResult_NotFound};
 
@@ -85,9 +85,9 @@ namespace PocketConsensus
         }
 
     protected:
-        ConsensusValidateResult ValidateBlock(const CommentDeleteRef& ptx, const PocketBlockRef& block) override
+        ConsensusValidateResult ValidateBlock(const CommentDeleteRef& ptx, const PocketBlockViewRef& block) override
         {
-            for (auto& blockTx : *block)
+            for (auto& blockTx : block->ByString2(*ptx->GetRootTxHash()))
             {
                 if (!TransactionHelper::IsIn(*blockTx->GetType(), {CONTENT_COMMENT, CONTENT_COMMENT_EDIT, CONTENT_COMMENT_DELETE}))
                     continue;
@@ -104,7 +104,7 @@ namespace PocketConsensus
         }
         ConsensusValidateResult ValidateMempool(const CommentDeleteRef& ptx) override
         {
-            if (ConsensusRepoInst.CountMempoolCommentEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
+            if (ConsensusRepo().CountMempoolCommentEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
                 return {false, SocialConsensusResult_DoubleCommentDelete};
 
             return Success;
@@ -118,23 +118,12 @@ namespace PocketConsensus
     /*******************************************************************************************************************
     *  Factory for select actual rules version
     *******************************************************************************************************************/
-    class CommentDeleteConsensusFactory
+    class CommentDeleteConsensusFactory : public BaseConsensusFactory<CommentDeleteConsensus>
     {
-    private:
-        const vector<ConsensusCheckpoint < CommentDeleteConsensus>> m_rules = {
-            { 0, 0, [](int height) { return make_shared<CommentDeleteConsensus>(height); }},
-        };
     public:
-        shared_ptr<CommentDeleteConsensus> Instance(int height)
-        {
-            int m_height = (height > 0 ? height : 0);
-            return (--upper_bound(m_rules.begin(), m_rules.end(), m_height,
-                [&](int target, const ConsensusCheckpoint<CommentDeleteConsensus>& itm)
-                {
-                    return target < itm.Height(Params().NetworkIDString());
-                }
-            ))->m_func(height);
-        }
+        CommentDeleteConsensusFactory() : BaseConsensusFactory<CommentDeleteConsensus>({
+            { 0, 0, [](int height) { return make_shared<CommentDeleteConsensus>(height); }},
+        }) {}
     };
 }
 
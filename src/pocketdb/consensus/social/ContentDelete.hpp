@@ -20,14 +20,14 @@ namespace PocketConsensus
     {
     public:
         ContentDeleteConsensus(int height) : SocialConsensus<ContentDelete>(height) {}
-        ConsensusValidateResult Validate(const CTransactionRef& tx, const ContentDeleteRef& ptx, const PocketBlockRef& block) override
+        ConsensusValidateResult Validate(const CTransactionRef& tx, const ContentDeleteRef& ptx, const PocketBlockViewRef& block) override
         {
             // Base validation with calling block or mempool check
             if (auto[baseValidate, baseValidateCode] = SocialConsensus::Validate(tx, ptx, block); !baseValidate)
                 return {false, baseValidateCode};
 
             // Actual content not deleted
-            auto[ok, actuallTx] = ConsensusRepoInst.GetLastContent(
+            auto[ok, actuallTx] = ConsensusRepo().GetLastContent(
                 *ptx->GetRootTxHash(),
                 { CONTENT_POST, CONTENT_VIDEO, CONTENT_ARTICLE, CONTENT_DELETE }
             );
@@ -58,9 +58,9 @@ namespace PocketConsensus
         }
 
     protected:
-        ConsensusValidateResult ValidateBlock(const ContentDeleteRef& ptx, const PocketBlockRef& block) override
+        ConsensusValidateResult ValidateBlock(const ContentDeleteRef& ptx, const PocketBlockViewRef& block) override
         {
-            for (auto& blockTx : *block)
+            for (auto& blockTx : block->ByString2(*ptx->GetRootTxHash()))
             {
                 if (!TransactionHelper::IsIn(*blockTx->GetType(), {CONTENT_POST, CONTENT_VIDEO, CONTENT_ARTICLE, CONTENT_DELETE}))
                     continue;
@@ -77,7 +77,7 @@ namespace PocketConsensus
         }
         ConsensusValidateResult ValidateMempool(const ContentDeleteRef& ptx) override
         {
-            if (ConsensusRepoInst.CountMempoolContentDelete(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
+            if (ConsensusRepo().CountMempoolContentDelete(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
                 return {false, SocialConsensusResult_ContentDeleteDouble};
 
             return Success;
@@ -91,23 +91,12 @@ namespace PocketConsensus
     /*******************************************************************************************************************
     *  Factory for select actual rules version
     *******************************************************************************************************************/
-    class ContentDeleteConsensusFactory
+    class ContentDeleteConsensusFactory : public BaseConsensusFactory<ContentDeleteConsensus>
     {
-    private:
-        const vector<ConsensusCheckpoint < ContentDeleteConsensus>> m_rules = {
-            { 0, 0, [](int height) { return make_shared<ContentDeleteConsensus>(height); }},
-        };
     public:
-        shared_ptr<ContentDeleteConsensus> Instance(int height)
-        {
-            int m_height = (height > 0 ? height : 0);
-            return (--upper_bound(m_rules.begin(), m_rules.end(), m_height,
-                [&](int target, const ConsensusCheckpoint<ContentDeleteConsensus>& itm)
-                {
-                    return target < itm.Height(Params().NetworkIDString());
-                }
-            ))->m_func(height);
-        }
+        ContentDeleteConsensusFactory() : BaseConsensusFactory<ContentDeleteConsensus>({
+            { 0, 0, [](int height) { return make_shared<ContentDeleteConsensus>(height); }},
+        }) {}
     };
 }
 
@@ -24,7 +24,7 @@ namespace PocketConsensus
     {
     public:
         PostConsensus(int height) : SocialConsensus<Post>(height) {}
-        tuple<bool, SocialConsensusResult> Validate(const CTransactionRef& tx, const PostRef& ptx, const PocketBlockRef& block) override
+        tuple<bool, SocialConsensusResult> Validate(const CTransactionRef& tx, const PostRef& ptx, const PocketBlockViewRef& block) override
         {
             // Base validation with calling block or mempool check
             if (auto[baseValidate, baseValidateCode] = SocialConsensus::Validate(tx, ptx, block); !baseValidate)
@@ -33,7 +33,7 @@ namespace PocketConsensus
             // Check if this post relay another
             if (!IsEmpty(ptx->GetRelayTxHash()))
             {
-                auto[relayOk, relayTx] = PocketDb::ConsensusRepoInst.GetLastContent(
+                auto[relayOk, relayTx] = ConsensusRepo().GetLastContent(
                     *ptx->GetRelayTxHash(),
                     { CONTENT_POST, CONTENT_VIDEO, CONTENT_ARTICLE, CONTENT_DELETE }
                 );
@@ -71,7 +71,7 @@ namespace PocketConsensus
             return mode >= AccountMode_Full ? GetConsensusLimit(ConsensusLimit_full_post) : GetConsensusLimit(ConsensusLimit_trial_post);
         }
 
-        tuple<bool, SocialConsensusResult> ValidateBlock(const PostRef& ptx, const PocketBlockRef& block) override
+        tuple<bool, SocialConsensusResult> ValidateBlock(const PostRef& ptx, const PocketBlockViewRef& block) override
         {
             // Edit posts
             if (ptx->IsEdit())
@@ -84,7 +84,7 @@ namespace PocketConsensus
             int count = GetChainCount(ptx);
 
             // Get count from block
-            for (const auto& blockTx : *block)
+            for (const auto& blockTx : block->ByString1(*ptx->GetAddress()))
             {
                 if (!TransactionHelper::IsIn(*blockTx->GetType(), {CONTENT_POST}))
                     continue;
@@ -119,7 +119,7 @@ namespace PocketConsensus
             int count = GetChainCount(ptx);
 
             // Get count from mempool
-            count += ConsensusRepoInst.CountMempoolPost(*ptx->GetAddress());
+            count += ConsensusRepo().CountMempoolPost(*ptx->GetAddress());
 
             return ValidateLimit(ptx, count);
         }
@@ -130,7 +130,7 @@ namespace PocketConsensus
 
         virtual tuple<bool, SocialConsensusResult> ValidateEdit(const PostRef& ptx)
         {
-            auto[lastContentOk, lastContent] = PocketDb::ConsensusRepoInst.GetLastContent(
+            auto[lastContentOk, lastContent] = ConsensusRepo().GetLastContent(
                 *ptx->GetRootTxHash(),
                 { CONTENT_POST, CONTENT_VIDEO, CONTENT_ARTICLE, CONTENT_DELETE }
             );
@@ -138,7 +138,7 @@ namespace PocketConsensus
                 return {false, SocialConsensusResult_NotAllowed};
 
             // First get original post transaction
-            auto[originalTxOk, originalTx] = PocketDb::ConsensusRepoInst.GetFirstContent(*ptx->GetRootTxHash());
+            auto[originalTxOk, originalTx] = ConsensusRepo().GetFirstContent(*ptx->GetRootTxHash());
             if (!lastContentOk || !originalTxOk)
                 return {false, SocialConsensusResult_NotFound};
 
@@ -181,15 +181,15 @@ namespace PocketConsensus
         }
         virtual int GetChainCount(const PostRef& ptx)
         {
-            return ConsensusRepoInst.CountChainPostTime(
+            return ConsensusRepo().CountChainPostTime(
                 *ptx->GetAddress(),
                 *ptx->GetTime() - GetConsensusLimit(ConsensusLimit_depth)
             );
         }
-        virtual tuple<bool, SocialConsensusResult> ValidateEditBlock(const PostRef& ptx, const PocketBlockRef& block)
+        virtual tuple<bool, SocialConsensusResult> ValidateEditBlock(const PostRef& ptx, const PocketBlockViewRef& block)
         {
             // Double edit in block not allowed
-            for (auto& blockTx : *block)
+            for (auto& blockTx : block->ByString2(*ptx->GetRootTxHash()))
             {
                 if (!TransactionHelper::IsIn(*blockTx->GetType(), {CONTENT_POST, CONTENT_DELETE}))
                     continue;
@@ -208,7 +208,7 @@ namespace PocketConsensus
         }
         virtual tuple<bool, SocialConsensusResult> ValidateEditMempool(const PostRef& ptx)
         {
-            if (ConsensusRepoInst.CountMempoolPostEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
+            if (ConsensusRepo().CountMempoolPostEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
                 return {false, SocialConsensusResult_DoubleContentEdit};
 
             // Check edit limit
@@ -216,7 +216,7 @@ namespace PocketConsensus
         }
         virtual tuple<bool, SocialConsensusResult> ValidateEditOneLimit(const PostRef& ptx)
         {
-            int count = ConsensusRepoInst.CountChainPostEdit(*ptx->GetAddress(), *ptx->GetRootTxHash());
+            int count = ConsensusRepo().CountChainPostEdit(*ptx->GetAddress(), *ptx->GetRootTxHash());
             if (count >= GetConsensusLimit(ConsensusLimit_post_edit_count))
                 return {false, SocialConsensusResult_ContentEditLimit};
 
@@ -282,14 +282,14 @@ namespace PocketConsensus
     protected:
         int GetChainCount(const PostRef& ptx) override
         {
-            return ConsensusRepoInst.CountChainPostHeight(
+            return ConsensusRepo().CountChainPostHeight(
                 *ptx->GetAddress(),
                 Height - (int) GetConsensusLimit(ConsensusLimit_depth)
             );
         }
         bool AllowEditWindow(const PostRef& ptx, const ContentRef& originalTx) override
         {
-            auto[ok, originalTxHeight] = ConsensusRepoInst.GetTransactionHeight(*originalTx->GetHash());
+            auto[ok, originalTxHeight] = ConsensusRepo().GetTransactionHeight(*originalTx->GetHash());
             if (!ok)
                 return false;
 
@@ -300,25 +300,14 @@ namespace PocketConsensus
     /*******************************************************************************************************************
     *  Factory for select actual rules version
     *******************************************************************************************************************/
-    class PostConsensusFactory
+    class PostConsensusFactory : public BaseConsensusFactory<PostConsensus>
     {
-    protected:
-        const vector<ConsensusCheckpoint < PostConsensus>> m_rules = {
+    public:
+        PostConsensusFactory() : BaseConsensusFactory<PostConsensus>({
             { 0, -1, [](int height) { return make_shared<PostConsensus>(height); }},
             { 1124000, -1, [](int height) { return make_shared<PostConsensus_checkpoint_1124000>(height); }},
             { 1180000, -1, [](int height) { return make_shared<PostConsensus_checkpoint_1180000>(height); }},
-        };
-    public:
-        shared_ptr<PostConsensus> Instance(int height)
-        {
-            int m_height = (height > 0 ? height : 0);
-            return (--upper_bound(m_rules.begin(), m_rules.end(), m_height,
-                [&](int target, const ConsensusCheckpoint<PostConsensus>& itm)
-                {
-                    return target < itm.Height(Params().NetworkIDString());
-                }
-            ))->m_func(height);
-        }
+        }) {}
     };
 } // namespace PocketConsensus
 
@@ -22,19 +22,19 @@ namespace PocketConsensus
     public:
         explicit ScoreCommentConsensus(int height) : SocialConsensus<ScoreComment>(height) {}
 
-        ConsensusValidateResult Validate(const CTransactionRef& tx, const ScoreCommentRef& ptx, const PocketBlockRef& block) override
+        ConsensusValidateResult Validate(const CTransactionRef& tx, const ScoreCommentRef& ptx, const PocketBlockViewRef& block) override
         {
             // Base validation with calling block or mempool check
             if (auto[baseValidate, baseValidateCode] = SocialConsensus::Validate(tx, ptx, block); !baseValidate)
                 return {false, baseValidateCode};
 
             // Check already scored content
-            if (PocketDb::ConsensusRepoInst.ExistsScore(
+            if (ConsensusRepo().ExistsScore(
                 *ptx->GetAddress(), *ptx->GetCommentTxHash(), ACTION_SCORE_COMMENT, false))
                 return {false, SocialConsensusResult_DoubleCommentScore};
 
             // Comment should be exists
-            auto[lastContentOk, lastContent] = PocketDb::ConsensusRepoInst.GetLastContent(
+            auto[lastContentOk, lastContent] = ConsensusRepo().GetLastContent(
                 *ptx->GetCommentTxHash(),
                 { CONTENT_COMMENT, CONTENT_COMMENT_EDIT, CONTENT_COMMENT_DELETE }
             );
@@ -42,7 +42,7 @@ namespace PocketConsensus
             if (!lastContentOk && block)
             {
                 // ... or in block
-                for (auto& blockTx : *block)
+                for (auto& blockTx : block->ByString2(*ptx->GetCommentTxHash()))
                 {
                     if (!TransactionHelper::IsIn(*blockTx->GetType(), {CONTENT_COMMENT, CONTENT_COMMENT_EDIT, CONTENT_COMMENT_DELETE}))
                         continue;
@@ -107,13 +107,13 @@ namespace PocketConsensus
         }
 
     protected:
-        ConsensusValidateResult ValidateBlock(const ScoreCommentRef& ptx, const PocketBlockRef& block) override
+        ConsensusValidateResult ValidateBlock(const ScoreCommentRef& ptx, const PocketBlockViewRef& block) override
         {
             // Get count from chain
             int count = GetChainCount(ptx);
 
             // Get count from block
-            for (auto& blockTx : *block)
+            for (auto& blockTx : block->ByString1(*ptx->GetAddress()))
             {
                 if (!TransactionHelper::IsIn(*blockTx->GetType(), {ACTION_SCORE_COMMENT}))
                     continue;
@@ -138,7 +138,7 @@ namespace PocketConsensus
         {
 
             // Check already scored content
-            if (PocketDb::ConsensusRepoInst.ExistsScore(
+            if (ConsensusRepo().ExistsScore(
                 *ptx->GetAddress(), *ptx->GetCommentTxHash(), ACTION_SCORE_COMMENT, true))
                 return {false, SocialConsensusResult_DoubleCommentScore};
 
@@ -146,7 +146,7 @@ namespace PocketConsensus
             int count = GetChainCount(ptx);
 
             // and from mempool
-            count += ConsensusRepoInst.CountMempoolScoreComment(*ptx->GetAddress());
+            count += ConsensusRepo().CountMempoolScoreComment(*ptx->GetAddress());
 
             return ValidateLimit(ptx, count);
         }
@@ -180,7 +180,7 @@ namespace PocketConsensus
         virtual int GetChainCount(const ScoreCommentRef& ptx)
         {
 
-            return ConsensusRepoInst.CountChainScoreCommentTime(
+            return ConsensusRepo().CountChainScoreCommentTime(
                 *ptx->GetAddress(),
                 *ptx->GetTime() - GetConsensusLimit(ConsensusLimit_depth)
             );
@@ -198,7 +198,7 @@ namespace PocketConsensus
         ConsensusValidateResult ValidateBlocking(const string& commentAddress, const ScoreCommentRef& ptx) override
         {
 
-            auto[existsBlocking, blockingType] = PocketDb::ConsensusRepoInst.GetLastBlockingType(
+            auto[existsBlocking, blockingType] = ConsensusRepo().GetLastBlockingType(
                 commentAddress,
                 *ptx->GetAddress()
             );
@@ -249,7 +249,7 @@ namespace PocketConsensus
         int GetChainCount(const ScoreCommentRef& ptx) override
         {
 
-            return ConsensusRepoInst.CountChainScoreCommentHeight(
+            return ConsensusRepo().CountChainScoreCommentHeight(
                 *ptx->GetAddress(),
                 Height - (int) GetConsensusLimit(ConsensusLimit_depth)
             );
@@ -259,27 +259,16 @@ namespace PocketConsensus
     /*******************************************************************************************************************
     *  Factory for select actual rules version
     *******************************************************************************************************************/
-    class ScoreCommentConsensusFactory
+    class ScoreCommentConsensusFactory : public BaseConsensusFactory<ScoreCommentConsensus>
     {
-    private:
-        const vector<ConsensusCheckpoint < ScoreCommentConsensus>> m_rules = {
+    public:
+        ScoreCommentConsensusFactory() : BaseConsensusFactory<ScoreCommentConsensus>({
             { 0, -1, [](int height) { return make_shared<ScoreCommentConsensus>(height); }},
             { 430000, -1, [](int height) { return make_shared<ScoreCommentConsensus_checkpoint_430000>(height); }},
             { 514184, -1, [](int height) { return make_shared<ScoreCommentConsensus_checkpoint_514184>(height); }},
             { 1124000, -1, [](int height) { return make_shared<ScoreCommentConsensus_checkpoint_1124000>(height); }},
             { 1180000, 0, [](int height) { return make_shared<ScoreCommentConsensus_checkpoint_1180000>(height); }},
-        };
-    public:
-        shared_ptr<ScoreCommentConsensus> Instance(int height)
-        {
-            int m_height = (height > 0 ? height : 0);
-            return (--upper_bound(m_rules.begin(), m_rules.end(), m_height,
-                [&](int target, const ConsensusCheckpoint<ScoreCommentConsensus>& itm)
-                {
-                    return target < itm.Height(Params().NetworkIDString());
-                }
-            ))->m_func(height);
-        }
+        }) {}
     };
 }
 
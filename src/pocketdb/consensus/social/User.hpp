@@ -20,14 +20,14 @@ namespace PocketConsensus
     {
     public:
         UserConsensus(int height) : SocialConsensus<User>(height) {}
-        ConsensusValidateResult Validate(const CTransactionRef& tx, const UserRef& ptx, const PocketBlockRef& block) override
+        ConsensusValidateResult Validate(const CTransactionRef& tx, const UserRef& ptx, const PocketBlockViewRef& block) override
         {
             // Base validation with calling block or mempool check
             if (auto[baseValidate, baseValidateCode] = SocialConsensus::Validate(tx, ptx, block); !baseValidate)
                 return {false, baseValidateCode};
 
             // Duplicate name
-            if (ConsensusRepoInst.ExistsAnotherByName(*ptx->GetAddress(), *ptx->GetPayloadName()))
+            if (ConsensusRepo().ExistsAnotherByName(*ptx->GetAddress(), *ptx->GetPayloadName()))
             {
                 if (!CheckpointRepoInst.IsSocialCheckpoint(*ptx->GetHash(), *ptx->GetType(), SocialConsensusResult_NicknameDouble))
                     return {false, SocialConsensusResult_NicknameDouble};
@@ -101,10 +101,10 @@ namespace PocketConsensus
         }
 
     protected:
-        ConsensusValidateResult ValidateBlock(const UserRef& ptx, const PocketBlockRef& block) override
+        ConsensusValidateResult ValidateBlock(const UserRef& ptx, const PocketBlockViewRef& block) override
         {
             // Only one transaction allowed in block
-            for (auto& blockTx: *block)
+            for (auto& blockTx : block->ByString1(*ptx->GetAddress()))
             {
                 if (!TransactionHelper::IsIn(*blockTx->GetType(), {ACCOUNT_USER}))
                     continue;
@@ -127,7 +127,7 @@ namespace PocketConsensus
         }
         ConsensusValidateResult ValidateMempool(const UserRef& ptx) override
         {
-            if (ConsensusRepoInst.CountMempoolUser(*ptx->GetAddress()) > 0)
+            if (ConsensusRepo().CountMempoolUser(*ptx->GetAddress()) > 0)
                 return {false, SocialConsensusResult_ChangeInfoDoubleInMempool};
 
             if (GetChainCount(ptx) > GetConsensusLimit(ConsensusLimit_edit_user_daily_count))
@@ -143,7 +143,7 @@ namespace PocketConsensus
         virtual ConsensusValidateResult ValidateEdit(const UserRef& ptx)
         {
             // First user account transaction allowed without next checks
-            if (auto[ok, prevTxHeight] = ConsensusRepoInst.GetLastAccountHeight(*ptx->GetAddress()); !ok)
+            if (auto[ok, prevTxHeight] = ConsensusRepo().GetLastAccountHeight(*ptx->GetAddress()); !ok)
                 return Success;
 
             // Check editing limits
@@ -156,7 +156,7 @@ namespace PocketConsensus
         virtual ConsensusValidateResult ValidateEditLimit(const UserRef& ptx)
         {
             // First user account transaction allowed without next checks
-            auto[prevOk, prevTx] = ConsensusRepoInst.GetLastAccount(*ptx->GetAddress());
+            auto[prevOk, prevTx] = ConsensusRepo().GetLastAccount(*ptx->GetAddress());
             if (!prevOk)
                 return Success;
 
@@ -202,7 +202,7 @@ namespace PocketConsensus
         ConsensusValidateResult ValidateEditLimit(const UserRef& ptx) override
         {
             // First user account transaction allowed without next checks
-            auto[ok, prevTxHeight] = ConsensusRepoInst.GetLastAccountHeight(*ptx->GetAddress());
+            auto[ok, prevTxHeight] = ConsensusRepo().GetLastAccountHeight(*ptx->GetAddress());
             if (!ok) return Success;
 
             // We allow edit profile only with delay
@@ -227,7 +227,7 @@ namespace PocketConsensus
         }
         int GetChainCount(const UserRef& ptx) override
         {
-            return ConsensusRepoInst.CountChainAccount(
+            return ConsensusRepo().CountChainAccount(
                 *ptx->GetType(),
                 *ptx->GetAddress(),
                 Height - (int)GetConsensusLimit(ConsensusLimit_depth)
@@ -238,25 +238,14 @@ namespace PocketConsensus
     /*******************************************************************************************************************
     *  Factory for select actual rules version
     *******************************************************************************************************************/
-    class UserConsensusFactory
+    class UserConsensusFactory : public BaseConsensusFactory<UserConsensus>
     {
-    private:
-        const vector<ConsensusCheckpoint < UserConsensus>> m_rules = {
+    public:
+        UserConsensusFactory() : BaseConsensusFactory<UserConsensus>({
             { 0, -1, [](int height) { return make_shared<UserConsensus>(height); }},
             { 1180000, 0, [](int height) { return make_shared<UserConsensus_checkpoint_1180000>(height); }},
             { 1381841, 162000, [](int height) { return make_shared<UserConsensus_checkpoint_1381841>(height); }},
-        };
-    public:
-        shared_ptr<UserConsensus> Instance(int height)
-        {
-            int m_height = (height > 0 ? height : 0);
-            return (--upper_bound(m_rules.begin(), m_rules.end(), m_height,
-                [&](int target, const ConsensusCheckpoint<UserConsensus>& itm)
-                {
-                    return target < itm.Height(Params().NetworkIDString());
-                }
-            ))->m_func(height);
-        }
+        }) {}
     };
 
 } // namespace PocketConsensus
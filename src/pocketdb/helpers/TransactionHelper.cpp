@@ -22,6 +22,17 @@ namespace PocketHelpers
         return "";
     }
 
+    std::string TransactionHelper::ExtractOutputAddress(const CScript& scriptPubKey)
+    {
+        TxoutType type;
+        std::vector<CTxDestination> vDest;
+        int nRequired;
+        if (!ExtractDestinations(scriptPubKey, type, vDest, nRequired) || vDest.empty())
+            return "";
+
+        return EncodeDestination(vDest.back());
+    }
+
     tuple<bool, string> TransactionHelper::GetPocketAuthorAddress(const CTransactionRef& tx)
     {
         if (tx->vout.size() < 2)
@@ -197,7 +208,7 @@ namespace PocketHelpers
         return IsPocketSupportedTransaction(txRef);
     }
 
-    bool TransactionHelper::IsPocketTransaction(TxType& txType)
+    bool TransactionHelper::IsPocketTransaction(const TxType& txType)
     {
         return txType != NOT_SUPPORTED &&
                txType != TX_COINBASE &&
@@ -475,4 +486,68 @@ namespace PocketHelpers
         else if (type == "contentBoost" || type == OR_CONTENT_BOOST) return TxType::BOOST_CONTENT;
         else return TxType::NOT_SUPPORTED;
     }
-}
\ No newline at end of file
+
+    // ----------------------------------------------------------------------
+
+    PocketBlockView::PocketBlockView(const PocketBlockRef& block) : m_block(block)
+    {
+        if (!m_block)
+            m_block = make_shared<PocketBlock>();
+
+        m_byHash.reserve(m_block->size());
+        for (const auto& ptx : *m_block)
+            index(ptx);
+    }
+
+    void PocketBlockView::Add(const PTransactionRef& ptx)
+    {
+        m_block->push_back(ptx);
+        index(ptx);
+    }
+
+    PTransactionRef PocketBlockView::Find(const string& txHash) const
+    {
+        auto it = m_byHash.find(txHash);
+        return it != m_byHash.end() ? it->second : nullptr;
+    }
+
+    const vector<PTransactionRef>& PocketBlockView::ByString1(const string& value) const
+    {
+        static const vector<PTransactionRef> empty;
+        auto it = m_byString1.find(value);
+
+        if (m_lookups)
+        {
+            m_lookups->String1.push_back(value);
+            m_lookups->Found |= it != m_byString1.end();
+        }
+
+        return it != m_byString1.end() ? it->second : empty;
+    }
+
+    const vector<PTransactionRef>& PocketBlockView::ByString2(const string& value) const
+    {
+        static const vector<PTransactionRef> empty;
+        auto it = m_byString2.find(value);
+
+        if (m_lookups)
+        {
+            m_lookups->String2.push_back(value);
+            m_lookups->Found |= it != m_byString2.end();
+        }
+
+        return it != m_byString2.end() ? it->second : empty;
+    }
+
+    void PocketBlockView::index(const PTransactionRef& ptx)
+    {
+        if (auto hash = ptx->GetHash(); hash)
+            m_byHash.emplace(*hash, ptx);
+
+        if (auto string1 = ptx->GetString1(); string1)
+            m_byString1[*string1].push_back(ptx);
+
+        if (auto string2 = ptx->GetString2(); string2)
+            m_byString2[*string2].push_back(ptx);
+    }
+}
@@ -9,6 +9,7 @@
 #include <key_io.h>
 #include <boost/algorithm/string.hpp>
 #include <numeric>
+#include <unordered_map>
 #include "script/standard.h"
 #include "primitives/transaction.h"
 #include "util/strencodings.h"
@@ -48,11 +49,55 @@ namespace PocketHelpers
     typedef vector<PTransactionRef> PocketBlock;
     typedef shared_ptr<PocketBlock> PocketBlockRef;
 
+    // Indexed view of a PocketBlock for in-block consensus lookups.
+    // Built once per block; lists keep block order so "first found" semantics are unchanged.
+    class PocketBlockView
+    {
+    public:
+        // Keys of ByString1 and ByString2 lookups and whether any of them found transactions
+        struct Lookups
+        {
+            vector<string> String1;
+            vector<string> String2;
+            bool Found = false;
+        };
+
+        explicit PocketBlockView(const PocketBlockRef& block);
+
+        // Append transaction accepted into the block under construction
+        void Add(const PTransactionRef& ptx);
+
+        const PocketBlockRef& Block() const { return m_block; }
+        PTransactionRef Find(const string& txHash) const;
+
+        // Block transactions with String1 (author address) equal to value
+        const vector<PTransactionRef>& ByString1(const string& value) const;
+        // Block transactions with String2 (root, target content or target address) equal to value
+        const vector<PTransactionRef>& ByString2(const string& value) const;
+
+        // Lookups are written to target until recording is stopped with nullptr.
+        // Used by block construction in one thread only.
+        void Record(Lookups* lookups) { m_lookups = lookups; }
+
+    private:
+        PocketBlockRef m_block;
+        Lookups* m_lookups = nullptr;
+        unordered_map<string, PTransactionRef> m_byHash;
+        unordered_map<string, vector<PTransactionRef>> m_byString1;
+        unordered_map<string, vector<PTransactionRef>> m_byString2;
+
+        void index(const PTransactionRef& ptx);
+    };
+
+    typedef shared_ptr<PocketBlockView> PocketBlockViewRef;
+
     class TransactionHelper
     {
     public:
         static TxoutType ScriptType(const CScript& scriptPubKey);
         static std::string ExtractDestination(const CScript& scriptPubKey);
+        // Address of output as saved in TxOutputs.AddressHash
+        static std::string ExtractOutputAddress(const CScript& scriptPubKey);
         static tuple<bool, string> GetPocketAuthorAddress(const CTransactionRef& tx);
         static TxType ConvertOpReturnToType(const string& op);
         static string ParseAsmType(const CTransactionRef& tx, vector<string>& vasm);
@@ -64,7 +109,7 @@ namespace PocketHelpers
         static bool IsPocketSupportedTransaction(const CTransactionRef& tx, TxType& txType);
         static bool IsPocketSupportedTransaction(const CTransactionRef& tx);
         static bool IsPocketSupportedTransaction(const CTransaction& tx);
-        static bool IsPocketTransaction(TxType& txType);
+        static bool IsPocketTransaction(const TxType& txType);
         static bool IsPocketTransaction(const CTransactionRef& tx, TxType& txType);
         static bool IsPocketTransaction(const CTransactionRef& tx);
         static bool IsPocketTransaction(const CTransaction& tx);
@@ -20,6 +20,9 @@ namespace PocketDb
         vector<string> _views;
         string _indexes;
 
+        // Indexes not used by consensus and indexing lookups, may be built later than data
+        vector<string> _deferredIndexes;
+
     public:
 
         explicit PocketDbMigration() = default;
@@ -27,6 +30,7 @@ namespace PocketDb
         vector<string>& Tables() { return _tables; }
         vector<string>& Views() { return _views; }
         string& Indexes() { return _indexes; }
+        vector<string>& DeferredIndexes() { return _deferredIndexes; }
     };
 
     typedef std::shared_ptr<PocketDbMigration> PocketDbMigrationRef;
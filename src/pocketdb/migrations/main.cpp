@@ -163,54 +163,97 @@ namespace PocketDb
             );
         )sql");
 
+        // Rows changed by connected blocks, replayed in reverse on rollback
+        _tables.emplace_back(R"sql(
+            create table if not exists BlockUndo
+            (
+                Height  int   not null,
+                Type    int   not null,
+                String1 text  null,
+                Int1    int   null,
+                Int2    int   null,
+                Int3    int   null
+            );
+        )sql");
+
+        // Transactions by type in buckets of Period blocks (hours and days) for explorer, maintained by block indexing.
+        // Last is the change of count of last versions (Last = 1) of the type made by transactions of the bucket.
+        _tables.emplace_back(R"sql(
+            create table if not exists TransactionsStatistic
+            (
+                Period  int   not null,
+                Bucket  int   not null,
+                Type    int   not null,
+                Count   int   not null,
+                Last    int   not null,
+                primary key (Period, Bucket, Type)
+            );
+        )sql");
+
+        // Node local state of the database
+        _tables.emplace_back(R"sql(
+            create table if not exists Settings
+            (
+                Key   text  not null primary key,
+                Value int   not null
+            );
+        )sql");
+
         _indexes = R"sql(
             drop index if exists Payload_String2;
             drop index if exists Payload_String2_TxHash;
             drop index if exists Transactions_Height_Time;
             drop index if exists Transactions_Time_Type_Height;
             drop index if exists Transactions_Type_Time_Height;
+            drop index if exists Transactions_Type_HeightByDay;
+            drop index if exists Transactions_Type_HeightByHour;
 
             create index if not exists Transactions_Id on Transactions (Id);
             create index if not exists Transactions_Id_Last on Transactions (Id, Last);
             create index if not exists Transactions_Hash_Height on Transactions (Hash, Height);
-            create index if not exists Transactions_Height_Type on Transactions (Height, Type);
             create index if not exists Transactions_Type_Last_String1_Height_Id on Transactions (Type, Last, String1, Height, Id);
             create index if not exists Transactions_Type_Last_String2_Height on Transactions (Type, Last, String2, Height);
-            create index if not exists Transactions_Type_Last_String3_Height on Transactions (Type, Last, String3, Height);
-            create index if not exists Transactions_Type_Last_String4_Height on Transactions (Type, Last, String4, Height);
             create index if not exists Transactions_Type_Last_String1_String2_Height on Transactions (Type, Last, String1, String2, Height);
-            create index if not exists Transactions_Type_Last_Height_String5_String1 on Transactions (Type, Last, Height, String5, String1);
-            create index if not exists Transactions_Type_Last_Height_Id on Transactions (Type, Last, Height, Id);
             create index if not exists Transactions_Type_String1_String2_Height on Transactions (Type, String1, String2, Height);
             create index if not exists Transactions_Type_String1_Height_Time_Int1 on Transactions (Type, String1, Height, Time, Int1);
-            create index if not exists Transactions_String1_Last_Height on Transactions (String1, Last, Height);
             create index if not exists Transactions_Last_Id_Height on Transactions (Last, Id, Height);
             create index if not exists Transactions_BlockHash on Transactions (BlockHash);
             create index if not exists Transactions_Height_Id on Transactions (Height, Id);
-            create index if not exists Transactions_Type_HeightByDay on Transactions (Type, (Height / 1440));
-            create index if not exists Transactions_Type_HeightByHour on Transactions (Type, (Height / 60));
 
             create index if not exists TxOutputs_SpentHeight_AddressHash on TxOutputs (SpentHeight, AddressHash);
             create index if not exists TxOutputs_TxHeight_AddressHash on TxOutputs (TxHeight, AddressHash);
             create index if not exists TxOutputs_SpentTxHash on TxOutputs (SpentTxHash);
             create index if not exists TxOutputs_TxHash_AddressHash_Value on TxOutputs (TxHash, AddressHash, Value);
-            create index if not exists TxOutputs_AddressHash_TxHeight_SpentHeight on TxOutputs (AddressHash, TxHeight, SpentHeight);
+            create index if not exists TxOutputs_AddressHash_Unspent on TxOutputs (AddressHash, TxHeight) where SpentHeight is null;
 
             create index if not exists Ratings_Last_Id_Height on Ratings (Last, Id, Height);
             create index if not exists Ratings_Height_Last on Ratings (Height, Last);
             create index if not exists Ratings_Type_Id_Value on Ratings (Type, Id, Value);
             create index if not exists Ratings_Type_Id_Last_Height on Ratings (Type, Id, Last, Height);
-            create index if not exists Ratings_Type_Id_Last_Value on Ratings (Type, Id, Last, Value);
             create index if not exists Ratings_Type_Id_Height_Value on Ratings (Type, Id, Height, Value);
 
             create index if not exists Payload_String2_nocase_TxHash on Payload (String2 collate nocase, TxHash);
-            create index if not exists Payload_String7 on Payload (String7);
-            create index if not exists Payload_String1_TxHash on Payload (String1, TxHash);
 
             create index if not exists Balances_Height on Balances (Height);
             create index if not exists Balances_AddressHash_Last_Height on Balances (AddressHash, Last, Height);
-            create index if not exists Balances_Last_Value on Balances (Last, Value);
             create index if not exists Balances_AddressHash_Last on Balances (AddressHash, Last);
+
+            create index if not exists BlockUndo_Height on BlockUndo (Height);
         )sql";
+
+        // Used only by RPC queries - dropped while bulk loading blocks
+        _deferredIndexes = {
+            R"sql(create index if not exists Transactions_Height_Type on Transactions (Height, Type);)sql",
+            R"sql(create index if not exists Transactions_Type_Last_String3_Height on Transactions (Type, Last, String3, Height);)sql",
+            R"sql(create index if not exists Transactions_Type_Last_String4_Height on Transactions (Type, Last, String4, Height);)sql",
+            R"sql(create index if not exists Transactions_Type_Last_Height_String5_String1 on Transactions (Type, Last, Height, String5, String1);)sql",
+            R"sql(create index if not exists Transactions_Type_Last_Height_Id on Transactions (Type, Last, Height, Id);)sql",
+            R"sql(create index if not exists Transactions_String1_Last_Height on Transactions (String1, Last, Height);)sql",
+            R"sql(create index if not exists TxOutputs_AddressHash_TxHeight_SpentHeight on TxOutputs (AddressHash, TxHeight, SpentHeight);)sql",
+            R"sql(create index if not exists Ratings_Type_Id_Last_Value on Ratings (Type, Id, Last, Value);)sql",
+            R"sql(create index if not exists Payload_String7 on Payload (String7);)sql",
+            R"sql(create index if not exists Payload_String1_TxHash on Payload (String1, TxHash);)sql",
+            R"sql(create index if not exists Balances_Last_Value on Balances (Last, Value);)sql"
+        };
     }
 }
\ No newline at end of file
@@ -42,11 +42,44 @@ namespace PocketDb
             );
         )sql");
 
+        // Materialized candidates of content feeds, maintained by WebPostProcessor.
+        // Rows mirror the last edition of content and its current rating.
+        _tables.emplace_back(R"sql(
+            create table if not exists Feed
+            (
+                Id            integer primary key,
+                Type          int   not null,
+                Lang          text  null,
+                AddressHash   text  not null,
+                RootTxHash    text  not null,
+                RelayTxHash   text  null,
+                Height        int   not null,
+                OrigHeight    int   not null,
+                Rating        int   not null,
+                RatingHeight  int   not null
+            );
+        )sql");
+
+        // Authors of feed contents with current account rating
+        _tables.emplace_back(R"sql(
+            create table if not exists FeedAccounts
+            (
+                AddressHash   text  not null primary key,
+                Id            int   not null,
+                Height        int   not null,
+                Rating        int   not null,
+                RatingHeight  int   not null
+            );
+        )sql");
+
         _indexes = R"sql(
             create unique index if not exists Tags_Lang_Value on Tags (Lang, Value);
             create index if not exists Tags_Lang_Id on Tags (Lang, Id);
             create index if not exists Tags_Lang_Value_Id on Tags (Lang, Value, Id);
             create index if not exists TagsMap_TagId_ContentId on TagsMap (TagId, ContentId);
+            create index if not exists Feed_Lang_Type_Height on Feed (Lang, Type, Height);
+            create index if not exists Feed_Type_Height on Feed (Type, Height);
+            create index if not exists Feed_Lang_Id on Feed (Lang, Id);
         )sql";
     }
 }
\ No newline at end of file
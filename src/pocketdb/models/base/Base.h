@@ -6,6 +6,7 @@
 #define POCKETTX_BASE_H
 
 #include <memory>
+#include <optional>
 #include "pocketdb/models/base/PocketTypes.h"
 #include <univalue/include/univalue.h>
 
@@ -19,6 +20,10 @@ namespace PocketTx
         Base() = default;
         virtual ~Base() = default;
     protected:
+        // Fields are stored inline; getters expose them as non-owning pointers valid while the model lives
+        template<typename T>
+        static const T* FieldPtr(const optional<T>& field) { return field ? &*field : nullptr; }
+
         tuple<bool, string> TryGetStr(const UniValue& o, const string& key);
         tuple<bool, int> TryGetInt(const UniValue& o, const string& key);
         tuple<bool, int64_t> TryGetInt64(const UniValue& o, const string& key);
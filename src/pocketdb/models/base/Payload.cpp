@@ -8,31 +8,31 @@ namespace PocketTx
 {
     Payload::Payload() {}
 
-    shared_ptr <string> Payload::GetTxHash() const { return m_txHash; }
-    void Payload::SetTxHash(string value) { m_txHash = make_shared<string>(value); }
+    const string* Payload::GetTxHash() const { return FieldPtr(m_txHash); }
+    void Payload::SetTxHash(string value) { m_txHash = std::move(value); }
 
-    shared_ptr <string> Payload::GetString1() const { return m_string1; }
-    void Payload::SetString1(string value) { m_string1 = make_shared<string>(value); }
+    const string* Payload::GetString1() const { return FieldPtr(m_string1); }
+    void Payload::SetString1(string value) { m_string1 = std::move(value); }
 
-    shared_ptr <string> Payload::GetString2() const { return m_string2; }
-    void Payload::SetString2(string value) { m_string2 = make_shared<string>(value); }
+    const string* Payload::GetString2() const { return FieldPtr(m_string2); }
+    void Payload::SetString2(string value) { m_string2 = std::move(value); }
 
-    shared_ptr <string> Payload::GetString3() const { return m_string3; }
-    void Payload::SetString3(string value) { m_string3 = make_shared<string>(value); }
+    const string* Payload::GetString3() const { return FieldPtr(m_string3); }
+    void Payload::SetString3(string value) { m_string3 = std::move(value); }
 
-    shared_ptr <string> Payload::GetString4() const { return m_string4; }
-    void Payload::SetString4(string value) { m_string4 = make_shared<string>(value); }
+    const string* Payload::GetString4() const { return FieldPtr(m_string4); }
+    void Payload::SetString4(string value) { m_string4 = std::move(value); }
 
-    shared_ptr <string> Payload::GetString5() const { return m_string5; }
-    void Payload::SetString5(string value) { m_string5 = make_shared<string>(value); }
+    const string* Payload::GetString5() const { return FieldPtr(m_string5); }
+    void Payload::SetString5(string value) { m_string5 = std::move(value); }
 
-    shared_ptr <string> Payload::GetString6() const { return m_string6; }
-    void Payload::SetString6(string value) { m_string6 = make_shared<string>(value); }
+    const string* Payload::GetString6() const { return FieldPtr(m_string6); }
+    void Payload::SetString6(string value) { m_string6 = std::move(value); }
 
-    shared_ptr <string> Payload::GetString7() const { return m_string7; }
-    void Payload::SetString7(string value) { m_string7 = make_shared<string>(value); }
+    const string* Payload::GetString7() const { return FieldPtr(m_string7); }
+    void Payload::SetString7(string value) { m_string7 = std::move(value); }
 
-    shared_ptr <int> Payload::GetInt1() const { return m_int1; }
-    void Payload::SetInt1(int value) { m_int1 = make_shared<int>(value); }
+    const int* Payload::GetInt1() const { return FieldPtr(m_int1); }
+    void Payload::SetInt1(int value) { m_int1 = value; }
 
 } // namespace PocketTx
\ No newline at end of file
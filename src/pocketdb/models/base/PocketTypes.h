@@ -96,6 +96,16 @@ namespace PocketTx
         RATING_COMMENT = 3,
     };
 
+    // Block undo journal record types - what to restore on rollback
+    enum BlockUndoType
+    {
+        BLOCK_UNDO_TX_INDEXED = 1,      // String1 = Transactions.Hash
+        BLOCK_UNDO_TX_LAST = 2,         // String1 = Transactions.Hash with cleared Last
+        BLOCK_UNDO_OUTPUT_SPENT = 3,    // String1 = TxOutputs.TxHash, Int1 = TxOutputs.Number
+        BLOCK_UNDO_RATING_LAST = 4,     // Int1 = Ratings.Type, Int2 = Ratings.Id, Int3 = Ratings.Height with cleared Last
+        BLOCK_UNDO_BALANCE_LAST = 5,    // String1 = Balances.AddressHash, Int1 = Balances.Height with cleared Last
+    };
+
     // Content field types
     enum ContentFieldType
     {
@@ -119,6 +129,8 @@ namespace PocketTx
         int64_t Time;
         TxType Type;
         vector<pair<string, int>> Inputs;
+        // Address and value of every output in tx.vout order
+        vector<pair<string, int64_t>> Outputs;
 
         bool IsAccount() const
         {
@@ -35,61 +35,62 @@ namespace PocketTx
         virtual string BuildHash() = 0;
         virtual void SetAddress(const string& value) {}
 
-        shared_ptr<string> GetHash() const;
+        const string* GetHash() const;
         void SetHash(string value);
         bool operator==(const string& hash) const;
 
-        shared_ptr<TxType> GetType() const;
+        const TxType* GetType() const;
         void SetType(TxType value);
 
-        shared_ptr<int64_t> GetTime() const;
+        const int64_t* GetTime() const;
         void SetTime(int64_t value);
 
-        shared_ptr<bool> GetLast() const;
+        const bool* GetLast() const;
         void SetLast(bool value);
 
-        shared_ptr<string> GetString1() const;
+        const string* GetString1() const;
         void SetString1(string value);
 
-        shared_ptr<string> GetString2() const;
+        const string* GetString2() const;
         void SetString2(string value);
 
-        shared_ptr<string> GetString3() const;
+        const string* GetString3() const;
         void SetString3(string value);
 
-        shared_ptr<string> GetString4() const;
+        const string* GetString4() const;
         void SetString4(string value);
 
-        shared_ptr<string> GetString5() const;
+        const string* GetString5() const;
         void SetString5(string value);
 
-        shared_ptr<int64_t> GetInt1() const;
+        const int64_t* GetInt1() const;
         void SetInt1(int64_t value);
 
-        shared_ptr<int64_t> GetId() const;
+        const int64_t* GetId() const;
         void SetId(int64_t value);
 
-        vector<shared_ptr<TransactionOutput>>& Outputs();
-        const vector<shared_ptr<TransactionOutput>>& OutputsConst() const;
+        vector<TransactionOutput>& Outputs();
+        const vector<TransactionOutput>& OutputsConst() const;
 
-        shared_ptr<Payload> GetPayload() const;
+        const Payload* GetPayload() const;
+        Payload* GetPayload();
         void SetPayload(Payload value);
         bool HasPayload() const;
 
     protected:
-        shared_ptr<TxType> m_type = nullptr;
-        shared_ptr<string> m_hash = nullptr;
-        shared_ptr<int64_t> m_time = nullptr;
-        shared_ptr<int64_t> m_id = nullptr;
-        shared_ptr<bool> m_last = nullptr;
-        shared_ptr<string> m_string1 = nullptr;
-        shared_ptr<string> m_string2 = nullptr;
-        shared_ptr<string> m_string3 = nullptr;
-        shared_ptr<string> m_string4 = nullptr;
-        shared_ptr<string> m_string5 = nullptr;
-        shared_ptr<int64_t> m_int1 = nullptr;
-        shared_ptr<Payload> m_payload = nullptr;
-        vector<shared_ptr<TransactionOutput>> m_outputs;
+        optional<TxType> m_type;
+        optional<string> m_hash;
+        optional<int64_t> m_time;
+        optional<int64_t> m_id;
+        optional<bool> m_last;
+        optional<string> m_string1;
+        optional<string> m_string2;
+        optional<string> m_string3;
+        optional<string> m_string4;
+        optional<string> m_string5;
+        optional<int64_t> m_int1;
+        optional<Payload> m_payload;
+        vector<TransactionOutput> m_outputs;
 
         void GeneratePayload();
         void ClearPayload();
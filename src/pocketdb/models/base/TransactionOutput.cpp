@@ -6,19 +6,19 @@
 
 namespace PocketTx
 {
-    shared_ptr <string> TransactionOutput::GetTxHash() const { return m_txHash; }
-    void TransactionOutput::SetTxHash(string value) { m_txHash = make_shared<string>(value); }
+    const string* TransactionOutput::GetTxHash() const { return FieldPtr(m_txHash); }
+    void TransactionOutput::SetTxHash(string value) { m_txHash = std::move(value); }
 
-    shared_ptr <int64_t> TransactionOutput::GetNumber() const { return m_number; }
-    void TransactionOutput::SetNumber(int64_t value) { m_number = make_shared<int64_t>(value); }
+    const int64_t* TransactionOutput::GetNumber() const { return FieldPtr(m_number); }
+    void TransactionOutput::SetNumber(int64_t value) { m_number = value; }
 
-    shared_ptr <string> TransactionOutput::GetAddressHash() const { return m_addressHash; }
-    void TransactionOutput::SetAddressHash(string value) { m_addressHash = make_shared<string>(value); }
+    const string* TransactionOutput::GetAddressHash() const { return FieldPtr(m_addressHash); }
+    void TransactionOutput::SetAddressHash(string value) { m_addressHash = std::move(value); }
 
-    shared_ptr <int64_t> TransactionOutput::GetValue() const { return m_value; }
-    void TransactionOutput::SetValue(int64_t value) { m_value = make_shared<int64_t>(value); }
+    const int64_t* TransactionOutput::GetValue() const { return FieldPtr(m_value); }
+    void TransactionOutput::SetValue(int64_t value) { m_value = value; }
     
-    shared_ptr <string> TransactionOutput::GetScriptPubKey() const { return m_scriptPubKey; }
-    void TransactionOutput::SetScriptPubKey(string value) { m_scriptPubKey = make_shared<string>(value); }
+    const string* TransactionOutput::GetScriptPubKey() const { return FieldPtr(m_scriptPubKey); }
+    void TransactionOutput::SetScriptPubKey(string value) { m_scriptPubKey = std::move(value); }
 
 } // namespace PocketTx
\ No newline at end of file
@@ -16,27 +16,27 @@ namespace PocketTx
     public:
         TransactionOutput() = default;
 
-        shared_ptr<string> GetTxHash() const;
+        const string* GetTxHash() const;
         void SetTxHash(string value);
 
-        shared_ptr<int64_t> GetNumber() const;
+        const int64_t* GetNumber() const;
         void SetNumber(int64_t value);
 
-        shared_ptr<string> GetAddressHash() const;
+        const string* GetAddressHash() const;
         void SetAddressHash(string value);
 
-        shared_ptr<int64_t> GetValue() const;
+        const int64_t* GetValue() const;
         void SetValue(int64_t value);
         
-        shared_ptr<string> GetScriptPubKey() const;
+        const string* GetScriptPubKey() const;
         void SetScriptPubKey(string value);
 
     protected:
-        shared_ptr<string> m_txHash = nullptr;
-        shared_ptr<int64_t> m_number = nullptr;
-        shared_ptr<string> m_addressHash = nullptr;
-        shared_ptr<int64_t> m_value = nullptr;
-        shared_ptr<string> m_scriptPubKey = nullptr;
+        optional<string> m_txHash;
+        optional<int64_t> m_number;
+        optional<string> m_addressHash;
+        optional<int64_t> m_value;
+        optional<string> m_scriptPubKey;
     };
 
 } // namespace PocketTx
@@ -18,10 +18,10 @@ namespace PocketTx
     }
 
     
-    shared_ptr <string> AccountSetting::GetAddress() const { return m_string1; }
-    void AccountSetting::SetAddress(const string& value) { m_string1 = make_shared<string>(value); }
+    const string* AccountSetting::GetAddress() const { return FieldPtr(m_string1); }
+    void AccountSetting::SetAddress(const string& value) { m_string1 = value; }
 
-    shared_ptr <string> AccountSetting::GetPayloadData() const {return GetPayload() ? GetPayload()->GetString1() : nullptr; }
+    const string* AccountSetting::GetPayloadData() const {return GetPayload() ? GetPayload()->GetString1() : nullptr; }
 
 
     shared_ptr <UniValue> AccountSetting::Serialize() const
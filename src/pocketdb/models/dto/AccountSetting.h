@@ -21,10 +21,10 @@ namespace PocketTx
         void DeserializeRpc(const UniValue& src) override;
         void DeserializePayload(const UniValue& src) override;
 
-        shared_ptr <string> GetAddress() const;
+        const string* GetAddress() const;
         void SetAddress(const string& value) override;
 
-        shared_ptr <string> GetPayloadData() const;
+        const string* GetPayloadData() const;
 
         string BuildHash() override;
 
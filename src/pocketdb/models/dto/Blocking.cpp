@@ -41,11 +41,11 @@ namespace PocketTx
         if (auto[ok, val] = TryGetStr(src, "address"); ok) SetAddressTo(val);
     }
 
-    shared_ptr <string> Blocking::GetAddress() const { return m_string1; }
-    void Blocking::SetAddress(const string& value) { m_string1 = make_shared<string>(value); }
+    const string* Blocking::GetAddress() const { return FieldPtr(m_string1); }
+    void Blocking::SetAddress(const string& value) { m_string1 = value; }
 
-    shared_ptr <string> Blocking::GetAddressTo() const { return m_string2; }
-    void Blocking::SetAddressTo(const string& value) { m_string2 = make_shared<string>(value); }
+    const string* Blocking::GetAddressTo() const { return FieldPtr(m_string2); }
+    void Blocking::SetAddressTo(const string& value) { m_string2 = value; }
 
     void Blocking::DeserializePayload(const UniValue& src)
     {
@@ -21,23 +21,23 @@ namespace PocketTx
         void DeserializeRpc(const UniValue& src) override;
         void DeserializePayload(const UniValue& src) override;
 
-        shared_ptr <string> GetAddress() const;
+        const string* GetAddress() const;
         void SetAddress(const string& value) override;
 
-        shared_ptr <string> GetRootTxHash() const;
+        const string* GetRootTxHash() const;
         void SetRootTxHash(const string& value);
 
-        shared_ptr <string> GetPostTxHash() const;
+        const string* GetPostTxHash() const;
         void SetPostTxHash(const string& value);
 
-        shared_ptr <string> GetParentTxHash() const;
+        const string* GetParentTxHash() const;
         void SetParentTxHash(const string& value);
 
-        shared_ptr <string> GetAnswerTxHash() const;
+        const string* GetAnswerTxHash() const;
         void SetAnswerTxHash(const string& value);
 
         // Payload getters
-        shared_ptr <string> GetPayloadMsg() const;
+        const string* GetPayloadMsg() const;
         void SetPayloadMsg(const string& value);
 
         string BuildHash() override;
@@ -17,10 +17,10 @@ namespace PocketTx
         Content();
         Content(const CTransactionRef& tx);
 
-        shared_ptr<string> GetAddress() const;
+        const string* GetAddress() const;
         void SetAddress(const string& value) override;
 
-        shared_ptr<string> GetRootTxHash() const;
+        const string* GetRootTxHash() const;
         void SetRootTxHash(const string& value);
         
         bool IsEdit() const;
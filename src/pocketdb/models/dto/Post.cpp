@@ -101,16 +101,16 @@ namespace PocketTx
         if (auto[ok, val] = TryGetStr(src, "settings"); ok) m_payload->SetString6(val);
     }
     
-    shared_ptr<string> Post::GetRelayTxHash() const { return m_string3; }
-    void Post::SetRelayTxHash(const string& value) { m_string3 = make_shared<string>(value); }
-
-    shared_ptr<string> Post::GetPayloadLang() const { return GetPayload() ? GetPayload()->GetString1() : nullptr; }
-    shared_ptr<string> Post::GetPayloadCaption() const { return GetPayload() ? GetPayload()->GetString2() : nullptr; }
-    shared_ptr<string> Post::GetPayloadMessage() const { return GetPayload() ? GetPayload()->GetString3() : nullptr; }
-    shared_ptr<string> Post::GetPayloadTags() const { return GetPayload() ? GetPayload()->GetString4() : nullptr; }
-    shared_ptr<string> Post::GetPayloadUrl() const { return GetPayload() ? GetPayload()->GetString7() : nullptr; }
-    shared_ptr<string> Post::GetPayloadImages() const { return GetPayload() ? GetPayload()->GetString5() : nullptr; }
-    shared_ptr<string> Post::GetPayloadSettings() const { return GetPayload() ? GetPayload()->GetString6() : nullptr; }
+    const string* Post::GetRelayTxHash() const { return FieldPtr(m_string3); }
+    void Post::SetRelayTxHash(const string& value) { m_string3 = value; }
+
+    const string* Post::GetPayloadLang() const { return GetPayload() ? GetPayload()->GetString1() : nullptr; }
+    const string* Post::GetPayloadCaption() const { return GetPayload() ? GetPayload()->GetString2() : nullptr; }
+    const string* Post::GetPayloadMessage() const { return GetPayload() ? GetPayload()->GetString3() : nullptr; }
+    const string* Post::GetPayloadTags() const { return GetPayload() ? GetPayload()->GetString4() : nullptr; }
+    const string* Post::GetPayloadUrl() const { return GetPayload() ? GetPayload()->GetString7() : nullptr; }
+    const string* Post::GetPayloadImages() const { return GetPayload() ? GetPayload()->GetString5() : nullptr; }
+    const string* Post::GetPayloadSettings() const { return GetPayload() ? GetPayload()->GetString6() : nullptr; }
 
     string Post::BuildHash()
     {
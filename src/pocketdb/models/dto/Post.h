@@ -22,16 +22,16 @@ namespace PocketTx
         void DeserializeRpc(const UniValue& src) override;
         void DeserializePayload(const UniValue& src) override;
 
-        shared_ptr<string> GetRelayTxHash() const;
+        const string* GetRelayTxHash() const;
         void SetRelayTxHash(const string& value);
 
-        shared_ptr<string> GetPayloadLang() const;
-        shared_ptr<string> GetPayloadCaption() const;
-        shared_ptr<string> GetPayloadMessage() const;
-        shared_ptr<string> GetPayloadTags() const;
-        shared_ptr<string> GetPayloadUrl() const;
-        shared_ptr<string> GetPayloadImages() const;
-        shared_ptr<string> GetPayloadSettings() const;
+        const string* GetPayloadLang() const;
+        const string* GetPayloadCaption() const;
+        const string* GetPayloadMessage() const;
+        const string* GetPayloadTags() const;
+        const string* GetPayloadUrl() const;
+        const string* GetPayloadImages() const;
+        const string* GetPayloadSettings() const;
 
         string BuildHash() override;
     };
@@ -22,10 +22,10 @@ namespace PocketTx
         void DeserializeRpc(const UniValue& src) override;
         void DeserializePayload(const UniValue& src) override;
 
-        shared_ptr <string> GetAddress() const;
+        const string* GetAddress() const;
         void SetAddress(const string& value) override;
 
-        shared_ptr <string> GetAddressTo() const;
+        const string* GetAddressTo() const;
         void SetAddressTo(const string& value);
 
         string BuildHash() override;
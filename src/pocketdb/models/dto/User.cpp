@@ -66,20 +66,20 @@ namespace PocketTx
         if (auto[ok, val] = TryGetStr(src, "b"); ok) m_payload->SetString7(val);
     }
 
-    shared_ptr <string> User::GetAddress() const { return m_string1; }
-    void User::SetAddress(const string& value) { m_string1 = make_shared<string>(value); }
+    const string* User::GetAddress() const { return FieldPtr(m_string1); }
+    void User::SetAddress(const string& value) { m_string1 = value; }
 
-    shared_ptr <string> User::GetReferrerAddress() const { return m_string2; }
-    void User::SetReferrerAddress(const string& value) { m_string2 = make_shared<string>(value); }
+    const string* User::GetReferrerAddress() const { return FieldPtr(m_string2); }
+    void User::SetReferrerAddress(const string& value) { m_string2 = value; }
 
     // Payload getters
-    shared_ptr <string> User::GetPayloadName() const { return GetPayload() ? GetPayload()->GetString2() : nullptr; }
-    shared_ptr <string> User::GetPayloadAvatar() const { return GetPayload() ? GetPayload()->GetString3() : nullptr; }
-    shared_ptr <string> User::GetPayloadUrl() const { return GetPayload() ? GetPayload()->GetString5() : nullptr; }
-    shared_ptr <string> User::GetPayloadLang() const { return GetPayload() ? GetPayload()->GetString1() : nullptr; }
-    shared_ptr <string> User::GetPayloadAbout() const { return GetPayload() ? GetPayload()->GetString4() : nullptr; }
-    shared_ptr <string> User::GetPayloadDonations() const { return GetPayload() ? GetPayload()->GetString7() : nullptr; }
-    shared_ptr <string> User::GetPayloadPubkey() const { return GetPayload() ? GetPayload()->GetString6() : nullptr; }
+    const string* User::GetPayloadName() const { return GetPayload() ? GetPayload()->GetString2() : nullptr; }
+    const string* User::GetPayloadAvatar() const { return GetPayload() ? GetPayload()->GetString3() : nullptr; }
+    const string* User::GetPayloadUrl() const { return GetPayload() ? GetPayload()->GetString5() : nullptr; }
+    const string* User::GetPayloadLang() const { return GetPayload() ? GetPayload()->GetString1() : nullptr; }
+    const string* User::GetPayloadAbout() const { return GetPayload() ? GetPayload()->GetString4() : nullptr; }
+    const string* User::GetPayloadDonations() const { return GetPayload() ? GetPayload()->GetString7() : nullptr; }
+    const string* User::GetPayloadPubkey() const { return GetPayload() ? GetPayload()->GetString6() : nullptr; }
 
     void User::DeserializePayload(const UniValue& src)
     {
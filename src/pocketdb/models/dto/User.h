@@ -21,20 +21,20 @@ namespace PocketTx
         void DeserializeRpc(const UniValue& src) override;
         void DeserializePayload(const UniValue& src) override;
 
-        shared_ptr <string> GetAddress() const;
+        const string* GetAddress() const;
         void SetAddress(const string& value) override;
 
-        shared_ptr <string> GetReferrerAddress() const;
+        const string* GetReferrerAddress() const;
         void SetReferrerAddress(const string& value);
 
         // Payload getters
-        shared_ptr <string> GetPayloadName() const;
-        shared_ptr <string> GetPayloadAvatar() const;
-        shared_ptr <string> GetPayloadUrl() const;
-        shared_ptr <string> GetPayloadLang() const;
-        shared_ptr <string> GetPayloadAbout() const;
-        shared_ptr <string> GetPayloadDonations() const;
-        shared_ptr <string> GetPayloadPubkey() const;
+        const string* GetPayloadName() const;
+        const string* GetPayloadAvatar() const;
+        const string* GetPayloadUrl() const;
+        const string* GetPayloadLang() const;
+        const string* GetPayloadAbout() const;
+        const string* GetPayloadDonations() const;
+        const string* GetPayloadPubkey() const;
 
         string BuildHash() override;
         string BuildHash(bool includeReferrer);
@@ -0,0 +1,33 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETDB_MODEL_WEB_SOCIAL_GRAPH_ACTION_H
+#define POCKETDB_MODEL_WEB_SOCIAL_GRAPH_ACTION_H
+
+#include "pocketdb/models/base/PocketTypes.h"
+
+namespace PocketDbWeb
+{
+    using namespace PocketTx;
+
+    // Transaction changing the social graph, objects are referenced by Transactions.Id
+    // Content: From - author, To - content
+    // Score (likes only): From - scorer, To - content
+    // Subscribe and cancel: From - subscriber, To - subscribed account
+    struct SocialGraphAction
+    {
+        TxType Type;
+        int64_t From;
+        int64_t To;
+        int Height;
+
+        SocialGraphAction(TxType type, int64_t from, int64_t to, int height)
+            : Type(type), From(from), To(to), Height(height)
+        {
+        }
+    };
+
+} // PocketDbWeb
+
+#endif //POCKETDB_MODEL_WEB_SOCIAL_GRAPH_ACTION_H
@@ -0,0 +1,28 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETDB_MODEL_WEB_UNSPENT_OUTPUT_H
+#define POCKETDB_MODEL_WEB_UNSPENT_OUTPUT_H
+
+#include <string>
+
+namespace PocketDbWeb
+{
+    using namespace std;
+
+    // Confirmed unspent output of TxOutputs with type of its transaction
+    struct UnspentOutput
+    {
+        string TxHash;
+        int Number = 0;
+        string AddressHash;
+        int64_t Value = 0;
+        string ScriptPubKey;
+        int TxType = 0;
+        int Height = 0;
+    };
+
+} // PocketDbWeb
+
+#endif //POCKETDB_MODEL_WEB_UNSPENT_OUTPUT_H
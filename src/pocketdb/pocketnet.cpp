@@ -26,4 +26,6 @@ namespace PocketWeb
 namespace PocketServices
 {
     WebPostProcessor WebPostProcessorInst;
+    BlockPayloadCache BlockPayloadCacheInst;
+    WsNotifier WsNotifierInst;
 } // namespace PocketServices
\ No newline at end of file
@@ -23,6 +23,8 @@
 #include "pocketdb/repositories/web/NotifierRepository.h"
 #include "pocketdb/web/PocketFrontend.h"
 #include "pocketdb/services/WebPostProcessing.h"
+#include "pocketdb/services/BlockPayloadCache.h"
+#include "pocketdb/services/WsNotifier.h"
 
 namespace PocketDb
 {
@@ -41,6 +43,8 @@ namespace PocketDb
 namespace PocketServices
 {
     extern WebPostProcessor WebPostProcessorInst;
+    extern BlockPayloadCache BlockPayloadCacheInst;
+    extern WsNotifier WsNotifierInst;
 } // namespace PocketServices
 
 namespace PocketWeb
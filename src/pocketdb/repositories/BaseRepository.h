@@ -64,18 +64,34 @@ namespace PocketDb
         {
             auto timeoutValue = chrono::seconds(gArgs.GetArg("-sqltimeout", 10));
 
-            run_with_timeout(
-                [&]()
-                {
-                    TryTransactionStepSince(func, sql);
-                },
-                timeoutValue,
-                [&]()
-                {
-                    m_database.InterruptQuery();
-                    LogPrintf("Function `%s` failed with execute timeout\n", func);
-                }
-            );
+            if (!m_database.BeginTransaction())
+                throw std::runtime_error(strprintf("%s: can't begin transaction\n", func));
+
+            bool expired = false;
+            try
+            {
+                m_database.SetDeadline(timeoutValue);
+                sql();
+                expired = m_database.ClearDeadline();
+            }
+            catch (...)
+            {
+                if (m_database.ClearDeadline())
+                    RegisterQueryTimeout(func);
+
+                throw;
+            }
+
+            // Interrupted statement ends as if it has no more rows - do not return partial result
+            if (expired)
+            {
+                RegisterQueryTimeout(func);
+                LogPrintf("Function `%s` failed with execute timeout\n", func);
+                throw std::runtime_error(strprintf("%s: execute timeout\n", func));
+            }
+
+            if (!m_database.CommitTransaction())
+                throw std::runtime_error(strprintf("%s: can't commit transaction\n", func));
         }
 
     protected:
@@ -91,7 +107,7 @@ namespace PocketDb
 
         // General method for SQL operations
         // Locked with shutdownMutex
-        // Timeouted for ReadOnly connections
+        // Timeouted for ReadOnly connections created with query timeouts
         template<typename T>
         void TryTransactionStep(const string& func, T sql)
         {
@@ -100,7 +116,7 @@ namespace PocketDb
                 int64_t nTime1 = GetTimeMicros();
 
                 // We are running SQL logic with timeout only for read-only connections
-                if (m_database.IsReadOnly())
+                if (m_database.IsQueryTimeouts())
                     TryTransactionStepTimeoutSince(func, sql);
                 else
                     TryTransactionStepSince(func, sql);
@@ -125,14 +141,22 @@ namespace PocketDb
                 throw std::runtime_error(strprintf("%s: Failed execute SQL statement\n", __func__));
         }
 
+        // Statements are taken from the connection cache and must be returned with FinalizeSqlStatement
         shared_ptr<sqlite3_stmt*> SetupSqlStatement(const std::string& sql) const
         {
             sqlite3_stmt* stmt;
 
-            int res = sqlite3_prepare_v2(m_database.m_db, sql.c_str(), (int) sql.size(), &stmt, nullptr);
+            int res = m_database.PrepareStatement(sql, &stmt);
             if (res != SQLITE_OK)
+            {
+                // Indexes named by queries are dropped while the initial sync bulk loads the database
+                string error = sqlite3_errmsg(m_database.m_db);
+                if (error.rfind("no such index", 0) == 0)
+                    throw std::runtime_error(strprintf("SQLiteDatabase: %s, database indexes are built after initial sync", error));
+
                 throw std::runtime_error(strprintf("SQLiteDatabase: Failed to setup SQL statements: %s\nSql: %s",
                     sqlite3_errstr(res), sql));
+            }
 
             return std::make_shared<sqlite3_stmt*>(stmt);
         }
@@ -150,14 +174,14 @@ namespace PocketDb
 
         int FinalizeSqlStatement(sqlite3_stmt* stmt)
         {
-            return sqlite3_finalize(stmt);
+            return m_database.ReleaseStatement(stmt);
         }
 
         // --------------------------------
         // BINDS
         // --------------------------------
 
-        bool TryBindStatementText(shared_ptr<sqlite3_stmt*>& stmt, int index, shared_ptr<std::string> value)
+        bool TryBindStatementText(shared_ptr<sqlite3_stmt*>& stmt, int index, const std::string* value)
         {
             if (!value) return true;
 
@@ -177,6 +201,11 @@ namespace PocketDb
         }
 
         bool TryBindStatementInt(shared_ptr<sqlite3_stmt*>& stmt, int index, const shared_ptr<int>& value)
+        {
+            return TryBindStatementInt(stmt, index, value.get());
+        }
+
+        bool TryBindStatementInt(shared_ptr<sqlite3_stmt*>& stmt, int index, const int* value)
         {
             if (!value) return true;
 
@@ -193,6 +222,11 @@ namespace PocketDb
         }
 
         bool TryBindStatementInt64(shared_ptr<sqlite3_stmt*>& stmt, int index, const shared_ptr<int64_t>& value)
+        {
+            return TryBindStatementInt64(stmt, index, value.get());
+        }
+
+        bool TryBindStatementInt64(shared_ptr<sqlite3_stmt*>& stmt, int index, const int64_t* value)
         {
             if (!value) return true;
 
@@ -6,12 +6,47 @@
 
 namespace PocketDb
 {
+    void ChainRepository::Init()
+    {
+        // Statistic of database indexed before it was introduced is built once
+        TryTransactionStep(__func__, [&]()
+        {
+            bool empty = false;
+
+            auto stmt = SetupSqlStatement(R"sql(
+                select
+                    not exists (select 1 from TransactionsStatistic)
+                    and exists (select 1 from Transactions indexed by Transactions_Height_Id where Height is not null)
+            )sql");
+
+            if (sqlite3_step(*stmt) == SQLITE_ROW)
+                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
+                    empty = (value == 1);
+
+            FinalizeSqlStatement(*stmt);
+
+            if (!empty)
+                return;
+
+            LogPrintf("Building explorer statistic of transactions. This can take a few minutes.\n");
+
+            for (int period : POCKET_STATISTIC_PERIODS)
+                IndexStatistic(period, 0);
+        });
+    }
+
     void ChainRepository::IndexBlock(const string& blockHash, int height, vector<TransactionIndexingInfo>& txs)
     {
+        // New last balances are cached only after the block is committed
+        map<string, tuple<int, int64_t>> balances;
+
         TryTransactionStep(__func__, [&]()
         {
             int64_t nTime1 = GetTimeMicros();
 
+            // Change of address balances by the block
+            map<string, int64_t> balanceDeltas;
+
             // Each transaction is processed individually
             for (const auto& txInfo : txs)
             {
@@ -19,24 +54,24 @@ namespace PocketDb
                 UpdateTransactionHeight(blockHash, txInfo.BlockNumber, height, txInfo.Hash);
 
                 // The outputs are needed for the explorer
-                UpdateTransactionOutputs(txInfo, height);
+                UpdateTransactionOutputs(txInfo, height, balanceDeltas);
 
                 // Account and Content must have unique ID
                 // Also all edited transactions must have Last=(0/1) field
                 if (txInfo.IsAccount())
-                    IndexAccount(txInfo.Hash);
+                    IndexAccount(txInfo.Hash, height);
 
                 if (txInfo.IsContent())
-                    IndexContent(txInfo.Hash);
+                    IndexContent(txInfo.Hash, height);
 
                 if (txInfo.IsComment())
-                    IndexComment(txInfo.Hash);
+                    IndexComment(txInfo.Hash, height);
 
                 if (txInfo.IsBlocking())
-                    IndexBlocking(txInfo.Hash);
+                    IndexBlocking(txInfo.Hash, height);
 
                 if (txInfo.IsSubscribe())
-                    IndexSubscribe(txInfo.Hash);
+                    IndexSubscribe(txInfo.Hash, height);
 
                 // Calculate and save fee for future selects
                 if (txInfo.IsBoostContent())
@@ -46,7 +81,12 @@ namespace PocketDb
             int64_t nTime2 = GetTimeMicros();
 
             // After set height and mark inputs as spent we need recalculcate balances
-            IndexBalances(height);
+            IndexBalances(height, balanceDeltas, balances);
+
+            for (int period : POCKET_STATISTIC_PERIODS)
+                IndexStatistic(period, height);
+
+            PruneUndoJournal(height);
 
             int64_t nTime3 = GetTimeMicros();
 
@@ -56,6 +96,14 @@ namespace PocketDb
                 0.001 * double(nTime3 - nTime1)
             );
         });
+
+        LOCK(m_balancesMutex);
+
+        if (m_balances.size() + balances.size() > POCKET_BALANCE_CACHE_SIZE)
+            m_balances.clear();
+
+        for (auto& [address, balance] : balances)
+            m_balances[address] = balance;
     }
 
     bool ChainRepository::ClearDatabase()
@@ -66,7 +114,9 @@ namespace PocketDb
         m_database.DropIndexes();
 
         LogPrintf("Rollback to first block..\n");
+        ClearBalancesCache();
         RollbackHeight(0);
+        RollbackStatistic(0);
 
         m_database.CreateStructure();
 
@@ -75,13 +125,24 @@ namespace PocketDb
 
     bool ChainRepository::Rollback(int height)
     {
+        ClearBalancesCache();
+
         try
         {
             // Update transactions
             TryTransactionStep(__func__, [&]()
             {
-                RestoreOldLast(height);
-                RollbackHeight(height);
+                if (ExistsUndoJournal(height))
+                {
+                    RollbackUndoJournal(height);
+                }
+                else
+                {
+                    RestoreOldLast(height);
+                    RollbackHeight(height);
+                }
+
+                RollbackStatistic(height);
             });
 
             return true;
@@ -149,12 +210,43 @@ namespace PocketDb
         TryBindStatementInt(stmtOuts, 1, height);
         TryBindStatementText(stmtOuts, 2, txHash);
         TryStepStatement(stmtOuts);
+
+        auto stmtUndo = SetupSqlStatement(R"sql(
+            insert into BlockUndo (Height, Type, String1)
+            values (?, ?, ?)
+        )sql");
+        TryBindStatementInt(stmtUndo, 1, height);
+        TryBindStatementInt(stmtUndo, 2, BLOCK_UNDO_TX_INDEXED);
+        TryBindStatementText(stmtUndo, 3, txHash);
+        TryStepStatement(stmtUndo);
     }
 
-    void ChainRepository::UpdateTransactionOutputs(const TransactionIndexingInfo& txInfo, int height)
+    void ChainRepository::UpdateTransactionOutputs(const TransactionIndexingInfo& txInfo, int height, map<string, int64_t>& balanceDeltas)
     {
+        for (auto& output : txInfo.Outputs)
+            balanceDeltas[output.first] += output.second;
+
         for (auto& input : txInfo.Inputs)
         {
+            // Spent value leaves the address of output
+            auto stmtOut = SetupSqlStatement(R"sql(
+                select AddressHash, Value
+                from TxOutputs
+                where TxHash = ? and Number = ?
+            )sql");
+            TryBindStatementText(stmtOut, 1, input.first);
+            TryBindStatementInt(stmtOut, 2, input.second);
+
+            if (sqlite3_step(*stmtOut) == SQLITE_ROW)
+            {
+                auto[okAddress, address] = TryGetColumnString(*stmtOut, 0);
+                auto[okValue, value] = TryGetColumnInt64(*stmtOut, 1);
+                if (okAddress && okValue)
+                    balanceDeltas[address] -= value;
+            }
+
+            FinalizeSqlStatement(*stmtOut);
+
             auto stmt = SetupSqlStatement(R"sql(
                 UPDATE TxOutputs SET
                     SpentHeight = ?,
@@ -167,65 +259,104 @@ namespace PocketDb
             TryBindStatementText(stmt, 3, input.first);
             TryBindStatementInt(stmt, 4, input.second);
             TryStepStatement(stmt);
+
+            auto stmtUndo = SetupSqlStatement(R"sql(
+                insert into BlockUndo (Height, Type, String1, Int1)
+                values (?, ?, ?, ?)
+            )sql");
+            TryBindStatementInt(stmtUndo, 1, height);
+            TryBindStatementInt(stmtUndo, 2, BLOCK_UNDO_OUTPUT_SPENT);
+            TryBindStatementText(stmtUndo, 3, input.first);
+            TryBindStatementInt(stmtUndo, 4, input.second);
+            TryStepStatement(stmtUndo);
         }
     }
 
-    void ChainRepository::IndexBalances(int height)
+    void ChainRepository::IndexBalances(int height, const map<string, int64_t>& deltas, map<string, tuple<int, int64_t>>& balances)
     {
-        // Generate new balance records
-        auto stmt = SetupSqlStatement(R"sql(
-            insert into Balances (AddressHash, Last, Height, Value)
-            select
-                saldo.AddressHash,
-                1,
-                ?,
-                sum(ifnull(saldo.Amount,0)) + ifnull(b.Value,0)
-            from (
+        for (const auto& [address, delta] : deltas)
+        {
+            int64_t value = delta;
 
-                select 'unspent',
-                       o.AddressHash,
-                       sum(o.Value)Amount
-                from TxOutputs o indexed by TxOutputs_TxHeight_AddressHash
-                where  o.TxHeight = ?
-                group by o.AddressHash
-
-                union
-
-                select 'spent',
-                       o.AddressHash,
-                       -sum(o.Value)Amount
-                from TxOutputs o indexed by TxOutputs_SpentHeight_AddressHash
-                where o.SpentHeight = ?
-                group by o.AddressHash
-
-            ) saldo
-            left join Balances b indexed by Balances_AddressHash_Last
-                on b.AddressHash = saldo.AddressHash and b.Last = 1
-            group by saldo.AddressHash
-        )sql");
-        TryBindStatementInt(stmt, 1, height);
-        TryBindStatementInt(stmt, 2, height);
-        TryBindStatementInt(stmt, 3, height);
-        TryStepStatement(stmt);
+            if (auto[exists, last] = GetLastBalance(address); exists)
+            {
+                auto[lastHeight, lastValue] = last;
+                value += lastValue;
+
+                // Remember old Last record for rollback
+                auto stmtUndo = SetupSqlStatement(R"sql(
+                    insert into BlockUndo (Height, Type, String1, Int1)
+                    values (?, ?, ?, ?)
+                )sql");
+                TryBindStatementInt(stmtUndo, 1, height);
+                TryBindStatementInt(stmtUndo, 2, BLOCK_UNDO_BALANCE_LAST);
+                TryBindStatementText(stmtUndo, 3, address);
+                TryBindStatementInt64(stmtUndo, 4, lastHeight);
+                TryStepStatement(stmtUndo);
+
+                // Remove old Last record
+                auto stmtOld = SetupSqlStatement(R"sql(
+                    update Balances
+                      set Last = 0
+                    where AddressHash = ?
+                      and Height = ?
+                )sql");
+                TryBindStatementText(stmtOld, 1, address);
+                TryBindStatementInt(stmtOld, 2, lastHeight);
+                TryStepStatement(stmtOld);
+            }
 
-        // Remove old Last records
-        auto stmtOld = SetupSqlStatement(R"sql(
-            update Balances indexed by Balances_AddressHash_Last_Height
-              set Last = 0
-            where Balances.Last = 1
-              and Balances.Height < ?
-              and Balances.AddressHash in (
-                select b.AddressHash
-                from Balances b indexed by Balances_Height
-                where b.Height = ?
-              )
+            auto stmt = SetupSqlStatement(R"sql(
+                insert into Balances (AddressHash, Last, Height, Value)
+                values (?, 1, ?, ?)
+            )sql");
+            TryBindStatementText(stmt, 1, address);
+            TryBindStatementInt(stmt, 2, height);
+            TryBindStatementInt64(stmt, 3, value);
+            TryStepStatement(stmt);
+
+            balances[address] = {height, value};
+        }
+    }
+
+    tuple<bool, tuple<int, int64_t>> ChainRepository::GetLastBalance(const string& address)
+    {
+        {
+            LOCK(m_balancesMutex);
+            if (auto it = m_balances.find(address); it != m_balances.end())
+                return {true, it->second};
+        }
+
+        tuple<bool, tuple<int, int64_t>> result = {false, {0, 0}};
+
+        auto stmt = SetupSqlStatement(R"sql(
+            select Height, Value
+            from Balances indexed by Balances_AddressHash_Last
+            where AddressHash = ?
+              and Last = 1
         )sql");
-        TryBindStatementInt(stmtOld, 1, height);
-        TryBindStatementInt(stmtOld, 2, height);
-        TryStepStatement(stmtOld);
+        TryBindStatementText(stmt, 1, address);
+
+        if (sqlite3_step(*stmt) == SQLITE_ROW)
+        {
+            auto[okHeight, lastHeight] = TryGetColumnInt(*stmt, 0);
+            auto[okValue, lastValue] = TryGetColumnInt64(*stmt, 1);
+            if (okHeight && okValue)
+                result = {true, {lastHeight, lastValue}};
+        }
+
+        FinalizeSqlStatement(*stmt);
+
+        return result;
     }
 
-    void ChainRepository::IndexAccount(const string& txHash)
+    void ChainRepository::ClearBalancesCache()
+    {
+        LOCK(m_balancesMutex);
+        m_balances.clear();
+    }
+
+    void ChainRepository::IndexAccount(const string& txHash, int height)
     {
         // Get new ID or copy previous
         auto setIdStmt = SetupSqlStatement(R"sql(
@@ -258,10 +389,10 @@ namespace PocketDb
         TryStepStatement(setIdStmt);
 
         // Clear old last records for set new last
-        ClearOldLast(txHash);
+        ClearOldLast(txHash, height);
     }
 
-    void ChainRepository::IndexContent(const string& txHash)
+    void ChainRepository::IndexContent(const string& txHash, int height)
     {
         // Get new ID or copy previous
         auto setIdStmt = SetupSqlStatement(R"sql(
@@ -294,10 +425,10 @@ namespace PocketDb
         TryStepStatement(setIdStmt);
 
         // Clear old last records for set new last
-        ClearOldLast(txHash);
+        ClearOldLast(txHash, height);
     }
 
-    void ChainRepository::IndexComment(const string& txHash)
+    void ChainRepository::IndexComment(const string& txHash, int height)
     {
         // Get new ID or copy previous
         auto setIdStmt = SetupSqlStatement(R"sql(
@@ -329,10 +460,10 @@ namespace PocketDb
         TryStepStatement(setIdStmt);
 
         // Clear old last records for set new last
-        ClearOldLast(txHash);
+        ClearOldLast(txHash, height);
     }
 
-    void ChainRepository::IndexBlocking(const string& txHash)
+    void ChainRepository::IndexBlocking(const string& txHash, int height)
     {
         // Set last=1 for new transaction
         auto setLastStmt = SetupSqlStatement(R"sql(
@@ -367,10 +498,10 @@ namespace PocketDb
         TryStepStatement(setLastStmt);
 
         // Clear old last records for set new last
-        ClearOldLast(txHash);
+        ClearOldLast(txHash, height);
     }
 
-    void ChainRepository::IndexSubscribe(const string& txHash)
+    void ChainRepository::IndexSubscribe(const string& txHash, int height)
     {
         // Set last=1 for new transaction
         auto setLastStmt = SetupSqlStatement(R"sql(
@@ -405,7 +536,7 @@ namespace PocketDb
         TryStepStatement(setLastStmt);
 
         // Clear old last records for set new last
-        ClearOldLast(txHash);
+        ClearOldLast(txHash, height);
     }
     
     void ChainRepository::IndexBoostContent(const string& txHash)
@@ -432,8 +563,27 @@ namespace PocketDb
         TryStepStatement(stmt);
     }
 
-    void ChainRepository::ClearOldLast(const string& txHash)
+    void ChainRepository::ClearOldLast(const string& txHash, int height)
     {
+        // Remember old Last records for rollback
+        auto stmtUndo = SetupSqlStatement(R"sql(
+            insert into BlockUndo (Height, Type, String1)
+            select ?, ?, Transactions.Hash
+            from (
+                select t.Hash, t.Id
+                from Transactions t
+                where t.Hash = ?
+            ) as tInner
+            join Transactions indexed by Transactions_Id_Last
+                on Transactions.Id = tInner.Id
+               and Transactions.Last = 1
+               and Transactions.Hash != tInner.Hash
+        )sql");
+        TryBindStatementInt(stmtUndo, 1, height);
+        TryBindStatementInt(stmtUndo, 2, BLOCK_UNDO_TX_LAST);
+        TryBindStatementText(stmtUndo, 3, txHash);
+        TryStepStatement(stmtUndo);
+
         auto stmt = SetupSqlStatement(R"sql(
             UPDATE Transactions indexed by Transactions_Id_Last SET
                 Last = 0
@@ -452,6 +602,67 @@ namespace PocketDb
     }
 
 
+    void ChainRepository::IndexStatistic(int period, int height)
+    {
+        // Every transaction with Id becomes last and replaces the previous one with the same Id
+        auto stmt = SetupSqlStatement(R"sql(
+            insert into TransactionsStatistic (Period, Bucket, Type, Count, Last)
+            select ?, s.Height / ?, s.Type, sum(s.Count), sum(s.Last)
+            from (
+                select t.Height, t.Type, 1 as Count, (t.Id is not null) as Last
+                from Transactions t indexed by Transactions_Height_Id
+                where t.Height >= ?
+
+                union all
+
+                select t.Height,
+                    (
+                        select p.Type
+                        from Transactions p indexed by Transactions_Id
+                        where p.Id = t.Id
+                          and p.Height is not null
+                          and (p.Height < t.Height or (p.Height = t.Height and p.BlockNum < t.BlockNum))
+                        order by p.Height desc, p.BlockNum desc
+                        limit 1
+                    ) as Type,
+                    0 as Count,
+                    -1 as Last
+                from Transactions t indexed by Transactions_Height_Id
+                where t.Height >= ?
+                  and t.Id is not null
+            ) s
+            where s.Type is not null
+            group by s.Height / ?, s.Type
+            on conflict (Period, Bucket, Type) do update set
+                Count = Count + excluded.Count,
+                Last = Last + excluded.Last
+        )sql");
+        TryBindStatementInt(stmt, 1, period);
+        TryBindStatementInt(stmt, 2, period);
+        TryBindStatementInt(stmt, 3, height);
+        TryBindStatementInt(stmt, 4, height);
+        TryBindStatementInt(stmt, 5, period);
+        TryStepStatement(stmt);
+    }
+
+    void ChainRepository::RollbackStatistic(int height)
+    {
+        for (int period : POCKET_STATISTIC_PERIODS)
+        {
+            auto stmt = SetupSqlStatement(R"sql(
+                delete from TransactionsStatistic
+                where Period = ?
+                  and Bucket >= ?
+            )sql");
+            TryBindStatementInt(stmt, 1, period);
+            TryBindStatementInt(stmt, 2, height / period);
+            TryStepStatement(stmt);
+
+            // Bucket of the new tip keeps its remaining blocks
+            IndexStatistic(period, height / period * period);
+        }
+    }
+
     void ChainRepository::RestoreOldLast(int height)
     {
         int64_t nTime1 = GetTimeMicros();
@@ -594,6 +805,201 @@ namespace PocketDb
 
         int64_t nTime6 = GetTimeMicros();
         LogPrint(BCLog::BENCH, "        - RollbackHeight (Balances delete): %.2fms\n", 0.001 * (nTime6 - nTime5));
+
+        // ----------------------------------------
+
+        // Journal for removed blocks not needed anymore
+        auto stmt41 = SetupSqlStatement(R"sql(
+            delete from BlockUndo
+            where Height >= ?
+        )sql");
+        TryBindStatementInt(stmt41, 1, height);
+        TryStepStatement(stmt41);
+    }
+
+    bool ChainRepository::ExistsUndoJournal(int height)
+    {
+        // Journal is written for every block since it was enabled and pruned only below tip,
+        // so it is complete above the lowest journaled block
+        bool result = false;
+
+        auto stmt = SetupSqlStatement(R"sql(
+            select min(Height)
+            from BlockUndo indexed by BlockUndo_Height
+        )sql");
+
+        if (sqlite3_step(*stmt) == SQLITE_ROW)
+            if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
+                result = (value <= height);
+
+        FinalizeSqlStatement(*stmt);
+
+        return result;
+    }
+
+    void ChainRepository::RollbackUndoJournal(int height)
+    {
+        int64_t nTime1 = GetTimeMicros();
+
+        struct UndoRecord
+        {
+            int Type = 0;
+            string String1;
+            int64_t Int1 = 0;
+            int64_t Int2 = 0;
+            int64_t Int3 = 0;
+        };
+
+        vector<UndoRecord> records;
+
+        // Newest changes first
+        auto stmt = SetupSqlStatement(R"sql(
+            select Type, String1, Int1, Int2, Int3
+            from BlockUndo indexed by BlockUndo_Height
+            where Height >= ?
+            order by Height desc, rowid desc
+        )sql");
+        TryBindStatementInt(stmt, 1, height);
+
+        while (sqlite3_step(*stmt) == SQLITE_ROW)
+        {
+            UndoRecord record;
+            if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok) record.Type = value;
+            if (auto[ok, value] = TryGetColumnString(*stmt, 1); ok) record.String1 = value;
+            if (auto[ok, value] = TryGetColumnInt64(*stmt, 2); ok) record.Int1 = value;
+            if (auto[ok, value] = TryGetColumnInt64(*stmt, 3); ok) record.Int2 = value;
+            if (auto[ok, value] = TryGetColumnInt64(*stmt, 4); ok) record.Int3 = value;
+            records.emplace_back(std::move(record));
+        }
+
+        FinalizeSqlStatement(*stmt);
+
+        int64_t nTime2 = GetTimeMicros();
+
+        for (const auto& record : records)
+        {
+            switch (record.Type)
+            {
+                case BLOCK_UNDO_TX_INDEXED:
+                {
+                    auto stmtTx = SetupSqlStatement(R"sql(
+                        UPDATE Transactions SET
+                            BlockHash = null,
+                            BlockNum = null,
+                            Height = null,
+                            Id = null,
+                            Last = 0
+                        WHERE Hash = ?
+                    )sql");
+                    TryBindStatementText(stmtTx, 1, record.String1);
+                    TryStepStatement(stmtTx);
+
+                    auto stmtOuts = SetupSqlStatement(R"sql(
+                        UPDATE TxOutputs SET
+                            TxHeight = null
+                        WHERE TxHash = ?
+                    )sql");
+                    TryBindStatementText(stmtOuts, 1, record.String1);
+                    TryStepStatement(stmtOuts);
+                    break;
+                }
+                case BLOCK_UNDO_TX_LAST:
+                {
+                    auto stmtLast = SetupSqlStatement(R"sql(
+                        UPDATE Transactions SET
+                            Last = 1
+                        WHERE Hash = ?
+                    )sql");
+                    TryBindStatementText(stmtLast, 1, record.String1);
+                    TryStepStatement(stmtLast);
+                    break;
+                }
+                case BLOCK_UNDO_OUTPUT_SPENT:
+                {
+                    auto stmtSpent = SetupSqlStatement(R"sql(
+                        UPDATE TxOutputs SET
+                            SpentHeight = null,
+                            SpentTxHash = null
+                        WHERE TxHash = ? and Number = ?
+                    )sql");
+                    TryBindStatementText(stmtSpent, 1, record.String1);
+                    TryBindStatementInt64(stmtSpent, 2, record.Int1);
+                    TryStepStatement(stmtSpent);
+                    break;
+                }
+                case BLOCK_UNDO_RATING_LAST:
+                {
+                    auto stmtRating = SetupSqlStatement(R"sql(
+                        update Ratings indexed by Ratings_Type_Id_Height_Value
+                          set Last = 1
+                        where Type = ?
+                          and Id = ?
+                          and Height = ?
+                    )sql");
+                    TryBindStatementInt64(stmtRating, 1, record.Int1);
+                    TryBindStatementInt64(stmtRating, 2, record.Int2);
+                    TryBindStatementInt64(stmtRating, 3, record.Int3);
+                    TryStepStatement(stmtRating);
+                    break;
+                }
+                case BLOCK_UNDO_BALANCE_LAST:
+                {
+                    auto stmtBalance = SetupSqlStatement(R"sql(
+                        update Balances
+                          set Last = 1
+                        where AddressHash = ?
+                          and Height = ?
+                    )sql");
+                    TryBindStatementText(stmtBalance, 1, record.String1);
+                    TryBindStatementInt64(stmtBalance, 2, record.Int1);
+                    TryStepStatement(stmtBalance);
+                    break;
+                }
+                default:
+                    throw std::runtime_error(strprintf("%s: unknown undo record type %d\n", __func__, record.Type));
+            }
+        }
+
+        int64_t nTime3 = GetTimeMicros();
+
+        // Ratings and balances of removed blocks are new rows - found by height index
+        auto stmtRatings = SetupSqlStatement(R"sql(
+            delete from Ratings indexed by Ratings_Height_Last
+            where Height >= ?
+        )sql");
+        TryBindStatementInt(stmtRatings, 1, height);
+        TryStepStatement(stmtRatings);
+
+        auto stmtBalances = SetupSqlStatement(R"sql(
+            delete from Balances indexed by Balances_Height
+            where Height >= ?
+        )sql");
+        TryBindStatementInt(stmtBalances, 1, height);
+        TryStepStatement(stmtBalances);
+
+        auto stmtJournal = SetupSqlStatement(R"sql(
+            delete from BlockUndo indexed by BlockUndo_Height
+            where Height >= ?
+        )sql");
+        TryBindStatementInt(stmtJournal, 1, height);
+        TryStepStatement(stmtJournal);
+
+        int64_t nTime4 = GetTimeMicros();
+
+        LogPrint(BCLog::BENCH, "        - RollbackUndoJournal (%d records): %.2fms + %.2fms + %.2fms\n", records.size(),
+            0.001 * (nTime2 - nTime1), 0.001 * (nTime3 - nTime2), 0.001 * (nTime4 - nTime3));
+    }
+
+    void ChainRepository::PruneUndoJournal(int height)
+    {
+        int depth = (int) max((int64_t) 1, gArgs.GetArg("-pocketundodepth", DEFAULT_POCKET_UNDO_DEPTH));
+
+        auto stmt = SetupSqlStatement(R"sql(
+            delete from BlockUndo indexed by BlockUndo_Height
+            where Height < ?
+        )sql");
+        TryBindStatementInt(stmt, 1, height - depth);
+        TryStepStatement(stmt);
     }
 
 
@@ -7,6 +7,11 @@
 #ifndef POCKETDB_CHAINREPOSITORY_H
 #define POCKETDB_CHAINREPOSITORY_H
 
+#include <map>
+#include <unordered_map>
+
+#include "sync.h"
+
 #include "pocketdb/helpers/TransactionHelper.h"
 #include "pocketdb/repositories/BaseRepository.h"
 #include "pocketdb/models/base/Rating.h"
@@ -18,6 +23,15 @@
 
 namespace PocketDb
 {
+    // Blocks below tip by more than this keep no undo journal and roll back with full scans
+    static const int DEFAULT_POCKET_UNDO_DEPTH = 1440;
+
+    // Last balances of addresses kept in memory between blocks, dropped all at once when exceeded
+    static const size_t POCKET_BALANCE_CACHE_SIZE = 200000;
+
+    // Blocks in buckets of explorer statistic: hour and day
+    static const int POCKET_STATISTIC_PERIODS[] = {60, 1440};
+
     using std::runtime_error;
     using boost::algorithm::join;
     using boost::adaptors::transformed;
@@ -29,15 +43,15 @@ namespace PocketDb
     public:
         explicit ChainRepository(SQLiteDatabase& db) : BaseRepository(db) {}
 
-        void Init() override {}
+        void Init() override;
         void Destroy() override {}
 
         // Update transactions set block hash & height
         // Also spent outputs
         void IndexBlock(const string& blockHash, int height, vector<TransactionIndexingInfo>& txs);
 
-        // Precalculate address balances from TxOutputs
-        void IndexBalances(int height);
+        // Save new last balances of addresses changed by block - deltas are summed outputs minus spent inputs
+        void IndexBalances(int height, const map<string, int64_t>& deltas, map<string, tuple<int, int64_t>>& balances);
 
         // Clear all calculated data
         bool ClearDatabase();
@@ -49,21 +63,37 @@ namespace PocketDb
         tuple<bool, bool> ExistsBlock(const string& blockHash, int height);
 
     private:
+        // Last balances as (height, value) of recently changed addresses
+        Mutex m_balancesMutex;
+        unordered_map<string, tuple<int, int64_t>> m_balances GUARDED_BY(m_balancesMutex);
+
+        tuple<bool, tuple<int, int64_t>> GetLastBalance(const string& address);
+        void ClearBalancesCache();
 
         void RollbackHeight(int height);
         void RestoreOldLast(int height);
 
+        // Undo journal covers all blocks from height to tip
+        bool ExistsUndoJournal(int height);
+        void RollbackUndoJournal(int height);
+        void PruneUndoJournal(int height);
+
         void UpdateTransactionHeight(const string& blockHash, int blockNumber, int height, const string& txHash);
-        void UpdateTransactionOutputs(const TransactionIndexingInfo& txInfo, int height);
+        void UpdateTransactionOutputs(const TransactionIndexingInfo& txInfo, int height, map<string, int64_t>& balanceDeltas);
 
-        void IndexAccount(const string& txHash);
-        void IndexContent(const string& txHash);
-        void IndexComment(const string& txHash);
-        void IndexBlocking(const string& txHash);
-        void IndexSubscribe(const string& txHash);
+        void IndexAccount(const string& txHash, int height);
+        void IndexContent(const string& txHash, int height);
+        void IndexComment(const string& txHash, int height);
+        void IndexBlocking(const string& txHash, int height);
+        void IndexSubscribe(const string& txHash, int height);
         void IndexBoostContent(const string& txHash);
 
-        void ClearOldLast(const string& txHash);
+        void ClearOldLast(const string& txHash, int height);
+
+        // Add transactions from height to buckets of statistic
+        void IndexStatistic(int period, int height);
+        // Build buckets of removed blocks again from remaining transactions
+        void RollbackStatistic(int height);
 
     };
 
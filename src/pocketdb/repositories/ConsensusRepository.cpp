@@ -590,6 +590,85 @@ namespace PocketDb
         return result;
     }
 
+    map<string, ScoreDataDtoRef> ConsensusRepository::GetScoreData(const vector<string>& txHashes)
+    {
+        map<string, ScoreDataDtoRef> result;
+
+        // Keep number of bound parameters under SQLite limit
+        const size_t chunkSize = 500;
+        for (size_t begin = 0; begin < txHashes.size(); begin += chunkSize)
+        {
+            size_t count = min(chunkSize, txHashes.size() - begin);
+
+            string sql = R"sql(
+                select
+
+                    s.Hash sTxHash,
+                    s.Type sType,
+                    s.Time sTime,
+                    s.Int1 sValue,
+                    sa.Id saId,
+                    sa.String1 saHash,
+                    c.Hash cTxHash,
+                    c.Type cType,
+                    c.Time cTime,
+                    c.Id cId,
+                    ca.Id caId,
+                    ca.String1 caHash
+
+                from Transactions s indexed by Transactions_Hash_Height
+
+                -- Score Address
+                join Transactions sa indexed by Transactions_Type_Last_String1_Height_Id
+                    on sa.Type in (100,101,102) and sa.Height > 0 and sa.String1 = s.String1 and sa.Last = 1
+
+                -- Content
+                join Transactions c indexed by Transactions_Hash_Height
+                    on c.Type in (200,201,202,203,204,205,206,207) and c.Height > 0 and c.Hash = s.String2
+
+                -- Content Address
+                join Transactions ca indexed by Transactions_Type_Last_String1_Height_Id
+                    on ca.Type in (100,101,102) and ca.Height > 0 and ca.String1 = c.String1 and ca.Last = 1
+
+                where s.Hash in ( )sql" + join(vector<string>(count, "?"), ",") + R"sql( )
+            )sql";
+
+            TryTransactionStep(__func__, [&]()
+            {
+                auto stmt = SetupSqlStatement(sql);
+
+                for (size_t i = 0; i < count; i++)
+                    TryBindStatementText(stmt, (int) i + 1, txHashes[begin + i]);
+
+                while (sqlite3_step(*stmt) == SQLITE_ROW)
+                {
+                    ScoreDataDto data;
+
+                    if (auto[ok, value] = TryGetColumnString(*stmt, 0); ok) data.ScoreTxHash = value;
+                    if (auto[ok, value] = TryGetColumnInt(*stmt, 1); ok) data.ScoreType = (TxType) value;
+                    if (auto[ok, value] = TryGetColumnInt64(*stmt, 2); ok) data.ScoreTime = value;
+                    if (auto[ok, value] = TryGetColumnInt(*stmt, 3); ok) data.ScoreValue = value;
+                    if (auto[ok, value] = TryGetColumnInt(*stmt, 4); ok) data.ScoreAddressId = value;
+                    if (auto[ok, value] = TryGetColumnString(*stmt, 5); ok) data.ScoreAddressHash = value;
+
+                    if (auto[ok, value] = TryGetColumnString(*stmt, 6); ok) data.ContentTxHash = value;
+                    if (auto[ok, value] = TryGetColumnInt(*stmt, 7); ok) data.ContentType = (TxType) value;
+                    if (auto[ok, value] = TryGetColumnInt64(*stmt, 8); ok) data.ContentTime = value;
+                    if (auto[ok, value] = TryGetColumnInt(*stmt, 9); ok) data.ContentId = value;
+                    if (auto[ok, value] = TryGetColumnInt(*stmt, 10); ok) data.ContentAddressId = value;
+                    if (auto[ok, value] = TryGetColumnString(*stmt, 11); ok) data.ContentAddressHash = value;
+
+                    // Keep the first row as the single hash query does
+                    result.emplace(data.ScoreTxHash, make_shared<ScoreDataDto>(data));
+                }
+
+                FinalizeSqlStatement(*stmt);
+            });
+        }
+
+        return result;
+    }
+
     // Select many referrers
     shared_ptr<map<string, string>> ConsensusRepository::GetReferrers(const vector<string>& addresses, int minHeight)
     {
@@ -50,6 +50,8 @@ namespace PocketDb
         int64_t GetAccountRegistrationTime(int addressId);
 
         ScoreDataDtoRef GetScoreData(const string& txHash);
+        // Scores without data are absent in result
+        map<string, ScoreDataDtoRef> GetScoreData(const vector<string>& txHashes);
         shared_ptr<map<string, string>> GetReferrers(const vector<string>& addresses, int minHeight);
         tuple<bool, string> GetReferrer(const string& address);
         int GetUserLikersCount(int addressId);
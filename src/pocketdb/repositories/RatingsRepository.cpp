@@ -77,6 +77,23 @@ namespace PocketDb
             TryBindStatementInt64(stmt, 7, rating.GetValue());
             TryStepStatement(stmt);
 
+            // Remember old Last record for rollback
+            auto stmtUndo = SetupSqlStatement(R"sql(
+                insert into BlockUndo (Height, Type, Int1, Int2, Int3)
+                select ?, ?, r.Type, r.Id, r.Height
+                from Ratings r indexed by Ratings_Type_Id_Last_Height
+                where r.Type = ?
+                  and r.Last = 1
+                  and r.Id = ?
+                  and r.Height < ?
+            )sql");
+            TryBindStatementInt(stmtUndo, 1, rating.GetHeight());
+            TryBindStatementInt(stmtUndo, 2, BLOCK_UNDO_RATING_LAST);
+            TryBindStatementInt(stmtUndo, 3, *rating.GetType());
+            TryBindStatementInt64(stmtUndo, 4, rating.GetId());
+            TryBindStatementInt(stmtUndo, 5, rating.GetHeight());
+            TryStepStatement(stmtUndo);
+
             // Clear old Last record
             auto stmtUpdate = SetupSqlStatement(R"sql(
                 update Ratings indexed by Ratings_Type_Id_Last_Height
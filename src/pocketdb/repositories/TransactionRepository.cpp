@@ -7,246 +7,147 @@
 
 namespace PocketDb
 {
+    /**
+     * Assembles transactions from separate queries over the same hashes: transactions, payloads and outputs.
+     * Each query is ordered by transaction hash, so its rows are merged to already read transactions in one pass
+     * without join fan-out. Rows must be fed query by query, Rewind() is called before every next query.
+     */
     class TransactionReconstructor : public RowAccessor
     {
     public:
-        TransactionReconstructor(bool includePayload, bool includeOutputs, bool includeInputs)
-            : m_includePayload(includePayload), m_includeOutputs(includeOutputs), m_includeInputs(includeInputs)
-        {}
+        explicit TransactionReconstructor(size_t count)
+        {
+            m_txs.reserve(count);
+            m_blockHashes.reserve(count);
+        }
         TransactionReconstructor() = delete;
 
         /**
-         * Pass a new row for reconstructor to collect all necessary data from it.
-         * @param stmt - sqlite stmt. Null is not allowed and will potentially cause a segfault
-         * Returns boolean result of collecting data. If false is returned - all data inside reconstructor is possibly corrupted due to bad input (missing columns, etc)
-         * and it should not be used anymore
+         * Columns: Type, Hash, Time, Last, Id, String1..5, Int1, BlockHash - ordered by Hash
+         * Returns false on bad input, collected data should not be used after that
          */
-        bool FeedRow(sqlite3_stmt* stmt)
+        bool FeedTransaction(sqlite3_stmt* stmt)
         {
-            auto[ok0, txHash] = TryGetColumnString(stmt, 1);
-            if (!ok0) {
+            // Transaction's columns are hardcoded because they are always the same and should always be presented.
+            auto[ok0, _txType] = TryGetColumnInt(stmt, 0);
+            auto[ok1, txHash] = TryGetColumnString(stmt, 1);
+            auto[ok2, nTime] = TryGetColumnInt64(stmt, 2);
+            if (!ok0 || !ok1 || !ok2)
                 return false;
-            }
 
-            // Using columns counter because other columns numbers depend on include* flags
-            // It is controlled inside below methods
-            int currentColumn = 0;
-
-            auto [ok1, txEntry] = ProcessTransaction(stmt, txHash, currentColumn);
-            if (!ok1 || txEntry == nullptr) {
+            auto ptx = PocketHelpers::TransactionHelper::CreateInstance(static_cast<TxType>(_txType));
+            if (ptx == nullptr)
                 return false;
-            }
 
-            // The order of below functions is necessary. It should correspond to order of joins in query.
-            if (m_includeOutputs && !ParseOutput(stmt, *txEntry, currentColumn)) {
-                return false;
-            }
-            if (m_includeInputs && !ParseInput(stmt, *txEntry, currentColumn)) {
-                return false;
-            }
-            
-            return true;
-        }
+            ptx->SetHash(txHash);
+            ptx->SetTime(nTime);
 
-        /**
-         * Constructs all collected data to PocketBlock format.
-         * blockHashes is filled with block hashes corresponding to all collected transactions, where key is tx hash
-         * and value is blockhash.
-         * 
-         */
-        PocketBlock GetResult(std::map<std::string, std::string>& blockHashes)
-        {
-            PocketBlock result;
-            std::map<std::string, std::string> blockHashesRes;
-            for (auto& txEntryPair: m_constructed) {
-                auto& txEntry = *txEntryPair.second;
-
-                auto tx = txEntry.tx;
-                if (txEntry.payload.has_value()) {
-                    tx->SetPayload(txEntry.payload.value());
-                }
-
-                auto& outputs = tx->Outputs();
-                outputs.clear();
-                outputs.reserve(txEntry.outputs.size());
-                for (const auto& outputPair: txEntry.outputs) {
-                    outputs.emplace_back(outputPair.second);
-                }
-
-                result.emplace_back(tx);
-                blockHashesRes.insert({*tx->GetHash(), txEntry.blockHash});
-            }
-            blockHashes = std::move(blockHashesRes);
-            return result;
-        }
-    private:
-        /**
-         * Used to collect all data for constructing transaction.
-         * It is needed to avoid duplicates of payload and outputs in case of multiple joins because it uses optional and map
-         * instead of object and vector in Transaction.
-         */
-        class ConstructEntry
-        {
-        public:
-            /**
-             * Transaction is going to be filled only with data from "Transactions" table
-             */
-            PTransactionRef tx;
-            /**
-             * Will be null and not included to transaction during constructing if includePayload == false.
-             * Otherwise, will be included even if there is no payload for transaction
-             */
-            std::optional<Payload> payload;
-            /**
-             * Map for outputs where key is "Number" from TxOutputs table
-             */
-            std::map<int64_t, std::shared_ptr<TransactionOutput>> outputs;
-            /**
-             * Block hash for current transaction
-             */
-            std::string blockHash; 
-
-            // TODO (team): Inputs here too
-        };
-        /**
-         * Map that is filled on every FeedRow(). TxHash is used as a key.
-         */
-        std::map<std::string, std::shared_ptr<ConstructEntry>> m_constructed;
+            if (auto[ok, value] = TryGetColumnInt(stmt, 3); ok) ptx->SetLast(value == 1);
+            if (auto[ok, value] = TryGetColumnInt64(stmt, 4); ok) ptx->SetId(value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 5); ok) ptx->SetString1(value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 6); ok) ptx->SetString2(value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 7); ok) ptx->SetString3(value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 8); ok) ptx->SetString4(value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 9); ok) ptx->SetString5(value);
+            if (auto[ok, value] = TryGetColumnInt64(stmt, 10); ok) ptx->SetInt1(value);
 
-        bool m_includePayload = false;
-        bool m_includeOutputs = false;
-        bool m_includeInputs = false;
-
-        /**
-         * This will bi filled by ProcessTransaction method to allow scip all already parsed single-row columns
-         */
-        int m_skipSingleRowColumnsOffset = 0;
+            auto[ok3, blockHash] = TryGetColumnString(stmt, 11);
+            m_blockHashes.push_back(ok3 ? std::move(blockHash) : "");
+            m_txs.push_back(std::move(ptx));
 
-        /**
-         * This method parses transaction data, constructs if needed and return construct entry to fill
-         */
-        tuple<bool, std::shared_ptr<ConstructEntry>> ProcessTransaction(sqlite3_stmt* stmt, const std::string& txHash, int& currentColumn)
-        {
-            auto tx = m_constructed.find(txHash);
-            if (tx == m_constructed.end()) {
-                // Transaction's columns are hardcoded because they are always the same and should always be presented.
-                // Probably this can be generalized in future
-                auto[ok1, _txType] = TryGetColumnInt(stmt, 0);
-                auto[ok2, nTime] = TryGetColumnInt64(stmt, 2);
-
-                if (!ok1 || !ok2)
-                    return {false, nullptr};
-
-                auto txType = static_cast<TxType>(_txType);
-                auto ptx = PocketHelpers::TransactionHelper::CreateInstance(txType);
-                if (ptx == nullptr)
-                    return {false, nullptr};
-                
-                ptx->SetTime(nTime);
-                ptx->SetHash(txHash);
-
-                // Creating construct entry that will be associated with current transaction and filled with payload, outputs, inputs, etc inside
-                auto txEntry = std::make_shared<ConstructEntry>();
-
-                if (auto[ok, value] = TryGetColumnInt(stmt, 3); ok) ptx->SetLast(value == 1);
-                if (auto[ok, value] = TryGetColumnInt64(stmt, 4); ok) ptx->SetId(value);
-                if (auto[ok, value] = TryGetColumnString(stmt, 5); ok) ptx->SetString1(value);
-                if (auto[ok, value] = TryGetColumnString(stmt, 6); ok) ptx->SetString2(value);
-                if (auto[ok, value] = TryGetColumnString(stmt, 7); ok) ptx->SetString3(value);
-                if (auto[ok, value] = TryGetColumnString(stmt, 8); ok) ptx->SetString4(value);
-                if (auto[ok, value] = TryGetColumnString(stmt, 9); ok) ptx->SetString5(value);
-                if (auto[ok, value] = TryGetColumnInt64(stmt, 10); ok) ptx->SetInt1(value);
-                if (auto[ok, value] = TryGetColumnString(stmt, 11); ok) txEntry->blockHash = value;
-
-                txEntry->tx = std::move(ptx);
-                m_constructed.insert({txHash, txEntry});
-
-                currentColumn = 12;
-                // Parsing single joins here results in some optimizing because we will not try to parse them later
-                // only after one check if transaction has already parsed
-                auto singleJoinsRes = ParseSingleJoins(stmt, *txEntry, currentColumn);
-                m_skipSingleRowColumnsOffset = currentColumn;
-                return {singleJoinsRes, txEntry};
-            } else {
-                currentColumn = m_skipSingleRowColumnsOffset;
-                return {true, tx->second};
-            }
+            return true;
         }
 
         /**
-         * This method is used inside ProcessTransaction to optimize and collect all one-row joins
-         * only once at time collecting transaction data.
+         * Columns: TxHash, String1..7 - ordered by TxHash
          */
-        bool ParseSingleJoins(sqlite3_stmt* stmt, ConstructEntry& result, int& currentColumn)
+        bool FeedPayload(sqlite3_stmt* stmt)
         {
-            if (m_includePayload && !ParsePayload(stmt, result, currentColumn)) {
+            auto[ok0, txHash] = TryGetColumnString(stmt, 0);
+            if (!ok0)
                 return false;
-            }
 
+            auto ptx = Seek(txHash);
+            if (!ptx)
+                return true;
+
+            Payload payload;
+            payload.SetTxHash(txHash);
+            if (auto[ok, value] = TryGetColumnString(stmt, 1); ok) payload.SetString1(value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 2); ok) payload.SetString2(value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 3); ok) payload.SetString3(value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 4); ok) payload.SetString4(value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 5); ok) payload.SetString5(value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 6); ok) payload.SetString6(value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 7); ok) payload.SetString7(value);
+
+            ptx->SetPayload(std::move(payload));
             return true;
         }
 
-        bool ParsePayload(sqlite3_stmt* stmt, ConstructEntry& result, int& currentColumn)
+        /**
+         * Columns: TxHash, Number, AddressHash, Value, ScriptPubKey - ordered by TxHash, Number
+         */
+        bool FeedOutput(sqlite3_stmt* stmt)
         {
-            auto skip = [&]() { currentColumn += 8; return true; };
-            if (result.payload.has_value()) {
-                // Already have parse this payload, skip
-                return skip();
-            }
-
-            bool ok0;
-            std::string txHash;
-            if (std::tie(ok0, txHash) = TryGetColumnString(stmt, currentColumn); !ok0) {
-                // Assuming missing hash is missing payload that is a legal situation even if we request it.
-                return skip();
-            }
+            auto[ok0, txHash] = TryGetColumnString(stmt, 0);
+            auto[ok1, number] = TryGetColumnInt64(stmt, 1);
+            if (!ok0 || !ok1)
+                return false;
 
-            auto payload = Payload();
+            auto ptx = Seek(txHash);
+            if (!ptx)
+                return true;
 
-            payload.SetTxHash(txHash); currentColumn++;
-            if (auto[ok, value] = TryGetColumnString(stmt, currentColumn); ok) payload.SetString1(value); currentColumn++;
-            if (auto[ok, value] = TryGetColumnString(stmt, currentColumn); ok) payload.SetString2(value); currentColumn++;
-            if (auto[ok, value] = TryGetColumnString(stmt, currentColumn); ok) payload.SetString3(value); currentColumn++;
-            if (auto[ok, value] = TryGetColumnString(stmt, currentColumn); ok) payload.SetString4(value); currentColumn++;
-            if (auto[ok, value] = TryGetColumnString(stmt, currentColumn); ok) payload.SetString5(value); currentColumn++;
-            if (auto[ok, value] = TryGetColumnString(stmt, currentColumn); ok) payload.SetString6(value); currentColumn++;
-            if (auto[ok, value] = TryGetColumnString(stmt, currentColumn); ok) payload.SetString7(value); currentColumn++;
+            // Multisig output has a row per address - first one is kept
+            auto& outputs = ptx->Outputs();
+            if (!outputs.empty() && *outputs.back().GetNumber() == number)
+                return true;
 
-            result.payload = std::move(payload);
+            auto& output = outputs.emplace_back();
+            output.SetTxHash(txHash);
+            output.SetNumber(number);
+            if (auto[ok, value] = TryGetColumnString(stmt, 2); ok) output.SetAddressHash(value);
+            if (auto[ok, value] = TryGetColumnInt64(stmt, 3); ok) output.SetValue(value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 4); ok) output.SetScriptPubKey(value);
 
             return true;
         }
 
-        bool ParseOutput(sqlite3_stmt* stmt, ConstructEntry& result, int& currentColumn)
+        void Rewind()
         {
-            auto[ok0, number] = TryGetColumnInt64(stmt, currentColumn); currentColumn++;
-            if (!ok0) {
-                return false;
-            }
-
-            if (result.outputs.find(number) != result.outputs.end()) {
-                // Skipping output's columns because they have been already parsed
-                currentColumn+=4;
-                return true;
-            }
+            m_cursor = 0;
+        }
 
-            auto output = std::make_shared<TransactionOutput>();
-            output->SetNumber(number);
+        /**
+         * Returns collected transactions ordered by hash.
+         * blockHashes is filled with block hashes corresponding to all collected transactions, where key is tx hash
+         * and value is blockhash.
+         */
+        PocketBlock GetResult(std::map<std::string, std::string>& blockHashes)
+        {
+            blockHashes.clear();
+            for (size_t i = 0; i < m_txs.size(); i++)
+                blockHashes.emplace_hint(blockHashes.end(), *m_txs[i]->GetHash(), std::move(m_blockHashes[i]));
 
-            if (auto[ok, value] = TryGetColumnString(stmt, currentColumn); ok) output->SetTxHash(value); currentColumn++;
-            if (auto[ok, value] = TryGetColumnString(stmt, currentColumn); ok) output->SetAddressHash(value); currentColumn++;
-            if (auto[ok, value] = TryGetColumnInt64(stmt, currentColumn); ok) output->SetValue(value); currentColumn++;
-            if (auto[ok, value] = TryGetColumnString(stmt, currentColumn); ok) output->SetScriptPubKey(value); currentColumn++;
+            return std::move(m_txs);
+        }
 
-            result.outputs.insert({number, std::move(output)});
+    private:
+        PocketBlock m_txs;
+        std::vector<std::string> m_blockHashes;
+        size_t m_cursor = 0;
 
-            return true;
-        }
-        
-        bool ParseInput(sqlite3_stmt* stmt, ConstructEntry& result, int& currentColumn)
+        // Rows of every query come in the same hash order as transactions
+        Transaction* Seek(const std::string& txHash)
         {
-            // TODO (team): Implement this
-            return true;
+            while (m_cursor < m_txs.size() && *m_txs[m_cursor]->GetHash() < txHash)
+                m_cursor++;
+
+            if (m_cursor < m_txs.size() && *m_txs[m_cursor]->GetHash() == txHash)
+                return m_txs[m_cursor].get();
+
+            return nullptr;
         }
     };
 
@@ -279,7 +180,9 @@ namespace PocketDb
     shared_ptr<PocketBlock> TransactionRepository::List(const vector<string>& txHashes, map<string, string>& blockHashes, bool includePayload, bool includeInputs, bool includeOutputs)
     {
         // TODO (brangr): implement variable inputs
-        auto sql = R"sql(
+        string hashesWhere = " in ( " + join(vector<string>(txHashes.size(), "?"), ",") + " ) ";
+
+        auto txSql = R"sql(
             SELECT
                 t.Type,
                 t.Hash,
@@ -293,69 +196,71 @@ namespace PocketDb
                 t.String5,
                 t.Int1,
                 t.BlockHash
-        )sql" +
-        // Payload part
-        (includePayload ? std::string(R"sql(,
-                p.TxHash pHash,
-                p.String1 pString1,
-                p.String2 pString2,
-                p.String3 pString3,
-                p.String4 pString4,
-                p.String5 pString5,
-                p.String6 pString6,
-                p.String7 pString7
-        )sql") : "") +
-        // 
-        // Outputs part
-        (includeOutputs ? std::string(R"sql(,
-                o.Number,
+            FROM Transactions t
+            WHERE t.Hash )sql" + hashesWhere + R"sql(
+            ORDER BY t.Hash
+        )sql";
+
+        auto payloadSql = R"sql(
+            SELECT
+                p.TxHash,
+                p.String1,
+                p.String2,
+                p.String3,
+                p.String4,
+                p.String5,
+                p.String6,
+                p.String7
+            FROM Payload p
+            WHERE p.TxHash )sql" + hashesWhere + R"sql(
+            ORDER BY p.TxHash
+        )sql";
+
+        auto outputsSql = R"sql(
+            SELECT
                 o.TxHash,
+                o.Number,
                 o.AddressHash,
                 o.Value,
                 o.ScriptPubKey
-        )sql") : "") +
-        // 
-        R"sql(
-            FROM Transactions t
-        )sql" +
-        // Payload part
-        (includePayload ? std::string(R"sql(
-            LEFT JOIN Payload p on t.Hash = p.TxHash
-        )sql") : "") +
-        //
-        // Outputs part
-        (includeOutputs ? std::string(R"sql(
-            CROSS JOIN TxOutputs o on t.Hash = o.TxHash
-        )sql") : "") +
-        //
-        R"sql(
-            WHERE t.Hash in ( )sql" + join(vector<string>(txHashes.size(), "?"), ",") + R"sql( )
+            FROM TxOutputs o
+            WHERE o.TxHash )sql" + hashesWhere + R"sql(
+            ORDER BY o.TxHash, o.Number
         )sql";
 
         PocketBlockRef result;
         TryTransactionStep(__func__, [&]()
         {
-            auto stmt = SetupSqlStatement(sql);
+            TransactionReconstructor constructor(txHashes.size());
 
-            for (size_t i = 0; i < txHashes.size(); i++)
-                TryBindStatementText(stmt, (int) i + 1, txHashes[i]);
-
-            TransactionReconstructor constructor(includePayload, includeOutputs, includeInputs);
-            bool res = true;
-            while (sqlite3_step(*stmt) == SQLITE_ROW)
+            auto read = [&](const string& sql, bool (TransactionReconstructor::*feed)(sqlite3_stmt*))
             {
-                if (!constructor.FeedRow(*stmt)) {
-                    // TODO (losty): error here
-                    res = false;
-                    break;
-                }
-            }
+                auto stmt = SetupSqlStatement(sql);
 
-            FinalizeSqlStatement(*stmt);
+                for (size_t i = 0; i < txHashes.size(); i++)
+                    TryBindStatementText(stmt, (int) i + 1, txHashes[i]);
 
-            if (res) {
-                result = std::make_shared<PocketBlock>(std::move(constructor.GetResult(blockHashes)));
-            }
+                constructor.Rewind();
+
+                bool res = true;
+                while (res && sqlite3_step(*stmt) == SQLITE_ROW)
+                    res = (constructor.*feed)(*stmt);
+
+                FinalizeSqlStatement(*stmt);
+                return res;
+            };
+
+            // TODO (losty): error here
+            if (!read(txSql, &TransactionReconstructor::FeedTransaction))
+                return;
+
+            if (includePayload && !read(payloadSql, &TransactionReconstructor::FeedPayload))
+                return;
+
+            if (includeOutputs && !read(outputsSql, &TransactionReconstructor::FeedOutput))
+                return;
+
+            result = std::make_shared<PocketBlock>(constructor.GetResult(blockHashes));
         });
 
         return result;
@@ -609,13 +514,13 @@ namespace PocketDb
             )sql");
 
             TryBindStatementText(stmt, 1, ptx->GetHash());
-            TryBindStatementInt64(stmt, 2, output->GetNumber());
-            TryBindStatementText(stmt, 3, output->GetAddressHash());
-            TryBindStatementInt64(stmt, 4, output->GetValue());
-            TryBindStatementText(stmt, 5, output->GetScriptPubKey());
+            TryBindStatementInt64(stmt, 2, output.GetNumber());
+            TryBindStatementText(stmt, 3, output.GetAddressHash());
+            TryBindStatementInt64(stmt, 4, output.GetValue());
+            TryBindStatementText(stmt, 5, output.GetScriptPubKey());
             TryBindStatementText(stmt, 6, ptx->GetHash());
-            TryBindStatementInt64(stmt, 7, output->GetNumber());
-            TryBindStatementText(stmt, 8, output->GetAddressHash());
+            TryBindStatementInt64(stmt, 7, output.GetNumber());
+            TryBindStatementText(stmt, 8, output.GetAddressHash());
 
             TryStepStatement(stmt);
         }
@@ -682,7 +587,7 @@ namespace PocketDb
         TryStepStatement(stmt);
     }
 
-    // TODO (losty): below code it fully duplicated with some nuances in TransactionReconstructor::ProcessTransaction method
+    // TODO (losty): below code it fully duplicated with some nuances in TransactionReconstructor::FeedTransaction method
     tuple<bool, PTransactionRef> TransactionRepository::CreateTransactionFromListRow(
         const shared_ptr<sqlite3_stmt*>& stmt, bool includedPayload)
     {
@@ -50,12 +50,13 @@ namespace PocketDb {
         TryTransactionStep(__func__, [&]()
         {
             auto stmt = SetupSqlStatement(R"sql(
-                select (t.Height / 60)Hour, t.Type, count()Count
-                from Transactions t indexed by Transactions_Type_HeightByHour
-                where t.Type in (1,100,103,200,201,202,204,205,208,300,301,302,303)
-                  and (t.Height / 60) < (? / 60)
-                  and (t.Height / 60) >= (? / 60)
-                group by (t.Height / 60), t.Type
+                select s.Bucket, s.Type, s.Count
+                from TransactionsStatistic s
+                where s.Period = 60
+                  and s.Bucket < (? / 60)
+                  and s.Bucket >= (? / 60)
+                  and s.Type in (1,100,103,200,201,202,204,205,208,300,301,302,303)
+                  and s.Count > 0
             )sql");
 
             TryBindStatementInt(stmt, 1, topHeight);
@@ -89,12 +90,13 @@ namespace PocketDb {
         TryTransactionStep(__func__, [&]()
         {
             auto stmt = SetupSqlStatement(R"sql(
-                select (t.Height / 1440)Day, t.Type, count()Count
-                from Transactions t indexed by Transactions_Type_HeightByDay
-                where t.Type in (1,100,103,200,201,202,204,205,208,300,301,302,303)
-                  and (t.Height / 1440) < (? / 1440)
-                  and (t.Height / 1440) >= (? / 1440)
-                group by (t.Height / 1440), t.Type
+                select s.Bucket, s.Type, s.Count
+                from TransactionsStatistic s
+                where s.Period = 1440
+                  and s.Bucket < (? / 1440)
+                  and s.Bucket >= (? / 1440)
+                  and s.Type in (1,100,103,200,201,202,204,205,208,300,301,302,303)
+                  and s.Count > 0
             )sql");
 
             TryBindStatementInt(stmt, 1, topHeight);
@@ -123,88 +125,36 @@ namespace PocketDb {
 
     UniValue ExplorerRepository::GetContentStatisticByHours(int topHeight, int depth)
     {
-        UniValue result(UniValue::VOBJ);
-
-        TryTransactionStep(__func__, [&]()
-        {
-            auto stmt = SetupSqlStatement(R"sql(
-                select (u.Height / 60)
-                  ,(
-                    select
-                      count()
-                    from Transactions u1 indexed by Transactions_Type_Last_Height_Id
-                    where u1.Type in (100)
-                    and u1.Height <= u.Height
-                    and u1.Last = 1
-                  )cnt
-                from Transactions u indexed by Transactions_Type_HeightByHour
-                where u.Type in (3)
-                  and (u.Height / 60) <= (? / 60)
-                  and (u.Height / 60) > (? / 60)
-
-                group by (u.Height / 60)
-                order by (u.Height / 60) desc
-            )sql");
-
-            TryBindStatementInt(stmt, 1, topHeight);
-            TryBindStatementInt(stmt, 2, topHeight - depth);
-
-            while (sqlite3_step(*stmt) == SQLITE_ROW)
-            {
-                auto [okPart, part] = TryGetColumnString(*stmt, 0);
-                auto [okCount, count] = TryGetColumnInt(*stmt, 1);
-
-                if (!okPart || !okCount)
-                    continue;
-
-                result.pushKV(part, count);
-            }
-
-            FinalizeSqlStatement(*stmt);
-        });
-
-        return result;
+        return GetAccountsStatistic(60, topHeight, depth);
     }
 
     UniValue ExplorerRepository::GetContentStatisticByDays(int topHeight, int depth)
+    {
+        return GetAccountsStatistic(1440, topHeight, depth);
+    }
+
+    UniValue ExplorerRepository::GetContentStatistic()
     {
         UniValue result(UniValue::VOBJ);
 
         TryTransactionStep(__func__, [&]()
         {
             auto stmt = SetupSqlStatement(R"sql(
-                select (u.Height / 1440)
-                  ,(
-                    select
-                      count()
-                    from Transactions u1 indexed by Transactions_Type_Last_Height_Id
-                    where u1.Type in (100)
-                    and u1.Height <= u.Height
-                    and u1.Last = 1
-                  )cnt
-
-                from Transactions u indexed by Transactions_Type_HeightByDay
-                
-                where u.Type in (3)
-                  and (u.Height / 1440) <= (? / 1440)
-                  and (u.Height / 1440) > (? / 1440)
-                
-                group by (u.Height / 1440)
-                order by (u.Height / 1440) desc
+                select s.Type, sum(s.Last)Count
+                from TransactionsStatistic s
+                where s.Period = 1440
+                  and s.Type in (100,101,102,200,201,202,208)
+                group by s.Type
+                having sum(s.Last) > 0
             )sql");
 
-            TryBindStatementInt(stmt, 1, topHeight);
-            TryBindStatementInt(stmt, 2, topHeight - depth);
-
             while (sqlite3_step(*stmt) == SQLITE_ROW)
             {
-                auto [okPart, part] = TryGetColumnString(*stmt, 0);
+                auto [okType, type] = TryGetColumnString(*stmt, 0);
                 auto [okCount, count] = TryGetColumnInt(*stmt, 1);
 
-                if (!okPart || !okCount)
-                    continue;
-
-                result.pushKV(part, count);
+                if (okType && okCount)
+                    result.pushKV(type, count);
             }
 
             FinalizeSqlStatement(*stmt);
@@ -213,28 +163,56 @@ namespace PocketDb {
         return result;
     }
 
-    UniValue ExplorerRepository::GetContentStatistic()
+    UniValue ExplorerRepository::GetAccountsStatistic(int period, int topHeight, int depth)
     {
         UniValue result(UniValue::VOBJ);
 
         TryTransactionStep(__func__, [&]()
         {
+            int64_t accounts = 0;
+
+            auto stmtTotal = SetupSqlStatement(R"sql(
+                select sum(s.Last)
+                from TransactionsStatistic s
+                where s.Period = ?
+                  and s.Type = 100
+            )sql");
+            TryBindStatementInt(stmtTotal, 1, period);
+
+            if (sqlite3_step(*stmtTotal) == SQLITE_ROW)
+                if (auto[ok, value] = TryGetColumnInt64(*stmtTotal, 0); ok)
+                    accounts = value;
+
+            FinalizeSqlStatement(*stmtTotal);
+
+            // Accounts at the end of bucket are current accounts without registered by later buckets.
+            // Buckets with blocks (coinstake transactions) are returned from the newest.
             auto stmt = SetupSqlStatement(R"sql(
-                select t.Type, count()Count
-                from Transactions t indexed by Transactions_Type_Last_Height_Id
-                where t.Type in (100,101,102,200,201,202,208)
-                  and t.Last = 1
-                  and t.Height > 0
-                group by t.Type
+                select s.Bucket, s.Type, s.Count, s.Last
+                from TransactionsStatistic s
+                where s.Period = ?
+                  and s.Bucket > (? / ?)
+                  and s.Type in (3, 100)
+                order by s.Bucket desc, s.Type asc
             )sql");
+            TryBindStatementInt(stmt, 1, period);
+            TryBindStatementInt(stmt, 2, topHeight - depth);
+            TryBindStatementInt(stmt, 3, period);
 
             while (sqlite3_step(*stmt) == SQLITE_ROW)
             {
-                auto [okType, type] = TryGetColumnString(*stmt, 0);
-                auto [okCount, count] = TryGetColumnInt(*stmt, 1);
+                auto [okBucket, bucket] = TryGetColumnInt(*stmt, 0);
+                auto [okType, type] = TryGetColumnInt(*stmt, 1);
+                auto [okCount, count] = TryGetColumnInt(*stmt, 2);
+                auto [okLast, last] = TryGetColumnInt64(*stmt, 3);
 
-                if (okType && okCount)
-                    result.pushKV(type, count);
+                if (!okBucket || !okType || !okCount || !okLast)
+                    continue;
+
+                if (type == 100)
+                    accounts -= last;
+                else if (count > 0 && bucket <= topHeight / period)
+                    result.pushKV(to_string(bucket), accounts);
             }
 
             FinalizeSqlStatement(*stmt);
@@ -484,7 +462,7 @@ namespace PocketDb {
         {
             auto stmt = SetupSqlStatement(R"sql(
                 select b.Height, sum(b.Value)Amount
-                from Balances b indexed by Balances_Height
+                from Balances b
                 where b.AddressHash in ( )sql" + join(vector<string>(addresses.size(), "?"), ",") + R"sql( )
                   and b.Height <= ?
                 group by b.Height
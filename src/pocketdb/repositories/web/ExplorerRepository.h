@@ -43,6 +43,9 @@ namespace PocketDb
 
     private:
 
+        // Registered accounts at the end of buckets of period blocks
+        UniValue GetAccountsStatistic(int period, int topHeight, int depth);
+
         template<typename T>
         UniValue _getTransactions(T stmtOut);
     
@@ -0,0 +1,254 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/repositories/web/FeedRepository.h"
+
+namespace PocketDb
+{
+    atomic<bool> FeedRepository::m_ready{false};
+
+    // Keep number of bound parameters under SQLite limit
+    static const size_t FEED_REFRESH_CHUNK = 500;
+
+    static const string FeedContentSelect = R"sql(
+        select
+            t.Id,
+            t.Type,
+            p.String1,
+            t.String1,
+            t.String2,
+            t.String3,
+            t.Height,
+            torig.Height,
+            ifnull(r.Value, 0),
+            ifnull(r.Height, 0)
+
+        from Transactions t indexed by Transactions_Last_Id_Height
+
+        join Transactions torig indexed by Transactions_Hash_Height
+            on torig.Hash = t.String2 and torig.Height > 0 and torig.Id = t.Id
+
+        left join Payload p
+            on p.TxHash = t.Hash
+
+        left join Ratings r indexed by Ratings_Type_Id_Last_Height
+            on r.Type = 2 and r.Last = 1 and r.Id = t.Id
+
+        where t.Type in (200, 201, 202, 207)
+          and t.Last = 1
+          and t.Height > 0
+    )sql";
+
+    static const string FeedAccountSelect = R"sql(
+        select
+            u.String1,
+            u.Id,
+            u.Height,
+            ifnull(ur.Value, 0),
+            ifnull(ur.Height, 0)
+
+        from Transactions u indexed by Transactions_Type_Last_String1_Height_Id
+
+        left join Ratings ur indexed by Ratings_Type_Id_Last_Height
+            on ur.Type = 0 and ur.Last = 1 and ur.Id = u.Id
+
+        where u.Type in (100)
+          and u.Last = 1
+          and u.Height > 0
+    )sql";
+
+    void FeedRepository::Init() {}
+
+    void FeedRepository::Destroy() {}
+
+    bool FeedRepository::IsReady()
+    {
+        return m_ready;
+    }
+
+    void FeedRepository::SetReady(bool ready)
+    {
+        m_ready = ready;
+    }
+
+    int FeedRepository::GetBlockHeight(const string& blockHash)
+    {
+        int result = -1;
+
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmt = SetupSqlStatement(R"sql(
+                select Height
+                from Transactions indexed by Transactions_BlockHash
+                where BlockHash = ?
+                limit 1
+            )sql");
+            TryBindStatementText(stmt, 1, blockHash);
+
+            if (sqlite3_step(*stmt) == SQLITE_ROW)
+                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
+                    result = value;
+
+            FinalizeSqlStatement(*stmt);
+        });
+
+        return result;
+    }
+
+    void FeedRepository::Rebuild()
+    {
+        TryTransactionStep(__func__, [&]()
+        {
+            auto clearStmt = SetupSqlStatement("delete from web.Feed");
+            TryStepStatement(clearStmt);
+
+            auto clearAccountsStmt = SetupSqlStatement("delete from web.FeedAccounts");
+            TryStepStatement(clearAccountsStmt);
+
+            auto stmt = SetupSqlStatement(R"sql(
+                insert into web.Feed (Id, Type, Lang, AddressHash, RootTxHash, RelayTxHash, Height, OrigHeight, Rating, RatingHeight)
+            )sql" + FeedContentSelect);
+            TryStepStatement(stmt);
+
+            auto accountsStmt = SetupSqlStatement(R"sql(
+                insert or replace into web.FeedAccounts (AddressHash, Id, Height, Rating, RatingHeight)
+            )sql" + FeedAccountSelect);
+            TryStepStatement(accountsStmt);
+        });
+    }
+
+    void FeedRepository::Refresh(const string& blockHash, int height, int reorgHeight)
+    {
+        set<int64_t> contentIds;
+        set<string> addresses;
+
+        TryTransactionStep(__func__, [&]()
+        {
+            // Contents published, edited or deleted in block
+            auto stmt = SetupSqlStatement(R"sql(
+                select Id
+                from Transactions indexed by Transactions_BlockHash
+                where BlockHash = ? and Type in (200, 201, 202, 207)
+            )sql");
+            TryBindStatementText(stmt, 1, blockHash);
+            while (sqlite3_step(*stmt) == SQLITE_ROW)
+                if (auto[ok, value] = TryGetColumnInt64(*stmt, 0); ok)
+                    contentIds.emplace(value);
+            FinalizeSqlStatement(*stmt);
+
+            // Contents with rating changed by block
+            stmt = SetupSqlStatement(R"sql(
+                select Id
+                from Ratings indexed by Ratings_Height_Last
+                where Height = ? and Type = 2
+            )sql");
+            TryBindStatementInt(stmt, 1, height);
+            while (sqlite3_step(*stmt) == SQLITE_ROW)
+                if (auto[ok, value] = TryGetColumnInt64(*stmt, 0); ok)
+                    contentIds.emplace(value);
+            FinalizeSqlStatement(*stmt);
+
+            // Accounts registered or edited in block
+            stmt = SetupSqlStatement(R"sql(
+                select String1
+                from Transactions indexed by Transactions_BlockHash
+                where BlockHash = ? and Type in (100)
+            )sql");
+            TryBindStatementText(stmt, 1, blockHash);
+            while (sqlite3_step(*stmt) == SQLITE_ROW)
+                if (auto[ok, value] = TryGetColumnString(*stmt, 0); ok)
+                    addresses.emplace(value);
+            FinalizeSqlStatement(*stmt);
+
+            // Accounts with rating changed by block
+            stmt = SetupSqlStatement(R"sql(
+                select u.String1
+                from Ratings r indexed by Ratings_Height_Last
+                join Transactions u indexed by Transactions_Id_Last
+                    on u.Id = r.Id and u.Last = 1 and u.Type in (100)
+                where r.Height = ? and r.Type = 0
+            )sql");
+            TryBindStatementInt(stmt, 1, height);
+            while (sqlite3_step(*stmt) == SQLITE_ROW)
+                if (auto[ok, value] = TryGetColumnString(*stmt, 0); ok)
+                    addresses.emplace(value);
+            FinalizeSqlStatement(*stmt);
+
+            if (reorgHeight >= 0)
+            {
+                stmt = SetupSqlStatement("select Id from web.Feed where Height >= ? or RatingHeight >= ?");
+                TryBindStatementInt(stmt, 1, reorgHeight);
+                TryBindStatementInt(stmt, 2, reorgHeight);
+                while (sqlite3_step(*stmt) == SQLITE_ROW)
+                    if (auto[ok, value] = TryGetColumnInt64(*stmt, 0); ok)
+                        contentIds.emplace(value);
+                FinalizeSqlStatement(*stmt);
+
+                stmt = SetupSqlStatement("select AddressHash from web.FeedAccounts where Height >= ? or RatingHeight >= ?");
+                TryBindStatementInt(stmt, 1, reorgHeight);
+                TryBindStatementInt(stmt, 2, reorgHeight);
+                while (sqlite3_step(*stmt) == SQLITE_ROW)
+                    if (auto[ok, value] = TryGetColumnString(*stmt, 0); ok)
+                        addresses.emplace(value);
+                FinalizeSqlStatement(*stmt);
+            }
+
+            RefreshContents(contentIds);
+            RefreshAccounts(addresses);
+        });
+    }
+
+    // Called inside transaction step
+    void FeedRepository::RefreshContents(const set<int64_t>& ids)
+    {
+        vector<int64_t> chunk;
+        for (auto it = ids.begin(); it != ids.end();)
+        {
+            chunk.clear();
+            for (; it != ids.end() && chunk.size() < FEED_REFRESH_CHUNK; it++)
+                chunk.push_back(*it);
+
+            string inList = join(vector<string>(chunk.size(), "?"), ",");
+
+            auto deleteStmt = SetupSqlStatement("delete from web.Feed where Id in ( " + inList + " )");
+            for (size_t i = 0; i < chunk.size(); i++)
+                TryBindStatementInt64(deleteStmt, (int) i + 1, chunk[i]);
+            TryStepStatement(deleteStmt);
+
+            auto insertStmt = SetupSqlStatement(R"sql(
+                insert into web.Feed (Id, Type, Lang, AddressHash, RootTxHash, RelayTxHash, Height, OrigHeight, Rating, RatingHeight)
+            )sql" + FeedContentSelect + " and t.Id in ( " + inList + " )");
+            for (size_t i = 0; i < chunk.size(); i++)
+                TryBindStatementInt64(insertStmt, (int) i + 1, chunk[i]);
+            TryStepStatement(insertStmt);
+        }
+    }
+
+    // Called inside transaction step
+    void FeedRepository::RefreshAccounts(const set<string>& addresses)
+    {
+        vector<string> chunk;
+        for (auto it = addresses.begin(); it != addresses.end();)
+        {
+            chunk.clear();
+            for (; it != addresses.end() && chunk.size() < FEED_REFRESH_CHUNK; it++)
+                chunk.push_back(*it);
+
+            string inList = join(vector<string>(chunk.size(), "?"), ",");
+
+            auto deleteStmt = SetupSqlStatement("delete from web.FeedAccounts where AddressHash in ( " + inList + " )");
+            for (size_t i = 0; i < chunk.size(); i++)
+                TryBindStatementText(deleteStmt, (int) i + 1, chunk[i]);
+            TryStepStatement(deleteStmt);
+
+            auto insertStmt = SetupSqlStatement(R"sql(
+                insert or replace into web.FeedAccounts (AddressHash, Id, Height, Rating, RatingHeight)
+            )sql" + FeedAccountSelect + " and u.String1 in ( " + inList + " )");
+            for (size_t i = 0; i < chunk.size(); i++)
+                TryBindStatementText(insertStmt, (int) i + 1, chunk[i]);
+            TryStepStatement(insertStmt);
+        }
+    }
+
+} // namespace PocketDb
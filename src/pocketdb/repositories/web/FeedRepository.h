@@ -0,0 +1,56 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETDB_FEED_REPOSITORY_H
+#define POCKETDB_FEED_REPOSITORY_H
+
+#include <atomic>
+#include <set>
+
+#include <boost/algorithm/string/join.hpp>
+
+#include "pocketdb/repositories/BaseRepository.h"
+
+namespace PocketDb
+{
+    using namespace std;
+
+    using boost::algorithm::join;
+
+    // Materialized candidates of hot, historical and hierarchical feeds in `web` db.
+    // Rows are refreshed for contents and accounts changed by every connected block,
+    // so feed RPCs read bounded ranges of web.Feed instead of ranking source tables.
+    class FeedRepository : public BaseRepository
+    {
+    public:
+        explicit FeedRepository(SQLiteDatabase& db) : BaseRepository(db) {}
+        void Init() override;
+        void Destroy() override;
+
+        // Feed tables follow the chain; feed RPCs read source tables otherwise
+        static bool IsReady();
+        static void SetReady(bool ready);
+
+        // Height of connected block, -1 if the block is not in chain anymore
+        int GetBlockHeight(const string& blockHash);
+
+        // Fill feed tables from chain data
+        void Rebuild();
+
+        // Refresh rows changed by the block. Rows written at or above reorgHeight
+        // are refreshed too: they may come from disconnected blocks. -1 - no reorg.
+        void Refresh(const string& blockHash, int height, int reorgHeight);
+
+    private:
+        static atomic<bool> m_ready;
+
+        void RefreshContents(const set<int64_t>& ids);
+        void RefreshAccounts(const set<string>& addresses);
+    };
+
+    typedef shared_ptr<FeedRepository> FeedRepositoryRef;
+
+} // namespace PocketDb
+
+#endif // POCKETDB_FEED_REPOSITORY_H
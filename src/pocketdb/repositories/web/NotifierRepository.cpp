@@ -46,72 +46,39 @@ namespace PocketDb
         return result;
     }
 
-    UniValue NotifierRepository::GetPostLang(const string &postHash)
+    map<string, UniValue> NotifierRepository::GetPostInfo(const vector<string>& postHashes)
     {
-        UniValue result(UniValue::VOBJ);
-
-        string sql = R"sql(
-            select p.String1 Lang
-            from Transactions t
-            join Payload p on p.TxHash = t.Hash
-            where t.Type in (200, 201, 202, 203)
-              and t.Hash = ?
-        )sql";
-
-        TryTransactionStep(__func__, [&]()
-        {
-            auto stmt = SetupSqlStatement(sql);
-
-            TryBindStatementText(stmt, 1, postHash);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-            {
-                if (auto[ok, value] = TryGetColumnString(*stmt, 0); ok) result.pushKV("lang", value);
-            }
-
-            FinalizeSqlStatement(*stmt);
-        });
+        map<string, UniValue> result;
 
-        return result;
-    }
-
-    UniValue NotifierRepository::GetPostInfo(const string& postHash)
-    {
-        UniValue result(UniValue::VOBJ);
-
-        string sql = R"sql(
+        SelectByKeys(__func__, postHashes, R"sql(
             select
                 t.Hash Hash,
                 t.String2 RootHash
             from Transactions t
             where t.Type in (200, 201, 202, 203)
-              and t.Hash = ?
-        )sql";
-
-        TryTransactionStep(__func__, [&]()
+              and t.Hash in ( )sql", R"sql( )
+        )sql", [&](sqlite3_stmt* stmt)
         {
-            auto stmt = SetupSqlStatement(sql);
-
-            TryBindStatementText(stmt, 1, postHash);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-            {
-                if (auto[ok, value] = TryGetColumnString(*stmt, 0); ok) result.pushKV("hash", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 1); ok) result.pushKV("rootHash", value);
-            }
-
-            FinalizeSqlStatement(*stmt);
+            auto[okKey, key] = TryGetColumnString(stmt, 0);
+            if (!okKey || result.count(key))
+                return;
+
+            UniValue record(UniValue::VOBJ);
+            record.pushKV("hash", key);
+            if (auto[ok, value] = TryGetColumnString(stmt, 1); ok) record.pushKV("rootHash", value);
+            result.emplace(key, record);
         });
 
         return result;
     }
 
-    UniValue NotifierRepository::GetOriginalPostAddressByRepost(const string &repostHash)
+    map<string, UniValue> NotifierRepository::GetOriginalPostAddressByRepost(const vector<string>& repostHashes)
     {
-        UniValue result(UniValue::VOBJ);
+        map<string, UniValue> result;
 
-        string sql = R"sql(
-            select t.String2 as RootTxHash,
+        SelectByKeys(__func__, repostHashes, R"sql(
+            select tRepost.Hash,
+                   t.String2 as RootTxHash,
                    t.String1 address,
                    tRepost.String1 addressRepost,
                    p.String2 as nameRepost,
@@ -121,39 +88,35 @@ namespace PocketDb
             join Transactions u indexed by Transactions_Type_Last_String1_Height_Id on u.String1 = tRepost.String1
             join Payload p on p.TxHash = u.Hash
             where tRepost.Type in (200, 201, 202, 203)
-              and tRepost.Hash = ?
               and u.Type in (100,101,102)
               and u.Last = 1
               and u.Height is not null
-        )sql";
-
-        TryTransactionStep(__func__, [&]()
+              and tRepost.Hash in ( )sql", R"sql( )
+        )sql", [&](sqlite3_stmt* stmt)
         {
-            auto stmt = SetupSqlStatement(sql);
-
-            TryBindStatementText(stmt, 1, repostHash);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-            {
-                if (auto[ok, value] = TryGetColumnString(*stmt, 0); ok) result.pushKV("hash", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 1); ok) result.pushKV("address", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 2); ok) result.pushKV("addressRepost", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 3); ok) result.pushKV("nameRepost", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 4); ok) result.pushKV("avatarRepost", value);
-            }
-
-            FinalizeSqlStatement(*stmt);
+            auto[okKey, key] = TryGetColumnString(stmt, 0);
+            if (!okKey || result.count(key))
+                return;
+
+            UniValue record(UniValue::VOBJ);
+            if (auto[ok, value] = TryGetColumnString(stmt, 1); ok) record.pushKV("hash", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 2); ok) record.pushKV("address", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 3); ok) record.pushKV("addressRepost", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 4); ok) record.pushKV("nameRepost", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 5); ok) record.pushKV("avatarRepost", value);
+            result.emplace(key, record);
         });
 
         return result;
     }
 
-    UniValue NotifierRepository::GetPrivateSubscribeAddressesByAddressTo(const string &addressTo)
+    map<string, UniValue> NotifierRepository::GetPrivateSubscribeAddressesByAddressTo(const vector<string>& addressesTo)
     {
-        UniValue result(UniValue::VARR);
+        map<string, UniValue> result;
 
-        string sql = R"sql(
-            select s.String1 as addressTo,
+        SelectByKeys(__func__, addressesTo, R"sql(
+            select s.String2,
+                  s.String1 as addressTo,
                   p.String2 as nameFrom,
                   p.String3 as avatarFrom
             from Transactions s indexed by Transactions_Type_Last_String2_Height
@@ -162,39 +125,34 @@ namespace PocketDb
             where s.Type in (303)
               and s.Last = 1
               and s.Height is not null
-              and s.String2 = ?
               and u.Type in (100,101,102)
               and u.Last=1
               and u.Height is not null
-        )sql";
-
-        TryTransactionStep(__func__, [&]()
+              and s.String2 in ( )sql", R"sql( )
+        )sql", [&](sqlite3_stmt* stmt)
         {
-            auto stmt = SetupSqlStatement(sql);
+            auto[okKey, key] = TryGetColumnString(stmt, 0);
+            if (!okKey)
+                return;
 
-            TryBindStatementText(stmt, 1, addressTo);
+            UniValue record(UniValue::VOBJ);
+            if (auto[ok, value] = TryGetColumnString(stmt, 1); ok) record.pushKV("addressTo", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 2); ok) record.pushKV("nameFrom", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 3); ok) record.pushKV("avatarFrom", value);
 
-            while (sqlite3_step(*stmt) == SQLITE_ROW)
-            {
-                UniValue record(UniValue::VOBJ);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 0); ok) record.pushKV("addressTo", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 1); ok) record.pushKV("nameFrom", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 2); ok) record.pushKV("avatarFrom", value);
-                result.push_back(record);
-            }
-
-            FinalizeSqlStatement(*stmt);
+            result.emplace(key, UniValue(UniValue::VARR)).first->second.push_back(record);
         });
 
         return result;
     }
 
-    UniValue NotifierRepository::GetUserReferrerAddress(const string &userHash)
+    map<string, UniValue> NotifierRepository::GetUserReferrerAddress(const vector<string>& userHashes)
     {
-        UniValue result(UniValue::VOBJ);
+        map<string, UniValue> result;
 
-        string sql = R"sql(
+        SelectByKeys(__func__, userHashes, R"sql(
             select
+                r.Hash,
                 r.String2 as referrerAddress,
                 p.String2 as referralName,
                 p.String3 as referralAvatar
@@ -203,37 +161,33 @@ namespace PocketDb
             join Payload p on p.TxHash = u.Hash
             where r.Type in (100)
               and r.String2 is not null
-              and r.Hash = ?
               and u.Type in (100,101,102)
               and u.Last=1
               and u.Height is not null
-        )sql";
-
-        TryTransactionStep(__func__, [&]()
+              and r.Hash in ( )sql", R"sql( )
+        )sql", [&](sqlite3_stmt* stmt)
         {
-            auto stmt = SetupSqlStatement(sql);
-
-            TryBindStatementText(stmt, 1, userHash);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-            {
-                if (auto[ok, value] = TryGetColumnString(*stmt, 0); ok) result.pushKV("referrerAddress", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 1); ok) result.pushKV("referralName", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 2); ok) result.pushKV("referralAvatar", value);
-            }
-
-            FinalizeSqlStatement(*stmt);
+            auto[okKey, key] = TryGetColumnString(stmt, 0);
+            if (!okKey || result.count(key))
+                return;
+
+            UniValue record(UniValue::VOBJ);
+            if (auto[ok, value] = TryGetColumnString(stmt, 1); ok) record.pushKV("referrerAddress", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 2); ok) record.pushKV("referralName", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 3); ok) record.pushKV("referralAvatar", value);
+            result.emplace(key, record);
         });
 
         return result;
     }
 
-    UniValue NotifierRepository::GetPostInfoAddressByScore(const string &postScoreHash)
+    map<string, UniValue> NotifierRepository::GetPostInfoAddressByScore(const vector<string>& postScoreHashes)
     {
-        UniValue result(UniValue::VOBJ);
+        map<string, UniValue> result;
 
-        string sql = R"sql(
-            select score.String2 postTxHash,
+        SelectByKeys(__func__, postScoreHashes, R"sql(
+            select score.Hash,
+                   score.String2 postTxHash,
                    score.Int1 value,
                    post.String1 postAddress,
                    p.String2 as scoreName,
@@ -243,76 +197,68 @@ namespace PocketDb
             join Transactions u indexed by Transactions_Type_Last_String1_Height_Id on u.String1 = score.String1
             join Payload p on p.TxHash = u.Hash
             where score.Type in (300)
-              and score.Hash = ?
               and u.Type in (100,101,102)
               and u.Last=1
               and u.Height is not null
-        )sql";
-
-        TryTransactionStep(__func__, [&]()
+              and score.Hash in ( )sql", R"sql( )
+        )sql", [&](sqlite3_stmt* stmt)
         {
-            auto stmt = SetupSqlStatement(sql);
-
-            TryBindStatementText(stmt, 1, postScoreHash);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-            {
-                if (auto[ok, value] = TryGetColumnString(*stmt, 0); ok) result.pushKV("postTxHash", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 1); ok) result.pushKV("value", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 2); ok) result.pushKV("postAddress", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 3); ok) result.pushKV("scoreName", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 4); ok) result.pushKV("scoreAvatar", value);
-            }
-
-            FinalizeSqlStatement(*stmt);
+            auto[okKey, key] = TryGetColumnString(stmt, 0);
+            if (!okKey || result.count(key))
+                return;
+
+            UniValue record(UniValue::VOBJ);
+            if (auto[ok, value] = TryGetColumnString(stmt, 1); ok) record.pushKV("postTxHash", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 2); ok) record.pushKV("value", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 3); ok) record.pushKV("postAddress", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 4); ok) record.pushKV("scoreName", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 5); ok) record.pushKV("scoreAvatar", value);
+            result.emplace(key, record);
         });
 
         return result;
     }
 
-    UniValue NotifierRepository::GetSubscribeAddressTo(const string &subscribeHash)
+    map<string, UniValue> NotifierRepository::GetSubscribeAddressTo(const vector<string>& subscribeHashes)
     {
-        UniValue result(UniValue::VOBJ);
+        map<string, UniValue> result;
 
-        string sql = R"sql(
-            select s.String2 addressTo,
+        SelectByKeys(__func__, subscribeHashes, R"sql(
+            select s.Hash,
+                  s.String2 addressTo,
                   p.String2 as nameFrom,
                   p.String3 as avatarFrom
             from Transactions s
             join Transactions u indexed by Transactions_Type_Last_String1_Height_Id on u.String1 = s.String1
             join Payload p on p.TxHash = u.Hash
             where s.Type in (302, 303, 304)
-              and s.Hash = ?
               and u.Type in (100,101,102)
               and u.Last=1
               and u.Height is not null
-        )sql";
-
-        TryTransactionStep(__func__, [&]()
+              and s.Hash in ( )sql", R"sql( )
+        )sql", [&](sqlite3_stmt* stmt)
         {
-            auto stmt = SetupSqlStatement(sql);
-
-            TryBindStatementText(stmt, 1, subscribeHash);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-            {
-                if (auto[ok, value] = TryGetColumnString(*stmt, 0); ok) result.pushKV("addressTo", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 1); ok) result.pushKV("nameFrom", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 2); ok) result.pushKV("avatarFrom", value);
-            }
-
-            FinalizeSqlStatement(*stmt);
+            auto[okKey, key] = TryGetColumnString(stmt, 0);
+            if (!okKey || result.count(key))
+                return;
+
+            UniValue record(UniValue::VOBJ);
+            if (auto[ok, value] = TryGetColumnString(stmt, 1); ok) record.pushKV("addressTo", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 2); ok) record.pushKV("nameFrom", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 3); ok) record.pushKV("avatarFrom", value);
+            result.emplace(key, record);
         });
 
         return result;
     }
 
-    UniValue NotifierRepository::GetCommentInfoAddressByScore(const string &commentScoreHash)
+    map<string, UniValue> NotifierRepository::GetCommentInfoAddressByScore(const vector<string>& commentScoreHashes)
     {
-        UniValue result(UniValue::VOBJ);
+        map<string, UniValue> result;
 
-        string sql = R"sql(
+        SelectByKeys(__func__, commentScoreHashes, R"sql(
             select
+                score.Hash,
                 score.String2 commentHash,
                 score.Int1 value,
                 comment.String1 commentAddress,
@@ -322,38 +268,35 @@ namespace PocketDb
             join Transactions comment on score.String2 = comment.Hash
             join Transactions u indexed by Transactions_Type_Last_String1_Height_Id on u.String1 = score.String1
             join Payload p on p.TxHash = u.Hash
-            where score.Hash = ?
-                and u.Type in (100,101,102)
+            where u.Type in (100,101,102)
                 and u.Last=1
                 and u.Height is not null
-        )sql";
-
-        TryTransactionStep(__func__, [&]()
+                and score.Hash in ( )sql", R"sql( )
+        )sql", [&](sqlite3_stmt* stmt)
         {
-            auto stmt = SetupSqlStatement(sql);
-            TryBindStatementText(stmt, 1, commentScoreHash);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-            {
-                if (auto[ok, value] = TryGetColumnString(*stmt, 0); ok) result.pushKV("commentHash", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 1); ok) result.pushKV("value", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 2); ok) result.pushKV("commentAddress", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 2); ok) result.pushKV("scoreCommentName", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 2); ok) result.pushKV("scoreCommentAvatar", value);
-            }
-
-            FinalizeSqlStatement(*stmt);
+            auto[okKey, key] = TryGetColumnString(stmt, 0);
+            if (!okKey || result.count(key))
+                return;
+
+            UniValue record(UniValue::VOBJ);
+            if (auto[ok, value] = TryGetColumnString(stmt, 1); ok) record.pushKV("commentHash", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 2); ok) record.pushKV("value", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 3); ok) record.pushKV("commentAddress", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 4); ok) record.pushKV("scoreCommentName", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 5); ok) record.pushKV("scoreCommentAvatar", value);
+            result.emplace(key, record);
         });
 
         return result;
     }
 
-    UniValue NotifierRepository::GetFullCommentInfo(const string &commentHash)
+    map<string, UniValue> NotifierRepository::GetFullCommentInfo(const vector<string>& commentHashes)
     {
-        UniValue result(UniValue::VOBJ);
+        map<string, UniValue> result;
 
-        string sql = R"sql(
+        SelectByKeys(__func__, commentHashes, R"sql(
             select
+                comment.Hash,
                 comment.String3 PostHash,
                 comment.String4 ParentHash,
                 comment.String5 AnswerHash,
@@ -375,71 +318,86 @@ namespace PocketDb
             left join Transactions answer indexed by Transactions_Type_Last_String2_Height
                 on answer.Type in (204, 205) and answer.Last = 1 and answer.String2 = comment.String5
             WHERE comment.Type in (204, 205)
-              and comment.Hash = ?
               and u.Type in (100,101,102)
               and u.Last=1
               and u.Height is not null
-        )sql";
-
-        TryTransactionStep(__func__, [&]()
+              and comment.Hash in ( )sql", R"sql( )
+        )sql", [&](sqlite3_stmt* stmt)
         {
-            auto stmt = SetupSqlStatement(sql);
-
-            TryBindStatementText(stmt, 1, commentHash);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
+            auto[okKey, key] = TryGetColumnString(stmt, 0);
+            if (!okKey || result.count(key))
+                return;
+
+            UniValue record(UniValue::VOBJ);
+            if (auto[ok, value] = TryGetColumnString(stmt, 1); ok) record.pushKV("postHash", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 2); ok) record.pushKV("parentHash", value); else record.pushKV("parentHash", "");
+            if (auto[ok, value] = TryGetColumnString(stmt, 3); ok) record.pushKV("answerHash", value); else record.pushKV("answerHash", "");
+            if (auto[ok, value] = TryGetColumnString(stmt, 4); ok) record.pushKV("rootHash", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 5); ok) record.pushKV("postAddress", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 6); ok) record.pushKV("answerAddress", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 7); ok) record.pushKV("commentName", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 8); ok) record.pushKV("commentAvatar", value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 9); ok)
             {
-                if (auto[ok, value] = TryGetColumnString(*stmt, 0); ok) result.pushKV("postHash", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 1); ok) result.pushKV("parentHash", value); else result.pushKV("parentHash", "");
-                if (auto[ok, value] = TryGetColumnString(*stmt, 2); ok) result.pushKV("answerHash", value); else result.pushKV("answerHash", "");
-                if (auto[ok, value] = TryGetColumnString(*stmt, 3); ok) result.pushKV("rootHash", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 4); ok) result.pushKV("postAddress", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 5); ok) result.pushKV("answerAddress", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 6); ok) result.pushKV("commentName", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 7); ok) result.pushKV("commentAvatar", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 8); ok)
-                {
-                    result.pushKV("donation", "true");
-                    result.pushKV("amount", value);
-                }
+                record.pushKV("donation", "true");
+                record.pushKV("amount", value);
             }
-
-            FinalizeSqlStatement(*stmt);
+            result.emplace(key, record);
         });
 
         return result;
     }
 
-    UniValue NotifierRepository::GetPostCountFromMySubscribes(const string& address, int height)
+    map<string, string> NotifierRepository::GetPostLangs(const vector<string>& postHashes)
     {
-        UniValue result(UniValue::VOBJ);
+        map<string, string> result;
 
-        string sql = R"sql(
-            select count(1)
-            from Transactions sub
-            join Transactions post
-                on post.String1 = sub.String2 and post.Type in (200, 201, 202, 203) and post.Last = 1
-            where sub.Type in (302, 303)
-              and sub.Last = 1
-              and post.Height = ?
-              and sub.String1 = ?
-        )sql";
-
-        TryTransactionStep(__func__, [&]()
+        SelectByKeys(__func__, postHashes, R"sql(
+            select t.Hash, p.String1 Lang
+            from Transactions t
+            join Payload p on p.TxHash = t.Hash
+            where t.Type in (200, 201, 202, 203)
+              and t.Hash in ( )sql", R"sql( )
+        )sql", [&](sqlite3_stmt* stmt)
         {
-            auto stmt = SetupSqlStatement(sql);
-
-            TryBindStatementInt(stmt, 1, height);
-            TryBindStatementText(stmt, 2, address);
+            auto[okHash, hash] = TryGetColumnString(stmt, 0);
+            auto[okLang, lang] = TryGetColumnString(stmt, 1);
+            if (okHash && okLang) result.emplace(hash, lang);
+        });
 
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-            {
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok) result.pushKV("count", value);
-            }
+        return result;
+    }
 
-            FinalizeSqlStatement(*stmt);
+    map<string, int> NotifierRepository::GetPostCountFromMySubscribes(const vector<string>& addresses, int height)
+    {
+        map<string, int> result;
+
+        SelectByKeys(__func__, addresses, R"sql(
+            select sub.String1, count(1)
+            from Transactions post
+            join Transactions sub
+                on sub.String2 = post.String1 and sub.Type in (302, 303) and sub.Last = 1
+            where post.Type in (200, 201, 202, 203)
+              and post.Last = 1
+              and post.Height = ?
+              and sub.String1 in ( )sql", R"sql( )
+            group by sub.String1
+        )sql", [&](auto& stmt)
+        {
+            TryBindStatementInt(stmt, 1, height);
+            return 2;
+        }, [&](sqlite3_stmt* stmt)
+        {
+            auto[okAddress, address] = TryGetColumnString(stmt, 0);
+            auto[okCount, count] = TryGetColumnInt(stmt, 1);
+            if (okAddress && okCount) result.emplace(address, count);
+        }, [&](size_t begin, size_t end)
+        {
+            // Addresses without posts from subscriptions are counted as zero
+            for (size_t j = begin; j < end; j++)
+                result.emplace(addresses[j], 0);
         });
 
         return result;
     }
-}
\ No newline at end of file
+}
@@ -9,6 +9,8 @@
 
 namespace PocketDb
 {
+    using boost::algorithm::join;
+
     class NotifierRepository : public BaseRepository
     {
     public:
@@ -18,16 +20,58 @@ namespace PocketDb
         void Destroy() override;
 
         UniValue GetAccountInfoByAddress(const string& address);
-        UniValue GetPostLang(const string& postHash);
-        UniValue GetPostInfo(const string& postHash);
-        UniValue GetOriginalPostAddressByRepost(const string& repostHash);
-        UniValue GetPrivateSubscribeAddressesByAddressTo(const string& addressTo);
-        UniValue GetUserReferrerAddress(const string& userHash);
-        UniValue GetPostInfoAddressByScore(const string& postScoreHash);
-        UniValue GetSubscribeAddressTo(const string& subscribeHash);
-        UniValue GetCommentInfoAddressByScore(const string& commentScoreHash);
-        UniValue GetFullCommentInfo(const string& commentHash);
-        UniValue GetPostCountFromMySubscribes(const string& address, int height);
+
+        // Batched queries for block notifications: one query per chunk of keys instead of one per key.
+        // Results are keyed by the requested hash or address, keys without data are absent.
+        map<string, UniValue> GetPostInfo(const vector<string>& postHashes);
+        map<string, UniValue> GetOriginalPostAddressByRepost(const vector<string>& repostHashes);
+        map<string, UniValue> GetPrivateSubscribeAddressesByAddressTo(const vector<string>& addressesTo);
+        map<string, UniValue> GetUserReferrerAddress(const vector<string>& userHashes);
+        map<string, UniValue> GetPostInfoAddressByScore(const vector<string>& postScoreHashes);
+        map<string, UniValue> GetSubscribeAddressTo(const vector<string>& subscribeHashes);
+        map<string, UniValue> GetCommentInfoAddressByScore(const vector<string>& commentScoreHashes);
+        map<string, UniValue> GetFullCommentInfo(const vector<string>& commentHashes);
+        map<string, string> GetPostLangs(const vector<string>& postHashes);
+        // Every requested address gets a count, so an absent address means the query failed
+        map<string, int> GetPostCountFromMySubscribes(const vector<string>& addresses, int height);
+
+    private:
+        static const size_t BATCH_SIZE = 500;
+
+        // Executes sqlBegin + placeholders + sqlEnd for every chunk of keys and calls read for each row
+        template<typename T>
+        void SelectByKeys(const string& func, const vector<string>& keys, const string& sqlBegin, const string& sqlEnd, T read)
+        {
+            SelectByKeys(func, keys, sqlBegin, sqlEnd, [](auto&) { return 1; }, read, [](size_t, size_t) {});
+        }
+
+        // Same with parameters before the keys: bind sets them and returns index of the first key.
+        // done is called with range of keys of every chunk queried without errors
+        template<typename B, typename T, typename D>
+        void SelectByKeys(const string& func, const vector<string>& keys, const string& sqlBegin, const string& sqlEnd, B bind, T read, D done)
+        {
+            for (size_t begin = 0; begin < keys.size(); begin += BATCH_SIZE)
+            {
+                auto end = min(keys.size(), begin + BATCH_SIZE);
+                auto sql = sqlBegin + join(vector<string>(end - begin, "?"), ",") + sqlEnd;
+
+                TryTransactionStep(func, [&]()
+                {
+                    auto stmt = SetupSqlStatement(sql);
+
+                    int i = bind(stmt);
+                    for (size_t j = begin; j < end; j++)
+                        TryBindStatementText(stmt, i++, keys[j]);
+
+                    while (sqlite3_step(*stmt) == SQLITE_ROW)
+                        read(*stmt);
+
+                    FinalizeSqlStatement(*stmt);
+
+                    done(begin, end);
+                });
+            }
+        }
     };
 }
 
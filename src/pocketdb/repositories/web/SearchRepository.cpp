@@ -663,4 +663,174 @@ namespace PocketDb
 
         return result;
     }
+
+    int64_t SearchRepository::GetAccountId(const string& address)
+    {
+        int64_t result = -1;
+
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmt = SetupSqlStatement(R"sql(
+                select u.Id
+                from Transactions u indexed by Transactions_Type_Last_String1_Height_Id
+                where u.Type in (100)
+                  and u.Last = 1
+                  and u.String1 = ?
+                  and u.Height > 0
+            )sql");
+            TryBindStatementText(stmt, 1, address);
+
+            if (sqlite3_step(*stmt) == SQLITE_ROW)
+                if (auto[ok, value] = TryGetColumnInt64(*stmt, 0); ok)
+                    result = value;
+
+            FinalizeSqlStatement(*stmt);
+        });
+
+        return result;
+    }
+
+    int64_t SearchRepository::GetContentId(const string& contentHash)
+    {
+        int64_t result = -1;
+
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmt = SetupSqlStatement(R"sql(
+                select c.Id
+                from Transactions c indexed by Transactions_Type_Last_String2_Height
+                where c.Type in (200, 201, 202, 207)
+                  and c.Last = 1
+                  and c.String2 = ?
+                  and c.Height > 0
+            )sql");
+            TryBindStatementText(stmt, 1, contentHash);
+
+            if (sqlite3_step(*stmt) == SQLITE_ROW)
+                if (auto[ok, value] = TryGetColumnInt64(*stmt, 0); ok)
+                    result = value;
+
+            FinalizeSqlStatement(*stmt);
+        });
+
+        return result;
+    }
+
+    UniValue SearchRepository::GetRecomendedAccountsByIds(const vector<int64_t>& ids)
+    {
+        UniValue result(UniValue::VARR);
+
+        if (ids.empty())
+            return result;
+
+        string sql = R"sql(
+            select
+                u.Id,
+                u.String1 as address,
+                p.String2 as name,
+                p.String3 as avatar
+
+                , ifnull((
+                    select r.Value
+                    from Ratings r indexed by Ratings_Type_Id_Last_Height
+                    where r.Type=0 and r.Id=u.Id and r.Last=1)
+                ,0) as Reputation
+
+                , (
+                    select count(*)
+                    from Transactions subs indexed by Transactions_Type_Last_String2_Height
+                    where subs.Type in (302,303) and subs.Height is not null and subs.Last = 1 and subs.String2 = u.String1
+                ) as SubscribersCount
+            from Transactions u indexed by Transactions_Last_Id_Height
+            cross join Payload p on p.TxHash = u.Hash
+            where u.Last = 1
+              and u.Id in ( )sql" + join(vector<string>(ids.size(), "?"), ",") + R"sql( )
+              and u.Type in (100,101,102)
+              and u.Height is not null
+        )sql";
+
+        // Records in the order of ids
+        map<int64_t, UniValue> records;
+
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmt = SetupSqlStatement(sql);
+
+            int i = 1;
+            for (const auto& id : ids)
+                TryBindStatementInt64(stmt, i++, id);
+
+            while (sqlite3_step(*stmt) == SQLITE_ROW)
+            {
+                auto[okId, id] = TryGetColumnInt64(*stmt, 0);
+                if (!okId) continue;
+
+                UniValue record(UniValue::VOBJ);
+                if (auto[ok, value] = TryGetColumnString(*stmt, 1); ok) record.pushKV("address", value);
+                if (auto[ok, value] = TryGetColumnString(*stmt, 2); ok) record.pushKV("name", value);
+                if (auto[ok, value] = TryGetColumnString(*stmt, 3); ok) record.pushKV("avatar", value);
+                if (auto[ok, value] = TryGetColumnInt(*stmt, 4); ok) record.pushKV("reputation", value / 10.0);
+                if (auto[ok, value] = TryGetColumnInt(*stmt, 5); ok) record.pushKV("subscribers_count", value);
+                records.emplace(id, record);
+            }
+
+            FinalizeSqlStatement(*stmt);
+        });
+
+        for (const auto& id : ids)
+            if (auto itr = records.find(id); itr != records.end())
+                result.push_back(itr->second);
+
+        return result;
+    }
+
+    UniValue SearchRepository::GetRecomendedContentsByIds(const vector<int64_t>& ids)
+    {
+        UniValue result(UniValue::VARR);
+
+        if (ids.empty())
+            return result;
+
+        string sql = R"sql(
+            select c.Id, c.String2
+            from Transactions c indexed by Transactions_Last_Id_Height
+            where c.Last = 1
+              and c.Id in ( )sql" + join(vector<string>(ids.size(), "?"), ",") + R"sql( )
+              and c.Type in (200, 201, 202)
+              and c.Height > 0
+        )sql";
+
+        map<int64_t, string> hashes;
+
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmt = SetupSqlStatement(sql);
+
+            int i = 1;
+            for (const auto& id : ids)
+                TryBindStatementInt64(stmt, i++, id);
+
+            while (sqlite3_step(*stmt) == SQLITE_ROW)
+            {
+                auto[okId, id] = TryGetColumnInt64(*stmt, 0);
+                auto[okHash, hash] = TryGetColumnString(*stmt, 1);
+                if (okId && okHash)
+                    hashes.emplace(id, hash);
+            }
+
+            FinalizeSqlStatement(*stmt);
+        });
+
+        for (const auto& id : ids)
+        {
+            if (auto itr = hashes.find(id); itr != hashes.end())
+            {
+                UniValue record(UniValue::VOBJ);
+                record.pushKV("contentid", itr->second);
+                result.push_back(record);
+            }
+        }
+
+        return result;
+    }
 }
\ No newline at end of file
@@ -39,6 +39,12 @@ namespace PocketDb
         UniValue GetRecomendedAccountsByTags(const vector<string>& tags, int nHeight, int depth = 1000, int cntOut = 10);
         UniValue GetRecomendedContentsByScoresOnSimilarContents(const string& contentid, const vector<int>& contentTypes, int depth = 1000, int cntOut = 10);
         UniValue GetRecomendedContentsByScoresFromAddress(const string& address, const vector<int>& contentTypes, int nHeight, int depth = 1000, int cntOut = 10);
+
+        // Lookups and results of recommendations walked on social graph; -1 if id is not found
+        int64_t GetAccountId(const string& address);
+        int64_t GetContentId(const string& contentHash);
+        UniValue GetRecomendedAccountsByIds(const vector<int64_t>& ids);
+        UniValue GetRecomendedContentsByIds(const vector<int64_t>& ids);
     };
 
     typedef shared_ptr<SearchRepository> SearchRepositoryRef;
@@ -3,10 +3,44 @@
 // https://www.apache.org/licenses/LICENSE-2.0
 
 #include "pocketdb/repositories/web/WebRepository.h"
+#include "util/html.h"
 
 namespace PocketDb
 {
-    void WebRepository::Init() {}
+    static void SqlUrlDecode(sqlite3_context* ctx, int argc, sqlite3_value** argv)
+    {
+        if (sqlite3_value_type(argv[0]) == SQLITE_NULL)
+        {
+            sqlite3_result_null(ctx);
+            return;
+        }
+
+        string value = HtmlUtils::UrlDecode(reinterpret_cast<const char*>(sqlite3_value_text(argv[0])));
+        sqlite3_result_text(ctx, value.c_str(), (int) value.size(), SQLITE_TRANSIENT);
+    }
+
+    static void SqlTagValue(sqlite3_context* ctx, int argc, sqlite3_value** argv)
+    {
+        if (sqlite3_value_type(argv[0]) == SQLITE_NULL)
+        {
+            sqlite3_result_null(ctx);
+            return;
+        }
+
+        string value = HtmlUtils::UrlDecode(reinterpret_cast<const char*>(sqlite3_value_text(argv[0])));
+        HtmlUtils::StringToLower(value);
+        sqlite3_result_text(ctx, value.c_str(), (int) value.size(), SQLITE_TRANSIENT);
+    }
+
+    // Same decoding as WebPostProcessor applies to single blocks
+    void WebRepository::Init()
+    {
+        int flags = SQLITE_UTF8 | SQLITE_DETERMINISTIC;
+
+        if (sqlite3_create_function_v2(m_database.m_db, "url_decode", 1, flags, nullptr, &SqlUrlDecode, nullptr, nullptr, nullptr) != SQLITE_OK ||
+            sqlite3_create_function_v2(m_database.m_db, "tag_value", 1, flags, nullptr, &SqlTagValue, nullptr, nullptr, nullptr) != SQLITE_OK)
+            throw std::runtime_error(strprintf("%s: Failed register SQL functions\n", __func__));
+    }
 
     void WebRepository::Destroy() {}
 
@@ -287,4 +321,263 @@ namespace PocketDb
             );
         });
     }
-}
\ No newline at end of file
+
+    void WebRepository::RebuildContentTags(int fromHeight, int toHeight)
+    {
+        string contents = R"sql(
+            from Transactions p indexed by Transactions_Height_Id
+            join Payload pp on pp.TxHash = p.Hash
+            join json_each(pp.String4)
+            where p.Height between ? and ?
+              and p.Type in (200, 201, 202)
+              and p.Last = 1
+              and pp.String1 is not null
+              and json_each.value is not null
+        )sql";
+
+        TryTransactionStep(__func__, [&]()
+        {
+            auto tagsStmt = SetupSqlStatement(R"sql(
+                insert or ignore
+                into web.Tags (Lang, Value)
+                select distinct pp.String1, tag_value(json_each.value)
+            )sql" + contents);
+            TryBindStatementInt(tagsStmt, 1, fromHeight);
+            TryBindStatementInt(tagsStmt, 2, toHeight);
+            TryStepStatement(tagsStmt);
+
+            auto delStmt = SetupSqlStatement(R"sql(
+                delete from web.TagsMap
+                where ContentId in (
+                    select p.Id
+                    from Transactions p indexed by Transactions_Height_Id
+                    where p.Height between ? and ?
+                      and p.Type in (200, 201, 202)
+                      and p.Last = 1
+                )
+            )sql");
+            TryBindStatementInt(delStmt, 1, fromHeight);
+            TryBindStatementInt(delStmt, 2, toHeight);
+            TryStepStatement(delStmt);
+
+            auto mapStmt = SetupSqlStatement(R"sql(
+                insert or ignore
+                into web.TagsMap (ContentId, TagId)
+                select distinct p.Id, (select t.Id from web.Tags t where t.Lang = pp.String1 and t.Value = tag_value(json_each.value))
+            )sql" + contents);
+            TryBindStatementInt(mapStmt, 1, fromHeight);
+            TryBindStatementInt(mapStmt, 2, toHeight);
+            TryStepStatement(mapStmt);
+        });
+    }
+
+    void WebRepository::RebuildContent(int fromHeight, int toHeight)
+    {
+        // Indexed fields of last editions - same as GetContent
+        vector<tuple<TxType, ContentFieldType, int>> fields = {
+            { ACCOUNT_USER, ContentFieldType_AccountUserName, 2 },
+            { ACCOUNT_USER, ContentFieldType_AccountUserAbout, 4 },
+            { CONTENT_POST, ContentFieldType_ContentPostCaption, 2 },
+            { CONTENT_POST, ContentFieldType_ContentPostMessage, 3 },
+            { CONTENT_VIDEO, ContentFieldType_ContentVideoCaption, 2 },
+            { CONTENT_VIDEO, ContentFieldType_ContentVideoMessage, 3 },
+        };
+
+        string ids = R"sql(
+            select t.Id
+            from Transactions t indexed by Transactions_Height_Id
+            where t.Height between ? and ?
+              and t.Type in (100, 200, 201)
+              and t.Last = 1
+        )sql";
+
+        string source = R"sql(
+            with
+                fields (TxType, FieldType, Field) as (
+                    values )sql" + join(vector<string>(fields.size(), "(?,?,?)"), ",") + R"sql(
+                ),
+                source as (
+                    select
+                        t.Id,
+                        f.FieldType,
+                        (case f.Field when 2 then p.String2 when 3 then p.String3 when 4 then p.String4 end) Value
+                    from Transactions t indexed by Transactions_Height_Id
+                    cross join fields f on f.TxType = t.Type
+                    join Payload p on p.TxHash = t.Hash
+                    where t.Height between ? and ?
+                      and t.Type in (100, 200, 201)
+                      and t.Last = 1
+                )
+        )sql";
+
+        auto bindSource = [&](shared_ptr<sqlite3_stmt*>& stmt)
+        {
+            int i = 1;
+            for (const auto& [txType, fieldType, field] : fields)
+            {
+                TryBindStatementInt(stmt, i++, (int) txType);
+                TryBindStatementInt(stmt, i++, (int) fieldType);
+                TryBindStatementInt(stmt, i++, field);
+            }
+            TryBindStatementInt(stmt, i++, fromHeight);
+            TryBindStatementInt(stmt, i++, toHeight);
+        };
+
+        TryTransactionStep(__func__, [&]()
+        {
+            auto delContentStmt = SetupSqlStatement(R"sql(
+                delete from web.Content
+                where ROWID in (
+                    select cm.ROWID from web.ContentMap cm where cm.ContentId in ( )sql" + ids + R"sql( )
+                )
+            )sql");
+            TryBindStatementInt(delContentStmt, 1, fromHeight);
+            TryBindStatementInt(delContentStmt, 2, toHeight);
+            TryStepStatement(delContentStmt);
+
+            auto delContentMapStmt = SetupSqlStatement(R"sql(
+                delete from web.ContentMap
+                where ContentId in ( )sql" + ids + R"sql( )
+            )sql");
+            TryBindStatementInt(delContentMapStmt, 1, fromHeight);
+            TryBindStatementInt(delContentMapStmt, 2, toHeight);
+            TryStepStatement(delContentMapStmt);
+
+            auto mapStmt = SetupSqlStatement(source + R"sql(
+                insert or ignore into web.ContentMap (ContentId, FieldType)
+                select s.Id, s.FieldType
+                from source s
+                where s.Value is not null
+            )sql");
+            bindSource(mapStmt);
+            TryStepStatement(mapStmt);
+
+            auto contentStmt = SetupSqlStatement(source + R"sql(
+                replace into web.Content (ROWID, Value)
+                select cm.ROWID, url_decode(s.Value)
+                from source s
+                join web.ContentMap cm on cm.ContentId = s.Id and cm.FieldType = s.FieldType
+                where s.Value is not null
+            )sql");
+            bindSource(contentStmt);
+            TryStepStatement(contentStmt);
+        });
+    }
+
+    // Account and content ids of graph actions; contents are referenced by their root tx hash
+    static const string SocialGraphAccountJoin = R"sql(
+        cross join Transactions u indexed by Transactions_Type_Last_String1_Height_Id
+            on u.Type in (100) and u.Last = 1 and u.String1 = t.String1 and u.Height > 0
+    )sql";
+
+    vector<SocialGraphAction> WebRepository::GetSocialGraph(int height)
+    {
+        vector<SocialGraphAction> result;
+
+        // State of every object as of height: the last content edition,
+        // all likes and the last action for every subscription pair
+        string contentsSql = R"sql(
+            select t.Type, u.Id, t.Id, max(t.Height)
+            from Transactions t indexed by Transactions_Type_Last_String1_Height_Id
+        )sql" + SocialGraphAccountJoin + R"sql(
+            where t.Type in (200, 201, 202, 207)
+              and t.Last in (0, 1)
+              and t.Height <= ?
+            group by t.Id
+        )sql";
+
+        string likesSql = R"sql(
+            select t.Type, u.Id, c.Id, t.Height
+            from Transactions t indexed by Transactions_Type_Last_String1_Height_Id
+        )sql" + SocialGraphAccountJoin + R"sql(
+            cross join Transactions c indexed by Transactions_Type_Last_String2_Height
+                on c.Type in (200, 201, 202, 207) and c.Last = 1 and c.String2 = t.String2 and c.Height > 0
+            where t.Type in (300)
+              and t.Last in (0, 1)
+              and t.Int1 > 3
+              and t.Height <= ?
+        )sql";
+
+        string subscribesSql = R"sql(
+            select t.Type, u.Id, ut.Id, max(t.Height)
+            from Transactions t indexed by Transactions_Type_Last_String1_String2_Height
+        )sql" + SocialGraphAccountJoin + R"sql(
+            cross join Transactions ut indexed by Transactions_Type_Last_String1_Height_Id
+                on ut.Type in (100) and ut.Last = 1 and ut.String1 = t.String2 and ut.Height > 0
+            where t.Type in (302, 303, 304)
+              and t.Last in (0, 1)
+              and t.Height <= ?
+            group by t.String1, t.String2
+        )sql";
+
+        TryTransactionStep(__func__, [&]()
+        {
+            for (const auto& sql : { contentsSql, likesSql, subscribesSql })
+            {
+                auto stmt = SetupSqlStatement(sql);
+                TryBindStatementInt(stmt, 1, height);
+
+                ReadSocialGraphActions(*stmt, result);
+
+                FinalizeSqlStatement(*stmt);
+            }
+        });
+
+        return result;
+    }
+
+    vector<SocialGraphAction> WebRepository::GetSocialGraphActions(const string& blockHash)
+    {
+        vector<SocialGraphAction> result;
+
+        string sql = R"sql(
+            select
+                t.Type,
+                u.Id,
+                (case
+                    when t.Type in (300) then c.Id
+                    when t.Type in (302, 303, 304) then ut.Id
+                    else t.Id
+                end),
+                t.Height
+            from Transactions t indexed by Transactions_BlockHash
+        )sql" + SocialGraphAccountJoin + R"sql(
+            left join Transactions c indexed by Transactions_Type_Last_String2_Height
+                on t.Type in (300) and c.Type in (200, 201, 202, 207) and c.Last = 1 and c.String2 = t.String2 and c.Height > 0
+            left join Transactions ut indexed by Transactions_Type_Last_String1_Height_Id
+                on t.Type in (302, 303, 304) and ut.Type in (100) and ut.Last = 1 and ut.String1 = t.String2 and ut.Height > 0
+            where t.BlockHash = ?
+              and (t.Type in (200, 201, 202, 207, 302, 303, 304) or (t.Type in (300) and t.Int1 > 3))
+            order by t.BlockNum
+        )sql";
+
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmt = SetupSqlStatement(sql);
+            TryBindStatementText(stmt, 1, blockHash);
+
+            ReadSocialGraphActions(*stmt, result);
+
+            FinalizeSqlStatement(*stmt);
+        });
+
+        return result;
+    }
+
+    void WebRepository::ReadSocialGraphActions(sqlite3_stmt* stmt, vector<SocialGraphAction>& result)
+    {
+        while (sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            auto[okType, type] = TryGetColumnInt(stmt, 0);
+            auto[okFrom, from] = TryGetColumnInt64(stmt, 1);
+            auto[okTo, to] = TryGetColumnInt64(stmt, 2);
+            auto[okHeight, height] = TryGetColumnInt(stmt, 3);
+
+            // Not resolved object - e.g. score of content not found
+            if (!okType || !okFrom || !okTo || !okHeight)
+                continue;
+
+            result.emplace_back((TxType) type, from, to, height);
+        }
+    }
+}
@@ -13,6 +13,7 @@
 #include "pocketdb/repositories/BaseRepository.h"
 #include "pocketdb/models/web/WebTag.h"
 #include "pocketdb/models/web/WebContent.h"
+#include "pocketdb/models/web/SocialGraphAction.h"
 
 namespace PocketDb
 {
@@ -34,6 +35,17 @@ namespace PocketDb
 
         vector<WebContent> GetContent(const string& blockHash);
         void UpsertContent(const vector<WebContent>& contentList);
+
+        // Set-based rebuild of tags and search content for last editions of contents in height range
+        void RebuildContentTags(int fromHeight, int toHeight);
+        void RebuildContent(int fromHeight, int toHeight);
+
+        // Social graph as of height and its changes by one block
+        vector<SocialGraphAction> GetSocialGraph(int height);
+        vector<SocialGraphAction> GetSocialGraphActions(const string& blockHash);
+
+    private:
+        void ReadSocialGraphActions(sqlite3_stmt* stmt, vector<SocialGraphAction>& result);
     };
 
     typedef shared_ptr<WebRepository> WebRepositoryRef;
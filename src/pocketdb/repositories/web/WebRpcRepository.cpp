@@ -3,6 +3,7 @@
 // https://www.apache.org/licenses/LICENSE-2.0
 
 #include "pocketdb/repositories/web/WebRpcRepository.h"
+#include "pocketdb/services/UnspentsCache.h"
 
 namespace PocketDb
 {
@@ -1507,6 +1508,67 @@ namespace PocketDb
     {
         UniValue result(UniValue::VARR);
 
+        // Hot addresses are served from memory, others are read by unspent outputs index
+        vector<UnspentOutput> outputs;
+        vector<string> missed;
+        set<string> requested;
+        for (const auto& address : addresses)
+        {
+            if (!requested.insert(address).second)
+                continue;
+
+            if (!PocketServices::UnspentsCacheInst.Get(address, outputs))
+                missed.push_back(address);
+        }
+
+        if (!missed.empty())
+        {
+            auto generation = PocketServices::UnspentsCacheInst.Generation();
+            auto loaded = GetUnspentOutputs(missed);
+
+            for (const auto& address : missed)
+            {
+                auto& addressOutputs = loaded[address];
+                outputs.insert(outputs.end(), addressOutputs.begin(), addressOutputs.end());
+                PocketServices::UnspentsCacheInst.Put(address, move(addressOutputs), generation);
+            }
+        }
+
+        stable_sort(outputs.begin(), outputs.end(), [](const UnspentOutput& a, const UnspentOutput& b)
+        {
+            return a.Height < b.Height;
+        });
+
+        // Exclude outputs already used as inputs in mempool
+        set<pair<string, uint32_t>> spent(mempoolInputs.begin(), mempoolInputs.end());
+
+        for (const auto& output : outputs)
+        {
+            if (spent.count({output.TxHash, (uint32_t) output.Number}))
+                continue;
+
+            UniValue record(UniValue::VOBJ);
+            record.pushKV("txid", output.TxHash);
+            record.pushKV("vout", output.Number);
+            record.pushKV("address", output.AddressHash);
+            record.pushKV("amount", ValueFromAmount(output.Value));
+            record.pushKV("amountSat", output.Value);
+            record.pushKV("scriptPubKey", output.ScriptPubKey);
+            record.pushKV("coinbase", output.TxType == 2 || output.TxType == 3);
+            record.pushKV("pockettx", output.TxType > 3);
+            record.pushKV("confirmations", height - output.Height);
+            record.pushKV("height", output.Height);
+
+            result.push_back(record);
+        }
+
+        return result;
+    }
+
+    map<string, vector<UnspentOutput>> WebRpcRepository::GetUnspentOutputs(const vector<string>& addresses)
+    {
+        map<string, vector<UnspentOutput>> result;
+
         string sql = R"sql(
             select
                 o.TxHash,
@@ -1516,7 +1578,7 @@ namespace PocketDb
                 o.ScriptPubKey,
                 t.Type,
                 o.TxHeight
-            from TxOutputs o indexed by TxOutputs_SpentHeight_AddressHash
+            from TxOutputs o indexed by TxOutputs_AddressHash_Unspent
             join Transactions t on t.Hash=o.TxHash
             where o.AddressHash in ( )sql" + join(vector<string>(addresses.size(), "?"), ",") + R"sql( )
               and o.TxHeight is not null
@@ -1534,45 +1596,23 @@ namespace PocketDb
 
             while (sqlite3_step(*stmt) == SQLITE_ROW)
             {
-                UniValue record(UniValue::VOBJ);
+                UnspentOutput output;
 
                 auto[ok0, txHash] = TryGetColumnString(*stmt, 0);
                 auto[ok1, txOut] = TryGetColumnInt(*stmt, 1);
-
-                string _txHash = txHash;
-                int _txOut = txOut;
-                // Exclude outputs already used as inputs in mempool
-                if (!ok0 || !ok1 || find_if(
-                    mempoolInputs.begin(),
-                    mempoolInputs.end(),
-                    [&](const pair<string, uint32_t>& itm)
-                    {
-                        return itm.first == _txHash && itm.second == _txOut;
-                    })  != mempoolInputs.end())
+                auto[ok2, address] = TryGetColumnString(*stmt, 2);
+                if (!ok0 || !ok1 || !ok2)
                     continue;
 
-                record.pushKV("txid", txHash);
-                record.pushKV("vout", txOut);
-
-                if (auto[ok, value] = TryGetColumnString(*stmt, 2); ok) record.pushKV("address", value);
-                if (auto[ok, value] = TryGetColumnInt64(*stmt, 3); ok)
-                {
-                    record.pushKV("amount", ValueFromAmount(value));
-                    record.pushKV("amountSat", value);
-                }
-                if (auto[ok, value] = TryGetColumnString(*stmt, 4); ok) record.pushKV("scriptPubKey", value);
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 5); ok)
-                {
-                    record.pushKV("coinbase", value == 2 || value == 3);
-                    record.pushKV("pockettx", value > 3);
-                }
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 6); ok)
-                {
-                    record.pushKV("confirmations", height - value);
-                    record.pushKV("height", value);
-                }
+                output.TxHash = txHash;
+                output.Number = txOut;
+                output.AddressHash = address;
+                if (auto[ok, value] = TryGetColumnInt64(*stmt, 3); ok) output.Value = value;
+                if (auto[ok, value] = TryGetColumnString(*stmt, 4); ok) output.ScriptPubKey = value;
+                if (auto[ok, value] = TryGetColumnInt(*stmt, 5); ok) output.TxType = value;
+                if (auto[ok, value] = TryGetColumnInt(*stmt, 6); ok) output.Height = value;
 
-                result.push_back(record);
+                result[address].push_back(move(output));
             }
 
             FinalizeSqlStatement(*stmt);
@@ -2264,6 +2304,32 @@ namespace PocketDb
             limit ?
         )sql";
 
+        // Same candidates from materialized feed - bound parameters keep their order
+        if (FeedRepository::IsReady())
+        {
+            sql = R"sql(
+                select f.Id
+
+                from web.Feed f indexed by Feed_Lang_Type_Height
+
+                join web.FeedAccounts a
+                    on a.AddressHash = f.AddressHash
+
+                where f.Lang = ?
+                    and f.Type in ( )sql" + join(vector<string>(contentTypes.size(), "?"), ",") + R"sql( )
+                    and f.Height <= ?
+                    and f.Height > ?
+                    and f.RelayTxHash is null
+                    and f.Rating > 0
+
+                    -- Do not show posts from users with low reputation
+                    and a.Rating > ?
+
+                order by f.Rating desc
+                limit ?
+            )sql";
+        }
+
         vector<int64_t> ids;
         TryTransactionStep(func, [&]()
         {
@@ -2655,9 +2721,15 @@ namespace PocketDb
 
         string contentTypesWhere = " ( " + join(vector<string>(contentTypes.size(), "?"), ",") + " ) ";
 
+        // Candidates from materialized feed when it follows the chain - bound parameters keep their order
+        bool feed = FeedRepository::IsReady();
+        string idColumn = feed ? "f.Id" : "t.Id";
+        string rootColumn = feed ? "f.RootTxHash" : "t.String2";
+        string addressColumn = feed ? "f.AddressHash" : "t.String1";
+
         string contentIdWhere;
         if (topContentId > 0)
-            contentIdWhere = " and t.Id < ? ";
+            contentIdWhere = " and " + idColumn + " < ? ";
 
         string langFilter;
         if (!lang.empty())
@@ -2688,10 +2760,32 @@ namespace PocketDb
                 )sql" + contentIdWhere + R"sql(
         )sql";
 
+        if (feed)
+        {
+            sql = string(R"sql(
+                select f.Id
+
+                from web.Feed f )sql") + (!lang.empty() ? "indexed by Feed_Lang_Id" : "not indexed") + R"sql(
+
+                join web.FeedAccounts a
+                    on a.AddressHash = f.AddressHash
+
+                where )sql" + (!lang.empty() ? "f.Lang = ? and" : "") + R"sql(
+                    f.Type in )sql" + contentTypesWhere + R"sql(
+                    and f.RelayTxHash is null
+                    and f.Height <= ?
+
+                    -- Do not show posts from users with low reputation
+                    and a.Rating > ?
+
+                    )sql" + contentIdWhere + R"sql(
+            )sql";
+        }
+
         if (!tags.empty())
         {
             sql += R"sql(
-                and t.id in (
+                and )sql" + idColumn + R"sql( in (
                     select tm.ContentId
                     from web.Tags tag indexed by Tags_Lang_Value_Id
                     join web.TagsMap tm indexed by TagsMap_TagId_ContentId
@@ -2702,11 +2796,11 @@ namespace PocketDb
             )sql";
         }
 
-        if (!txidsExcluded.empty()) sql += " and t.String2 not in ( " + join(vector<string>(txidsExcluded.size(), "?"), ",") + " ) ";
-        if (!adrsExcluded.empty()) sql += " and t.String1 not in ( " + join(vector<string>(adrsExcluded.size(), "?"), ",") + " ) ";
+        if (!txidsExcluded.empty()) sql += " and " + rootColumn + " not in ( " + join(vector<string>(txidsExcluded.size(), "?"), ",") + " ) ";
+        if (!adrsExcluded.empty()) sql += " and " + addressColumn + " not in ( " + join(vector<string>(adrsExcluded.size(), "?"), ",") + " ) ";
         if (!tagsExcluded.empty())
         {
-            sql += R"sql( and t.Id not in (
+            sql += R"sql( and )sql" + idColumn + R"sql( not in (
                 select tmEx.ContentId
                 from web.Tags tagEx indexed by Tags_Lang_Value_Id
                 join web.TagsMap tmEx indexed by TagsMap_TagId_ContentId
@@ -2716,7 +2810,7 @@ namespace PocketDb
              ) )sql";
         }
 
-        sql += " order by t.Id desc ";
+        sql += " order by " + idColumn + " desc ";
         sql += " limit ? ";
 
         // ---------------------------------------------
@@ -2802,6 +2896,12 @@ namespace PocketDb
 
         string contentTypesFilter = join(vector<string>(contentTypes.size(), "?"), ",");
 
+        // Candidates from materialized feed when it follows the chain - bound parameters keep their order
+        bool feed = FeedRepository::IsReady();
+        string idColumn = feed ? "f.Id" : "t.Id";
+        string rootColumn = feed ? "f.RootTxHash" : "t.String2";
+        string addressColumn = feed ? "f.AddressHash" : "t.String1";
+
         string langFilter;
         if (!lang.empty())
             langFilter += " join Payload p indexed by Payload_String1_TxHash on p.TxHash = t.Hash and p.String1 = ? ";
@@ -2855,9 +2955,51 @@ namespace PocketDb
                 and ifnull(ur.Value,0) > ?
         )sql";
 
+        if (feed)
+        {
+            sql = R"sql(
+                select
+                    (f.Id)ContentId,
+                    f.Rating ContentRating,
+                    a.Rating AccountRating,
+                    f.OrigHeight,
+
+                    ifnull((
+                        select sum(ifnull(pr.Value,0))
+                        from (
+                            select p.Id
+                            from Transactions p indexed by Transactions_Type_Last_String1_Height_Id
+                            where p.Type in ( )sql" + contentTypesFilter + R"sql( )
+                                and p.Last = 1
+                                and p.String1 = f.AddressHash
+                                and p.Height < f.OrigHeight
+                                and p.Height > (f.OrigHeight - ?)
+                            order by p.Height desc
+                            limit ?
+                        )q
+                        left join Ratings pr indexed by Ratings_Type_Id_Last_Height
+                            on pr.Type = 2 and pr.Id = q.Id and pr.Last = 1
+                    ), 0)SumRating
+
+                from web.Feed f indexed by )sql" + (!lang.empty() ? "Feed_Lang_Type_Height" : "Feed_Type_Height") + R"sql(
+
+                join web.FeedAccounts a
+                    on a.AddressHash = f.AddressHash
+
+                where )sql" + (!lang.empty() ? "f.Lang = ? and" : "") + R"sql(
+                    f.Type in ( )sql" + contentTypesFilter + R"sql( )
+                    and f.RelayTxHash is null
+                    and f.Height <= ?
+                    and f.Height > ?
+
+                    -- Do not show posts from users with low reputation
+                    and a.Rating > ?
+            )sql";
+        }
+
         if (!tags.empty())
         {
-            sql += R"sql( and t.id in (
+            sql += R"sql( and )sql" + idColumn + R"sql( in (
                 select tm.ContentId
                 from web.Tags tag indexed by Tags_Lang_Value_Id
                 join web.TagsMap tm indexed by TagsMap_TagId_ContentId
@@ -2867,11 +3009,11 @@ namespace PocketDb
             ) )sql";
         }
 
-        if (!txidsExcluded.empty()) sql += " and t.String2 not in ( " + join(vector<string>(txidsExcluded.size(), "?"), ",") + " ) ";
-        if (!adrsExcluded.empty()) sql += " and t.String1 not in ( " + join(vector<string>(adrsExcluded.size(), "?"), ",") + " ) ";
+        if (!txidsExcluded.empty()) sql += " and " + rootColumn + " not in ( " + join(vector<string>(txidsExcluded.size(), "?"), ",") + " ) ";
+        if (!adrsExcluded.empty()) sql += " and " + addressColumn + " not in ( " + join(vector<string>(adrsExcluded.size(), "?"), ",") + " ) ";
         if (!tagsExcluded.empty())
         {
-            sql += R"sql( and t.Id not in (
+            sql += R"sql( and )sql" + idColumn + R"sql( not in (
                 select tmEx.ContentId
                 from web.Tags tagEx indexed by Tags_Lang_Value_Id
                 join web.TagsMap tmEx indexed by TagsMap_TagId_ContentId
@@ -8,6 +8,8 @@
 #include "pocketdb/helpers/PocketnetHelper.h"
 #include "pocketdb/helpers/TransactionHelper.h"
 #include "pocketdb/repositories/BaseRepository.h"
+#include "pocketdb/repositories/web/FeedRepository.h"
+#include "pocketdb/models/web/UnspentOutput.h"
 
 #include <boost/algorithm/string/join.hpp>
 #include <boost/range/adaptor/transformed.hpp>
@@ -23,6 +25,7 @@ namespace PocketDb
     using namespace std;
     using namespace PocketTx;
     using namespace PocketHelpers;
+    using namespace PocketDbWeb;
 
     struct HierarchicalRecord
     {
@@ -135,6 +138,9 @@ namespace PocketDb
         double dekayContent =  0.96;
 
         vector<tuple<string, int64_t, UniValue>> GetAccountProfiles(const vector<string>& addresses, const vector<int64_t>& ids, bool shortForm);
+
+        // Confirmed unspent outputs of addresses grouped by address
+        map<string, vector<UnspentOutput>> GetUnspentOutputs(const vector<string>& addresses);
     };
 
     typedef shared_ptr<WebRpcRepository> WebRpcRepositoryRef;
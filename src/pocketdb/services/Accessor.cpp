@@ -33,19 +33,48 @@ namespace PocketServices
     }
 
     // Read block data for send via network
-    bool Accessor::GetBlock(const CBlock& block, string& data)
+    bool Accessor::GetBlock(const CBlock& block, string& data, bool binary)
     {
+        auto blockHash = block.GetHash();
+        if (BlockPayloadCacheInst.Get(blockHash, binary, data))
+            return true;
+
         PocketBlockRef pocketBlock;
         if (!GetBlock(block, pocketBlock))
             return false;
 
-        auto dataPtr = PocketServices::Serializer::SerializeBlock(*pocketBlock);
-        if (dataPtr)
-            data = dataPtr->write();
+        if (!pocketBlock)
+            return true;
+
+        if (binary)
+        {
+            data = PocketServices::Serializer::SerializeBlockBinary(*pocketBlock);
+        }
+        else
+        {
+            auto dataPtr = PocketServices::Serializer::SerializeBlock(*pocketBlock);
+            if (dataPtr)
+                data = dataPtr->write();
+        }
 
+        BlockPayloadCacheInst.Put(blockHash, binary, data);
         return true;
     }
 
+    void Accessor::CacheBlock(const CBlock& block, const PocketBlockRef& pocketBlock)
+    {
+        if (!pocketBlock)
+            return;
+
+        auto blockHash = block.GetHash();
+        if (!BlockPayloadCacheInst.Exists(blockHash, true))
+            BlockPayloadCacheInst.Put(blockHash, true, PocketServices::Serializer::SerializeBlockBinary(*pocketBlock));
+
+        if (!BlockPayloadCacheInst.Exists(blockHash, false))
+            if (auto dataPtr = PocketServices::Serializer::SerializeBlock(*pocketBlock))
+                BlockPayloadCacheInst.Put(blockHash, false, dataPtr->write());
+    }
+
     bool Accessor::GetTransaction(const CTransaction& tx, PTransactionRef& pocketTx)
     {
         pocketTx = PocketDb::TransRepoInst.Get(tx.GetHash().GetHex(), true);
@@ -53,7 +82,7 @@ namespace PocketServices
     }
 
     // Read transaction data for send via network
-    bool Accessor::GetTransaction(const CTransaction& tx, string& data)
+    bool Accessor::GetTransaction(const CTransaction& tx, string& data, bool binary)
     {
         if (!PocketHelpers::TransactionHelper::IsPocketSupportedTransaction(tx))
             return true;
@@ -62,6 +91,12 @@ namespace PocketServices
         if (!GetTransaction(tx, pocketTx) || !pocketTx)
             return false;
             
+        if (binary)
+        {
+            data = PocketServices::Serializer::SerializeTransactionBinary(*pocketTx);
+            return true;
+        }
+
         auto dataPtr = PocketServices::Serializer::SerializeTransaction(*pocketTx);
         if (dataPtr)
             data = dataPtr->write();
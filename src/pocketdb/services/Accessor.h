@@ -27,9 +27,11 @@ namespace PocketServices
     {
     public:
         static bool GetBlock(const CBlock& block, PocketBlockRef& pocketBlock);
-        static bool GetBlock(const CBlock& block, string& data);
+        static bool GetBlock(const CBlock& block, string& data, bool binary = false);
+        // Put both payload encodings of block to the peers cache
+        static void CacheBlock(const CBlock& block, const PocketBlockRef& pocketBlock);
         static bool GetTransaction(const CTransaction& tx, PTransactionRef& pocketTx);
-        static bool GetTransaction(const CTransaction& tx, string& data);
+        static bool GetTransaction(const CTransaction& tx, string& data, bool binary = false);
     };
 } // namespace PocketServices
 
@@ -0,0 +1,110 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/services/BlockPayloadCache.h"
+#include "memusage.h"
+
+namespace PocketServices
+{
+    void BlockPayloadCache::SetLimit(size_t bytes)
+    {
+        LOCK(m_mutex);
+        m_limit = bytes;
+        Shrink();
+    }
+
+    bool BlockPayloadCache::Exists(const uint256& blockHash, bool binary)
+    {
+        LOCK(m_mutex);
+        return m_index.find({blockHash, binary}) != m_index.end();
+    }
+
+    bool BlockPayloadCache::Get(const uint256& blockHash, bool binary, string& data)
+    {
+        LOCK(m_mutex);
+
+        auto found = m_index.find({blockHash, binary});
+        if (found == m_index.end())
+        {
+            m_misses += 1;
+            return false;
+        }
+
+        // Move to front as most recently used
+        m_lru.splice(m_lru.begin(), m_lru, found->second);
+        data = found->second->Data;
+        m_hits += 1;
+        return true;
+    }
+
+    void BlockPayloadCache::Put(const uint256& blockHash, bool binary, const string& data)
+    {
+        LOCK(m_mutex);
+
+        if (auto found = m_index.find({blockHash, binary}); found != m_index.end())
+            EraseEntry(found->second);
+
+        Entry entry{blockHash, binary, data};
+        if (EntryUsage(entry) > m_limit)
+            return;
+
+        m_lru.push_front(std::move(entry));
+        m_index.emplace(std::make_pair(blockHash, binary), m_lru.begin());
+        m_usage += EntryUsage(m_lru.front());
+
+        Shrink();
+    }
+
+    void BlockPayloadCache::Erase(const uint256& blockHash)
+    {
+        LOCK(m_mutex);
+
+        for (bool binary : {false, true})
+            if (auto found = m_index.find({blockHash, binary}); found != m_index.end())
+                EraseEntry(found->second);
+    }
+
+    void BlockPayloadCache::Clear()
+    {
+        LOCK(m_mutex);
+        m_index.clear();
+        m_lru.clear();
+        m_usage = 0;
+    }
+
+    BlockPayloadCacheStats BlockPayloadCache::GetStats()
+    {
+        LOCK(m_mutex);
+
+        BlockPayloadCacheStats stats;
+        stats.Entries = m_lru.size();
+        stats.Usage = m_usage;
+        stats.Limit = m_limit;
+        stats.Hits = m_hits;
+        stats.Misses = m_misses;
+        return stats;
+    }
+
+    size_t BlockPayloadCache::EntryUsage(const Entry& entry)
+    {
+        // List node + index node + payload buffer
+        return memusage::MallocUsage(sizeof(Entry) + 2 * sizeof(void*)) +
+               memusage::MallocUsage(sizeof(pair<uint256, bool>) + sizeof(list<Entry>::iterator) + 4 * sizeof(void*)) +
+               memusage::MallocUsage(entry.Data.capacity());
+    }
+
+    void BlockPayloadCache::EraseEntry(list<Entry>::iterator itr)
+    {
+        m_usage -= EntryUsage(*itr);
+        m_index.erase({itr->BlockHash, itr->Binary});
+        m_lru.erase(itr);
+    }
+
+    void BlockPayloadCache::Shrink()
+    {
+        while (m_usage > m_limit && !m_lru.empty())
+            EraseEntry(std::prev(m_lru.end()));
+    }
+
+} // namespace PocketServices
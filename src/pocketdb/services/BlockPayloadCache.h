@@ -0,0 +1,71 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETDB_BLOCK_PAYLOAD_CACHE_H
+#define POCKETDB_BLOCK_PAYLOAD_CACHE_H
+
+#include "sync.h"
+#include "uint256.h"
+
+#include <list>
+#include <map>
+#include <string>
+
+namespace PocketServices
+{
+    using std::list;
+    using std::map;
+    using std::pair;
+    using std::string;
+
+    static const int64_t DEFAULT_POCKET_BLOCK_CACHE_SIZE = 32;
+
+    struct BlockPayloadCacheStats
+    {
+        size_t Entries = 0;
+        size_t Usage = 0;
+        size_t Limit = 0;
+        int64_t Hits = 0;
+        int64_t Misses = 0;
+    };
+
+    // Bounded LRU of serialized Pocket block payloads sent to peers.
+    // Key is block hash plus encoding (JSON or binary), size is accounted in bytes.
+    class BlockPayloadCache
+    {
+    public:
+        void SetLimit(size_t bytes);
+
+        bool Exists(const uint256& blockHash, bool binary);
+        bool Get(const uint256& blockHash, bool binary, string& data);
+        void Put(const uint256& blockHash, bool binary, const string& data);
+        void Erase(const uint256& blockHash);
+        void Clear();
+
+        BlockPayloadCacheStats GetStats();
+
+    private:
+        struct Entry
+        {
+            uint256 BlockHash;
+            bool Binary;
+            string Data;
+        };
+
+        Mutex m_mutex;
+        list<Entry> m_lru GUARDED_BY(m_mutex);
+        map<pair<uint256, bool>, list<Entry>::iterator> m_index GUARDED_BY(m_mutex);
+        size_t m_usage GUARDED_BY(m_mutex) = 0;
+        size_t m_limit GUARDED_BY(m_mutex) = DEFAULT_POCKET_BLOCK_CACHE_SIZE * 1024 * 1024;
+        int64_t m_hits GUARDED_BY(m_mutex) = 0;
+        int64_t m_misses GUARDED_BY(m_mutex) = 0;
+
+        static size_t EntryUsage(const Entry& entry);
+        void EraseEntry(list<Entry>::iterator itr) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+        void Shrink() EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    };
+
+} // namespace PocketServices
+
+#endif // POCKETDB_BLOCK_PAYLOAD_CACHE_H
@@ -0,0 +1,222 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/services/BulkSync.h"
+#include "pocketdb/pocketnet.h"
+#include "chain.h"
+#include "timedata.h"
+#include "validation.h"
+
+namespace PocketServices
+{
+    BulkSync BulkSyncInst;
+
+    void BulkSync::Start(boost::thread_group& threadGroup, bool enabled, int batchBlocks)
+    {
+        threadGroup.create_thread([this] { IndexesWorker(); });
+
+        LOCK(m_mutex);
+
+        m_enabled = enabled;
+        m_batch_size = max(1, batchBlocks);
+
+        if (!PocketDb::SQLiteDbInst.IsIndexesDeferred())
+            return;
+
+        if (m_enabled)
+        {
+            // Indexes stay deferred until the tip is reached
+            LogPrintf("BulkSync: resume bulk load of Pocket DB\n");
+            PocketDb::SQLiteDbInst.SetWalAutoCheckpoint(POCKET_BULK_SYNC_WAL_CHECKPOINT);
+            PocketDb::SQLiteDbInst.SetSynchronous(false);
+            m_active = true;
+        }
+        else
+        {
+            Leave();
+        }
+    }
+
+    void BulkSync::Stop()
+    {
+        LOCK(m_mutex);
+
+        if (!Commit())
+            LogPrintf("BulkSync: failed commit bulk load batch on shutdown\n");
+    }
+
+    void BulkSync::Interrupt()
+    {
+        LOCK(m_mutex);
+
+        m_shutdown = true;
+        m_build_cond.notify_all();
+    }
+
+    bool BulkSync::IsActive() const
+    {
+        return m_active;
+    }
+
+    bool BulkSync::BlockConnected(const CBlockIndex* pindex)
+    {
+        LOCK(m_mutex);
+
+        if (!m_enabled && !m_active)
+            return true;
+
+        auto age = GetAdjustedTime() - pindex->GetBlockTime();
+
+        if (!m_active)
+        {
+            if (age <= POCKET_BULK_SYNC_ENTER_AGE)
+                return true;
+
+            Enter(pindex);
+        }
+        else if (age < POCKET_BULK_SYNC_LEAVE_AGE)
+        {
+            if (!Commit())
+                return false;
+
+            Leave();
+            return true;
+        }
+
+        if (!m_active)
+            return true;
+
+        if (++m_batch_blocks >= m_batch_size && !Commit())
+            return false;
+
+        if (!PocketDb::SQLiteDbInst.InBatch() && !PocketDb::SQLiteDbInst.BeginBatch())
+            LogPrintf("BulkSync: failed begin batch at height %d\n", pindex->nHeight);
+
+        return true;
+    }
+
+    void BulkSync::EnqueueWebPost(const string& blockHash, int height)
+    {
+        {
+            LOCK(m_mutex);
+
+            if (PocketDb::SQLiteDbInst.InBatch())
+            {
+                m_web_queue.emplace_back(blockHash, height);
+                return;
+            }
+        }
+
+        WebPostProcessorInst.Enqueue(blockHash, height);
+    }
+
+    bool BulkSync::Flush()
+    {
+        LOCK(m_mutex);
+
+        if (!m_active)
+            return Commit();
+
+        // Chainstate is written next - this commit must survive power failure
+        PocketDb::SQLiteDbInst.SetSynchronous(true);
+        bool result = Commit();
+        PocketDb::SQLiteDbInst.SetSynchronous(false);
+
+        return result;
+    }
+
+    bool BulkSync::Commit()
+    {
+        AssertLockHeld(m_mutex);
+
+        m_batch_blocks = 0;
+
+        if (!PocketDb::SQLiteDbInst.CommitBatch())
+            return false;
+
+        for (const auto& [blockHash, height] : m_web_queue)
+            WebPostProcessorInst.Enqueue(blockHash, height);
+        m_web_queue.clear();
+
+        return true;
+    }
+
+    void BulkSync::Enter(const CBlockIndex* pindex)
+    {
+        AssertLockHeld(m_mutex);
+
+        try
+        {
+            LogPrintf("BulkSync: start bulk load of Pocket DB at height %d\n", pindex->nHeight);
+
+            // Building indexes again pays off only if most of the chain is still to be loaded
+            if (!m_build && !m_building && pindexBestHeader && pindex->nHeight < pindexBestHeader->nHeight / 2)
+                PocketDb::SQLiteDbInst.DeferIndexes();
+
+            PocketDb::SQLiteDbInst.SetWalAutoCheckpoint(POCKET_BULK_SYNC_WAL_CHECKPOINT);
+            PocketDb::SQLiteDbInst.SetSynchronous(false);
+            m_active = true;
+        }
+        catch (const std::exception& ex)
+        {
+            LogPrintf("BulkSync: failed start bulk load: %s\n", ex.what());
+            m_enabled = false;
+        }
+    }
+
+    void BulkSync::Leave()
+    {
+        AssertLockHeld(m_mutex);
+
+        LogPrintf("BulkSync: finish bulk load of Pocket DB\n");
+
+        m_active = false;
+        PocketDb::SQLiteDbInst.SetWalAutoCheckpoint(POCKET_WAL_CHECKPOINT);
+        PocketDb::SQLiteDbInst.SetSynchronous(true);
+
+        // Called under cs_main - indexes are built by the worker
+        if (PocketDb::SQLiteDbInst.IsIndexesDeferred())
+        {
+            m_build = true;
+            m_build_cond.notify_all();
+        }
+    }
+
+    void BulkSync::IndexesWorker()
+    {
+        while (true)
+        {
+            {
+                WAIT_LOCK(m_mutex, lock);
+
+                while (!m_shutdown && !m_build)
+                    m_build_cond.wait(lock);
+
+                if (m_shutdown) break;
+
+                m_build = false;
+                m_building = true;
+            }
+
+            try
+            {
+                LogPrintf("BulkSync: building deferred indexes..\n");
+
+                int64_t nTime1 = GetTimeMicros();
+                if (PocketDb::SQLiteDbInst.BuildDeferredIndexes(m_shutdown))
+                    LogPrintf("BulkSync: deferred indexes built in %.2fs\n", 0.000001 * (GetTimeMicros() - nTime1));
+                else
+                    LogPrintf("BulkSync: building deferred indexes interrupted\n");
+            }
+            catch (const std::exception& ex)
+            {
+                // Build is retried on next start
+                LogPrintf("BulkSync: failed build deferred indexes: %s\n", ex.what());
+            }
+
+            m_building = false;
+        }
+    }
+
+} // namespace PocketServices
@@ -0,0 +1,88 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETDB_BULK_SYNC_H
+#define POCKETDB_BULK_SYNC_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "sync.h"
+
+#include <boost/thread.hpp>
+
+class CBlockIndex;
+
+namespace PocketServices
+{
+    using namespace std;
+
+    static const bool DEFAULT_POCKET_BULK_SYNC = true;
+    static const int DEFAULT_POCKET_BULK_SYNC_BATCH = 500;
+
+    // Bulk load starts when the connected block is older than ENTER age
+    // and ends when it is younger than LEAVE age
+    static const int64_t POCKET_BULK_SYNC_ENTER_AGE = 24 * 60 * 60;
+    static const int64_t POCKET_BULK_SYNC_LEAVE_AGE = 2 * 60 * 60;
+
+    static const int POCKET_BULK_SYNC_WAL_CHECKPOINT = 10000;
+    static const int POCKET_WAL_CHECKPOINT = 1000;
+
+    // Bulk load of Pocket DB while the node is far behind the network (IBD, -reindex).
+    // Blocks are indexed in batches of one transaction; from the start of the chain deferred
+    // indexes are dropped as well.
+    // Commits are not synced to disk except the one made before the chainstate is written, so
+    // Pocket DB is never behind the chainstate after a crash or power failure.
+    // Deferred indexes are built in background when the tip is reached. SQLite has one writer,
+    // so the build is not moved to another connection: block connection waits at most while one
+    // index is built (minutes for the largest ones on mainnet), RPC queries naming an index not
+    // built yet fail with an error.
+    class BulkSync
+    {
+    public:
+        // Resumes the bulk load interrupted by shutdown or crash
+        void Start(boost::thread_group& threadGroup, bool enabled, int batchBlocks);
+        void Stop();
+
+        // Stop building deferred indexes before worker threads are joined
+        void Interrupt();
+
+        bool IsActive() const;
+
+        // Called under cs_main after the block is indexed and connected to the chain.
+        // Returns false if the batch failed to commit.
+        bool BlockConnected(const CBlockIndex* pindex);
+
+        // Web data is built with another connection and must wait for the batch commit
+        void EnqueueWebPost(const string& blockHash, int height);
+
+        // Commit blocks indexed so far; returns false if the batch failed to commit
+        bool Flush();
+
+    private:
+        Mutex m_mutex;
+        bool m_enabled = false;
+        atomic<bool> m_active{false};
+        int m_batch_size = DEFAULT_POCKET_BULK_SYNC_BATCH;
+        int m_batch_blocks = 0;
+        vector<pair<string, int>> m_web_queue;
+
+        std::condition_variable m_build_cond;
+        bool m_build = false;
+        atomic<bool> m_building{false};
+        atomic<bool> m_shutdown{false};
+
+        void Enter(const CBlockIndex* pindex);
+        void Leave();
+        bool Commit();
+
+        void IndexesWorker();
+    };
+
+    extern BulkSync BulkSyncInst;
+
+} // namespace PocketServices
+
+#endif // POCKETDB_BULK_SYNC_H
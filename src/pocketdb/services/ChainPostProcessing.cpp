@@ -14,11 +14,12 @@ namespace PocketServices
         int64_t nTime1 = GetTimeMicros();
 
         IndexChain(block.GetHash().GetHex(), height, txs);
+        UnspentsCacheInst.BlockConnected(txs);
 
         int64_t nTime2 = GetTimeMicros();
         LogPrint(BCLog::BENCH, "    - IndexChain: %.2fms _ %d\n", 0.001 * (double)(nTime2 - nTime1), height);
 
-        IndexRatings(height, txs);
+        IndexRatings(block.GetHash().GetHex(), height, txs);
 
         int64_t nTime3 = GetTimeMicros();
         LogPrint(BCLog::BENCH, "    - IndexRatings: %.2fms _ %d\n", 0.001 * (double)(nTime3 - nTime2), height);
@@ -27,7 +28,15 @@ namespace PocketServices
     bool ChainPostProcessing::Rollback(int height)
     {
         LogPrint(BCLog::SYNC, "Rollback current block to prev at height %d\n", height - 1);
-        return PocketDb::ChainRepoInst.Rollback(height);
+        PocketConsensus::ScoreDataCacheInst.Clear();
+        SocialGraphInst.Rollback(height);
+
+        bool result = PocketDb::ChainRepoInst.Rollback(height);
+
+        // After commit: outputs read by RPC before it would be cached again as unspent
+        UnspentsCacheInst.Clear();
+
+        return result;
     }
 
     void ChainPostProcessing::PrepareTransactions(const CBlock& block, vector<TransactionIndexingInfo>& txs)
@@ -51,6 +60,9 @@ namespace PocketServices
                         txInfo.Inputs.emplace_back(inp.prevout.hash.GetHex(), inp.prevout.n);
                 }
 
+                for (const auto& out : tx->vout)
+                    txInfo.Outputs.emplace_back(PocketHelpers::TransactionHelper::ExtractOutputAddress(out.scriptPubKey), out.nValue);
+
                 txs.emplace_back(txInfo);
             }
         }
@@ -62,7 +74,7 @@ namespace PocketServices
         PocketDb::ChainRepoInst.IndexBlock(blockHash, height, txs);
     }
 
-    void ChainPostProcessing::IndexRatings(int height, vector<TransactionIndexingInfo>& txs)
+    void ChainPostProcessing::IndexRatings(const string& blockHash, int height, vector<TransactionIndexingInfo>& txs)
     {
         map <RatingType, map<int, int>> ratingValues;
         map<int, vector<int>> accountLikersSrc;
@@ -70,17 +82,23 @@ namespace PocketServices
         // Actual consensus checker instance by current height
         auto reputationConsensus = PocketConsensus::ReputationConsensusFactoryInst.Instance(height);
 
-        // Loop all transactions for find scores and increase ratings for accounts and contents
+        // Only scores allowed in calculating ratings
+        vector<string> scoreTxHashes;
         for (const auto& txInfo : txs)
+            if (txInfo.IsActionScore())
+                scoreTxHashes.push_back(txInfo.Hash);
+
+        // Need select content id for saving rating - all block scores at once
+        auto scoresData = PocketConsensus::ScoreDataCacheInst.Get(blockHash, scoreTxHashes);
+
+        // Loop all scores and increase ratings for accounts and contents
+        for (const auto& scoreTxHash : scoreTxHashes)
         {
-            // Only scores allowed in calculating ratings
-            if (!txInfo.IsActionScore())
-                continue;
+            auto it = scoresData.find(scoreTxHash);
+            if (it == scoresData.end())
+                throw std::runtime_error(strprintf("%s: Failed get score data for tx: %s\n", __func__, scoreTxHash));
 
-            // Need select content id for saving rating
-            auto scoreData = PocketDb::ConsensusRepoInst.GetScoreData(txInfo.Hash);
-            if (!scoreData)
-                throw std::runtime_error(strprintf("%s: Failed get score data for tx: %s\n", __func__, txInfo.Hash));
+            auto& scoreData = it->second;
 
             // Old posts denied change reputation
             auto allowModifyOldPosts = reputationConsensus->AllowModifyOldPosts(
@@ -10,6 +10,9 @@
 #include "primitives/block.h"
 
 #include "pocketdb/consensus/Reputation.h"
+#include "pocketdb/consensus/ScoreDataCache.h"
+#include "pocketdb/services/SocialGraph.h"
+#include "pocketdb/services/UnspentsCache.h"
 #include "pocketdb/helpers/TransactionHelper.h"
 #include "pocketdb/pocketnet.h"
 
@@ -32,7 +35,7 @@ namespace PocketServices
     protected:
         static void PrepareTransactions(const CBlock& block, vector<TransactionIndexingInfo>& txs);
         static void IndexChain(const string& blockHash, int height, vector<TransactionIndexingInfo>& txs);
-        static void IndexRatings(int height, vector<TransactionIndexingInfo>& txs);
+        static void IndexRatings(const string& blockHash, int height, vector<TransactionIndexingInfo>& txs);
     private:
         static void BuildAccountLikers(const shared_ptr<ScoreDataDto>& scoreData, map<int, vector<int>>& accountLikers);
     };
@@ -4,13 +4,41 @@
 
 #include "pocketdb/services/Serializer.h"
 #include "script/standard.h"
+#include "version.h"
 
 namespace PocketServices
 {
+    // Binary entry field flags
+    enum BinaryField : uint16_t
+    {
+        BF_STRING1 = 1 << 0,
+        BF_STRING2 = 1 << 1,
+        BF_STRING3 = 1 << 2,
+        BF_STRING4 = 1 << 3,
+        BF_STRING5 = 1 << 4,
+        BF_INT1 = 1 << 5,
+        BF_PAYLOAD = 1 << 6,
+        BF_P_STRING1 = 1 << 7,
+        BF_P_STRING2 = 1 << 8,
+        BF_P_STRING3 = 1 << 9,
+        BF_P_STRING4 = 1 << 10,
+        BF_P_STRING5 = 1 << 11,
+        BF_P_STRING6 = 1 << 12,
+        BF_P_STRING7 = 1 << 13,
+        BF_P_INT1 = 1 << 14,
+    };
+
     tuple<bool, PocketBlock> Serializer::DeserializeBlock(const CBlock& block, CDataStream& stream)
     {
         // Get Serialized data from stream
-        auto pocketData = parseStream(stream);
+        string src;
+        if (!stream.empty())
+            stream >> src;
+
+        if (isBinary(src))
+            return deserializeBlock(block, parseBinary(src));
+
+        auto pocketData = parseString(src);
         return deserializeBlock(block, pocketData);
     }
     tuple<bool, PocketBlock> Serializer::DeserializeBlock(const CBlock& block)
@@ -27,7 +55,26 @@ namespace PocketServices
 
     tuple<bool, PTransactionRef> Serializer::DeserializeTransaction(const CTransactionRef& tx, CDataStream& stream)
     {
-        auto pocketData = parseStream(stream);
+        string src;
+        if (!stream.empty())
+            stream >> src;
+
+        if (isBinary(src))
+        {
+            auto pocketData = parseBinary(src);
+
+            UniValue fakeData(UniValue::VOBJ);
+            auto ptx = buildInstance(tx, fakeData);
+            if (!ptx)
+                return {false, nullptr};
+
+            if (auto entry = pocketData.find(*ptx->GetHash()); entry != pocketData.end())
+                applyBinaryEntry(ptx, entry->second);
+
+            return {true, ptx};
+        }
+
+        auto pocketData = parseString(src);
         return deserializeTransaction(tx, pocketData);
     }
 
@@ -73,6 +120,83 @@ namespace PocketServices
     }
 
 
+    string Serializer::SerializeBlockBinary(const PocketBlock& block)
+    {
+        CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+        stream << POCKET_BINARY_PAYLOAD_MARKER << POCKET_BINARY_PAYLOAD_FORMAT;
+
+        uint64_t count = 0;
+        for (const auto& transaction : block)
+            if (PocketHelpers::TransactionHelper::IsPocketTransaction(*transaction->GetType()))
+                count += 1;
+
+        WriteCompactSize(stream, count);
+        for (const auto& transaction : block)
+            if (PocketHelpers::TransactionHelper::IsPocketTransaction(*transaction->GetType()))
+                writeBinaryEntry(stream, *transaction);
+
+        return stream.str();
+    }
+
+    string Serializer::SerializeTransactionBinary(const Transaction& transaction)
+    {
+        if (!PocketHelpers::TransactionHelper::IsPocketTransaction(*transaction.GetType()))
+            return "";
+
+        CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+        stream << POCKET_BINARY_PAYLOAD_MARKER << POCKET_BINARY_PAYLOAD_FORMAT;
+        WriteCompactSize(stream, 1);
+        writeBinaryEntry(stream, transaction);
+
+        return stream.str();
+    }
+
+    // Entry contains only fields stored in the Transactions and Payload tables:
+    //   uint256 hash, compactsize type, uint16 flags, then present fields in flags order
+    void Serializer::writeBinaryEntry(CDataStream& stream, const Transaction& transaction)
+    {
+        auto payload = transaction.GetPayload();
+
+        uint16_t flags = 0;
+        if (transaction.GetString1()) flags |= BF_STRING1;
+        if (transaction.GetString2()) flags |= BF_STRING2;
+        if (transaction.GetString3()) flags |= BF_STRING3;
+        if (transaction.GetString4()) flags |= BF_STRING4;
+        if (transaction.GetString5()) flags |= BF_STRING5;
+        if (transaction.GetInt1()) flags |= BF_INT1;
+        if (payload)
+        {
+            flags |= BF_PAYLOAD;
+            if (payload->GetString1()) flags |= BF_P_STRING1;
+            if (payload->GetString2()) flags |= BF_P_STRING2;
+            if (payload->GetString3()) flags |= BF_P_STRING3;
+            if (payload->GetString4()) flags |= BF_P_STRING4;
+            if (payload->GetString5()) flags |= BF_P_STRING5;
+            if (payload->GetString6()) flags |= BF_P_STRING6;
+            if (payload->GetString7()) flags |= BF_P_STRING7;
+            if (payload->GetInt1()) flags |= BF_P_INT1;
+        }
+
+        stream << uint256S(*transaction.GetHash());
+        WriteCompactSize(stream, (uint64_t) *transaction.GetType());
+        stream << flags;
+
+        if (flags & BF_STRING1) stream << *transaction.GetString1();
+        if (flags & BF_STRING2) stream << *transaction.GetString2();
+        if (flags & BF_STRING3) stream << *transaction.GetString3();
+        if (flags & BF_STRING4) stream << *transaction.GetString4();
+        if (flags & BF_STRING5) stream << *transaction.GetString5();
+        if (flags & BF_INT1) stream << *transaction.GetInt1();
+        if (flags & BF_P_STRING1) stream << *payload->GetString1();
+        if (flags & BF_P_STRING2) stream << *payload->GetString2();
+        if (flags & BF_P_STRING3) stream << *payload->GetString3();
+        if (flags & BF_P_STRING4) stream << *payload->GetString4();
+        if (flags & BF_P_STRING5) stream << *payload->GetString5();
+        if (flags & BF_P_STRING6) stream << *payload->GetString6();
+        if (flags & BF_P_STRING7) stream << *payload->GetString7();
+        if (flags & BF_P_INT1) stream << (int64_t) *payload->GetInt1();
+    }
+
     shared_ptr <Transaction> Serializer::buildInstance(const CTransactionRef& tx, const UniValue& src)
     {
         TxType txType;
@@ -135,44 +259,116 @@ namespace PocketServices
         {
             const CTxOut& txout = tx->vout[i];
 
-            auto out = make_shared<TransactionOutput>();
-            out->SetTxHash(tx->GetHash().GetHex());
-            out->SetNumber((int) i);
-            out->SetValue(txout.nValue);
-            out->SetScriptPubKey(HexStr(txout.scriptPubKey));
+            TransactionOutput out;
+            out.SetTxHash(tx->GetHash().GetHex());
+            out.SetNumber((int) i);
+            out.SetValue(txout.nValue);
+            out.SetScriptPubKey(HexStr(txout.scriptPubKey));
+            out.SetAddressHash(PocketHelpers::TransactionHelper::ExtractOutputAddress(txout.scriptPubKey));
+
+            ptx->Outputs().push_back(std::move(out));
+        }
+
+        return !ptx->Outputs().empty();
+    }
 
-            TxoutType type;
-            std::vector <CTxDestination> vDest;
-            int nRequired;
-            if (ExtractDestinations(txout.scriptPubKey, type, vDest, nRequired))
+    UniValue Serializer::parseString(const string& src)
+    {
+        // Prepare source data - old format (Json)
+        UniValue pocketData(UniValue::VOBJ);
+        if (!src.empty())
+            pocketData.read(src);
+
+        return pocketData;
+    }
+
+    bool Serializer::isBinary(const string& src)
+    {
+        return src.size() >= 2 && (unsigned char) src[0] == POCKET_BINARY_PAYLOAD_MARKER;
+    }
+
+    map<string, PTransactionRef> Serializer::parseBinary(const string& src)
+    {
+        map<string, PTransactionRef> result;
+
+        try
+        {
+            CDataStream stream(src.data(), src.data() + src.size(), SER_NETWORK, PROTOCOL_VERSION);
+
+            unsigned char marker, format;
+            stream >> marker >> format;
+            if (format != POCKET_BINARY_PAYLOAD_FORMAT)
             {
-                for (const auto& dest : vDest)
-                    out->SetAddressHash(EncodeDestination(dest));
+                LogPrintf("Error deserialize binary payload: unsupported format %d\n", (int) format);
+                return result;
             }
-            else
+
+            uint64_t count = ReadCompactSize(stream);
+            for (uint64_t i = 0; i < count; i++)
             {
-                out->SetAddressHash("");
-            }
+                uint256 hash;
+                stream >> hash;
+                auto txType = (TxType) ReadCompactSize(stream);
+                uint16_t flags;
+                stream >> flags;
+
+                auto ptx = PocketHelpers::TransactionHelper::CreateInstance(txType);
+                if (!ptx)
+                    throw std::ios_base::failure(strprintf("unsupported type %d", (int) txType));
+
+                ptx->SetHash(hash.GetHex());
+
+                string str;
+                int64_t num;
+                if (flags & BF_STRING1) { stream >> str; ptx->SetString1(str); }
+                if (flags & BF_STRING2) { stream >> str; ptx->SetString2(str); }
+                if (flags & BF_STRING3) { stream >> str; ptx->SetString3(str); }
+                if (flags & BF_STRING4) { stream >> str; ptx->SetString4(str); }
+                if (flags & BF_STRING5) { stream >> str; ptx->SetString5(str); }
+                if (flags & BF_INT1) { stream >> num; ptx->SetInt1(num); }
+
+                if (flags & BF_PAYLOAD)
+                {
+                    Payload payload;
+                    payload.SetTxHash(*ptx->GetHash());
+                    if (flags & BF_P_STRING1) { stream >> str; payload.SetString1(str); }
+                    if (flags & BF_P_STRING2) { stream >> str; payload.SetString2(str); }
+                    if (flags & BF_P_STRING3) { stream >> str; payload.SetString3(str); }
+                    if (flags & BF_P_STRING4) { stream >> str; payload.SetString4(str); }
+                    if (flags & BF_P_STRING5) { stream >> str; payload.SetString5(str); }
+                    if (flags & BF_P_STRING6) { stream >> str; payload.SetString6(str); }
+                    if (flags & BF_P_STRING7) { stream >> str; payload.SetString7(str); }
+                    if (flags & BF_P_INT1) { stream >> num; payload.SetInt1((int) num); }
+                    ptx->SetPayload(payload);
+                }
 
-            ptx->Outputs().push_back(out);
+                result.emplace(*ptx->GetHash(), ptx);
+            }
+        }
+        catch (const std::exception& ex)
+        {
+            LogPrintf("Error deserialize binary payload: %s\n", ex.what());
+            result.clear();
         }
 
-        return !ptx->Outputs().empty();
+        return result;
     }
 
-    UniValue Serializer::parseStream(CDataStream& stream)
+    void Serializer::applyBinaryEntry(const PTransactionRef& ptx, const PTransactionRef& entry)
     {
-        // Prepare source data - old format (Json)
-        UniValue pocketData(UniValue::VOBJ);
-        if (!stream.empty())
+        if (*ptx->GetType() != *entry->GetType())
         {
-            // TODO (brangr) (v0.21.0): speed up protocol
-            string src;
-            stream >> src;
-            pocketData.read(src);
+            LogPrintf("Error deserialize transaction: %s: type mismatch\n", *ptx->GetHash());
+            return;
         }
 
-        return pocketData;
+        if (entry->GetString1()) ptx->SetString1(*entry->GetString1());
+        if (entry->GetString2()) ptx->SetString2(*entry->GetString2());
+        if (entry->GetString3()) ptx->SetString3(*entry->GetString3());
+        if (entry->GetString4()) ptx->SetString4(*entry->GetString4());
+        if (entry->GetString5()) ptx->SetString5(*entry->GetString5());
+        if (entry->GetInt1()) ptx->SetInt1(*entry->GetInt1());
+        if (entry->GetPayload()) ptx->SetPayload(*entry->GetPayload());
     }
 
 
@@ -180,6 +376,7 @@ namespace PocketServices
     {
         // Restore pocket transaction instance
         PocketBlock pocketBlock;
+        pocketBlock.reserve(block.vtx.size());
         for (const auto& tx : block.vtx)
         {
             auto txHash = tx->GetHash().GetHex();
@@ -206,6 +403,26 @@ namespace PocketServices
         return { true, pocketBlock };
     }
 
+    tuple<bool, PocketBlock> Serializer::deserializeBlock(const CBlock& block, const map<string, PTransactionRef>& pocketData)
+    {
+        PocketBlock pocketBlock;
+        pocketBlock.reserve(block.vtx.size());
+        UniValue fakeData(UniValue::VOBJ);
+        for (const auto& tx : block.vtx)
+        {
+            auto ptx = buildInstance(tx, fakeData);
+            if (!ptx)
+                continue;
+
+            if (auto entry = pocketData.find(*ptx->GetHash()); entry != pocketData.end())
+                applyBinaryEntry(ptx, entry->second);
+
+            pocketBlock.push_back(ptx);
+        }
+
+        return { true, pocketBlock };
+    }
+
     tuple<bool, shared_ptr<Transaction>> Serializer::deserializeTransaction(const CTransactionRef& tx, UniValue& pocketData)
     {
         auto ptx = buildInstance(tx, pocketData);
@@ -36,6 +36,10 @@ namespace PocketServices
     using namespace PocketTx;
     using namespace PocketHelpers;
 
+    // First byte of binary payload. JSON payload always starts with '{'
+    static const unsigned char POCKET_BINARY_PAYLOAD_MARKER = 0x01;
+    static const unsigned char POCKET_BINARY_PAYLOAD_FORMAT = 0x01;
+
     class Serializer
     {
     public:
@@ -49,12 +53,21 @@ namespace PocketServices
         static shared_ptr<UniValue> SerializeBlock(const PocketBlock& block);
         static shared_ptr<UniValue> SerializeTransaction(const Transaction& transaction);
 
+        // Compact binary protocol for peers with POCKET_BINARY_PAYLOAD_VERSION
+        static string SerializeBlockBinary(const PocketBlock& block);
+        static string SerializeTransactionBinary(const Transaction& transaction);
+
     private:
         static shared_ptr<Transaction> buildInstance(const CTransactionRef& tx, const UniValue& src);
         static shared_ptr<Transaction> buildInstanceRpc(const CTransactionRef& tx, const UniValue& src);
         static bool buildOutputs(const CTransactionRef& tx, shared_ptr<Transaction>& ptx);
-        static UniValue parseStream(CDataStream& stream);
+        static UniValue parseString(const string& src);
+        static bool isBinary(const string& src);
+        static void writeBinaryEntry(CDataStream& stream, const Transaction& transaction);
+        static map<string, PTransactionRef> parseBinary(const string& src);
+        static void applyBinaryEntry(const PTransactionRef& ptx, const PTransactionRef& entry);
         static tuple<bool, PocketBlock> deserializeBlock(const CBlock& block, UniValue& pocketData);
+        static tuple<bool, PocketBlock> deserializeBlock(const CBlock& block, const map<string, PTransactionRef>& pocketData);
         static tuple<bool, shared_ptr<Transaction>> deserializeTransaction(const CTransactionRef& tx, UniValue& pocketData);
     };
 
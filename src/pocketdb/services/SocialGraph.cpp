@@ -0,0 +1,551 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/services/SocialGraph.h"
+#include "logging.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace PocketServices
+{
+    SocialGraph SocialGraphInst;
+
+    void SocialGraphAdjacency::Build(vector<tuple<int, int, int>>& edges, size_t nodes)
+    {
+        // Rows of nodes from the newest edge
+        sort(edges.begin(), edges.end(), [](const auto& a, const auto& b)
+        {
+            return get<0>(a) != get<0>(b) ? get<0>(a) < get<0>(b) : get<2>(a) > get<2>(b);
+        });
+
+        m_offsets.assign(nodes + 1, 0);
+        m_edges.clear();
+        m_edges.reserve(edges.size());
+
+        for (const auto& [from, to, height] : edges)
+        {
+            m_offsets[from + 1]++;
+            m_edges.push_back({to, height});
+        }
+
+        for (size_t i = 1; i < m_offsets.size(); i++)
+            m_offsets[i] += m_offsets[i - 1];
+
+        m_added.clear();
+        m_addedCount = 0;
+        m_removedCount = 0;
+    }
+
+    void SocialGraphAdjacency::Add(int from, int to, int height)
+    {
+        m_added[from].push_back({to, height});
+        m_addedCount++;
+    }
+
+    bool SocialGraphAdjacency::Remove(int from, int to, int& height)
+    {
+        if (auto itr = m_added.find(from); itr != m_added.end())
+        {
+            auto& added = itr->second;
+            for (auto edge = added.rbegin(); edge != added.rend(); ++edge)
+            {
+                if (edge->Target != to)
+                    continue;
+
+                height = edge->Height;
+                added.erase(std::next(edge).base());
+                if (added.empty())
+                    m_added.erase(itr);
+
+                m_addedCount--;
+                return true;
+            }
+        }
+
+        if (from < 0 || from + 1 >= (int) m_offsets.size())
+            return false;
+
+        for (auto i = m_offsets[from]; i < m_offsets[from + 1]; i++)
+        {
+            if (m_edges[i].Target != to)
+                continue;
+
+            height = m_edges[i].Height;
+            m_edges[i].Target = -1;
+            m_removedCount++;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool SocialGraphAdjacency::Exists(int from, int to) const
+    {
+        bool found = false;
+        Visit(from, [&](const Edge& edge)
+        {
+            found = edge.Target == to;
+            return !found;
+        });
+
+        return found;
+    }
+
+    void SocialGraphAdjacency::Compact(size_t nodes)
+    {
+        if (m_addedCount + m_removedCount < max(SOCIAL_GRAPH_COMPACT_EDGES, m_edges.size() / 8))
+            return;
+
+        vector<tuple<int, int, int>> edges;
+        edges.reserve(Count());
+
+        for (int from = 0; from + 1 < (int) m_offsets.size(); from++)
+            for (auto i = m_offsets[from]; i < m_offsets[from + 1]; i++)
+                if (m_edges[i].Target >= 0)
+                    edges.emplace_back(from, m_edges[i].Target, m_edges[i].Height);
+
+        for (const auto& [from, added] : m_added)
+            for (const auto& edge : added)
+                edges.emplace_back(from, edge.Target, edge.Height);
+
+        Build(edges, nodes);
+    }
+
+    size_t SocialGraphAdjacency::Count() const
+    {
+        return m_edges.size() - m_removedCount + m_addedCount;
+    }
+
+    int SocialGraph::Graph::GetNode(int64_t id) const
+    {
+        auto itr = Index.find(id);
+        return itr == Index.end() ? -1 : itr->second;
+    }
+
+    int SocialGraph::Graph::AddNode(int64_t id)
+    {
+        auto[itr, inserted] = Index.emplace(id, (int) Nodes.size());
+        if (inserted)
+        {
+            Node node;
+            node.Id = id;
+            Nodes.push_back(node);
+        }
+
+        return itr->second;
+    }
+
+    bool SocialGraph::IsReady() const
+    {
+        return m_ready;
+    }
+
+    void SocialGraph::BeginBuild()
+    {
+        LOCK(m_mutex);
+        m_buildRollbackHeight = numeric_limits<int>::max();
+    }
+
+    bool SocialGraph::Build(const vector<SocialGraphAction>& actions, int height)
+    {
+        // Built aside - walks are served by the previous graph until it is replaced
+        Graph graph;
+        vector<tuple<int, int, int>> subscribes;
+        vector<tuple<int, int, int>> likes;
+        vector<tuple<int, int, int>> contents;
+
+        for (const auto& action : actions)
+        {
+            int from = graph.AddNode(action.From);
+            int to = graph.AddNode(action.To);
+
+            switch (action.Type)
+            {
+                case CONTENT_POST:
+                case CONTENT_VIDEO:
+                case CONTENT_ARTICLE:
+                case CONTENT_DELETE:
+                    graph.Nodes[to].Author = from;
+                    graph.Nodes[to].Height = action.Height;
+                    graph.Nodes[to].Type = action.Type;
+                    contents.emplace_back(from, to, action.Height);
+                    break;
+                case ACTION_SCORE_CONTENT:
+                    likes.emplace_back(from, to, action.Height);
+                    break;
+                case ACTION_SUBSCRIBE:
+                case ACTION_SUBSCRIBE_PRIVATE:
+                    subscribes.emplace_back(from, to, action.Height);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        auto reversed = [](const vector<tuple<int, int, int>>& edges)
+        {
+            vector<tuple<int, int, int>> result;
+            result.reserve(edges.size());
+            for (const auto& [from, to, height] : edges)
+                result.emplace_back(to, from, height);
+            return result;
+        };
+
+        auto subscribers = reversed(subscribes);
+        auto likers = reversed(likes);
+
+        size_t nodes = graph.Nodes.size();
+        graph.Subscribes.Build(subscribes, nodes);
+        graph.Subscribers.Build(subscribers, nodes);
+        graph.Likes.Build(likes, nodes);
+        graph.Likers.Build(likers, nodes);
+        graph.Contents.Build(contents, nodes);
+
+        LogPrintf("SocialGraph: %d nodes, %d subscriptions, %d likes at height %d\n",
+            nodes, graph.Subscribes.Count(), graph.Likes.Count(), height);
+
+        LOCK(m_mutex);
+
+        // Actions were loaded with blocks disconnected since then
+        if (m_buildRollbackHeight <= height)
+        {
+            LogPrintf("SocialGraph: blocks from height %d disconnected while building, graph at height %d dropped\n",
+                m_buildRollbackHeight, height);
+            return false;
+        }
+
+        m_graph = std::move(graph);
+        m_height = height;
+        m_undoHeight = height + 1;
+        m_journal.clear();
+        m_ready = true;
+
+        return true;
+    }
+
+    void SocialGraph::Apply(const vector<SocialGraphAction>& actions, int height)
+    {
+        LOCK(m_mutex);
+
+        if (!m_ready)
+            return;
+
+        if (height <= m_height)
+        {
+            RollbackLocked(height);
+            if (!m_ready)
+                return;
+        }
+
+        vector<Change> changes;
+        for (const auto& action : actions)
+            ApplyAction(action, changes);
+
+        m_height = height;
+        m_journal.emplace_back(height, std::move(changes));
+
+        while (m_journal.size() > (size_t) SOCIAL_GRAPH_UNDO_DEPTH)
+        {
+            m_journal.pop_front();
+            m_undoHeight = m_journal.front().first;
+        }
+
+        size_t nodes = m_graph.Nodes.size();
+        m_graph.Subscribes.Compact(nodes);
+        m_graph.Subscribers.Compact(nodes);
+        m_graph.Likes.Compact(nodes);
+        m_graph.Likers.Compact(nodes);
+        m_graph.Contents.Compact(nodes);
+    }
+
+    void SocialGraph::Rollback(int height)
+    {
+        LOCK(m_mutex);
+
+        m_buildRollbackHeight = min(m_buildRollbackHeight, height);
+        RollbackLocked(height);
+    }
+
+    void SocialGraph::Clear()
+    {
+        LOCK(m_mutex);
+        ClearLocked();
+    }
+
+    void SocialGraph::RollbackLocked(int height)
+    {
+        if (!m_ready || height > m_height)
+            return;
+
+        if (height < m_undoHeight)
+        {
+            LogPrintf("SocialGraph: rollback to height %d is deeper than journal, graph dropped\n", height);
+            ClearLocked();
+            return;
+        }
+
+        while (!m_journal.empty() && m_journal.back().first >= height)
+        {
+            const auto& changes = m_journal.back().second;
+            for (auto change = changes.rbegin(); change != changes.rend(); ++change)
+                Undo(*change);
+
+            m_journal.pop_back();
+        }
+
+        m_height = height - 1;
+    }
+
+    void SocialGraph::ClearLocked()
+    {
+        m_ready = false;
+        m_graph = Graph();
+        m_height = -1;
+        m_undoHeight = -1;
+        m_journal.clear();
+    }
+
+    void SocialGraph::ApplyAction(const SocialGraphAction& action, vector<Change>& changes)
+    {
+        int from = m_graph.AddNode(action.From);
+        int to = m_graph.AddNode(action.To);
+
+        switch (action.Type)
+        {
+            case CONTENT_POST:
+            case CONTENT_VIDEO:
+            case CONTENT_ARTICLE:
+            case CONTENT_DELETE:
+            {
+                auto& node = m_graph.Nodes[to];
+                changes.push_back({ChangeType::Content, from, to, action.Height, node});
+
+                // Editions and deletion keep the author
+                if (node.Type == 0)
+                    m_graph.Contents.Add(from, to, action.Height);
+
+                node.Author = from;
+                node.Height = action.Height;
+                node.Type = action.Type;
+                break;
+            }
+            case ACTION_SCORE_CONTENT:
+            {
+                m_graph.Likes.Add(from, to, action.Height);
+                m_graph.Likers.Add(to, from, action.Height);
+                changes.push_back({ChangeType::Like, from, to, action.Height, {}});
+                break;
+            }
+            case ACTION_SUBSCRIBE:
+            case ACTION_SUBSCRIBE_PRIVATE:
+            {
+                // Change of subscription mode keeps the edge
+                if (m_graph.Subscribes.Exists(from, to))
+                    break;
+
+                m_graph.Subscribes.Add(from, to, action.Height);
+                m_graph.Subscribers.Add(to, from, action.Height);
+                changes.push_back({ChangeType::Subscribe, from, to, action.Height, {}});
+                break;
+            }
+            case ACTION_SUBSCRIBE_CANCEL:
+            {
+                int height;
+                if (!m_graph.Subscribes.Remove(from, to, height))
+                    break;
+
+                m_graph.Subscribers.Remove(to, from, height);
+                changes.push_back({ChangeType::Unsubscribe, from, to, height, {}});
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    void SocialGraph::Undo(const Change& change)
+    {
+        int height;
+
+        switch (change.Type)
+        {
+            case ChangeType::Content:
+                if (change.Prev.Type == 0)
+                    m_graph.Contents.Remove(change.From, change.To, height);
+
+                m_graph.Nodes[change.To] = change.Prev;
+                break;
+            case ChangeType::Like:
+                m_graph.Likes.Remove(change.From, change.To, height);
+                m_graph.Likers.Remove(change.To, change.From, height);
+                break;
+            case ChangeType::Subscribe:
+                m_graph.Subscribes.Remove(change.From, change.To, height);
+                m_graph.Subscribers.Remove(change.To, change.From, height);
+                break;
+            case ChangeType::Unsubscribe:
+                m_graph.Subscribes.Add(change.From, change.To, change.Height);
+                m_graph.Subscribers.Add(change.To, change.From, change.Height);
+                break;
+        }
+    }
+
+    bool SocialGraph::IsContent(const Node& node, const vector<int>& contentTypes, int minHeight)
+    {
+        return node.Type != 0 && node.Height >= minHeight &&
+               find(contentTypes.begin(), contentTypes.end(), node.Type) != contentTypes.end();
+    }
+
+    vector<int64_t> SocialGraph::Top(const unordered_map<int, int>& counts, int cntOut)
+    {
+        vector<pair<int, int>> items(counts.begin(), counts.end());
+        size_t count = cntOut < 0 ? items.size() : min(items.size(), (size_t) cntOut);
+
+        partial_sort(items.begin(), items.begin() + count, items.end(), [&](const auto& a, const auto& b)
+        {
+            return a.second != b.second ? a.second > b.second : m_graph.Nodes[a.first].Id < m_graph.Nodes[b.first].Id;
+        });
+
+        vector<int64_t> result;
+        result.reserve(count);
+        for (size_t i = 0; i < count; i++)
+            result.push_back(m_graph.Nodes[items[i].first].Id);
+
+        return result;
+    }
+
+    vector<int64_t> SocialGraph::GetRecomendedAccountsBySubscriptions(int64_t accountId, int cntOut)
+    {
+        LOCK(m_mutex);
+
+        int account = m_graph.GetNode(accountId);
+        if (!m_ready || account < 0)
+            return {};
+
+        // Subscribers of the account
+        vector<int> subscribers;
+        m_graph.Subscribers.Visit(account, [&](const auto& edge)
+        {
+            subscribers.push_back(edge.Target);
+            return (int) subscribers.size() < SOCIAL_GRAPH_FRONTIER;
+        });
+
+        // Other accounts they are subscribed to
+        unordered_map<int, int> counts;
+        for (int subscriber : subscribers)
+        {
+            int visited = 0;
+            m_graph.Subscribes.Visit(subscriber, [&](const auto& edge)
+            {
+                if (edge.Target != account)
+                    counts[edge.Target]++;
+
+                return ++visited < SOCIAL_GRAPH_FANOUT;
+            });
+        }
+
+        return Top(counts, cntOut);
+    }
+
+    vector<int64_t> SocialGraph::GetRecomendedAccountsByScoresOnSimilarAccounts(int64_t accountId, const vector<int>& contentTypes, int minHeight, int cntOut)
+    {
+        LOCK(m_mutex);
+
+        int account = m_graph.GetNode(accountId);
+        if (!m_ready || account < 0)
+            return {};
+
+        // Contents of the account
+        vector<int> contents;
+        int visited = 0;
+        m_graph.Contents.Visit(account, [&](const auto& edge)
+        {
+            if (IsContent(m_graph.Nodes[edge.Target], contentTypes, minHeight))
+                contents.push_back(edge.Target);
+
+            return ++visited < SOCIAL_GRAPH_FANOUT;
+        });
+
+        // Accounts liked these contents
+        unordered_set<int> likers;
+        for (int content : contents)
+        {
+            visited = 0;
+            m_graph.Likers.Visit(content, [&](const auto& edge)
+            {
+                if (edge.Height < minHeight)
+                    return false;
+
+                likers.insert(edge.Target);
+                return ++visited < SOCIAL_GRAPH_FANOUT && (int) likers.size() < SOCIAL_GRAPH_FRONTIER;
+            });
+        }
+
+        // Other contents liked by them
+        unordered_set<int> liked;
+        for (int liker : likers)
+        {
+            visited = 0;
+            m_graph.Likes.Visit(liker, [&](const auto& edge)
+            {
+                if (edge.Height < minHeight)
+                    return false;
+
+                liked.insert(edge.Target);
+                return ++visited < SOCIAL_GRAPH_FANOUT;
+            });
+        }
+
+        // Authors of these contents by count of contents
+        unordered_map<int, int> counts;
+        for (int content : liked)
+        {
+            const auto& node = m_graph.Nodes[content];
+            if (node.Author >= 0 && node.Author != account && IsContent(node, contentTypes, minHeight))
+                counts[node.Author]++;
+        }
+
+        return Top(counts, cntOut);
+    }
+
+    vector<int64_t> SocialGraph::GetRecomendedContentsByScoresOnSimilarContents(int64_t contentId, const vector<int>& contentTypes, int depth, int cntOut)
+    {
+        LOCK(m_mutex);
+
+        int content = m_graph.GetNode(contentId);
+        if (!m_ready || content < 0 || !IsContent(m_graph.Nodes[content], contentTypes, 0))
+            return {};
+
+        int minHeight = m_graph.Nodes[content].Height - depth;
+
+        // Accounts liked the content
+        vector<int> likers;
+        m_graph.Likers.Visit(content, [&](const auto& edge)
+        {
+            likers.push_back(edge.Target);
+            return (int) likers.size() < SOCIAL_GRAPH_FRONTIER;
+        });
+
+        // Other contents liked by them by count of likes
+        unordered_map<int, int> counts;
+        for (int liker : likers)
+        {
+            int visited = 0;
+            m_graph.Likes.Visit(liker, [&](const auto& edge)
+            {
+                if (edge.Height < minHeight)
+                    return false;
+
+                if (edge.Target != content && IsContent(m_graph.Nodes[edge.Target], contentTypes, 0))
+                    counts[edge.Target]++;
+
+                return ++visited < SOCIAL_GRAPH_FANOUT;
+            });
+        }
+
+        return Top(counts, cntOut);
+    }
+
+} // namespace PocketServices
@@ -0,0 +1,179 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETDB_SOCIAL_GRAPH_H
+#define POCKETDB_SOCIAL_GRAPH_H
+
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "sync.h"
+
+#include "pocketdb/models/web/SocialGraphAction.h"
+
+namespace PocketServices
+{
+    using namespace std;
+    using namespace PocketDbWeb;
+
+    // Edges visited from one node and nodes taken into one step of a walk
+    static const int SOCIAL_GRAPH_FANOUT = 200;
+    static const int SOCIAL_GRAPH_FRONTIER = 2000;
+
+    // Connected blocks that can be undone without rebuilding the graph
+    static const int SOCIAL_GRAPH_UNDO_DEPTH = 1000;
+
+    // Added edges that trigger rebuild of rows, at least this count and a part of rows
+    static const size_t SOCIAL_GRAPH_COMPACT_EDGES = 100000;
+
+    // Edges of one relation: compressed sparse rows built at once and per-node lists of edges added later.
+    // Removed edges of rows are marked and dropped when rows are built again.
+    class SocialGraphAdjacency
+    {
+    public:
+        struct Edge
+        {
+            int Target;
+            int Height;
+        };
+
+        // Edges as (from, to, height)
+        void Build(vector<tuple<int, int, int>>& edges, size_t nodes);
+        void Add(int from, int to, int height);
+        bool Remove(int from, int to, int& height);
+        bool Exists(int from, int to) const;
+
+        // Build rows again with added edges when they take a considerable part of the relation
+        void Compact(size_t nodes);
+
+        size_t Count() const;
+
+        // Edges from the newest until func returns false. Added edges follow the building height,
+        // so likes are visited in descending height order.
+        template<typename Func>
+        void Visit(int from, Func func) const
+        {
+            if (auto itr = m_added.find(from); itr != m_added.end())
+                for (auto edge = itr->second.rbegin(); edge != itr->second.rend(); ++edge)
+                    if (!func(*edge))
+                        return;
+
+            if (from < 0 || from + 1 >= (int) m_offsets.size())
+                return;
+
+            for (auto i = m_offsets[from]; i < m_offsets[from + 1]; i++)
+                if (m_edges[i].Target >= 0 && !func(m_edges[i]))
+                    return;
+        }
+
+    private:
+        vector<uint32_t> m_offsets;
+        vector<Edge> m_edges;
+        unordered_map<int, vector<Edge>> m_added;
+        size_t m_addedCount = 0;
+        size_t m_removedCount = 0;
+    };
+
+    // In-memory graph of subscriptions, likes and authors of contents for recommendations.
+    // Built by web post-processing at the height of a connected block and updated by following blocks.
+    // Changes of last blocks are journaled, so disconnected blocks are undone without rebuilding.
+    // Walks visit bounded number of edges, newest first.
+    class SocialGraph
+    {
+    public:
+        bool IsReady() const;
+
+        // Called before actions for Build are loaded. Blocks disconnected after it make the graph stale.
+        void BeginBuild();
+
+        // Returns false and keeps the previous graph if blocks at or below height were disconnected
+        // since BeginBuild - the graph must be built again at the new height of the chain
+        bool Build(const vector<SocialGraphAction>& actions, int height);
+
+        // Block at or below the current height replaces disconnected blocks
+        void Apply(const vector<SocialGraphAction>& actions, int height);
+
+        // Undo blocks at or above height. Graph is dropped if they are not journaled.
+        void Rollback(int height);
+
+        void Clear();
+
+        // Results are ids of Transactions ordered by relevance
+        vector<int64_t> GetRecomendedAccountsBySubscriptions(int64_t accountId, int cntOut);
+        vector<int64_t> GetRecomendedAccountsByScoresOnSimilarAccounts(int64_t accountId, const vector<int>& contentTypes, int minHeight, int cntOut);
+        vector<int64_t> GetRecomendedContentsByScoresOnSimilarContents(int64_t contentId, const vector<int>& contentTypes, int depth, int cntOut);
+
+    private:
+        struct Node
+        {
+            int64_t Id = -1;
+            int Author = -1;
+            int Height = 0;
+            int Type = 0;
+        };
+
+        enum class ChangeType
+        {
+            Content,
+            Like,
+            Subscribe,
+            Unsubscribe,
+        };
+
+        // Content: From - author, To - content with previous state in Prev
+        struct Change
+        {
+            ChangeType Type;
+            int From;
+            int To;
+            int Height;
+            Node Prev;
+        };
+
+        struct Graph
+        {
+            // Nodes are accounts and contents, indexed densely
+            unordered_map<int64_t, int> Index;
+            vector<Node> Nodes;
+
+            SocialGraphAdjacency Subscribes;
+            SocialGraphAdjacency Subscribers;
+            SocialGraphAdjacency Likes;
+            SocialGraphAdjacency Likers;
+            SocialGraphAdjacency Contents;
+
+            int GetNode(int64_t id) const;
+            int AddNode(int64_t id);
+        };
+
+        atomic<bool> m_ready{false};
+
+        Mutex m_mutex;
+        Graph m_graph GUARDED_BY(m_mutex);
+        int m_height GUARDED_BY(m_mutex) = -1;
+        // Lowest height of block that can be undone
+        int m_undoHeight GUARDED_BY(m_mutex) = -1;
+        deque<pair<int, vector<Change>>> m_journal GUARDED_BY(m_mutex);
+        // Lowest height rolled back since BeginBuild
+        int m_buildRollbackHeight GUARDED_BY(m_mutex) = numeric_limits<int>::max();
+
+        void RollbackLocked(int height) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+        void ClearLocked() EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+        void ApplyAction(const SocialGraphAction& action, vector<Change>& changes) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+        void Undo(const Change& change) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+
+        static bool IsContent(const Node& node, const vector<int>& contentTypes, int minHeight);
+
+        vector<int64_t> Top(const unordered_map<int, int>& counts, int cntOut) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    };
+
+    extern SocialGraph SocialGraphInst;
+
+} // namespace PocketServices
+
+#endif // POCKETDB_SOCIAL_GRAPH_H
@@ -0,0 +1,93 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/services/UnspentsCache.h"
+
+namespace PocketServices
+{
+    UnspentsCache UnspentsCacheInst;
+
+    bool UnspentsCache::Get(const string& address, vector<UnspentOutput>& outputs)
+    {
+        LOCK(m_mutex);
+
+        auto itr = m_addresses.find(address);
+        if (itr == m_addresses.end())
+            return false;
+
+        // Move to front as most recently used
+        m_lru.splice(m_lru.begin(), m_lru, itr->second.Lru);
+        outputs.insert(outputs.end(), itr->second.Outputs.begin(), itr->second.Outputs.end());
+        return true;
+    }
+
+    int64_t UnspentsCache::Generation()
+    {
+        LOCK(m_mutex);
+        return m_generation;
+    }
+
+    void UnspentsCache::Put(const string& address, vector<UnspentOutput> outputs, int64_t generation)
+    {
+        LOCK(m_mutex);
+
+        if (generation != m_generation || outputs.size() > POCKET_UNSPENTS_CACHE_ADDRESS_OUTPUTS)
+            return;
+
+        Erase(address);
+
+        for (const auto& output : outputs)
+            m_outputs.emplace(make_pair(output.TxHash, output.Number), address);
+
+        m_lru.push_front(address);
+        m_addresses.emplace(address, Entry{move(outputs), m_lru.begin()});
+
+        while (m_outputs.size() > POCKET_UNSPENTS_CACHE_OUTPUTS && !m_lru.empty())
+            Erase(m_lru.back());
+    }
+
+    void UnspentsCache::BlockConnected(const vector<TransactionIndexingInfo>& txs)
+    {
+        LOCK(m_mutex);
+
+        m_generation += 1;
+
+        if (m_addresses.empty())
+            return;
+
+        for (const auto& txInfo : txs)
+        {
+            for (const auto& output : txInfo.Outputs)
+                Erase(output.first);
+
+            for (const auto& input : txInfo.Inputs)
+                if (auto itr = m_outputs.find(input); itr != m_outputs.end())
+                    Erase(string(itr->second));
+        }
+    }
+
+    void UnspentsCache::Clear()
+    {
+        LOCK(m_mutex);
+
+        m_generation += 1;
+        m_lru.clear();
+        m_addresses.clear();
+        m_outputs.clear();
+    }
+
+    void UnspentsCache::Erase(const string& address)
+    {
+        auto itr = m_addresses.find(address);
+        if (itr == m_addresses.end())
+            return;
+
+        for (const auto& output : itr->second.Outputs)
+            m_outputs.erase({output.TxHash, output.Number});
+
+        m_lru.erase(itr->second.Lru);
+        m_addresses.erase(itr);
+    }
+
+} // namespace PocketServices
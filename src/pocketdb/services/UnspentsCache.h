@@ -0,0 +1,67 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETDB_UNSPENTS_CACHE_H
+#define POCKETDB_UNSPENTS_CACHE_H
+
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sync.h"
+
+#include "pocketdb/models/base/PocketTypes.h"
+#include "pocketdb/models/web/UnspentOutput.h"
+
+namespace PocketServices
+{
+    using namespace std;
+    using namespace PocketTx;
+    using namespace PocketDbWeb;
+
+    // Unspent outputs kept in memory for all addresses together
+    static const size_t POCKET_UNSPENTS_CACHE_OUTPUTS = 200000;
+    // Addresses with more unspent outputs are always read from database
+    static const size_t POCKET_UNSPENTS_CACHE_ADDRESS_OUTPUTS = 1000;
+
+    // Bounded LRU of confirmed unspent outputs of recently requested addresses.
+    // Addresses receiving or spending outputs in a connected block are dropped, disconnected blocks drop all.
+    // Outputs spent by mempool are excluded by readers - the cache follows only the chain.
+    class UnspentsCache
+    {
+    public:
+        // Appends cached outputs of address, false if address is not cached
+        bool Get(const string& address, vector<UnspentOutput>& outputs);
+
+        // Outputs read from database before the chain changed are not saved
+        int64_t Generation();
+        void Put(const string& address, vector<UnspentOutput> outputs, int64_t generation);
+
+        void BlockConnected(const vector<TransactionIndexingInfo>& txs);
+        void Clear();
+
+    private:
+        struct Entry
+        {
+            vector<UnspentOutput> Outputs;
+            list<string>::iterator Lru;
+        };
+
+        Mutex m_mutex;
+        list<string> m_lru GUARDED_BY(m_mutex);
+        unordered_map<string, Entry> m_addresses GUARDED_BY(m_mutex);
+        // Cached outputs by (TxHash, Number) to find addresses spending in block
+        map<pair<string, int>, string> m_outputs GUARDED_BY(m_mutex);
+        int64_t m_generation GUARDED_BY(m_mutex) = 0;
+
+        void Erase(const string& address) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    };
+
+    extern UnspentsCache UnspentsCacheInst;
+
+} // namespace PocketServices
+
+#endif // POCKETDB_UNSPENTS_CACHE_H
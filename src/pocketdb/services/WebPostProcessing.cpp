@@ -3,14 +3,50 @@
 // https://www.apache.org/licenses/LICENSE-2.0
 
 #include "pocketdb/services/WebPostProcessing.h"
+#include "pocketdb/services/BulkSync.h"
+#include "rpc/cache.h"
 
 namespace PocketServices
 {
+    bool ApplyCatchupChunk(SQLiteDatabase& db, int fromHeight, int toHeight, const function<void(int, int)>& apply)
+    {
+        for (int attempt = 1; attempt <= WEB_CATCHUP_ATTEMPTS; attempt++)
+        {
+            try
+            {
+                if (!db.BeginBatch())
+                    throw std::runtime_error("can't begin transaction");
+
+                apply(fromHeight, toHeight);
+
+                if (!db.CommitBatch())
+                    throw std::runtime_error("can't commit transaction");
+
+                return true;
+            }
+            catch (const std::exception& e)
+            {
+                db.AbortBatch();
+                LogPrintf("Warning: WebPostProcessor::ProcessRange - heights %d..%d (attempt %d): %s\n",
+                    fromHeight, toHeight, attempt, e.what());
+            }
+        }
+
+        return false;
+    }
+
     WebPostProcessor::WebPostProcessor() = default;
 
-    void WebPostProcessor::Start(boost::thread_group& threadGroup)
+    void WebPostProcessor::Start(boost::thread_group& threadGroup, int queueSize)
     {
-        shutdown = false;
+        {
+            LOCK(_queue_mutex);
+
+            shutdown = false;
+            running = true;
+            _queue_size = (size_t) max(WEB_CATCHUP_BLOCKS, queueSize);
+        }
+
         threadGroup.create_thread([this] { Worker(); });
     }
 
@@ -22,6 +58,7 @@ namespace PocketServices
 
             shutdown = true;
             _queue_cond.notify_all();
+            _space_cond.notify_all();
         }
 
         // Wait all tasks completed
@@ -42,50 +79,214 @@ namespace PocketServices
         sqliteDbInst->AttachDatabase("web");
 
         webRepoInst = make_shared<WebRepository>(*sqliteDbInst);
+        webRepoInst->Init();
+        feedRepoInst = make_shared<FeedRepository>(*sqliteDbInst);
 
         // Start worker infinity loop
         while (true)
         {
-            string blockHash;
+            int fromHeight = -1;
+            int toHeight = -1;
 
             {
                 WAIT_LOCK(_queue_mutex, lock);
 
-                while (!shutdown && _queue_records.empty())
+                while (!shutdown && _queue_records.empty() && _range_from < 0)
                     _queue_cond.wait(lock);
 
                 if (shutdown) break;
 
-                blockHash = std::move(_queue_records.front());
-                _queue_records.pop_front();
+                // Far behind the chain - take all queued blocks as one height range
+                if (_range_from >= 0 || _queue_records.size() >= (size_t) WEB_CATCHUP_BLOCKS)
+                {
+                    fromHeight = _range_from;
+                    toHeight = _range_to;
+
+                    for (const auto& [blockHash, height] : _queue_records)
+                    {
+                        fromHeight = fromHeight < 0 ? height : min(fromHeight, height);
+                        toHeight = max(toHeight, height);
+                    }
+
+                    _queue_records.clear();
+                    _range_from = -1;
+                    _range_to = -1;
+                    _space_cond.notify_all();
+                }
             }
 
-            ProcessTags(blockHash);
-            ProcessSearchContent(blockHash);
+            if (fromHeight >= 0)
+                ProcessRange(fromHeight, toHeight);
+            else
+                ProcessBatch();
         }
 
+        // Queue is not persisted - feed tables and social graph are rebuilt on next start
+        FeedRepository::SetReady(false);
+        SocialGraphInst.Clear();
+
         // Shutdown DB
         sqliteDbInst->m_connection_mutex.lock();
 
         webRepoInst->Destroy();
         webRepoInst = nullptr;
 
+        feedRepoInst->Destroy();
+        feedRepoInst = nullptr;
+
         sqliteDbInst->DetachDatabase("web");
         sqliteDbInst->Close();
 
         sqliteDbInst->m_connection_mutex.unlock();
         sqliteDbInst = nullptr;
 
+        {
+            LOCK(_queue_mutex);
+            running = false;
+            _space_cond.notify_all();
+        }
+
         LogPrintf("WebPostProcessor: thread worker exit\n");
     }
 
-    void WebPostProcessor::Enqueue(const string& blockHash)
+    void WebPostProcessor::Enqueue(const string& blockHash, int height)
+    {
+        WAIT_LOCK(_queue_mutex, lock);
+
+        // Backpressure: block connection waits for the worker instead of growing the queue.
+        // Wait is bounded - it runs under cs_main and the worker can be busy with a long rebuild
+        auto deadline = chrono::steady_clock::now() + chrono::microseconds(WEB_QUEUE_WAIT_TIME);
+        while (running && !shutdown && _queue_records.size() >= _queue_size)
+        {
+            if (_space_cond.wait_until(lock, deadline) == cv_status::timeout)
+            {
+                LogPrint(BCLog::SYNC, "WebPostProcessor: queue of %d blocks is full, enqueue block %d\n",
+                    (int) _queue_records.size(), height);
+                break;
+            }
+        }
+
+        _queue_records.emplace_back(blockHash, height);
+        _queue_cond.notify_one();
+    }
+
+    void WebPostProcessor::EnqueueRange(int fromHeight, int toHeight)
     {
         LOCK(_queue_mutex);
-        _queue_records.emplace_back(blockHash);
+
+        _range_from = _range_from < 0 ? fromHeight : min(_range_from, fromHeight);
+        _range_to = max(_range_to, toHeight);
         _queue_cond.notify_one();
     }
 
+    WebPostProcessorStats WebPostProcessor::GetStats()
+    {
+        LOCK(_queue_mutex);
+
+        WebPostProcessorStats stats;
+        stats.Queue = (int) _queue_records.size();
+        stats.Height = _height;
+        return stats;
+    }
+
+    void WebPostProcessor::ProcessBatch()
+    {
+        int64_t nTime1 = GetTimeMicros();
+        int blocks = 0;
+        int lastHeight = -1;
+
+        // Steps of every block become savepoints of one transaction
+        if (!sqliteDbInst->BeginBatch())
+            LogPrintf("Warning: WebPostProcessor::ProcessBatch - can't begin transaction\n");
+
+        while (blocks < WEB_BATCH_BLOCKS && GetTimeMicros() - nTime1 < WEB_BATCH_TIME)
+        {
+            string blockHash;
+            int height;
+
+            {
+                LOCK(_queue_mutex);
+
+                if (shutdown || _queue_records.empty())
+                    break;
+
+                tie(blockHash, height) = std::move(_queue_records.front());
+                _queue_records.pop_front();
+                _space_cond.notify_one();
+            }
+
+            ProcessTags(blockHash);
+            ProcessSearchContent(blockHash);
+            ProcessFeed(blockHash);
+            ProcessSocialGraph(blockHash);
+
+            lastHeight = height;
+            blocks++;
+        }
+
+        if (!sqliteDbInst->CommitBatch())
+        {
+            // Feed tables follow written blocks and must be rebuilt
+            feedHeight = -1;
+            LogPrintf("Warning: WebPostProcessor::ProcessBatch - failed commit %d blocks\n", blocks);
+        }
+        else if (lastHeight >= 0)
+        {
+            _height = lastHeight;
+
+            // Cached RPC results may miss tags, search content and feeds of these blocks
+            g_rpc_cache.Invalidate();
+        }
+
+        // RPC connections see feed tables only after commit
+        FeedRepository::SetReady(feedHeight >= 0);
+
+        LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessBatch: %d blocks %.2fms\n", blocks, 0.001 * (double)(GetTimeMicros() - nTime1));
+    }
+
+    void WebPostProcessor::ProcessRange(int fromHeight, int toHeight)
+    {
+        LogPrintf("WebPostProcessor: rebuilding web database for heights %d..%d\n", fromHeight, toHeight);
+
+        int64_t nTime1 = GetTimeMicros();
+
+        // Feed tables and social graph are rebuilt after catch-up
+        feedHeight = -1;
+        FeedRepository::SetReady(false);
+        SocialGraphInst.Clear();
+
+        for (int height = fromHeight; height <= toHeight; height += WEB_CATCHUP_CHUNK)
+        {
+            int chunkTo = min(toHeight, height + WEB_CATCHUP_CHUNK - 1);
+
+            // Chunk is applied completely or not at all
+            bool done = ApplyCatchupChunk(*sqliteDbInst, height, chunkTo, [&](int from, int to)
+            {
+                webRepoInst->RebuildContentTags(from, to);
+                webRepoInst->RebuildContent(from, to);
+            });
+
+            if (!done)
+            {
+                LogPrintf("Error: WebPostProcessor::ProcessRange - web database catch-up stopped at height %d, "
+                          "restart with -reindex=5 to rebuild it\n", height);
+                return;
+            }
+
+            _height = chunkTo;
+            g_rpc_cache.Invalidate();
+
+            {
+                LOCK(_queue_mutex);
+                if (shutdown)
+                    return;
+            }
+
+            LogPrintf("WebPostProcessor: rebuilt web database up to height %d (%.2fm)\n", chunkTo,
+                (0.000001 * (GetTimeMicros() - nTime1)) / 60.0);
+        }
+    }
+
     void WebPostProcessor::ProcessTags(const string& blockHash)
     {
         try
@@ -174,5 +375,101 @@ namespace PocketServices
         }
     }
 
+    void WebPostProcessor::ProcessFeed(const string& blockHash)
+    {
+        try
+        {
+            // Feed tables are built at once when the node is synced.
+            // Not checked with IBD state - it takes cs_main while block connection may wait for the queue.
+            if (BulkSyncInst.IsActive())
+            {
+                feedHeight = -1;
+                return;
+            }
+
+            int64_t nTime1 = GetTimeMicros();
+
+            int height = feedRepoInst->GetBlockHeight(blockHash);
+            if (height < 0)
+                return;
+
+            if (feedHeight < 0)
+            {
+                LogPrintf("WebPostProcessor: building feed tables at height %d..\n", height);
+
+                feedRepoInst->Rebuild();
+                feedHeight = height;
+
+                LogPrintf("WebPostProcessor: feed tables built in %.2fs\n", 0.000001 * (double)(GetTimeMicros() - nTime1));
+                return;
+            }
+
+            // Block at or below the last applied height replaces disconnected blocks
+            feedRepoInst->Refresh(blockHash, height, height <= feedHeight ? height : -1);
+            feedHeight = height;
+
+            int64_t nTime2 = GetTimeMicros();
+            LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessFeed: %.2fms\n", 0.001 * (double)(nTime2 - nTime1));
+        }
+        catch (const std::exception& e)
+        {
+            // Feed RPCs read source tables until the feed is rebuilt
+            feedHeight = -1;
+            FeedRepository::SetReady(false);
+            LogPrintf("Warning: WebPostProcessor::ProcessFeed - %s\n", e.what());
+        }
+    }
+
+    void WebPostProcessor::ProcessSocialGraph(const string& blockHash)
+    {
+        try
+        {
+            // Built at once when the node is synced, same as feed tables
+            if (BulkSyncInst.IsActive())
+            {
+                SocialGraphInst.Clear();
+                return;
+            }
+
+            int64_t nTime1 = GetTimeMicros();
+
+            int height = feedRepoInst->GetBlockHeight(blockHash);
+            if (height < 0)
+                return;
+
+            if (!SocialGraphInst.IsReady())
+            {
+                // Graph built with disconnected blocks is not installed - build it again
+                // while the block is still in the chain, otherwise with the next block
+                while (height >= 0)
+                {
+                    LogPrintf("WebPostProcessor: building social graph at height %d..\n", height);
+
+                    SocialGraphInst.BeginBuild();
+                    if (SocialGraphInst.Build(webRepoInst->GetSocialGraph(height), height))
+                    {
+                        LogPrintf("WebPostProcessor: social graph built in %.2fs\n", 0.000001 * (double)(GetTimeMicros() - nTime1));
+                        break;
+                    }
+
+                    height = feedRepoInst->GetBlockHeight(blockHash);
+                }
+
+                return;
+            }
+
+            SocialGraphInst.Apply(webRepoInst->GetSocialGraphActions(blockHash), height);
+
+            int64_t nTime2 = GetTimeMicros();
+            LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessSocialGraph: %.2fms\n", 0.001 * (double)(nTime2 - nTime1));
+        }
+        catch (const std::exception& e)
+        {
+            // Recommendation RPCs read source tables until the graph is rebuilt
+            SocialGraphInst.Clear();
+            LogPrintf("Warning: WebPostProcessor::ProcessSocialGraph - %s\n", e.what());
+        }
+    }
+
 
 } // PocketServices
\ No newline at end of file
@@ -5,6 +5,7 @@
 #ifndef POCKETDB_WEB_POST_PROCESSING_H
 #define POCKETDB_WEB_POST_PROCESSING_H
 
+#include <atomic>
 #include <boost/thread.hpp>
 #include "util/time.h"
 #include "sync.h"
@@ -12,6 +13,8 @@
 
 #include "pocketdb/SQLiteDatabase.h"
 #include "pocketdb/repositories/web/WebRepository.h"
+#include "pocketdb/repositories/web/FeedRepository.h"
+#include "pocketdb/services/SocialGraph.h"
 #include "pocketdb/models/web/WebTag.h"
 #include "pocketdb/models/web/WebContent.h"
 
@@ -20,32 +23,78 @@ namespace PocketServices
     using namespace PocketDb;
     using namespace PocketDbWeb;
 
+    static const int DEFAULT_WEB_QUEUE_SIZE = 5000;
+
+    // Longest wait of block connection for space in the full queue; the queue grows after it
+    static const int64_t WEB_QUEUE_WAIT_TIME = 10 * 1000 * 1000;
+
+    // Blocks written in one transaction of web DB
+    static const int WEB_BATCH_BLOCKS = 100;
+    static const int64_t WEB_BATCH_TIME = 1000 * 1000;
+
+    // Queued blocks switching the processor to set-based rebuild of their height range
+    static const int WEB_CATCHUP_BLOCKS = 500;
+    static const int WEB_CATCHUP_CHUNK = 1000;
+    static const int WEB_CATCHUP_ATTEMPTS = 3;
+
+    // Applies heights fromHeight..toHeight in one batch of db. Failed attempt is rolled back
+    // and retried up to WEB_CATCHUP_ATTEMPTS times; returns false if all of them failed.
+    bool ApplyCatchupChunk(SQLiteDatabase& db, int fromHeight, int toHeight, const function<void(int, int)>& apply);
+
+    struct WebPostProcessorStats
+    {
+        int Queue = 0;
+        int Height = -1;
+    };
+
+    // Builds web DB (tags, search content, feeds) and social graph for connected blocks.
+    // Queued blocks are written in batches of one transaction. When the queue grows
+    // behind the chain, the whole height range of queued blocks is rebuilt with set-based SQL.
+    // Enqueue blocks the caller while the queue is full, at most for WEB_QUEUE_WAIT_TIME.
     class WebPostProcessor
     {
     public:
         WebPostProcessor();
-        void Start(boost::thread_group& threadGroup);
+        void Start(boost::thread_group& threadGroup, int queueSize = DEFAULT_WEB_QUEUE_SIZE);
         void Stop();
 
-        void Enqueue(const string& blockHash);
-                
-        void ProcessTags(const string& blockHash);
-        void ProcessSearchContent(const string& blockHash);
+        void Enqueue(const string& blockHash, int height);
+
+        // Rebuild web DB for height range in background
+        void EnqueueRange(int fromHeight, int toHeight);
+
+        WebPostProcessorStats GetStats();
 
     private:
         SQLiteDatabaseRef sqliteDbInst;
         WebRepositoryRef webRepoInst;
+        FeedRepositoryRef feedRepoInst;
+
+        // Height of the last block applied to feed tables, -1 if tables must be rebuilt
+        int feedHeight = -1;
 
-        uint32_t sleep = 5 * 1000;
         bool shutdown = false;
+        bool running = false;
+        size_t _queue_size = DEFAULT_WEB_QUEUE_SIZE;
+        atomic<int> _height{-1};
 
         Mutex _running_mutex;
         Mutex _queue_mutex;
         std::condition_variable _queue_cond;
-        deque<string> _queue_records;
+        std::condition_variable _space_cond;
+        deque<pair<string, int>> _queue_records;
+        int _range_from = -1;
+        int _range_to = -1;
 
         void Worker();
 
+        void ProcessBatch();
+        void ProcessRange(int fromHeight, int toHeight);
+
+        void ProcessTags(const string& blockHash);
+        void ProcessSearchContent(const string& blockHash);
+        void ProcessFeed(const string& blockHash);
+        void ProcessSocialGraph(const string& blockHash);
     };
 
 } // PocketServices
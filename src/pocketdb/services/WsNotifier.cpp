@@ -2,4 +2,675 @@
 // Distributed under the Apache 2.0 software license, see the accompanying
 // https://www.apache.org/licenses/LICENSE-2.0
 
-#include "WsNotifier.h"
+#include "pocketdb/services/WsNotifier.h"
+
+#include "chainparams.h"
+#include "core_io.h"
+#include "key_io.h"
+#include "validation.h"
+#include "pocketdb/helpers/TransactionHelper.h"
+
+#include <boost/algorithm/string.hpp>
+
+namespace PocketServices
+{
+    using namespace PocketHelpers;
+
+    WsNotifier::WsNotifier() = default;
+
+    void WsNotifier::Start(boost::thread_group& threadGroup, int senders, int clientQueueLimit)
+    {
+        shutdown = false;
+        this->clientQueueLimit = max(1, clientQueueLimit);
+
+        {
+            LOCK(_send_mutex);
+            _send_jobs.assign(max(1, senders), {});
+        }
+
+        threadGroup.create_thread([this] { Worker(); });
+        for (size_t i = 0; i < _send_jobs.size(); i++)
+            threadGroup.create_thread([this, i] { Sender(i); });
+    }
+
+    void WsNotifier::Stop()
+    {
+        // Signal for complete all tasks
+        {
+            LOCK(_queue_mutex);
+
+            shutdown = true;
+            _queue_cond.notify_all();
+        }
+
+        {
+            WAIT_LOCK(_send_mutex, lock);
+
+            _send_cond.notify_all();
+            while (_senders_running > 0)
+                _send_cond.wait(lock);
+        }
+
+        // Wait all tasks completed
+        LOCK(_running_mutex);
+    }
+
+    void WsNotifier::Enqueue(const shared_ptr<const CBlock>& block, int height)
+    {
+        LOCK(_queue_mutex);
+
+        if (shutdown)
+            return;
+
+        // Notifier does not keep up (fast sync) - clients are notified of the newest blocks only
+        while (_queue_records.size() >= WS_BLOCK_QUEUE_LIMIT)
+        {
+            LogPrint(BCLog::SYNC, "WsNotifier: skip notifications of block %d\n", _queue_records.front().Height);
+            _queue_records.pop_front();
+        }
+
+        _queue_records.push_back({block, height});
+        _queue_cond.notify_one();
+    }
+
+    void WsNotifier::Worker()
+    {
+        LogPrintf("WsNotifier: starting thread worker\n");
+
+        LOCK(_running_mutex);
+
+        // Run database
+        auto dbBasePath = (GetDataDir() / "pocketdb").string();
+
+        sqliteDbInst = make_shared<SQLiteDatabase>(true);
+        sqliteDbInst->Init(dbBasePath, "main");
+
+        notifierRepoInst = make_shared<NotifierRepository>(*sqliteDbInst);
+
+        // Start worker infinity loop
+        while (true)
+        {
+            BlockEvent event;
+
+            {
+                WAIT_LOCK(_queue_mutex, lock);
+
+                while (!shutdown && _queue_records.empty())
+                    _queue_cond.wait(lock);
+
+                if (shutdown) break;
+
+                event = std::move(_queue_records.front());
+                _queue_records.pop_front();
+            }
+
+            try
+            {
+                Process(*event.Block, event.Height);
+            }
+            catch (const std::exception& e)
+            {
+                LogPrintf("Error: WsNotifier::Process - %s\n", e.what());
+            }
+        }
+
+        // Shutdown DB
+        sqliteDbInst->m_connection_mutex.lock();
+
+        notifierRepoInst->Destroy();
+        notifierRepoInst = nullptr;
+
+        sqliteDbInst->Close();
+
+        sqliteDbInst->m_connection_mutex.unlock();
+        sqliteDbInst = nullptr;
+
+        LogPrintf("WsNotifier: thread worker exit\n");
+    }
+
+    void WsNotifier::Sender(size_t shard)
+    {
+        {
+            LOCK(_send_mutex);
+            _senders_running += 1;
+        }
+
+        while (true)
+        {
+            SendJob job;
+
+            {
+                WAIT_LOCK(_send_mutex, lock);
+
+                auto& jobs = _send_jobs[shard];
+                while (!shutdown && jobs.empty())
+                    _send_cond.wait(lock);
+
+                if (shutdown) break;
+
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+
+            Send(job);
+        }
+
+        LOCK(_send_mutex);
+        _senders_running -= 1;
+        _send_cond.notify_all();
+    }
+
+    void WsNotifier::Send(SendJob& job)
+    {
+        shared_ptr<atomic<int>> pending;
+
+        {
+            LOCK(_pending_mutex);
+
+            auto& counter = _pending[job.ConnectionId];
+            if (!counter) counter = make_shared<atomic<int>>(0);
+            pending = counter;
+        }
+
+        // The previous blocks are still queued in the connection - the client does not keep up
+        if (*pending + (int) job.Messages.size() > clientQueueLimit)
+        {
+            LogPrintf("WsNotifier: dropping slow client %s (%d messages pending)\n",
+                job.Connection->remote_endpoint_address(), pending->load());
+
+            Drop(job.ConnectionId, job.Connection);
+            return;
+        }
+
+        for (const auto& message : job.Messages)
+        {
+            try
+            {
+                *pending += 1;
+                job.Connection->send(message, [pending](const SimpleWeb::error_code& ec) { *pending -= 1; });
+            }
+            catch (const std::exception& e)
+            {
+                *pending -= 1;
+                LogPrintf("Error: WsNotifier::Send - %s\n", e.what());
+            }
+        }
+    }
+
+    void WsNotifier::Drop(const string& connectionId, const shared_ptr<WsConnection>& connection)
+    {
+        {
+            boost::lock_guard<boost::mutex> guard(WSMutex);
+            auto it = WSConnections.find(connectionId);
+            if (it != WSConnections.end() && it->second.Connection == connection)
+                WSConnections.erase(it);
+        }
+
+        {
+            LOCK(_pending_mutex);
+            _pending.erase(connectionId);
+        }
+
+        try
+        {
+            connection->send_close(1008, "Notification queue overflow");
+        }
+        catch (const std::exception& e)
+        {
+            LogPrintf("Error: WsNotifier::Drop - %s\n", e.what());
+        }
+    }
+
+    void WsNotifier::Process(const CBlock& block, int height)
+    {
+        int64_t nTime1 = GetTimeMicros();
+
+        map<string, vector<UniValue>> messages;
+        int sharesCnt = 0;
+        map<string, map<string, int>> contentLangCnt;
+        map<string, string> contentTypes;
+        string txidpocketnet;
+        string addrespocketnet = (Params().NetworkIDString() == CBaseChainParams::MAIN) ? "PEj7QNjKdDPqE9kMDRboKoCtp8V6vZeZPd" : "TAqR1ncH95eq9XKSDRR18DtpXqktxh74UU";
+        auto pocketnetaccinfo = notifierRepoInst->GetAccountInfoByAddress(addrespocketnet);
+
+        struct TxEvent
+        {
+            string Txid;
+            int64_t Time;
+            string OpType;
+            map<string, pair<int, int64_t>> Addrs;
+        };
+
+        // Collect transactions of the block and keys for lookups by type of operation
+        vector<TxEvent> events;
+        events.reserve(block.vtx.size());
+        map<string, set<string>> keys;
+
+        for (const auto& tx : block.vtx)
+        {
+            TxEvent event{tx->GetHash().GetHex(), tx->nTime, "", {}};
+            auto& addrs = event.Addrs;
+            const auto& txid = event.Txid;
+            auto& optype = event.OpType;
+
+            // Get all addresses from tx outs and check OP_RETURN
+            for (int i = 0; i < (int) tx->vout.size(); i++)
+            {
+                const CTxOut& txout = tx->vout[i];
+                //-------------------------
+                if (!txout.scriptPubKey.empty() && txout.scriptPubKey[0] == OP_RETURN)
+                {
+                    string asmstr = ScriptToAsmStr(txout.scriptPubKey);
+                    vector<string> spl;
+                    boost::split(spl, asmstr, boost::is_any_of("\t "));
+                    if (spl.size() >= 3)
+                    {
+                        if (spl[1] == OR_POST)
+                        {
+                            optype = "share";
+                            sharesCnt += 1;
+                            contentTypes.emplace(txid, OR_POST);
+                        }
+                        else if (spl[1] == OR_VIDEO)
+                        {
+                            optype = "video";
+                            sharesCnt += 1;
+                            contentTypes.emplace(txid, OR_VIDEO);
+                        }
+                        else if (spl[1] == OR_SCORE)
+                            optype = "upvoteShare";
+                        else if (spl[1] == OR_SUBSCRIBE)
+                            optype = "subscribe";
+                        else if (spl[1] == OR_SUBSCRIBEPRIVATE)
+                            optype = "subscribePrivate";
+                        else if (spl[1] == OR_USERINFO)
+                            optype = "userInfo";
+                        else if (spl[1] == OR_UNSUBSCRIBE)
+                            optype = "unsubscribe";
+                        else if (spl[1] == OR_COMMENT_SCORE)
+                            optype = "cScore";
+                        else if (spl[1] == OR_COMMENT)
+                            optype = "comment";
+                        else if (spl[1] == OR_COMMENT_EDIT)
+                            optype = "commentEdit";
+                        else if (spl[1] == OR_COMMENT_DELETE)
+                            optype = "commentDelete";
+                    }
+                }
+                //-------------------------
+                CTxDestination destAddress;
+                bool fValidAddress = ExtractDestination(txout.scriptPubKey, destAddress);
+                if (fValidAddress)
+                {
+                    string encoded_address = EncodeDestination(destAddress);
+                    if (addrs.find(encoded_address) == addrs.end())
+                        addrs.emplace(encoded_address, make_pair(i, (int64_t) txout.nValue));
+                }
+            }
+
+            if (!addrs.empty())
+            {
+                if (optype == "share" || optype == "video")
+                {
+                    keys["content"].insert(txid);
+                    for (const auto& addr : addrs)
+                        keys["privateSubscribers"].insert(addr.first);
+                }
+                else if (optype == "subscribe" || optype == "subscribePrivate" || optype == "unsubscribe")
+                    keys["subscribe"].insert(txid);
+                else if (optype == "comment" || optype == "commentEdit" || optype == "commentDelete")
+                    keys["comment"].insert(txid);
+                else if (!optype.empty())
+                    keys[optype].insert(txid);
+            }
+
+            events.push_back(std::move(event));
+        }
+
+        // Data for all transactions of the block with one query per kind of lookup
+        auto keysOf = [&](const string& kind) { return vector<string>(keys[kind].begin(), keys[kind].end()); };
+        auto postInfos = notifierRepoInst->GetPostInfo(keysOf("content"));
+        auto reposts = notifierRepoInst->GetOriginalPostAddressByRepost(keysOf("content"));
+        auto privateSubscribers = notifierRepoInst->GetPrivateSubscribeAddressesByAddressTo(keysOf("privateSubscribers"));
+        auto referrers = notifierRepoInst->GetUserReferrerAddress(keysOf("userInfo"));
+        auto postScores = notifierRepoInst->GetPostInfoAddressByScore(keysOf("upvoteShare"));
+        auto subscribes = notifierRepoInst->GetSubscribeAddressTo(keysOf("subscribe"));
+        auto commentScores = notifierRepoInst->GetCommentInfoAddressByScore(keysOf("cScore"));
+        auto comments = notifierRepoInst->GetFullCommentInfo(keysOf("comment"));
+
+        const UniValue emptyObject(UniValue::VOBJ);
+        const UniValue emptyArray(UniValue::VARR);
+        auto find = [](const map<string, UniValue>& data, const string& key, const UniValue& empty) -> const UniValue&
+        {
+            auto it = data.find(key);
+            return it != data.end() ? it->second : empty;
+        };
+
+        for (const auto& event : events)
+        {
+            const auto& txid = event.Txid;
+            const auto& optype = event.OpType;
+            int64_t txtime = event.Time;
+
+            for (auto const& addr : event.Addrs)
+            {
+                // Event for new transaction
+                custom_fields cTrFields{
+                    {"nout", to_string(addr.second.first)},
+                    {"amount", to_string(addr.second.second)},
+                };
+
+                if (!optype.empty()) cTrFields.emplace("type", optype);
+                PrepareMessage(messages, "transaction", addr.first, txid, txtime, cTrFields);
+
+                // Event for new PocketNET transaction
+                if (optype == "share" || optype == "video")
+                {
+                    auto& response = find(postInfos, txid, emptyObject);
+                    if (response.exists("hash") && response.exists("rootHash") && response["hash"].get_str() != response["rootHash"].get_str())
+                        continue;
+
+                    if (addr.first == addrespocketnet && txidpocketnet.find(txid) == string::npos)
+                    {
+                        txidpocketnet += txid + ",";
+                    }
+                    else
+                    {
+                        auto& response = find(reposts, txid, emptyObject);
+                        if (response.exists("hash"))
+                        {
+                            string address = response["address"].get_str();
+
+                            custom_fields cFields
+                            {
+                                {"mesType",    "reshare"},
+                                {"txidRepost", response["hash"].get_str()},
+                                {"addrFrom",   response["addressRepost"].get_str()},
+                                {"nameFrom",   response["nameRepost"].get_str()}
+                            };
+                            if (response.exists("avatarRepost"))
+                                cFields.emplace("avatarFrom", response["avatarRepost"].get_str());
+
+                            PrepareMessage(messages, "event", address, txid, txtime, cFields);
+                        }
+                    }
+
+                    auto& subscribesResponse = find(privateSubscribers, addr.first, emptyArray);
+                    for (size_t i = 0; i < subscribesResponse.size(); ++i)
+                    {
+                        auto address = subscribesResponse[i]["addressTo"].get_str();
+
+                        custom_fields cFields{
+                            {"mesType", "postfromprivate"},
+                            {"addrFrom", addr.first},
+                            {"nameFrom", subscribesResponse[i]["nameFrom"].get_str()}
+                        };
+
+                        if (subscribesResponse[i].exists("avatarFrom"))
+                            cFields.emplace("avatarFrom", subscribesResponse[i]["avatarFrom"].get_str());
+
+                        PrepareMessage(messages, "event", address, txid, txtime, cFields);
+                    }
+                }
+                else if (optype == "userInfo")
+                {
+                    auto& response = find(referrers, txid, emptyObject);
+                    if (response.exists("referrerAddress"))
+                    {
+                        custom_fields cFields
+                        {
+                            {"mesType", optype},
+                            {"addrFrom", addr.first},
+                            {"nameFrom", response["referralName"].get_str()}
+                        };
+                        if (response.exists("referralAvatar"))
+                            cFields.emplace("avatarFrom", response["referralAvatar"].get_str());
+
+                        PrepareMessage(messages, "event", response["referrerAddress"].get_str(), txid, txtime, cFields);
+                    }
+                }
+                else if (optype == "upvoteShare")
+                {
+                    auto& response = find(postScores, txid, emptyObject);
+                    if (response.exists("postTxHash"))
+                    {
+                        custom_fields cFields
+                        {
+                            {"mesType", optype},
+                            {"addrFrom", addr.first},
+                            {"nameFrom", response["scoreName"].get_str()},
+                            {"posttxid", response["postTxHash"].get_str()},
+                            {"upvoteVal", response["value"].get_str()}
+                        };
+
+                        if (response.exists("scoreAvatar"))
+                            cFields.emplace("avatarFrom", response["scoreAvatar"].get_str());
+
+                        PrepareMessage(messages, "event", response["postAddress"].get_str(), txid, txtime, cFields);
+                    }
+                }
+                else if (optype == "subscribe" || optype == "subscribePrivate" || optype == "unsubscribe")
+                {
+                    auto& response = find(subscribes, txid, emptyObject);
+                    if (response.exists("addressTo"))
+                    {
+                        custom_fields cFields
+                        {
+                            {"mesType", optype},
+                            {"addrFrom", addr.first},
+                            {"nameFrom", response["nameFrom"].get_str()}
+                        };
+
+                        if (response.exists("avatarFrom"))
+                            cFields.emplace("avatarFrom", response["avatarFrom"].get_str());
+
+                        PrepareMessage(messages, "event", response["addressTo"].get_str(), txid, txtime, cFields);
+                    }
+                }
+                else if (optype == "cScore")
+                {
+                    auto& response = find(commentScores, txid, emptyObject);
+                    if (response.exists("commentHash"))
+                    {
+                        custom_fields cFields
+                        {
+                            {"mesType", optype},
+                            {"addrFrom", addr.first},
+                            {"nameFrom", response["scoreCommentName"].get_str()},
+                            {"commentid", response["commentHash"].get_str()},
+                            {"upvoteVal", response["value"].get_str()}
+                        };
+
+                        if (response.exists("scoreCommentAvatar"))
+                            cFields.emplace("avatarFrom", response["scoreCommentAvatar"].get_str());
+
+                        PrepareMessage(messages, "event", response["commentAddress"].get_str(), txid, txtime, cFields);
+                    }
+                }
+                else if (optype == "comment" || optype == "commentEdit" || optype == "commentDelete")
+                {
+                    auto& response = find(comments, txid, emptyObject);
+                    if (response.exists("postHash"))
+                    {
+                        if (response.exists("answerAddress") && !response["answerAddress"].get_str().empty())
+                        {
+                            custom_fields c1Fields
+                            {
+                                {"mesType", optype},
+                                {"addrFrom", addr.first},
+                                {"nameFrom", response["commentName"].get_str()},
+                                {"posttxid", response["postHash"].get_str()},
+                                {"parentid", response["parentHash"].get_str()},
+                                {"answerid", response["answerHash"].get_str()},
+                                {"reason", "answer"},
+                            };
+
+                            if (response.exists("commentAvatar"))
+                                c1Fields.emplace("avatarFrom", response["commentAvatar"].get_str());
+
+                            PrepareMessage(messages, "event", response["answerAddress"].get_str(), response["rootHash"].get_str(), txtime, c1Fields);
+                        }
+
+                        if (response["postAddress"].get_str() == addr.first)
+                            continue;
+
+                        custom_fields cFields
+                        {
+                            {"mesType", optype},
+                            {"addrFrom", addr.first},
+                            {"nameFrom", response["commentName"].get_str()},
+                            {"posttxid", response["postHash"].get_str()},
+                            {"parentid", response["parentHash"].get_str()},
+                            {"answerid", response["answerHash"].get_str()},
+                            {"reason", "post"},
+                        };
+
+                        if (response.exists("commentAvatar"))
+                            cFields.emplace("avatarFrom", response["commentAvatar"].get_str());
+
+                        if (response.exists("donation"))
+                        {
+                            cFields.emplace("donation", "true");
+                            cFields.emplace("amount", response["amount"].get_str());
+                        }
+
+                        PrepareMessage(messages, "event", response["postAddress"].get_str(), response["rootHash"].get_str(), txtime, cFields);
+                    }
+                }
+            }
+        }
+
+        // Content languages for all posts in block with one query
+        vector<string> contentHashes;
+        for (const auto& content : contentTypes)
+            contentHashes.push_back(content.first);
+
+        for (const auto& [hash, lang] : notifierRepoInst->GetPostLangs(contentHashes))
+            contentLangCnt[contentTypes[hash]][lang] += 1;
+
+        UniValue contentsLang(UniValue::VOBJ);
+        for (const auto& itemContent : contentLangCnt)
+        {
+            UniValue langContents(UniValue::VOBJ);
+            for (const auto& itemLang : itemContent.second)
+                langContents.pushKV(itemLang.first, itemLang.second);
+
+            contentsLang.pushKV(TransactionHelper::TxStringType(TransactionHelper::ConvertOpReturnToType(itemContent.first)), langContents);
+        }
+
+        // Take clients that have not seen this block yet; the lock is held only for the copy
+        vector<pair<string, WSUser>> clients;
+        set<string> connected;
+        {
+            boost::lock_guard<boost::mutex> guard(WSMutex);
+            for (auto& connWS : WSConnections)
+            {
+                connected.insert(connWS.first);
+
+                if (height <= connWS.second.Block)
+                    continue;
+
+                connWS.second.Block = height;
+                clients.emplace_back(connWS.first, connWS.second);
+            }
+        }
+
+        // Forget send counters of closed connections
+        {
+            LOCK(_pending_mutex);
+            for (auto it = _pending.begin(); it != _pending.end();)
+                it = connected.count(it->first) ? next(it) : _pending.erase(it);
+        }
+
+        if (clients.empty())
+            return;
+
+        // Subscriptions counters for all connected addresses with one query
+        set<string> uniqueAddresses;
+        for (const auto& client : clients)
+            uniqueAddresses.insert(client.second.Address);
+
+        auto subscribesCounts = notifierRepoInst->GetPostCountFromMySubscribes(
+            vector<string>(uniqueAddresses.begin(), uniqueAddresses.end()), height);
+
+        string pocketnetMessage;
+        if (!txidpocketnet.empty())
+        {
+            UniValue m(UniValue::VOBJ);
+            m.pushKV("msg", "sharepocketnet");
+            m.pushKV("time", to_string(block.nTime));
+            m.pushKV("addrFrom", addrespocketnet);
+            if (pocketnetaccinfo.exists("name")) m.pushKV("nameFrom", pocketnetaccinfo["name"].get_str());
+            if (pocketnetaccinfo.exists("avatar")) m.pushKV("avatarFrom", pocketnetaccinfo["avatar"].get_str());
+            m.pushKV("txids", txidpocketnet.substr(0, txidpocketnet.size() - 1));
+            pocketnetMessage = m.write();
+        }
+
+        // Address specific messages serialized once for all connections of this address
+        map<string, vector<string>> addressMessages;
+        for (const auto& address : uniqueAddresses)
+        {
+            auto it = messages.find(address);
+            if (it == messages.end())
+                continue;
+
+            auto& serialized = addressMessages[address];
+            for (const auto& m : it->second)
+                serialized.push_back(m.write());
+        }
+
+        deque<SendJob> jobs;
+        for (auto& [connectionId, user] : clients)
+        {
+            UniValue msg(UniValue::VOBJ);
+            msg.pushKV("addr", user.Address);
+            msg.pushKV("msg", "new block");
+            msg.pushKV("blockhash", block.GetHash().GetHex());
+            msg.pushKV("time", to_string(block.nTime));
+            msg.pushKV("height", height);
+            msg.pushKV("shares", sharesCnt);
+            msg.pushKV("contentsLang", contentsLang);
+
+            if (auto countIt = subscribesCounts.find(user.Address); countIt != subscribesCounts.end())
+                msg.pushKV("sharesSubscr", countIt->second);
+
+            SendJob job{connectionId, user.Connection, {msg.write()}};
+
+            if (!pocketnetMessage.empty())
+                job.Messages.push_back(pocketnetMessage);
+
+            if (auto it = addressMessages.find(user.Address); it != addressMessages.end())
+                job.Messages.insert(job.Messages.end(), it->second.begin(), it->second.end());
+
+            jobs.push_back(std::move(job));
+        }
+
+        {
+            LOCK(_send_mutex);
+
+            for (auto& job : jobs)
+                _send_jobs[hash<string>{}(job.ConnectionId) % _send_jobs.size()].push_back(std::move(job));
+
+            _send_cond.notify_all();
+        }
+
+        int64_t nTime2 = GetTimeMicros();
+        LogPrint(BCLog::BENCH, "    - WsNotifier::Process: %.2fms _ %d clients\n", 0.001 * (nTime2 - nTime1), (int) clients.size());
+    }
+
+    void WsNotifier::PrepareMessage(map<string, vector<UniValue>>& messages, const string& msgType,
+        const string& addrTo, const string& txid, int64_t txtime, const custom_fields& cFields)
+    {
+        UniValue msg(UniValue::VOBJ);
+        msg.pushKV("addr", addrTo);
+        msg.pushKV("msg", msgType);
+        msg.pushKV("txid", txid);
+        msg.pushKV("time", txtime);
+
+        for (auto& it : cFields)
+            msg.pushKV(it.first, it.second);
+
+        messages[addrTo].push_back(msg);
+    }
+
+} // PocketServices
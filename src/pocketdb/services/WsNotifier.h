@@ -5,10 +5,91 @@
 #ifndef POCKETNET_CORE_WSNOTIFIER_H
 #define POCKETNET_CORE_WSNOTIFIER_H
 
+#include <boost/thread.hpp>
+#include <atomic>
+#include <deque>
 
-class WsNotifier {
+#include "sync.h"
+#include "univalue.h"
+#include "primitives/block.h"
+#include "websocket/ws.h"
 
-};
+#include "pocketdb/SQLiteDatabase.h"
+#include "pocketdb/repositories/web/NotifierRepository.h"
 
+namespace PocketServices
+{
+    using namespace std;
+    using namespace PocketDb;
+
+    static const int DEFAULT_WS_NOTIFY_THREADS = 2;
+    static const int DEFAULT_WS_CLIENT_QUEUE = 256;
+    // Blocks waiting for notification, older blocks are skipped while the node catches up
+    static const size_t WS_BLOCK_QUEUE_LIMIT = 16;
+
+    typedef SimpleWeb::SocketServer<SimpleWeb::WS>::Connection WsConnection;
+    typedef map<string, string> custom_fields;
+
+    // Builds websocket notifications for connected blocks outside of the validation thread.
+    // Block connection only enqueues the block; a dispatcher thread resolves addresses with
+    // one batched query per kind of lookup and block on its own read-only connection and hands
+    // per-client messages to a pool of sender threads. Clients that do not drain their send
+    // queue are disconnected.
+    class WsNotifier
+    {
+    public:
+        WsNotifier();
+        void Start(boost::thread_group& threadGroup, int senders, int clientQueueLimit);
+        void Stop();
+
+        void Enqueue(const shared_ptr<const CBlock>& block, int height);
+
+    private:
+        struct BlockEvent
+        {
+            shared_ptr<const CBlock> Block;
+            int Height;
+        };
+
+        struct SendJob
+        {
+            string ConnectionId;
+            shared_ptr<WsConnection> Connection;
+            vector<string> Messages;
+        };
+
+        SQLiteDatabaseRef sqliteDbInst;
+        shared_ptr<NotifierRepository> notifierRepoInst;
+
+        atomic<bool> shutdown{false};
+        int clientQueueLimit = DEFAULT_WS_CLIENT_QUEUE;
+
+        Mutex _running_mutex;
+        Mutex _queue_mutex;
+        std::condition_variable _queue_cond;
+        deque<BlockEvent> _queue_records;
+
+        // Jobs of one connection always go to the same sender, so its messages keep the order
+        Mutex _send_mutex;
+        std::condition_variable _send_cond;
+        vector<deque<SendJob>> _send_jobs;
+        int _senders_running = 0;
+
+        // Messages handed to a connection and not yet written to its socket
+        Mutex _pending_mutex;
+        map<string, shared_ptr<atomic<int>>> _pending;
+
+        void Worker();
+        void Sender(size_t shard);
+
+        void Process(const CBlock& block, int height);
+        void Send(SendJob& job);
+        void Drop(const string& connectionId, const shared_ptr<WsConnection>& connection);
+
+        static void PrepareMessage(map<string, vector<UniValue>>& messages, const string& msgType,
+            const string& addrTo, const string& txid, int64_t txtime, const custom_fields& cFields = custom_fields());
+    };
+
+} // PocketServices
 
 #endif //POCKETNET_CORE_WSNOTIFIER_H
@@ -4,6 +4,7 @@
 
 #include "pocketdb/web/PocketRpc.h"
 #include "rpc/util.h"
+#include "rpc/cache.h"
 
 RPCHelpMan gettemplate()
 {
@@ -131,8 +132,44 @@ static const CRPCCommand commands_post[] =
 };
 // @formatter:on
 
+// Results depend only on params and chain tip - served from RPC cache.
+// Cache is not dropped on mempool changes: methods must not return transactions without height.
+static const char* cached_commands[] =
+{
+    "gethotposts",
+    "gethistoricalfeed",
+    "gethistoricalstrip",
+    "gethierarchicalfeed",
+    "gethierarchicalstrip",
+    "getrawtransactionwithmessagebyid",
+    "getcontent",
+    "getrawtransactionwithmessage",
+    "getprofilefeed",
+    "getsubscribesfeed",
+    "getcontentsstatistic",
+    "getcontents",
+    "gettags",
+    "getcomments",
+    "getlastcomments",
+    "getuserprofile",
+    "getuseraddress",
+    "getaddressregistration",
+    "getaddressid",
+    "getaccountsetting",
+    "getuserstatistic",
+    "getusersubscribes",
+    "getusersubscribers",
+    "getuserblockings",
+    "getaddressscores",
+    "getpostscores",
+    "getpagescores",
+};
+
 void RegisterPocketnetWebRPCCommands(CRPCTable &tableRPC, CRPCTable &tablePostRPC)
 {
+    for (const auto& method : cached_commands)
+        g_rpc_cache.Enable(method);
+
     for (const auto& command : commands)
         tableRPC.appendCommand(command.name, &command);
 
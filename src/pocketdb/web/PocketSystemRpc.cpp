@@ -154,6 +154,14 @@ namespace PocketWeb::PocketWebRpc
                                 {RPCResult::Type::NUM, "http", ""},
                                 {RPCResult::Type::NUM, "https", ""},
                             }
+                        },
+                        {
+                            RPCResult::Type::OBJ, "web", "",
+                            {
+                                {RPCResult::Type::NUM, "queue", "Connected blocks waiting for the web database"},
+                                {RPCResult::Type::NUM, "height", "Last block written to the web database"},
+                                {RPCResult::Type::NUM, "lag", "Blocks between the chain tip and the web database"},
+                            }
                         }
                     },
                 },
@@ -218,6 +226,14 @@ namespace PocketWeb::PocketWebRpc
         ports.pushKV("https", staticPort);
         entry.pushKV("ports", ports);
 
+        // Web database progress
+        auto webStats = PocketServices::WebPostProcessorInst.GetStats();
+        UniValue web(UniValue::VOBJ);
+        web.pushKV("queue", webStats.Queue);
+        web.pushKV("height", webStats.Height);
+        web.pushKV("lag", webStats.Height < 0 ? pindex->nHeight + 1 : max(0, pindex->nHeight - webStats.Height));
+        entry.pushKV("web", web);
+
         return entry;
     },
         };
@@ -3,6 +3,7 @@
 // https://www.apache.org/licenses/LICENSE-2.0
 
 #include "pocketdb/web/SearchRpc.h"
+#include "pocketdb/services/SocialGraph.h"
 #include "rpc/util.h"
 #include "validation.h"
 
@@ -356,7 +357,12 @@ namespace PocketWeb::PocketWebRpc
         if (request.params.size() > 1 && request.params[1].isNum())
             cntOut = request.params[1].get_int();
 
-        return request.DbConnection()->SearchRepoInst->GetRecomendedAccountsBySubscriptions(address, cntOut);
+        auto& searchRepo = request.DbConnection()->SearchRepoInst;
+        if (PocketServices::SocialGraphInst.IsReady())
+            return searchRepo->GetRecomendedAccountsByIds(
+                PocketServices::SocialGraphInst.GetRecomendedAccountsBySubscriptions(searchRepo->GetAccountId(address), cntOut));
+
+        return searchRepo->GetRecomendedAccountsBySubscriptions(address, cntOut);
     },
         };
     }
@@ -409,7 +415,12 @@ namespace PocketWeb::PocketWebRpc
         if (request.params.size() > 4 && request.params[4].isNum())
             cntOut = request.params[4].get_int();
 
-        return request.DbConnection()->SearchRepoInst->GetRecomendedAccountsByScoresOnSimilarAccounts(address, contentTypes, nHeight, depth, cntOut);
+        auto& searchRepo = request.DbConnection()->SearchRepoInst;
+        if (PocketServices::SocialGraphInst.IsReady())
+            return searchRepo->GetRecomendedAccountsByIds(
+                PocketServices::SocialGraphInst.GetRecomendedAccountsByScoresOnSimilarAccounts(searchRepo->GetAccountId(address), contentTypes, nHeight - depth, cntOut));
+
+        return searchRepo->GetRecomendedAccountsByScoresOnSimilarAccounts(address, contentTypes, nHeight, depth, cntOut);
     },
         };
     }
@@ -547,7 +558,12 @@ namespace PocketWeb::PocketWebRpc
         if (request.params.size() > 3 && request.params[3].isNum())
             cntOut = request.params[3].get_int();
 
-        return request.DbConnection()->SearchRepoInst->GetRecomendedContentsByScoresOnSimilarContents(contentid, contentTypes, depth, cntOut);
+        auto& searchRepo = request.DbConnection()->SearchRepoInst;
+        if (PocketServices::SocialGraphInst.IsReady())
+            return searchRepo->GetRecomendedContentsByIds(
+                PocketServices::SocialGraphInst.GetRecomendedContentsByScoresOnSimilarContents(searchRepo->GetContentId(contentid), contentTypes, depth, cntOut));
+
+        return searchRepo->GetRecomendedContentsByScoresOnSimilarContents(contentid, contentTypes, depth, cntOut);
     },
         };
     }
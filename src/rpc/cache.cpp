@@ -0,0 +1,185 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <rpc/cache.h>
+#include <memusage.h>
+#include <tinyformat.h>
+
+#include <algorithm>
+#include <numeric>
+
+RPCCache g_rpc_cache;
+
+static UniValue CanonicalParams(const UniValue& value)
+{
+    if (value.isArray())
+    {
+        UniValue result(UniValue::VARR);
+        for (const auto& item : value.getValues())
+            result.push_back(CanonicalParams(item));
+        return result;
+    }
+
+    if (value.isObject())
+    {
+        const auto& keys = value.getKeys();
+        const auto& values = value.getValues();
+
+        std::vector<size_t> order(keys.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return keys[a] < keys[b]; });
+
+        UniValue result(UniValue::VOBJ);
+        for (size_t i : order)
+            result.pushKV(keys[i], CanonicalParams(values[i]));
+        return result;
+    }
+
+    return value;
+}
+
+void RPCCache::SetLimit(size_t bytes)
+{
+    m_limit = bytes;
+
+    for (auto& shard : m_shards)
+    {
+        LOCK(shard.m_mutex);
+        Shrink(shard);
+    }
+}
+
+void RPCCache::Enable(const std::string& method)
+{
+    m_methods[method];
+}
+
+bool RPCCache::IsEnabled(const std::string& method) const
+{
+    return m_limit > 0 && m_methods.find(method) != m_methods.end();
+}
+
+std::string RPCCache::MakeKey(const CRPCTable& table, const JSONRPCRequest& request)
+{
+    // Tables live until shutdown, address identifies the table
+    return strprintf("%p\n%s\n%s", (const void*) &table, request.strMethod, CanonicalParams(request.params).write());
+}
+
+uint64_t RPCCache::Generation() const
+{
+    return m_generation;
+}
+
+bool RPCCache::Get(const std::string& method, const std::string& key, std::string& data)
+{
+    auto& counters = m_methods.at(method);
+    auto& shard = GetShard(key);
+
+    LOCK(shard.m_mutex);
+
+    auto found = shard.m_index.find(key);
+    if (found == shard.m_index.end())
+    {
+        counters.Misses++;
+        return false;
+    }
+
+    // Move to front as most recently used
+    shard.m_lru.splice(shard.m_lru.begin(), shard.m_lru, found->second);
+    data = found->second->Data;
+    counters.Hits++;
+    return true;
+}
+
+void RPCCache::Put(const std::string& key, const std::string& data, uint64_t generation)
+{
+    auto& shard = GetShard(key);
+
+    LOCK(shard.m_mutex);
+
+    // Tip changed while the result was computed
+    if (generation != m_generation)
+        return;
+
+    if (auto found = shard.m_index.find(key); found != shard.m_index.end())
+        EraseEntry(shard, found->second);
+
+    Entry entry{key, data};
+    if (EntryUsage(entry) > m_limit / RPC_CACHE_SHARDS)
+        return;
+
+    shard.m_lru.push_front(std::move(entry));
+    shard.m_index.emplace(key, shard.m_lru.begin());
+    shard.m_usage += EntryUsage(shard.m_lru.front());
+
+    Shrink(shard);
+}
+
+void RPCCache::Invalidate()
+{
+    // Put of an older generation either sees the new one or is stored before its shard is cleared
+    m_generation++;
+
+    for (auto& shard : m_shards)
+    {
+        LOCK(shard.m_mutex);
+
+        shard.m_index.clear();
+        shard.m_lru.clear();
+        shard.m_usage = 0;
+    }
+}
+
+RPCCacheStats RPCCache::GetStats()
+{
+    RPCCacheStats stats;
+    stats.Limit = m_limit;
+
+    for (auto& shard : m_shards)
+    {
+        LOCK(shard.m_mutex);
+        stats.Entries += shard.m_lru.size();
+        stats.Usage += shard.m_usage;
+    }
+
+    for (const auto& [method, counters] : m_methods)
+    {
+        RPCCacheMethodStats methodStats;
+        methodStats.Hits = counters.Hits;
+        methodStats.Misses = counters.Misses;
+
+        stats.Hits += methodStats.Hits;
+        stats.Misses += methodStats.Misses;
+        stats.Methods.emplace(method, methodStats);
+    }
+
+    return stats;
+}
+
+RPCCache::Shard& RPCCache::GetShard(const std::string& key)
+{
+    return m_shards[std::hash<std::string>{}(key) % RPC_CACHE_SHARDS];
+}
+
+size_t RPCCache::EntryUsage(const Entry& entry)
+{
+    // List node + index node + key copy in index + buffers
+    return memusage::MallocUsage(sizeof(Entry) + 2 * sizeof(void*)) +
+           memusage::MallocUsage(sizeof(std::string) + sizeof(std::list<Entry>::iterator) + 2 * sizeof(void*)) +
+           2 * memusage::MallocUsage(entry.Key.capacity()) +
+           memusage::MallocUsage(entry.Data.capacity());
+}
+
+void RPCCache::EraseEntry(Shard& shard, std::list<Entry>::iterator itr)
+{
+    shard.m_usage -= EntryUsage(*itr);
+    shard.m_index.erase(itr->Key);
+    shard.m_lru.erase(itr);
+}
+
+void RPCCache::Shrink(Shard& shard)
+{
+    while (shard.m_usage > m_limit / RPC_CACHE_SHARDS && !shard.m_lru.empty())
+        EraseEntry(shard, std::prev(shard.m_lru.end()));
+}
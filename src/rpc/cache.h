@@ -0,0 +1,101 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETCOIN_RPC_CACHE_H
+#define POCKETCOIN_RPC_CACHE_H
+
+#include <rpc/request.h>
+#include <sync.h>
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+class CRPCTable;
+
+static const int64_t DEFAULT_RPC_CACHE_SIZE = 32;
+static const int RPC_CACHE_SHARDS = 16;
+
+struct RPCCacheMethodStats
+{
+    int64_t Hits = 0;
+    int64_t Misses = 0;
+};
+
+struct RPCCacheStats
+{
+    size_t Entries = 0;
+    size_t Usage = 0;
+    size_t Limit = 0;
+    int64_t Hits = 0;
+    int64_t Misses = 0;
+    std::map<std::string, RPCCacheMethodStats> Methods;
+};
+
+/**
+ * Serialized results of public RPC methods that are deterministic for a chain tip.
+ * Key is dispatch table, method name and params with sorted object keys. All entries are dropped
+ * when the tip changes or web database is written; results computed before that are not stored.
+ * Mempool changes do not drop entries: enabled methods must read confirmed data only.
+ * Size is accounted in bytes and split evenly between shards with own locks and LRU.
+ */
+class RPCCache
+{
+public:
+    void SetLimit(size_t bytes);
+
+    //! Opt-in of method, must be called before RPC server starts
+    void Enable(const std::string& method);
+    bool IsEnabled(const std::string& method) const;
+
+    //! Same method name can be bound to different handlers in tables of different ports
+    static std::string MakeKey(const CRPCTable& table, const JSONRPCRequest& request);
+
+    //! Current version of cached data - taken before the result is computed
+    uint64_t Generation() const;
+
+    bool Get(const std::string& method, const std::string& key, std::string& data);
+    void Put(const std::string& key, const std::string& data, uint64_t generation);
+    void Invalidate();
+
+    RPCCacheStats GetStats();
+
+private:
+    struct Entry
+    {
+        std::string Key;
+        std::string Data;
+    };
+
+    struct Shard
+    {
+        Mutex m_mutex;
+        std::list<Entry> m_lru GUARDED_BY(m_mutex);
+        std::unordered_map<std::string, std::list<Entry>::iterator> m_index GUARDED_BY(m_mutex);
+        size_t m_usage GUARDED_BY(m_mutex) = 0;
+    };
+
+    struct MethodCounters
+    {
+        std::atomic<int64_t> Hits{0};
+        std::atomic<int64_t> Misses{0};
+    };
+
+    Shard m_shards[RPC_CACHE_SHARDS];
+    std::atomic<size_t> m_limit{DEFAULT_RPC_CACHE_SIZE * 1024 * 1024};
+    std::atomic<uint64_t> m_generation{0};
+    std::map<std::string, MethodCounters> m_methods;
+
+    Shard& GetShard(const std::string& key);
+    static size_t EntryUsage(const Entry& entry);
+    void EraseEntry(Shard& shard, std::list<Entry>::iterator itr) EXCLUSIVE_LOCKS_REQUIRED(shard.m_mutex);
+    void Shrink(Shard& shard) EXCLUSIVE_LOCKS_REQUIRED(shard.m_mutex);
+};
+
+extern RPCCache g_rpc_cache;
+
+#endif // POCKETCOIN_RPC_CACHE_H
@@ -11,7 +11,9 @@
 #include <key_io.h>
 #include <node/context.h>
 #include <outputtype.h>
+#include <pocketdb/pocketnet.h>
 #include <rpc/blockchain.h>
+#include <rpc/cache.h>
 #include <rpc/server.h>
 #include <rpc/util.h>
 #include <scheduler.h>
@@ -444,6 +446,44 @@ static UniValue RPCLockedMemoryInfo()
     return obj;
 }
 
+static UniValue RPCPocketBlockCacheInfo()
+{
+    auto stats = PocketServices::BlockPayloadCacheInst.GetStats();
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("entries", uint64_t(stats.Entries));
+    obj.pushKV("usage", uint64_t(stats.Usage));
+    obj.pushKV("limit", uint64_t(stats.Limit));
+    obj.pushKV("hits", stats.Hits);
+    obj.pushKV("misses", stats.Misses);
+    return obj;
+}
+
+static UniValue RPCCacheInfo()
+{
+    auto stats = g_rpc_cache.GetStats();
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("entries", uint64_t(stats.Entries));
+    obj.pushKV("usage", uint64_t(stats.Usage));
+    obj.pushKV("limit", uint64_t(stats.Limit));
+    obj.pushKV("hits", stats.Hits);
+    obj.pushKV("misses", stats.Misses);
+
+    UniValue methods(UniValue::VOBJ);
+    for (const auto& [method, methodStats] : stats.Methods)
+    {
+        if (methodStats.Hits + methodStats.Misses == 0)
+            continue;
+
+        UniValue item(UniValue::VOBJ);
+        item.pushKV("hits", methodStats.Hits);
+        item.pushKV("misses", methodStats.Misses);
+        methods.pushKV(method, item);
+    }
+    obj.pushKV("methods", methods);
+
+    return obj;
+}
+
 #ifdef HAVE_MALLOC_INFO
 static std::string RPCMallocInfo()
 {
@@ -488,6 +528,30 @@ static RPCHelpMan getmemoryinfo()
                                 {RPCResult::Type::NUM, "chunks_used", "Number allocated chunks"},
                                 {RPCResult::Type::NUM, "chunks_free", "Number unused chunks"},
                             }},
+                            {RPCResult::Type::OBJ, "pocketblockcache", "Information about serialized Pocket block payloads cache",
+                            {
+                                {RPCResult::Type::NUM, "entries", "Number of cached payloads"},
+                                {RPCResult::Type::NUM, "usage", "Number of bytes used"},
+                                {RPCResult::Type::NUM, "limit", "Maximum number of bytes"},
+                                {RPCResult::Type::NUM, "hits", "Number of payloads served from cache"},
+                                {RPCResult::Type::NUM, "misses", "Number of payloads read from sqlite db"},
+                            }},
+                            {RPCResult::Type::OBJ, "rpccache", "Information about public RPC results cache",
+                            {
+                                {RPCResult::Type::NUM, "entries", "Number of cached results"},
+                                {RPCResult::Type::NUM, "usage", "Number of bytes used"},
+                                {RPCResult::Type::NUM, "limit", "Maximum number of bytes"},
+                                {RPCResult::Type::NUM, "hits", "Number of requests served from cache"},
+                                {RPCResult::Type::NUM, "misses", "Number of requests executed"},
+                                {RPCResult::Type::OBJ_DYN, "methods", "Hits and misses of every requested method",
+                                {
+                                    {RPCResult::Type::OBJ, "method", "",
+                                    {
+                                        {RPCResult::Type::NUM, "hits", ""},
+                                        {RPCResult::Type::NUM, "misses", ""},
+                                    }},
+                                }},
+                            }},
                         }
                     },
                     RPCResult{"mode \"mallocinfo\"",
@@ -504,6 +568,8 @@ static RPCHelpMan getmemoryinfo()
     if (mode == "stats") {
         UniValue obj(UniValue::VOBJ);
         obj.pushKV("locked", RPCLockedMemoryInfo());
+        obj.pushKV("pocketblockcache", RPCPocketBlockCacheInfo());
+        obj.pushKV("rpccache", RPCCacheInfo());
         return obj;
     } else if (mode == "mallocinfo") {
 #ifdef HAVE_MALLOC_INFO
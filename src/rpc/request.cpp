@@ -48,6 +48,12 @@ std::string JSONRPCReply(const UniValue& result, const UniValue& error, const Un
     return reply.write() + "\n";
 }
 
+std::string JSONRPCReplySerialized(const std::string& result, const UniValue& id)
+{
+    // Same layout as JSONRPCReplyObj
+    return "{\"result\":" + result + ",\"error\":null,\"id\":" + id.write() + "}\n";
+}
+
 UniValue JSONRPCError(int code, const std::string& message)
 {
     UniValue error(UniValue::VOBJ);
@@ -9,13 +9,20 @@
 #include "validation.h"
 #include "util/ref.h"
 #include "clientversion.h"
+#include "pocketdb/SQLiteConnectionPool.h"
 #include <boost/thread.hpp>
 #include <chrono>
 #include <cstdint>
 #include <ctime>
+#include <crypto/common.h>
+#include <crypto/siphash.h>
 #include <net.h>
 #include <numeric>
 #include <set>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <thread>
 
 namespace Statistic
 {
@@ -37,94 +44,312 @@ namespace Statistic
         RequestPayloadSize OutputSize;
     };
 
-    class RequestStatEngine
+    // Latency histogram with logarithmic bins: exact up to 16ms, then 8 bins per power of two
+    // (relative error ~6%). Values above 2^24ms are counted in the last bin.
+    class LatencyHistogram
     {
     public:
-        RequestStatEngine() = default;
+        static constexpr int LinearBins = 16;
+        static constexpr int SubBinBits = 3;
+        static constexpr int MaxPower = 24;
+        static constexpr int Size = LinearBins + (MaxPower - 4 + 1) * (1 << SubBinBits);
 
-        void AddSample(const RequestSample& sample)
+        void Add(int64_t value)
         {
-            if (sample.TimestampEnd < sample.TimestampBegin)
-                return;
+            _counts[Index(value)] += 1;
+            _total += 1;
+        }
 
-            LOCK(_samplesLock);
-            _samples.push_back(sample);
+        void Merge(const LatencyHistogram& other)
+        {
+            for (int i = 0; i < Size; i++)
+                _counts[i] += other._counts[i];
+            _total += other._total;
         }
 
-        std::size_t GetNumSamplesSince(RequestTime time)
+        uint64_t Total() const { return _total; }
+
+        // Value below which the given share (0..1) of samples falls
+        int64_t Percentile(double share) const
         {
-            LOCK(_samplesLock);
-            return std::count_if(
-                _samples.begin(),
-                _samples.end(),
-                [=](const RequestSample& sample)
-                {
-                    return sample.TimestampEnd >= time && sample.TimestampEnd <= RequestTime::max();
-                });
+            if (_total == 0)
+                return 0;
+
+            uint64_t rank = std::max<uint64_t>(1, (uint64_t) std::ceil(share * _total));
+            uint64_t seen = 0;
+            for (int i = 0; i < Size; i++)
+            {
+                seen += _counts[i];
+                if (seen >= rank)
+                    return Value(i);
+            }
+
+            return Value(Size - 1);
         }
 
-        std::size_t GetNumFailedSamplesSince(RequestTime time)
+    private:
+        std::array<uint32_t, Size> _counts{};
+        uint64_t _total = 0;
+
+        static int Index(int64_t value)
         {
-            LOCK(_samplesLock);
-            return std::count_if(
-                _samples.begin(),
-                _samples.end(),
-                [=](const RequestSample& sample)
-                {
-                    return sample.TimestampEnd >= time && sample.TimestampEnd <= RequestTime::max() && sample.Failed;
-                });
+            if (value < LinearBins)
+                return (int) std::max<int64_t>(0, value);
+
+            int power = std::min<int>(MaxPower, (int) CountBits((uint64_t) value) - 1);
+            if (power == MaxPower)
+                return Size - 1;
+
+            int sub = (int) ((uint64_t) value >> (power - SubBinBits)) & ((1 << SubBinBits) - 1);
+            return LinearBins + (power - 4) * (1 << SubBinBits) + sub;
         }
 
-        RequestTime GetAvgRequestTimeSince(RequestTime since)
+        // Middle of the bin
+        static int64_t Value(int index)
         {
-            LOCK(_samplesLock);
+            if (index < LinearBins)
+                return index;
 
-            if (_samples.empty())
-                return {};
+            int power = (index - LinearBins) / (1 << SubBinBits) + 4;
+            int sub = (index - LinearBins) % (1 << SubBinBits);
+            int64_t width = int64_t{1} << (power - SubBinBits);
+            return (((1 << SubBinBits) + sub) * width) + width / 2;
+        }
+    };
 
-            RequestTime sum{};
-            std::size_t count{};
+    // Cardinality estimator for unique source IPs with fixed 1KiB of registers (~3% error)
+    class HyperLogLog
+    {
+    public:
+        static constexpr int Precision = 10;
+        static constexpr int Registers = 1 << Precision;
 
-            for (auto& sample : _samples)
+        void Add(const std::string& value)
+        {
+            uint64_t hash = CSipHasher(0x9ae16a3b2f90404fULL, 0xc3a5c85c97cb3127ULL)
+                .Write((const unsigned char*) value.data(), value.size())
+                .Finalize();
+
+            int index = (int) (hash >> (64 - Precision));
+            uint64_t rest = hash & ((uint64_t{1} << (64 - Precision)) - 1);
+            uint8_t rank = (uint8_t) (64 - Precision - CountBits(rest) + 1);
+
+            _registers[index] = std::max(_registers[index], rank);
+        }
+
+        void Merge(const HyperLogLog& other)
+        {
+            for (int i = 0; i < Registers; i++)
+                _registers[i] = std::max(_registers[i], other._registers[i]);
+        }
+
+        uint64_t Estimate() const
+        {
+            double sum = 0;
+            int zeros = 0;
+            for (auto reg : _registers)
             {
-                if (sample.TimestampEnd.count() > 0 && sample.TimestampEnd >= since && sample.Key != "WorkQueue::Enqueue")
+                sum += std::ldexp(1.0, -reg);
+                if (reg == 0) zeros++;
+            }
+
+            double m = Registers;
+            double estimate = (0.7213 / (1 + 1.079 / m)) * m * m / sum;
+            if (estimate <= 2.5 * m && zeros > 0)
+                estimate = m * std::log(m / zeros);
+
+            return (uint64_t) std::llround(estimate);
+        }
+
+    private:
+        std::array<uint8_t, Registers> _registers{};
+    };
+
+    // Space-Saving heavy hitters: keeps the K most frequent values with bounded overestimation
+    class TopCounter
+    {
+    public:
+        explicit TopCounter(std::size_t capacity) : _capacity(capacity) {}
+
+        void Add(const std::string& value, uint64_t count = 1)
+        {
+            auto min = _items.end();
+            for (auto it = _items.begin(); it != _items.end(); it++)
+            {
+                if (it->first == value)
                 {
-                    sum += sample.TimestampEnd - sample.TimestampBegin;
-                    count++;
+                    it->second += count;
+                    return;
                 }
+
+                if (min == _items.end() || it->second < min->second)
+                    min = it;
             }
 
-            if (count <= 0) return {};
-            return sum / count;
+            if (_items.size() < _capacity)
+                _items.emplace_back(value, count);
+            else
+                *min = {value, min->second + count};
         }
 
+        const std::vector<std::pair<std::string, uint64_t>>& Items() const { return _items; }
 
-        RequestTime GetAvgExecutionTimeSince(RequestTime since)
+        void Clear() { _items.clear(); }
+
+    private:
+        std::size_t _capacity;
+        std::vector<std::pair<std::string, uint64_t>> _items;
+    };
+
+    struct RequestKeyStat
+    {
+        uint64_t Count = 0;
+        uint64_t Failed = 0;
+        RequestTime SumRequestTime{};
+        RequestTime SumExecutionTime{};
+        LatencyHistogram Histogram;
+
+        void Merge(const RequestKeyStat& other)
+        {
+            Count += other.Count;
+            Failed += other.Failed;
+            SumRequestTime += other.SumRequestTime;
+            SumExecutionTime += other.SumExecutionTime;
+            Histogram.Merge(other.Histogram);
+        }
+    };
+
+    // Aggregated statistic for a time range
+    struct RequestStatSnapshot
+    {
+        std::map<RequestKey, RequestKeyStat> Keys;
+        RequestKeyStat Total;
+        HyperLogLog SourceIPs;
+        TopCounter TopSourceIPs{64};
+        std::vector<RequestSample> TopTime;
+        std::vector<RequestSample> TopInput;
+        std::vector<RequestSample> TopOutput;
+    };
+
+    class RequestStatEngine
+    {
+    public:
+        static constexpr std::size_t Shards = 4;
+        static constexpr std::size_t Buckets = 30;
+        static constexpr std::size_t MaxKeys = 128;
+        static constexpr std::size_t TopSamples = 8;
+        static constexpr std::size_t TopIPs = 32;
+
+        RequestStatEngine() = default;
+
+        // Samples are spread over shards by thread so request threads rarely contend,
+        // and land in a ring of time buckets so memory does not grow with the request rate.
+        void AddSample(const RequestSample& sample)
         {
-            LOCK(_samplesLock);
+            if (sample.TimestampEnd < sample.TimestampBegin)
+                return;
+
+            auto& shard = _shards[std::hash<std::thread::id>{}(std::this_thread::get_id()) % Shards];
+
+            LOCK(shard.Lock);
+            auto pbucket = shard.Bucket(sample.TimestampEnd.count() / _bucketWidth.load().count());
+            if (!pbucket)
+                return;
+
+            auto& bucket = *pbucket;
+
+            auto keyIt = bucket.Keys.find(sample.Key);
+            if (keyIt == bucket.Keys.end())
+                keyIt = bucket.Keys.emplace(bucket.Keys.size() < MaxKeys ? sample.Key : "other", RequestKeyStat{}).first;
 
-            if (_samples.empty())
-                return {};
+            auto& stat = keyIt->second;
+            stat.Count += 1;
+            if (sample.Failed) stat.Failed += 1;
+            stat.SumRequestTime += sample.TimestampEnd - sample.TimestampBegin;
+            stat.SumExecutionTime += sample.TimestampEnd - sample.TimestampExec;
+            stat.Histogram.Add((sample.TimestampEnd - sample.TimestampBegin).count());
 
-            RequestTime sum{};
-            std::size_t count{};
+            bucket.SourceIPs.Add(sample.SourceIP);
+            bucket.TopSourceIPs.Add(sample.SourceIP);
 
-            for (auto& sample : _samples)
+            InsertTop(bucket.TopTime, sample, TopSamples, [](const RequestSample& s) { return (s.TimestampEnd - s.TimestampBegin).count(); });
+            InsertTop(bucket.TopInput, sample, TopSamples, [](const RequestSample& s) { return (int64_t) s.InputSize; });
+            InsertTop(bucket.TopOutput, sample, TopSamples, [](const RequestSample& s) { return (int64_t) s.OutputSize; });
+        }
+
+        // Merge all buckets that overlap [since, now]
+        RequestStatSnapshot GetSnapshotSince(RequestTime since)
+        {
+            RequestStatSnapshot result;
+
+            auto width = _bucketWidth.load().count();
+            int64_t current = GetCurrentSystemTime().count() / width;
+            int64_t first = std::max<int64_t>(current - (int64_t) Buckets + 1, since.count() / width);
+
+            for (auto& shard : _shards)
             {
-                if (sample.TimestampEnd.count() > 0 && sample.TimestampEnd >= since && sample.Key != "WorkQueue::Enqueue")
+                LOCK(shard.Lock);
+                for (auto& bucket : shard.Ring)
                 {
-                    sum += sample.TimestampEnd - sample.TimestampExec;
-                    count++;
+                    if (bucket.Epoch < first || bucket.Epoch > current)
+                        continue;
+
+                    for (auto& [key, stat] : bucket.Keys)
+                    {
+                        result.Keys[key].Merge(stat);
+                        if (key != "WorkQueue::Enqueue")
+                            result.Total.Merge(stat);
+                    }
+
+                    result.SourceIPs.Merge(bucket.SourceIPs);
+                    for (auto& [ip, count] : bucket.TopSourceIPs.Items())
+                        result.TopSourceIPs.Add(ip, count);
+
+                    for (auto& sample : bucket.TopTime)
+                        InsertTop(result.TopTime, sample, TopSamples, [](const RequestSample& s) { return (s.TimestampEnd - s.TimestampBegin).count(); });
+                    for (auto& sample : bucket.TopInput)
+                        InsertTop(result.TopInput, sample, TopSamples, [](const RequestSample& s) { return (int64_t) s.InputSize; });
+                    for (auto& sample : bucket.TopOutput)
+                        InsertTop(result.TopOutput, sample, TopSamples, [](const RequestSample& s) { return (int64_t) s.OutputSize; });
                 }
             }
 
-            if (count <= 0) return {};
-            return sum / count;
+            return result;
+        }
+
+        std::size_t GetNumSamplesSince(RequestTime time)
+        {
+            uint64_t count = 0;
+            for (auto& [key, stat] : GetSnapshotSince(time).Keys)
+                count += stat.Count;
+            return count;
+        }
+
+        std::size_t GetNumFailedSamplesSince(RequestTime time)
+        {
+            uint64_t count = 0;
+            for (auto& [key, stat] : GetSnapshotSince(time).Keys)
+                count += stat.Failed;
+            return count;
+        }
+
+        RequestTime GetAvgRequestTimeSince(RequestTime since)
+        {
+            auto total = GetSnapshotSince(since).Total;
+            if (total.Count <= 0) return {};
+            return total.SumRequestTime / total.Count;
+        }
+
+        RequestTime GetAvgExecutionTimeSince(RequestTime since)
+        {
+            auto total = GetSnapshotSince(since).Total;
+            if (total.Count <= 0) return {};
+            return total.SumExecutionTime / total.Count;
         }
 
         std::vector<RequestSample> GetTopHeavyTimeSamplesSince(std::size_t limit, RequestTime since)
         {
-            return GetTopTimeSamplesImpl(limit, since);
+            return Limit(GetSnapshotSince(since).TopTime, limit);
         }
 
         std::vector<RequestSample> GetTopHeavyTimeSamples(std::size_t limit)
@@ -134,7 +359,7 @@ namespace Statistic
 
         std::vector<RequestSample> GetTopHeavyInputSamplesSince(std::size_t limit, RequestTime since)
         {
-            return GetTopSizeSamplesImpl(limit, &RequestSample::InputSize, since);
+            return Limit(GetSnapshotSince(since).TopInput, limit);
         }
 
         std::vector<RequestSample> GetTopHeavyInputSamples(std::size_t limit)
@@ -144,7 +369,7 @@ namespace Statistic
 
         std::vector<RequestSample> GetTopHeavyOutputSamplesSince(std::size_t limit, RequestTime since)
         {
-            return GetTopSizeSamplesImpl(limit, &RequestSample::OutputSize, since);
+            return Limit(GetSnapshotSince(since).TopOutput, limit);
         }
 
         std::vector<RequestSample> GetTopHeavyOutputSamples(std::size_t limit)
@@ -152,21 +377,14 @@ namespace Statistic
             return GetTopHeavyOutputSamplesSince(limit, RequestTime::min());
         }
 
-        std::set<RequestIP> GetUniqueSourceIPsSince(RequestTime since)
+        std::size_t GetUniqueSourceIPsCountSince(RequestTime since)
         {
-            std::set<RequestIP> result{};
-
-            LOCK(_samplesLock);
-            for (auto& sample : _samples)
-                if (sample.TimestampEnd >= since)
-                    result.insert(sample.SourceIP);
-
-            return result;
+            return GetSnapshotSince(since).SourceIPs.Estimate();
         }
 
-        std::set<RequestIP> GetUniqueSourceIPs()
+        std::size_t GetUniqueSourceIPsCount()
         {
-            return GetUniqueSourceIPsSince(RequestTime::min());
+            return GetUniqueSourceIPsCountSince(RequestTime::min());
         }
 
         UniValue CompileStatsAsJsonSince(RequestTime since, const util::Ref& context)
@@ -190,29 +408,53 @@ namespace Statistic
                 return value;
             };
 
-            UniValue unique_ips_json{UniValue::VARR};
+            const auto percentiles_to_json = [](UniValue& value, const RequestKeyStat& stat)
+            {
+                value.pushKV("P50", stat.Histogram.Percentile(0.50));
+                value.pushKV("P95", stat.Histogram.Percentile(0.95));
+                value.pushKV("P99", stat.Histogram.Percentile(0.99));
+            };
+
+            auto snapshot = GetSnapshotSince(since);
+
+            uint64_t requests_all = 0;
+            uint64_t requests_failed = 0;
+            UniValue methods_json{UniValue::VOBJ};
+            for (auto& [key, stat] : snapshot.Keys)
+            {
+                requests_all += stat.Count;
+                requests_failed += stat.Failed;
+
+                UniValue method{UniValue::VOBJ};
+                method.pushKV("Count", (int64_t) stat.Count);
+                method.pushKV("Failed", (int64_t) stat.Failed);
+                method.pushKV("AvgTime", stat.Count > 0 ? (stat.SumRequestTime / stat.Count).count() : 0);
+                percentiles_to_json(method, stat);
+                methods_json.pushKV(key, method);
+            }
+
+            UniValue top_ips_json{UniValue::VOBJ};
             UniValue top_tm_json{UniValue::VARR};
             UniValue top_in_json{UniValue::VARR};
             UniValue top_out_json{UniValue::VARR};
 
-            auto unique_ips = GetUniqueSourceIPsSince(since);
-            auto unique_ips_count = unique_ips.size();
             if (LogInstance().WillLogCategory(BCLog::STATDETAIL))
             {
-                auto top_tm = GetTopHeavyTimeSamplesSince(top_limit, since);
-                auto top_in = GetTopHeavyInputSamplesSince(top_limit, since);
-                auto top_out = GetTopHeavyOutputSamplesSince(top_limit, since);
+                auto top_ips = snapshot.TopSourceIPs.Items();
+                std::sort(top_ips.begin(), top_ips.end(), [](const auto& l, const auto& r) { return l.second > r.second; });
+                if (top_ips.size() > TopIPs)
+                    top_ips.resize(TopIPs);
 
-                for (auto& ip : unique_ips)
-                    unique_ips_json.push_back(ip);
+                for (auto& [ip, count] : top_ips)
+                    top_ips_json.pushKV(ip, (int64_t) count);
 
-                for (auto& sample : top_tm)
+                for (auto& sample : Limit(snapshot.TopTime, top_limit))
                     top_tm_json.push_back(sample_to_json(sample));
 
-                for (auto& sample : top_in)
+                for (auto& sample : Limit(snapshot.TopInput, top_limit))
                     top_in_json.push_back(sample_to_json(sample));
 
-                for (auto& sample : top_out)
+                for (auto& sample : Limit(snapshot.TopOutput, top_limit))
                     top_out_json.push_back(sample_to_json(sample));
             }
 
@@ -227,14 +469,16 @@ namespace Statistic
             result.pushKV("General", chainStat);
 
             UniValue rpcStat(UniValue::VOBJ);
-            rpcStat.pushKV("RequestsAll", (int) GetNumSamplesSince(since));
-            rpcStat.pushKV("RequestsFailed", (int) GetNumFailedSamplesSince(since));
-            rpcStat.pushKV("AvgReqTime", GetAvgRequestTimeSince(since).count());
-            rpcStat.pushKV("AvgExecTime", GetAvgExecutionTimeSince(since).count());
-            rpcStat.pushKV("UniqueIPs", (int) unique_ips_count);
+            rpcStat.pushKV("RequestsAll", (int64_t) requests_all);
+            rpcStat.pushKV("RequestsFailed", (int64_t) requests_failed);
+            rpcStat.pushKV("AvgReqTime", snapshot.Total.Count > 0 ? (snapshot.Total.SumRequestTime / snapshot.Total.Count).count() : 0);
+            rpcStat.pushKV("AvgExecTime", snapshot.Total.Count > 0 ? (snapshot.Total.SumExecutionTime / snapshot.Total.Count).count() : 0);
+            percentiles_to_json(rpcStat, snapshot.Total);
+            rpcStat.pushKV("UniqueIPs", (int64_t) snapshot.SourceIPs.Estimate());
+            rpcStat.pushKV("Methods", methods_json);
             if (LogInstance().WillLogCategory(BCLog::STATDETAIL))
             {
-                rpcStat.pushKV("UniqueIps", unique_ips_json);
+                rpcStat.pushKV("TopIPs", top_ips_json);
                 rpcStat.pushKV("TopTime", top_tm_json);
                 rpcStat.pushKV("TopInputSize", top_in_json);
                 rpcStat.pushKV("TopOutputSize", top_out_json);
@@ -270,6 +514,29 @@ namespace Statistic
             sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_SPILL, &current, &highWater, true);
             sqlStats.pushKV("CacheSpill", current);
 
+            auto stmtCacheStats = PocketDb::SQLiteDbInst.GetStatementCacheStats();
+            sqlStats.pushKV("StatementCacheSize", (int64_t) stmtCacheStats.Size);
+            sqlStats.pushKV("StatementCacheHit", stmtCacheStats.Hits);
+            sqlStats.pushKV("StatementCacheMiss", stmtCacheStats.Misses);
+
+            auto poolStats = PocketDb::SQLiteConnectionPoolInst.GetStats();
+            UniValue poolStat(UniValue::VOBJ);
+            poolStat.pushKV("Idle", poolStats.Idle);
+            poolStat.pushKV("InUse", poolStats.InUse);
+            poolStat.pushKV("Checkouts", poolStats.Checkouts);
+            poolStat.pushKV("Waits", poolStats.Waits);
+            poolStat.pushKV("AvgWaitTime", poolStats.Checkouts > 0 ? poolStats.WaitTime / poolStats.Checkouts : 0);
+            poolStat.pushKV("MaxWaitTime", poolStats.MaxWaitTime);
+            poolStat.pushKV("Opened", poolStats.Opened);
+            poolStat.pushKV("Recycled", poolStats.Recycled);
+            poolStat.pushKV("Unhealthy", poolStats.Unhealthy);
+            sqlStats.pushKV("ConnectionPool", poolStat);
+
+            UniValue timeoutsStat(UniValue::VOBJ);
+            for (const auto& [func, count] : PocketDb::GetQueryTimeouts())
+                timeoutsStat.pushKV(func, count);
+            sqlStats.pushKV("QueryTimeouts", timeoutsStat);
+
             result.pushKV("SQL", sqlStats);
 
             return result;
@@ -283,6 +550,10 @@ namespace Statistic
 
         void Run(boost::thread_group& threadGroup, const util::Ref& context)
         {
+            // The ring keeps twice the logging period so every period is covered completely
+            auto statDepth = std::max<int64_t>(1, gArgs.GetArg("-statdepth", 60));
+            SetBucketWidth(std::chrono::milliseconds(std::max<int64_t>(1000, statDepth * 2 * 1000 / (int64_t) Buckets)));
+
             shutdown = false;
             threadGroup.create_thread(boost::bind(&RequestStatEngine::PeriodicStatLogger, this, boost::cref(context)));
         }
@@ -304,90 +575,81 @@ namespace Statistic
                 LogPrint(BCLog::STATDETAIL, msg.c_str(), statLoggerSleep / 1000,
                     CompileStatsAsJsonSince(chunkSize, context).write(1));
 
-                RemoveSamplesBefore(chunkSize * 2);
                 UninterruptibleSleep(std::chrono::milliseconds{statLoggerSleep});
             }
         }
 
     private:
-        std::vector<RequestSample> _samples;
-        Mutex _samplesLock;
-        bool shutdown = false;
-
-        void RemoveSamplesBefore(RequestTime time)
+        struct StatBucket
         {
-            LOCK(_samplesLock);
-            int64_t sizeBefore = _samples.size();
+            int64_t Epoch = -1;
+            std::map<RequestKey, RequestKeyStat> Keys;
+            HyperLogLog SourceIPs;
+            TopCounter TopSourceIPs{TopIPs};
+            std::vector<RequestSample> TopTime;
+            std::vector<RequestSample> TopInput;
+            std::vector<RequestSample> TopOutput;
+        };
+
+        struct StatShard
+        {
+            Mutex Lock;
+            std::array<StatBucket, Buckets> Ring;
 
-            _samples.erase(
-                std::remove_if(
-                    _samples.begin(),
-                    _samples.end(),
-                    [time](const RequestSample& sample)
-                    {
-                        return sample.TimestampEnd < time;
-                    }),
-                _samples.end());
+            // Bucket for the epoch, recycled if it still holds an older epoch.
+            // Samples older than the ring are dropped.
+            StatBucket* Bucket(int64_t epoch) EXCLUSIVE_LOCKS_REQUIRED(Lock)
+            {
+                auto& bucket = Ring[(std::size_t) epoch % Buckets];
+                if (bucket.Epoch > epoch)
+                    return nullptr;
 
-            LogPrint(BCLog::STAT, "Clear statistic cache: %d -> %d items after.\n", sizeBefore, _samples.size());
-        }
+                if (bucket.Epoch < epoch)
+                {
+                    bucket = StatBucket{};
+                    bucket.Epoch = epoch;
+                }
 
-        std::vector<RequestSample> GetTopSizeSamplesImpl(std::size_t limit, RequestPayloadSize RequestSample::*size_field, RequestTime since)
-        {
-            LOCK(_samplesLock);
-            auto samples_copy = _samples;
+                return &bucket;
+            }
+        };
 
-            samples_copy.erase(
-                std::remove_if(
-                    samples_copy.begin(),
-                    samples_copy.end(),
-                    [since](const RequestSample& sample)
-                    {
-                        return sample.TimestampEnd < since;
-                    }),
-                samples_copy.end());
-
-            std::sort(
-                samples_copy.begin(),
-                samples_copy.end(),
-                [size_field](const RequestSample& left, const RequestSample& right)
-                {
-                    return left.*size_field > right.*size_field;
-                });
+        std::array<StatShard, Shards> _shards;
+        std::atomic<RequestTime> _bucketWidth{std::chrono::seconds(10)};
+        bool shutdown = false;
 
-            if (samples_copy.size() > limit)
-                samples_copy.resize(limit);
+        void SetBucketWidth(RequestTime width)
+        {
+            for (auto& shard : _shards)
+            {
+                LOCK(shard.Lock);
+                for (auto& bucket : shard.Ring)
+                    bucket = StatBucket{};
+            }
 
-            return samples_copy;
+            _bucketWidth = width;
         }
 
-        std::vector<RequestSample> GetTopTimeSamplesImpl(std::size_t limit, RequestTime since)
+        // Keep the `limit` heaviest samples ordered by weight descending
+        template<typename T>
+        static void InsertTop(std::vector<RequestSample>& top, const RequestSample& sample, std::size_t limit, T weight)
         {
-            LOCK(_samplesLock);
-            auto samples_copy = _samples;
+            if (top.size() >= limit && weight(top.back()) >= weight(sample))
+                return;
 
-            samples_copy.erase(
-                std::remove_if(
-                    samples_copy.begin(),
-                    samples_copy.end(),
-                    [since](const RequestSample& sample)
-                    {
-                        return sample.TimestampEnd < since;
-                    }),
-                samples_copy.end());
-
-            std::sort(
-                samples_copy.begin(),
-                samples_copy.end(),
-                [](const RequestSample& left, const RequestSample& right)
-                {
-                    return left.TimestampEnd - left.TimestampBegin > right.TimestampEnd - right.TimestampBegin;
-                });
+            auto pos = std::find_if(top.begin(), top.end(), [&](const RequestSample& s) { return weight(s) < weight(sample); });
+            top.insert(pos, sample);
+
+            if (top.size() > limit)
+                top.pop_back();
+        }
 
-            if (samples_copy.size() > limit)
-                samples_copy.resize(limit);
+        static std::vector<RequestSample> Limit(std::vector<RequestSample> samples, std::size_t limit)
+        {
+            if (samples.size() > limit)
+                samples.resize(limit);
 
-            return samples_copy;
+            return samples;
         }
     };
 
@@ -0,0 +1,153 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <pocketdb/pocketnet.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace PocketDb;
+using namespace PocketTx;
+
+BOOST_FIXTURE_TEST_SUITE(pocketdb_balances_tests, TestingSetup)
+
+struct TestTx
+{
+    string Hash;
+    vector<pair<string, int>> Inputs;
+    vector<pair<string, int64_t>> Outputs;
+};
+
+static const vector<vector<TestTx>> TEST_BLOCKS = {
+    {{"cb_1", {}, {{"A", 1000}}}},
+    {{"tx_2", {{"cb_1", 0}}, {{"B", 300}, {"A", 700}}}},
+    {{"tx_3", {{"tx_2", 1}}, {{"C", 200}, {"A", 500}}}, {"cb_3", {}, {{"B", 50}}}},
+    {{"tx_4", {{"tx_3", 0}}, {{"A", 200}}}, {"tx_5", {{"tx_2", 0}}, {{"C", 300}}}},
+    {{"tx_6", {{"tx_4", 0}}, {{"B", 200}}}},
+};
+
+// Blocks connected instead of 3..5 after disconnect, last one spends output of the same block
+static const vector<vector<TestTx>> FORK_BLOCKS = {
+    {{"fork_3", {{"tx_2", 0}}, {{"C", 300}}}},
+    {{"fork_4", {{"tx_2", 1}}, {{"B", 100}, {"A", 600}}}, {"fork_5", {{"fork_4", 0}}, {{"C", 100}}}},
+};
+
+static void Exec(const string& sql)
+{
+    BOOST_REQUIRE_EQUAL(sqlite3_exec(SQLiteDbInst.m_db, sql.c_str(), nullptr, nullptr, nullptr), SQLITE_OK);
+}
+
+static vector<string> Select(const string& sql)
+{
+    vector<string> rows;
+
+    sqlite3_stmt* stmt;
+    BOOST_REQUIRE_EQUAL(sqlite3_prepare_v2(SQLiteDbInst.m_db, sql.c_str(), -1, &stmt, nullptr), SQLITE_OK);
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        string row;
+        for (int i = 0; i < sqlite3_column_count(stmt); i++)
+        {
+            auto value = sqlite3_column_text(stmt, i);
+            row += (value ? string(reinterpret_cast<const char*>(value)) : "null") + "|";
+        }
+        rows.push_back(row);
+    }
+    sqlite3_finalize(stmt);
+
+    return rows;
+}
+
+static void IndexBlock(int height, const vector<TestTx>& block)
+{
+    vector<TransactionIndexingInfo> txs;
+    for (const auto& tx : block)
+    {
+        Exec(strprintf("insert into Transactions (Type, Hash, Time) values (%d, '%s', %d)",
+            (int) TxType::TX_DEFAULT, tx.Hash, height));
+
+        TransactionIndexingInfo txInfo;
+        txInfo.Hash = tx.Hash;
+        txInfo.BlockNumber = (int) txs.size();
+        txInfo.Time = height;
+        txInfo.Type = TxType::TX_DEFAULT;
+        txInfo.Inputs = tx.Inputs;
+        txInfo.Outputs = tx.Outputs;
+
+        for (size_t i = 0; i < tx.Outputs.size(); i++)
+            Exec(strprintf("insert into TxOutputs (TxHash, Number, AddressHash, Value, ScriptPubKey) values ('%s', %d, '%s', %d, '')",
+                tx.Hash, (int) i, tx.Outputs[i].first, tx.Outputs[i].second));
+
+        txs.push_back(txInfo);
+    }
+
+    ChainRepoInst.IndexBlock(strprintf("block_%d", height), height, txs);
+}
+
+// Every balance row must equal the sum over TxOutputs at its height, one last row per address
+static void CheckFullRecompute()
+{
+    auto rows = Select(R"sql(
+        select b.AddressHash, b.Height, b.Value,
+          (select ifnull(sum(o.Value), 0) from TxOutputs o where o.AddressHash = b.AddressHash and o.TxHeight <= b.Height) -
+          (select ifnull(sum(o.Value), 0) from TxOutputs o where o.AddressHash = b.AddressHash and o.SpentHeight <= b.Height)
+        from Balances b
+        order by b.AddressHash, b.Height
+    )sql");
+    BOOST_CHECK(!rows.empty());
+
+    for (const auto& row : rows)
+    {
+        auto valueBegin = row.find('|', row.find('|') + 1) + 1;
+        auto valueEnd = row.find('|', valueBegin);
+        BOOST_CHECK_MESSAGE(row.substr(valueBegin, valueEnd - valueBegin) + "|" == row.substr(valueEnd + 1), row);
+    }
+
+    auto last = Select(R"sql(
+        select b.AddressHash
+        from Balances b
+        where b.Last = 1
+          and b.Height = (select max(b2.Height) from Balances b2 where b2.AddressHash = b.AddressHash)
+        order by b.AddressHash
+    )sql");
+    auto addresses = Select("select distinct AddressHash from TxOutputs where TxHeight is not null order by AddressHash");
+    BOOST_CHECK(last == addresses);
+    BOOST_CHECK(Select("select AddressHash from Balances where Last = 1").size() == addresses.size());
+}
+
+BOOST_AUTO_TEST_CASE(connect_disconnect_equals_full_recompute)
+{
+    // Rollback replays the journal or scans by height when it is pruned
+    for (int undoDepth : {100, 1})
+    {
+        gArgs.ForceSetArg("-pocketundodepth", strprintf("%d", undoDepth));
+
+        for (const auto& table : {"Transactions", "TxOutputs", "Balances", "TransactionsStatistic", "BlockUndo"})
+            Exec(strprintf("delete from %s", table));
+
+        for (size_t b = 0; b < TEST_BLOCKS.size(); b++)
+            IndexBlock((int) b + 1, TEST_BLOCKS[b]);
+        CheckFullRecompute();
+
+        // Cached last balances of blocks 3..5 must not survive the disconnect
+        BOOST_REQUIRE(ChainRepoInst.Rollback(3));
+        BOOST_CHECK(Select("select 1 from Balances where Height >= 3").empty());
+        CheckFullRecompute();
+
+        for (size_t b = 0; b < FORK_BLOCKS.size(); b++)
+            IndexBlock((int) b + 3, FORK_BLOCKS[b]);
+        CheckFullRecompute();
+
+        auto last = Select("select AddressHash, Height, Value from Balances where Last = 1 order by AddressHash");
+        BOOST_CHECK(last == vector<string>({"A|4|600|", "B|4|0|", "C|4|400|"}));
+
+        // Disconnect of all blocks, it also empties the cache for the next round
+        BOOST_REQUIRE(ChainRepoInst.Rollback(1));
+        BOOST_CHECK(Select("select 1 from Balances").empty());
+    }
+
+    gArgs.ForceSetArg("-pocketundodepth", strprintf("%d", DEFAULT_POCKET_UNDO_DEPTH));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
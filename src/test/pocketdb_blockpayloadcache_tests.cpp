@@ -0,0 +1,82 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <pocketdb/services/BlockPayloadCache.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace PocketServices;
+
+BOOST_FIXTURE_TEST_SUITE(pocketdb_blockpayloadcache_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(lru_eviction)
+{
+    BlockPayloadCache cache;
+    const string data(1000, 'x');
+
+    // Limit fits exactly three entries of the same size
+    cache.Put(uint256S("01"), false, data);
+    auto entryUsage = cache.GetStats().Usage;
+    BOOST_REQUIRE(entryUsage > data.size());
+    cache.SetLimit(entryUsage * 3);
+
+    cache.Put(uint256S("02"), false, data);
+    cache.Put(uint256S("03"), false, data);
+    BOOST_CHECK_EQUAL(cache.GetStats().Entries, 3U);
+
+    // Touch the oldest entry, so the next one becomes least recently used
+    string out;
+    BOOST_CHECK(cache.Get(uint256S("01"), false, out));
+    BOOST_CHECK_EQUAL(out, data);
+
+    cache.Put(uint256S("04"), false, data);
+    BOOST_CHECK_EQUAL(cache.GetStats().Entries, 3U);
+    BOOST_CHECK(cache.Exists(uint256S("01"), false));
+    BOOST_CHECK(!cache.Exists(uint256S("02"), false));
+    BOOST_CHECK(cache.Exists(uint256S("03"), false));
+    BOOST_CHECK(cache.Exists(uint256S("04"), false));
+    BOOST_CHECK(cache.GetStats().Usage <= cache.GetStats().Limit);
+
+    // Replacing an entry does not grow usage
+    cache.Put(uint256S("04"), false, data);
+    BOOST_CHECK_EQUAL(cache.GetStats().Usage, entryUsage * 3);
+
+    // Lower limit shrinks from the least recently used end
+    cache.SetLimit(entryUsage);
+    BOOST_CHECK_EQUAL(cache.GetStats().Entries, 1U);
+    BOOST_CHECK(cache.Exists(uint256S("04"), false));
+}
+
+BOOST_AUTO_TEST_CASE(encodings_and_limits)
+{
+    BlockPayloadCache cache;
+    cache.SetLimit(1024 * 1024);
+
+    auto hash = uint256S("0a");
+    cache.Put(hash, false, "{}");
+    cache.Put(hash, true, "\x01\x01");
+
+    string out;
+    BOOST_CHECK(cache.Get(hash, false, out) && out == "{}");
+    BOOST_CHECK(cache.Get(hash, true, out) && out == "\x01\x01");
+    BOOST_CHECK(!cache.Get(uint256S("0b"), true, out));
+
+    auto stats = cache.GetStats();
+    BOOST_CHECK_EQUAL(stats.Hits, 2);
+    BOOST_CHECK_EQUAL(stats.Misses, 1);
+
+    // Erase drops both encodings of the block
+    cache.Erase(hash);
+    BOOST_CHECK(!cache.Exists(hash, false));
+    BOOST_CHECK(!cache.Exists(hash, true));
+    BOOST_CHECK_EQUAL(cache.GetStats().Usage, 0U);
+
+    // Entry larger than the whole cache is not stored
+    cache.Put(hash, false, string(2 * 1024 * 1024, 'x'));
+    BOOST_CHECK(!cache.Exists(hash, false));
+    BOOST_CHECK_EQUAL(cache.GetStats().Entries, 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
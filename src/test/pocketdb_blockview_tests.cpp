@@ -0,0 +1,109 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <pocketdb/helpers/TransactionHelper.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace PocketTx;
+using namespace PocketHelpers;
+
+BOOST_FIXTURE_TEST_SUITE(pocketdb_blockview_tests, BasicTestingSetup)
+
+static PTransactionRef MakeTx(TxType type, const string& hash, const string& string1, const string& string2)
+{
+    auto ptx = TransactionHelper::CreateInstance(type);
+    ptx->SetHash(hash);
+    ptx->SetString1(string1);
+    ptx->SetString2(string2);
+    return ptx;
+}
+
+// Same lookup by linear scan as consensus did before the view
+static vector<PTransactionRef> Scan(const PocketBlock& block, const string& value, bool string1)
+{
+    vector<PTransactionRef> result;
+    for (const auto& ptx : block)
+    {
+        auto field = string1 ? ptx->GetString1() : ptx->GetString2();
+        if (field && *field == value)
+            result.push_back(ptx);
+    }
+    return result;
+}
+
+BOOST_AUTO_TEST_CASE(lookup_keeps_block_order)
+{
+    auto block = make_shared<PocketBlock>();
+    vector<string> addresses = {"A1", "A2", "A3"};
+    vector<string> targets = {"T1", "T2"};
+    for (int i = 0; i < 60; i++)
+    {
+        auto type = (i % 3 == 0) ? ACTION_SUBSCRIBE : (i % 3 == 1) ? ACTION_SCORE_CONTENT : CONTENT_POST;
+        block->push_back(MakeTx(type, "h" + to_string(i),
+            addresses[InsecureRandRange(addresses.size())], targets[InsecureRandRange(targets.size())]));
+    }
+
+    PocketBlockView view(block);
+    for (const auto& address : addresses)
+        BOOST_CHECK(view.ByString1(address) == Scan(*block, address, true));
+    for (const auto& target : targets)
+        BOOST_CHECK(view.ByString2(target) == Scan(*block, target, false));
+
+    BOOST_CHECK(view.ByString1("missing").empty());
+    BOOST_CHECK(view.Find("h7") == (*block)[7]);
+    BOOST_CHECK(!view.Find("missing"));
+
+    // Added transactions go to the end of the block and of every list
+    auto added = MakeTx(ACTION_SUBSCRIBE, "added", "A1", "T1");
+    view.Add(added);
+    BOOST_CHECK(view.Block()->back() == added);
+    BOOST_CHECK(view.ByString1("A1").back() == added);
+    BOOST_CHECK(view.ByString2("T1").back() == added);
+    BOOST_CHECK(view.ByString1("A1") == Scan(*block, "A1", true));
+}
+
+BOOST_AUTO_TEST_CASE(duplicate_hash_finds_first)
+{
+    auto block = make_shared<PocketBlock>();
+    auto first = MakeTx(CONTENT_POST, "dup", "A1", "R1");
+    auto second = MakeTx(CONTENT_POST, "dup", "A2", "R2");
+    block->push_back(first);
+    block->push_back(second);
+
+    PocketBlockView view(block);
+    BOOST_CHECK(view.Find("dup") == first);
+
+    // Empty view of a missing block
+    PocketBlockView empty(nullptr);
+    BOOST_CHECK(empty.Block() && empty.Block()->empty());
+    BOOST_CHECK(empty.ByString2("R1").empty());
+}
+
+BOOST_AUTO_TEST_CASE(lookups_recording)
+{
+    auto block = make_shared<PocketBlock>();
+    block->push_back(MakeTx(ACTION_SUBSCRIBE, "s1", "A1", "A2"));
+
+    PocketBlockView view(block);
+
+    PocketBlockView::Lookups lookups;
+    view.Record(&lookups);
+    view.ByString1("A3");
+    view.ByString2("A4");
+    BOOST_CHECK(!lookups.Found);
+
+    view.ByString2("A2");
+    BOOST_CHECK(lookups.Found);
+    BOOST_CHECK(lookups.String1 == vector<string>({"A3"}));
+    BOOST_CHECK(lookups.String2 == vector<string>({"A4", "A2"}));
+
+    // Lookups after recording stopped are not written
+    view.Record(nullptr);
+    view.ByString1("A1");
+    BOOST_CHECK_EQUAL(lookups.String1.size(), 1U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,174 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <pocketdb/pocketnet.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace PocketDb;
+using namespace PocketTx;
+
+BOOST_FIXTURE_TEST_SUITE(pocketdb_explorerstatistic_tests, TestingSetup)
+
+struct TestTx
+{
+    int Height;
+    string Hash;
+    TxType Type;
+    string String1;
+    string String2;
+};
+
+// Accounts registered around hour boundaries and edited in the bucket of registration, one post edited later
+static const vector<TestTx> TEST_TXS = {
+    {5, "user_1", TxType::ACCOUNT_USER, "address_1", ""},
+    {10, "post_1", TxType::CONTENT_POST, "address_1", "post_1"},
+    {30, "user_1_edit", TxType::ACCOUNT_USER, "address_1", ""},
+    {59, "user_2", TxType::ACCOUNT_USER, "address_2", ""},
+    {60, "user_3", TxType::ACCOUNT_USER, "address_3", ""},
+    {61, "user_4", TxType::ACCOUNT_USER, "address_4", ""},
+    {70, "post_1_edit", TxType::CONTENT_POST, "address_1", "post_1"},
+    {100, "user_4_edit", TxType::ACCOUNT_USER, "address_4", ""},
+    {119, "user_5", TxType::ACCOUNT_USER, "address_5", ""},
+    {130, "user_6", TxType::ACCOUNT_USER, "address_6", ""},
+};
+
+static void Exec(const string& sql)
+{
+    BOOST_REQUIRE_EQUAL(sqlite3_exec(SQLiteDbInst.m_db, sql.c_str(), nullptr, nullptr, nullptr), SQLITE_OK);
+}
+
+// Every block has a coinstake transaction, as buckets are reported by them
+static void IndexBlock(int height, const vector<TestTx>& txs)
+{
+    vector<TransactionIndexingInfo> infos;
+    for (const auto& tx : txs)
+    {
+        Exec(strprintf("insert into Transactions (Type, Hash, Time, String1, String2) values (%d, '%s', %d, '%s', %s)",
+            (int) tx.Type, tx.Hash, height, tx.String1, tx.String2.empty() ? "null" : "'" + tx.String2 + "'"));
+
+        TransactionIndexingInfo txInfo;
+        txInfo.Hash = tx.Hash;
+        txInfo.BlockNumber = (int) infos.size();
+        txInfo.Time = height;
+        txInfo.Type = tx.Type;
+        infos.push_back(txInfo);
+    }
+
+    ChainRepoInst.IndexBlock(strprintf("block_%d", height), height, infos);
+}
+
+static void IndexChain(int fromHeight, int toHeight)
+{
+    for (int height = fromHeight; height <= toHeight; height++)
+    {
+        vector<TestTx> txs = {{height, strprintf("coinstake_%d", height), TxType::TX_COINSTAKE, "", ""}};
+        for (const auto& tx : TEST_TXS)
+            if (tx.Height == height)
+                txs.push_back(tx);
+
+        IndexBlock(height, txs);
+    }
+}
+
+// Scan of Transactions that served the statistic before the rollup, sampled at the last block of bucket
+static UniValue ScanAccountsStatistic(int period, int topHeight, int depth)
+{
+    UniValue result(UniValue::VOBJ);
+
+    sqlite3_stmt* stmt;
+    BOOST_REQUIRE_EQUAL(sqlite3_prepare_v2(SQLiteDbInst.m_db, R"sql(
+        select b.Part
+          ,(
+            select
+              count()
+            from Transactions u1 indexed by Transactions_Type_Last_Height_Id
+            where u1.Type in (100)
+            and u1.Height <= b.Height
+            and u1.Last = 1
+          )cnt
+        from (
+            select (u.Height / ?1)Part, max(u.Height)Height
+            from Transactions u
+            where u.Type in (3)
+              and (u.Height / ?1) <= (?2 / ?1)
+              and (u.Height / ?1) > (?3 / ?1)
+            group by (u.Height / ?1)
+        ) b
+        order by b.Part desc
+    )sql", -1, &stmt, nullptr), SQLITE_OK);
+    sqlite3_bind_int(stmt, 1, period);
+    sqlite3_bind_int(stmt, 2, topHeight);
+    sqlite3_bind_int(stmt, 3, topHeight - depth);
+
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+        result.pushKV(to_string(sqlite3_column_int(stmt, 0)), sqlite3_column_int(stmt, 1));
+
+    sqlite3_finalize(stmt);
+    return result;
+}
+
+static UniValue ScanContentStatistic()
+{
+    UniValue result(UniValue::VOBJ);
+
+    sqlite3_stmt* stmt;
+    BOOST_REQUIRE_EQUAL(sqlite3_prepare_v2(SQLiteDbInst.m_db, R"sql(
+        select t.Type, count()Count
+        from Transactions t indexed by Transactions_Type_Last_Height_Id
+        where t.Type in (100,101,102,200,201,202,208)
+          and t.Last = 1
+          and t.Height > 0
+        group by t.Type
+    )sql", -1, &stmt, nullptr), SQLITE_OK);
+
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+        result.pushKV(to_string(sqlite3_column_int(stmt, 0)), sqlite3_column_int(stmt, 1));
+
+    sqlite3_finalize(stmt);
+    return result;
+}
+
+BOOST_AUTO_TEST_CASE(rollup_equals_scan)
+{
+    IndexChain(1, 150);
+
+    for (const auto& [topHeight, depth] : vector<pair<int, int>>{{150, 150}, {150, 60}, {100, 60}, {119, 60}, {120, 1}})
+    {
+        auto scan = ScanAccountsStatistic(60, topHeight, depth);
+        BOOST_CHECK_MESSAGE(!scan.empty(), strprintf("%d %d", topHeight, depth));
+        BOOST_CHECK_EQUAL(ExplorerRepoInst.GetContentStatisticByHours(topHeight, depth).write(), scan.write());
+        BOOST_CHECK_EQUAL(ExplorerRepoInst.GetContentStatisticByDays(topHeight, depth).write(),
+            ScanAccountsStatistic(1440, topHeight, depth).write());
+    }
+
+    BOOST_CHECK_EQUAL(ExplorerRepoInst.GetContentStatistic().write(), ScanContentStatistic().write());
+
+    // Same after rollback into the middle of a bucket and connecting it again
+    BOOST_REQUIRE(ChainRepoInst.Rollback(90));
+    BOOST_CHECK_EQUAL(ExplorerRepoInst.GetContentStatisticByHours(89, 89).write(), ScanAccountsStatistic(60, 89, 89).write());
+
+    Exec("delete from Transactions where Height is null");
+    IndexChain(90, 150);
+    BOOST_CHECK_EQUAL(ExplorerRepoInst.GetContentStatisticByHours(150, 150).write(), ScanAccountsStatistic(60, 150, 150).write());
+    BOOST_CHECK_EQUAL(ExplorerRepoInst.GetContentStatistic().write(), ScanContentStatistic().write());
+}
+
+BOOST_AUTO_TEST_CASE(edited_account_counted_from_registration)
+{
+    IndexChain(1, 150);
+    IndexBlock(151, {
+        {151, "coinstake_151", TxType::TX_COINSTAKE, "", ""},
+        {151, "user_3_edit", TxType::ACCOUNT_USER, "address_3", ""}});
+
+    // Scan dropped the account from hour 1 as its last version moved to hour 2, rollup keeps it
+    auto rollup = ExplorerRepoInst.GetContentStatisticByHours(151, 151);
+    auto scan = ScanAccountsStatistic(60, 151, 151);
+    BOOST_CHECK_EQUAL(rollup["1"].get_int(), 5);
+    BOOST_CHECK_EQUAL(scan["1"].get_int(), 4);
+    BOOST_CHECK_EQUAL(rollup["2"].get_int(), scan["2"].get_int());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,111 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <pocketdb/consensus/MempoolValidationCache.h>
+#include <pocketdb/helpers/TransactionHelper.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace PocketTx;
+using namespace PocketHelpers;
+using namespace PocketConsensus;
+
+BOOST_FIXTURE_TEST_SUITE(pocketdb_mempoolvalidationcache_tests, BasicTestingSetup)
+
+static PTransactionRef MakeTx(TxType type, const string& hash, const string& string1, const string& string2)
+{
+    auto ptx = TransactionHelper::CreateInstance(type);
+    ptx->SetHash(hash);
+    ptx->SetString1(string1);
+    ptx->SetString2(string2);
+    return ptx;
+}
+
+// Validation looking for transactions of the same account in the block, as consensus rules do
+struct CountingValidation
+{
+    PocketBlockView& View;
+    int Calls = 0;
+
+    tuple<bool, SocialConsensusResult> operator()()
+    {
+        Calls++;
+        View.ByString1("A1");
+        View.ByString2("T1");
+        return {true, SocialConsensusResult_Success};
+    }
+};
+
+BOOST_AUTO_TEST_CASE(cached_when_nothing_found)
+{
+    auto block = make_shared<PocketBlock>();
+    block->push_back(MakeTx(ACTION_SUBSCRIBE, "h1", "A2", "T2"));
+    PocketBlockView view(block);
+
+    MempoolValidationCache cache;
+    CountingValidation validation{view};
+    auto validate = [&]() { return validation(); };
+
+    auto [ok, result] = cache.Validate("tip", "tx", view, validate);
+    BOOST_CHECK(ok);
+    BOOST_CHECK_EQUAL(result, SocialConsensusResult_Success);
+    BOOST_CHECK_EQUAL(validation.Calls, 1);
+
+    cache.Validate("tip", "tx", view, validate);
+    BOOST_CHECK_EQUAL(validation.Calls, 1);
+
+    // New tip and Clear drop verdicts
+    cache.Validate("tip2", "tx", view, validate);
+    BOOST_CHECK_EQUAL(validation.Calls, 2);
+
+    cache.Clear();
+    cache.Validate("tip2", "tx", view, validate);
+    BOOST_CHECK_EQUAL(validation.Calls, 3);
+}
+
+BOOST_AUTO_TEST_CASE(not_cached_when_found)
+{
+    auto block = make_shared<PocketBlock>();
+    block->push_back(MakeTx(ACTION_SUBSCRIBE, "h1", "A1", "T2"));
+    PocketBlockView view(block);
+
+    MempoolValidationCache cache;
+    CountingValidation validation{view};
+    auto validate = [&]() { return validation(); };
+
+    cache.Validate("tip", "tx", view, validate);
+    cache.Validate("tip", "tx", view, validate);
+    BOOST_CHECK_EQUAL(validation.Calls, 2);
+}
+
+BOOST_AUTO_TEST_CASE(conflict_recheck)
+{
+    auto block = make_shared<PocketBlock>();
+    PocketBlockView view(block);
+
+    MempoolValidationCache cache;
+    CountingValidation validation{view};
+    auto validate = [&]() { return validation(); };
+
+    cache.Validate("tip", "tx", view, validate);
+    cache.Validate("tip", "tx", view, validate);
+    BOOST_CHECK_EQUAL(validation.Calls, 1);
+
+    // Transaction of another key does not touch the verdict
+    view.Add(MakeTx(ACTION_SUBSCRIBE, "h1", "A2", "T2"));
+    cache.Validate("tip", "tx", view, validate);
+    BOOST_CHECK_EQUAL(validation.Calls, 1);
+
+    // Block now has a transaction the validation looked for
+    view.Add(MakeTx(ACTION_SCORE_CONTENT, "h2", "A3", "T1"));
+    cache.Validate("tip", "tx", view, validate);
+    BOOST_CHECK_EQUAL(validation.Calls, 2);
+
+    // Verdict with the conflict found is not kept
+    cache.Validate("tip", "tx", view, validate);
+    BOOST_CHECK_EQUAL(validation.Calls, 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,142 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <pocketdb/pocketnet.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace PocketDb;
+using namespace PocketTx;
+
+BOOST_FIXTURE_TEST_SUITE(pocketdb_rollback_tests, TestingSetup)
+
+struct TestTx
+{
+    string Hash;
+    TxType Type;
+    string Root;
+};
+
+// Account edited twice and post edited twice by one address, every tx spends the previous one
+static const vector<vector<TestTx>> TEST_BLOCKS = {
+    {{"user_1", TxType::ACCOUNT_USER, ""}},
+    {{"post_1", TxType::CONTENT_POST, "post_1"}},
+    {{"user_2", TxType::ACCOUNT_USER, ""}},
+    {{"post_2", TxType::CONTENT_POST, "post_1"}},
+    {{"user_3", TxType::ACCOUNT_USER, ""}, {"post_3", TxType::CONTENT_POST, "post_1"}},
+};
+
+static void Exec(const string& sql)
+{
+    BOOST_REQUIRE_EQUAL(sqlite3_exec(SQLiteDbInst.m_db, sql.c_str(), nullptr, nullptr, nullptr), SQLITE_OK);
+}
+
+static vector<string> Select(const string& sql)
+{
+    vector<string> rows;
+
+    sqlite3_stmt* stmt;
+    BOOST_REQUIRE_EQUAL(sqlite3_prepare_v2(SQLiteDbInst.m_db, sql.c_str(), -1, &stmt, nullptr), SQLITE_OK);
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        string row;
+        for (int i = 0; i < sqlite3_column_count(stmt); i++)
+        {
+            auto value = sqlite3_column_text(stmt, i);
+            row += (value ? string(reinterpret_cast<const char*>(value)) : "null") + "|";
+        }
+        rows.push_back(row);
+    }
+    sqlite3_finalize(stmt);
+
+    return rows;
+}
+
+static vector<string> Dump()
+{
+    vector<string> rows;
+    for (const auto& sql : {
+        "select Hash, BlockHash, BlockNum, Height, Last, Id from Transactions order by Hash",
+        "select TxHash, Number, TxHeight, SpentHeight, SpentTxHash from TxOutputs order by TxHash, Number",
+        "select AddressHash, Last, Height, Value from Balances order by AddressHash, Height",
+        "select Period, Bucket, Type, Count, Last from TransactionsStatistic order by Period, Bucket, Type" })
+    {
+        auto table = Select(sql);
+        rows.insert(rows.end(), table.begin(), table.end());
+    }
+
+    return rows;
+}
+
+// Index all test blocks, roll back to height and return the database state
+static vector<string> IndexAndRollback(int rollbackHeight)
+{
+    for (const auto& table : {"Transactions", "TxOutputs", "Balances", "TransactionsStatistic", "BlockUndo"})
+        Exec(strprintf("delete from %s", table));
+
+    string prevHash;
+    for (size_t b = 0; b < TEST_BLOCKS.size(); b++)
+    {
+        int height = (int) b + 1;
+
+        vector<TransactionIndexingInfo> txs;
+        for (const auto& tx : TEST_BLOCKS[b])
+        {
+            Exec(strprintf(
+                "insert into Transactions (Type, Hash, Time, String1, String2) values (%d, '%s', %d, 'address', %s)",
+                (int) tx.Type, tx.Hash, height, tx.Root.empty() ? "null" : "'" + tx.Root + "'"));
+            Exec(strprintf(
+                "insert into TxOutputs (TxHash, Number, AddressHash, Value, ScriptPubKey) values ('%s', 0, 'address', 100, '')",
+                tx.Hash));
+
+            TransactionIndexingInfo txInfo;
+            txInfo.Hash = tx.Hash;
+            txInfo.BlockNumber = (int) txs.size();
+            txInfo.Time = height;
+            txInfo.Type = tx.Type;
+            if (!prevHash.empty())
+                txInfo.Inputs.emplace_back(prevHash, 0);
+            txInfo.Outputs.emplace_back("address", 100);
+            txs.push_back(txInfo);
+
+            prevHash = tx.Hash;
+        }
+
+        ChainRepoInst.IndexBlock(strprintf("block_%d", height), height, txs);
+    }
+
+    BOOST_REQUIRE(ChainRepoInst.Rollback(rollbackHeight));
+
+    return Dump();
+}
+
+BOOST_AUTO_TEST_CASE(undo_journal_equals_full_rollback)
+{
+    const int rollbackHeight = 3;
+
+    // Journal of all blocks - rollback replays it
+    gArgs.ForceSetArg("-pocketundodepth", "100");
+    auto journal = IndexAndRollback(rollbackHeight);
+    BOOST_CHECK(Select("select 1 from BlockUndo where Height >= 3").empty());
+
+    // Journal pruned above the rollback height - rollback scans by height
+    gArgs.ForceSetArg("-pocketundodepth", "1");
+    auto full = IndexAndRollback(rollbackHeight);
+
+    gArgs.ForceSetArg("-pocketundodepth", strprintf("%d", DEFAULT_POCKET_UNDO_DEPTH));
+
+    BOOST_CHECK_EQUAL(journal.size(), full.size());
+    for (size_t i = 0; i < min(journal.size(), full.size()); i++)
+        BOOST_CHECK_EQUAL(journal[i], full[i]);
+
+    // Blocks 1 and 2 remain with their first versions as last
+    auto last = Select("select Hash from Transactions where Last = 1 order by Hash");
+    BOOST_CHECK(last == vector<string>({"post_1|", "user_1|"}));
+
+    auto unspent = Select("select TxHash from TxOutputs where TxHeight is not null and SpentHeight is null");
+    BOOST_CHECK(unspent == vector<string>({"post_1|"}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,149 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <pocketdb/services/Serializer.h>
+#include <primitives/block.h>
+#include <script/standard.h>
+#include <streams.h>
+#include <version.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace PocketTx;
+using namespace PocketServices;
+
+BOOST_FIXTURE_TEST_SUITE(pocketdb_serializer_tests, BasicTestingSetup)
+
+static CTransactionRef MakePostTx(uint32_t n)
+{
+    CMutableTransaction mtx;
+    mtx.vin.resize(1);
+    mtx.vin[0].prevout = COutPoint(uint256S("aa"), n);
+    mtx.vout.resize(2);
+    mtx.vout[0].scriptPubKey = CScript() << OP_RETURN << ParseHex(OR_POST) << ParseHex("00ff");
+    mtx.vout[1].scriptPubKey = GetScriptForDestination(PKHash(uint160()));
+    mtx.vout[1].nValue = 1000 + n;
+    return MakeTransactionRef(mtx);
+}
+
+static PTransactionRef MakePost(const CTransactionRef& tx)
+{
+    auto[ok, ptx] = Serializer::DeserializeTransaction(tx);
+    BOOST_REQUIRE(ok && ptx);
+
+    ptx->SetString1("PAddress");
+    ptx->SetString2(*ptx->GetHash());
+    ptx->SetString3("");
+
+    Payload payload;
+    payload.SetTxHash(*ptx->GetHash());
+    payload.SetString1("en");
+    payload.SetString2("Caption \xd0\xbf\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82");
+    payload.SetString3(string(300, 'm'));
+    payload.SetString4("[\"tag\"]");
+    payload.SetInt1(-5);
+    ptx->SetPayload(payload);
+
+    return ptx;
+}
+
+static void CheckEqual(const Transaction& a, const Transaction& b)
+{
+    BOOST_CHECK_EQUAL(*a.GetHash(), *b.GetHash());
+    BOOST_CHECK_EQUAL((int) *a.GetType(), (int) *b.GetType());
+
+    for (auto [x, y] : {
+        make_pair(a.GetString1(), b.GetString1()), make_pair(a.GetString2(), b.GetString2()),
+        make_pair(a.GetString3(), b.GetString3()), make_pair(a.GetString4(), b.GetString4()),
+        make_pair(a.GetString5(), b.GetString5()) })
+    {
+        BOOST_CHECK_EQUAL(!x, !y);
+        if (x && y) BOOST_CHECK_EQUAL(*x, *y);
+    }
+
+    BOOST_CHECK_EQUAL(!a.GetInt1(), !b.GetInt1());
+    BOOST_REQUIRE_EQUAL(!a.GetPayload(), !b.GetPayload());
+    if (!a.GetPayload())
+        return;
+
+    auto pa = a.GetPayload();
+    auto pb = b.GetPayload();
+    for (auto [x, y] : {
+        make_pair(pa->GetString1(), pb->GetString1()), make_pair(pa->GetString2(), pb->GetString2()),
+        make_pair(pa->GetString3(), pb->GetString3()), make_pair(pa->GetString4(), pb->GetString4()),
+        make_pair(pa->GetString5(), pb->GetString5()), make_pair(pa->GetString6(), pb->GetString6()),
+        make_pair(pa->GetString7(), pb->GetString7()) })
+    {
+        BOOST_CHECK_EQUAL(!x, !y);
+        if (x && y) BOOST_CHECK_EQUAL(*x, *y);
+    }
+
+    BOOST_CHECK_EQUAL(!pa->GetInt1(), !pb->GetInt1());
+    if (pa->GetInt1() && pb->GetInt1()) BOOST_CHECK_EQUAL(*pa->GetInt1(), *pb->GetInt1());
+}
+
+BOOST_AUTO_TEST_CASE(binary_transaction_roundtrip)
+{
+    auto tx = MakePostTx(0);
+    auto ptx = MakePost(tx);
+
+    auto binary = Serializer::SerializeTransactionBinary(*ptx);
+    BOOST_REQUIRE(!binary.empty());
+    BOOST_CHECK_EQUAL((unsigned char) binary[0], POCKET_BINARY_PAYLOAD_MARKER);
+
+    CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+    stream << binary;
+
+    auto[ok, restored] = Serializer::DeserializeTransaction(tx, stream);
+    BOOST_REQUIRE(ok && restored);
+    CheckEqual(*ptx, *restored);
+    BOOST_CHECK_EQUAL(restored->Outputs().size(), tx->vout.size());
+}
+
+BOOST_AUTO_TEST_CASE(binary_block_roundtrip)
+{
+    CBlock block;
+    PocketBlock pocketBlock;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        auto tx = MakePostTx(i);
+        block.vtx.push_back(tx);
+        pocketBlock.push_back(MakePost(tx));
+    }
+
+    // Transaction without payload keeps absent fields absent
+    auto bare = Serializer::DeserializeTransaction(block.vtx[2]);
+    pocketBlock[2] = get<1>(bare);
+    pocketBlock[2]->SetString1("PAddress2");
+
+    CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+    stream << Serializer::SerializeBlockBinary(pocketBlock);
+
+    auto[ok, restored] = Serializer::DeserializeBlock(block, stream);
+    BOOST_REQUIRE(ok);
+    BOOST_REQUIRE_EQUAL(restored.size(), pocketBlock.size());
+    for (size_t i = 0; i < restored.size(); i++)
+        CheckEqual(*pocketBlock[i], *restored[i]);
+}
+
+BOOST_AUTO_TEST_CASE(binary_truncated_payload)
+{
+    auto tx = MakePostTx(0);
+    auto ptx = MakePost(tx);
+
+    auto binary = Serializer::SerializeTransactionBinary(*ptx);
+    binary.resize(binary.size() / 2);
+
+    CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+    stream << binary;
+
+    // Broken payload is dropped, transaction itself is still restored from outputs
+    auto[ok, restored] = Serializer::DeserializeTransaction(tx, stream);
+    BOOST_REQUIRE(ok && restored);
+    BOOST_CHECK(!restored->GetPayload());
+    BOOST_CHECK(!restored->GetString1());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,102 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <pocketdb/pocketnet.h>
+#include <pocketdb/repositories/web/SearchRepository.h>
+#include <pocketdb/repositories/web/WebRepository.h>
+#include <pocketdb/services/SocialGraph.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace PocketDb;
+using namespace PocketServices;
+
+BOOST_FIXTURE_TEST_SUITE(pocketdb_socialgraph_tests, TestingSetup)
+
+static const vector<int> CONTENT_TYPES = {200, 201, 202};
+
+static void Exec(const string& sql)
+{
+    BOOST_REQUIRE_EQUAL(sqlite3_exec(SQLiteDbInst.m_db, sql.c_str(), nullptr, nullptr, nullptr), SQLITE_OK);
+}
+
+static void InsertTx(int type, const string& hash, int height, int64_t id, const string& string1, const string& string2, int int1 = 0)
+{
+    Exec(strprintf("insert into Transactions (Type, Hash, Time, BlockHash, BlockNum, Height, Last, Id, String1, String2, Int1) "
+                   "values (%d, '%s', %d, 'block_%d', 0, %d, 1, %d, '%s', '%s', %d)",
+        type, hash, height, height, height, id, string1, string2, int1));
+}
+
+// Accounts 1..6 at height 1, contents at height 2, subscriptions and likes at height 3.
+// Counts of recommended accounts differ, so SQL and graph order them in the same way.
+static void FillChain()
+{
+    for (int i = 1; i <= 6; i++)
+    {
+        InsertTx(100, strprintf("user_%d", i), 1, i, strprintf("address_%d", i), "");
+        Exec(strprintf("insert into Payload (TxHash, String2, String3) values ('user_%d', 'name_%d', 'avatar_%d')", i, i, i));
+    }
+
+    int64_t contentId = 100;
+    for (const auto& [author, contents] : vector<pair<int, int>>{{1, 1}, {4, 1}, {5, 3}, {6, 2}})
+        for (int i = 0; i < contents; i++, contentId++)
+            InsertTx(200, strprintf("post_%d_%d", author, i), 2, contentId, strprintf("address_%d", author), strprintf("post_%d_%d", author, i));
+
+    // Subscribers of account 1 are subscribed to 5 (3 times), 6 (2 times), 4 (once)
+    for (const auto& [from, to] : vector<pair<int, int>>{{2, 1}, {3, 1}, {4, 1}, {2, 5}, {3, 5}, {4, 5}, {2, 6}, {3, 6}, {3, 4}})
+        InsertTx(302, strprintf("subscribe_%d_%d", from, to), 3, 0, strprintf("address_%d", from), strprintf("address_%d", to));
+
+    // Likers of account 1 content liked 3 contents of 5, 2 of 6 and 1 of 4; low scores are not likes
+    for (const auto& [from, post, value] : vector<tuple<int, string, int>>{
+        {2, "post_1_0", 5}, {3, "post_1_0", 4}, {4, "post_1_0", 3},
+        {2, "post_5_0", 5}, {2, "post_5_1", 5}, {3, "post_5_2", 5}, {3, "post_5_0", 5},
+        {2, "post_6_0", 5}, {3, "post_6_1", 4}, {3, "post_4_0", 5}, {4, "post_6_0", 5}})
+        InsertTx(300, strprintf("score_%d_%s", from, post), 3, 0, strprintf("address_%d", from), post, value);
+}
+
+static void Compare(SocialGraph& graph)
+{
+    SearchRepository searchRepo(SQLiteDbInst);
+
+    auto sqlSubscriptions = searchRepo.GetRecomendedAccountsBySubscriptions("address_1", 10);
+    auto graphSubscriptions = searchRepo.GetRecomendedAccountsByIds(graph.GetRecomendedAccountsBySubscriptions(1, 10));
+    BOOST_CHECK_EQUAL(sqlSubscriptions.size(), 3U);
+    BOOST_CHECK_EQUAL(graphSubscriptions.write(), sqlSubscriptions.write());
+
+    auto sqlSimilar = searchRepo.GetRecomendedAccountsByScoresOnSimilarAccounts("address_1", CONTENT_TYPES, 3, 1000, 10);
+    auto graphSimilar = searchRepo.GetRecomendedAccountsByIds(graph.GetRecomendedAccountsByScoresOnSimilarAccounts(1, CONTENT_TYPES, 3 - 1000, 10));
+    BOOST_CHECK_EQUAL(sqlSimilar.size(), 3U);
+    BOOST_CHECK_EQUAL(graphSimilar.write(), sqlSimilar.write());
+}
+
+BOOST_AUTO_TEST_CASE(build_equals_sql)
+{
+    FillChain();
+
+    WebRepository webRepo(SQLiteDbInst);
+    SocialGraph graph;
+    graph.BeginBuild();
+    BOOST_REQUIRE(graph.Build(webRepo.GetSocialGraph(3), 3));
+
+    Compare(graph);
+}
+
+BOOST_AUTO_TEST_CASE(apply_equals_sql)
+{
+    FillChain();
+
+    // Graph built before subscriptions and likes, the block with them applied later
+    WebRepository webRepo(SQLiteDbInst);
+    SocialGraph graph;
+    graph.BeginBuild();
+    BOOST_REQUIRE(graph.Build(webRepo.GetSocialGraph(2), 2));
+    BOOST_CHECK(graph.GetRecomendedAccountsBySubscriptions(1, 10).empty());
+
+    graph.Apply(webRepo.GetSocialGraphActions("block_3"), 3);
+
+    Compare(graph);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,137 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <pocketdb/SQLiteDatabase.h>
+#include <test/util/setup_common.h>
+#include <util/system.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace PocketDb;
+
+struct StatementCacheSetup : public TestingSetup
+{
+    SQLiteDatabase db{false};
+
+    StatementCacheSetup()
+    {
+        gArgs.ForceSetArg("-sqlstatementcache", "2");
+        db.Init((GetDataDir() / "statementcache").string(), "test");
+        BOOST_REQUIRE_EQUAL(sqlite3_exec(db.m_db, "create table t (v int); insert into t values (1), (2), (3);", nullptr, nullptr, nullptr), SQLITE_OK);
+    }
+
+    ~StatementCacheSetup()
+    {
+        db.Cleanup();
+        gArgs.ForceSetArg("-sqlstatementcache", "");
+    }
+
+    sqlite3_stmt* Prepare(const string& sql)
+    {
+        sqlite3_stmt* stmt = nullptr;
+        BOOST_REQUIRE_EQUAL(db.PrepareStatement(sql, &stmt), SQLITE_OK);
+        return stmt;
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(pocketdb_statementcache_tests, StatementCacheSetup)
+
+BOOST_AUTO_TEST_CASE(hit_miss)
+{
+    auto first = Prepare("select v from t");
+    db.ReleaseStatement(first);
+
+    auto second = Prepare("select v from t");
+    BOOST_CHECK(first == second);
+    db.ReleaseStatement(second);
+
+    auto stats = db.GetStatementCacheStats();
+    BOOST_CHECK_EQUAL(stats.Misses, 1);
+    BOOST_CHECK_EQUAL(stats.Hits, 1);
+    BOOST_CHECK_EQUAL(stats.Size, 1U);
+}
+
+BOOST_AUTO_TEST_CASE(busy_reprepare)
+{
+    // Nested use of the same SQL gets own statement, not cached
+    auto outer = Prepare("select v from t");
+    auto inner = Prepare("select v from t");
+    BOOST_CHECK(outer != inner);
+    BOOST_CHECK_EQUAL(db.GetStatementCacheStats().Size, 1U);
+
+    BOOST_CHECK_EQUAL(db.ReleaseStatement(inner), SQLITE_OK);
+    db.ReleaseStatement(outer);
+
+    BOOST_CHECK(Prepare("select v from t") == outer);
+    db.ReleaseStatement(outer);
+}
+
+BOOST_AUTO_TEST_CASE(release_resets)
+{
+    auto stmt = Prepare("select v from t where v >= ? order by v");
+    BOOST_REQUIRE_EQUAL(sqlite3_bind_int(stmt, 1, 2), SQLITE_OK);
+    BOOST_REQUIRE_EQUAL(sqlite3_step(stmt), SQLITE_ROW);
+    BOOST_CHECK_EQUAL(sqlite3_column_int(stmt, 0), 2);
+    db.ReleaseStatement(stmt);
+
+    // Statement starts from the first row and the binding is cleared to null
+    stmt = Prepare("select v from t where v >= ? order by v");
+    BOOST_CHECK_EQUAL(sqlite3_step(stmt), SQLITE_DONE);
+    db.ReleaseStatement(stmt);
+
+    // Statements left busy by an exception are reset too
+    stmt = Prepare("select v from t where v >= ? order by v");
+    sqlite3_bind_int(stmt, 1, 3);
+    BOOST_REQUIRE_EQUAL(sqlite3_step(stmt), SQLITE_ROW);
+    db.ReleaseBusyStatements();
+
+    BOOST_CHECK(Prepare("select v from t where v >= ? order by v") == stmt);
+    BOOST_CHECK_EQUAL(sqlite3_step(stmt), SQLITE_DONE);
+    db.ReleaseStatement(stmt);
+}
+
+BOOST_AUTO_TEST_CASE(evict_lru)
+{
+    auto a = Prepare("select 1");
+    db.ReleaseStatement(a);
+    auto b = Prepare("select 2");
+    db.ReleaseStatement(b);
+
+    // Use of `a` makes `b` the least recently used
+    db.ReleaseStatement(Prepare("select 1"));
+    db.ReleaseStatement(Prepare("select 3"));
+
+    auto stats = db.GetStatementCacheStats();
+    BOOST_CHECK_EQUAL(stats.Size, 2U);
+    BOOST_CHECK_EQUAL(stats.Evictions, 1);
+
+    BOOST_CHECK(Prepare("select 1") == a);
+    db.ReleaseStatement(a);
+    BOOST_CHECK_EQUAL(db.GetStatementCacheStats().Hits, 2);
+
+    db.ReleaseStatement(Prepare("select 2"));
+    BOOST_CHECK_EQUAL(db.GetStatementCacheStats().Misses, 4);
+}
+
+BOOST_AUTO_TEST_CASE(busy_not_evicted)
+{
+    auto a = Prepare("select 1");
+    auto b = Prepare("select 2");
+
+    // All cached statements are in use - new one is not cached
+    auto c = Prepare("select 3");
+    BOOST_CHECK_EQUAL(db.ReleaseStatement(c), SQLITE_OK);
+
+    auto stats = db.GetStatementCacheStats();
+    BOOST_CHECK_EQUAL(stats.Size, 2U);
+    BOOST_CHECK_EQUAL(stats.Evictions, 0);
+
+    db.ReleaseStatement(a);
+    db.ReleaseStatement(b);
+
+    BOOST_CHECK(Prepare("select 2") == b);
+    db.ReleaseStatement(b);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,123 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <pocketdb/services/UnspentsCache.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace PocketServices;
+
+BOOST_FIXTURE_TEST_SUITE(pocketdb_unspentscache_tests, BasicTestingSetup)
+
+static vector<UnspentOutput> MakeOutputs(const string& address, const string& txHash, size_t count)
+{
+    vector<UnspentOutput> outputs(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        outputs[i].TxHash = txHash;
+        outputs[i].Number = (int) i;
+        outputs[i].AddressHash = address;
+        outputs[i].Value = 100;
+    }
+
+    return outputs;
+}
+
+static TransactionIndexingInfo MakeTx(const string& hash, vector<pair<string, int>> inputs, vector<pair<string, int64_t>> outputs)
+{
+    TransactionIndexingInfo txInfo;
+    txInfo.Hash = hash;
+    txInfo.BlockNumber = 0;
+    txInfo.Time = 0;
+    txInfo.Type = TxType::TX_DEFAULT;
+    txInfo.Inputs = move(inputs);
+    txInfo.Outputs = move(outputs);
+    return txInfo;
+}
+
+static bool Cached(UnspentsCache& cache, const string& address)
+{
+    vector<UnspentOutput> outputs;
+    return cache.Get(address, outputs);
+}
+
+BOOST_AUTO_TEST_CASE(put_get)
+{
+    UnspentsCache cache;
+
+    cache.Put("a", MakeOutputs("a", "tx_a", 2), cache.Generation());
+
+    vector<UnspentOutput> outputs;
+    BOOST_CHECK(cache.Get("a", outputs));
+    BOOST_CHECK(!cache.Get("b", outputs));
+    BOOST_REQUIRE_EQUAL(outputs.size(), 2U);
+    BOOST_CHECK_EQUAL(outputs[1].TxHash, "tx_a");
+    BOOST_CHECK_EQUAL(outputs[1].Number, 1);
+
+    // Addresses with many outputs are not cached
+    cache.Put("big", MakeOutputs("big", "tx_big", POCKET_UNSPENTS_CACHE_ADDRESS_OUTPUTS + 1), cache.Generation());
+    BOOST_CHECK(!Cached(cache, "big"));
+}
+
+BOOST_AUTO_TEST_CASE(block_connected_drops_changed_addresses)
+{
+    UnspentsCache cache;
+
+    for (const auto& address : {"receiver", "spender", "other"})
+        cache.Put(address, MakeOutputs(address, string("tx_") + address, 1), cache.Generation());
+
+    // Outputs read before the block was indexed are not saved
+    auto generation = cache.Generation();
+
+    cache.BlockConnected({MakeTx("tx_new", {{"tx_spender", 0}}, {{"receiver", 50}})});
+
+    BOOST_CHECK(!Cached(cache, "receiver"));
+    BOOST_CHECK(!Cached(cache, "spender"));
+    BOOST_CHECK(Cached(cache, "other"));
+
+    cache.Put("late", MakeOutputs("late", "tx_late", 1), generation);
+    BOOST_CHECK(!Cached(cache, "late"));
+
+    cache.Put("late", MakeOutputs("late", "tx_late", 1), cache.Generation());
+    BOOST_CHECK(Cached(cache, "late"));
+}
+
+BOOST_AUTO_TEST_CASE(clear_after_rollback)
+{
+    UnspentsCache cache;
+
+    // RPC reads outputs while the rollback is not committed yet
+    auto generation = cache.Generation();
+    cache.Put("a", MakeOutputs("a", "tx_a", 1), generation);
+
+    // Rollback committed - everything read before is dropped and not saved later
+    cache.Clear();
+    BOOST_CHECK(!Cached(cache, "a"));
+
+    cache.Put("b", MakeOutputs("b", "tx_b", 1), generation);
+    BOOST_CHECK(!Cached(cache, "b"));
+}
+
+BOOST_AUTO_TEST_CASE(lru_eviction)
+{
+    UnspentsCache cache;
+
+    size_t perAddress = POCKET_UNSPENTS_CACHE_ADDRESS_OUTPUTS;
+    size_t addresses = POCKET_UNSPENTS_CACHE_OUTPUTS / perAddress;
+
+    for (size_t i = 0; i < addresses; i++)
+        cache.Put(strprintf("address_%d", i), MakeOutputs("", strprintf("tx_%d", i), perAddress), cache.Generation());
+
+    // Recently used address stays, the least recently used one is evicted
+    BOOST_CHECK(Cached(cache, "address_0"));
+    cache.Put("extra", MakeOutputs("extra", "tx_extra", perAddress), cache.Generation());
+
+    BOOST_CHECK(Cached(cache, "extra"));
+    BOOST_CHECK(Cached(cache, "address_0"));
+    BOOST_CHECK(!Cached(cache, "address_1"));
+    BOOST_CHECK(Cached(cache, "address_2"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,114 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <pocketdb/consensus/Base.h>
+#include <pocketdb/consensus/ValidationPool.h>
+#include <pocketdb/pocketnet.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/thread.hpp>
+
+using namespace PocketDb;
+using namespace PocketConsensus;
+
+BOOST_FIXTURE_TEST_SUITE(pocketdb_validationpool_tests, TestingSetup)
+
+static void InsertPosts(int addresses, int height)
+{
+    for (int a = 0; a < addresses; a++)
+    {
+        for (int h = 1; h <= height; h++)
+        {
+            // Every address has a post at every height up to its number
+            if (h > a + 1)
+                continue;
+
+            auto hash = strprintf("post_%d_%d", a, h);
+            auto sql = strprintf(
+                "insert into Transactions (Type, Hash, Time, Height, Last, String1, String2) "
+                "values (200, '%s', %d, %d, 1, 'address_%d', '%s')", hash, h, h, a, hash);
+
+            BOOST_REQUIRE_EQUAL(sqlite3_exec(SQLiteDbInst.m_db, sql.c_str(), nullptr, nullptr, nullptr), SQLITE_OK);
+        }
+    }
+}
+
+static vector<int> CountPosts(ValidationPool& pool, size_t count, int addresses, vector<boost::thread::id>* threads = nullptr)
+{
+    vector<int> results(count, -1);
+    vector<boost::thread::id> ids(count);
+
+    pool.Run(count, [&](size_t i)
+    {
+        results[i] = ConsensusRepo().CountChainPostHeight(strprintf("address_%d", i % addresses), (int) (i % 3));
+        ids[i] = boost::this_thread::get_id();
+    });
+
+    if (threads)
+        *threads = ids;
+
+    return results;
+}
+
+BOOST_AUTO_TEST_CASE(parallel_equals_serial)
+{
+    const int addresses = 10;
+    const size_t count = 200;
+    InsertPosts(addresses, addresses);
+
+    ValidationPool serialPool;
+    auto serial = CountPosts(serialPool, count, addresses);
+
+    ValidationPool pool;
+    boost::thread_group threadGroup;
+    pool.Start(threadGroup, 4);
+
+    vector<boost::thread::id> threads;
+    auto parallel = CountPosts(pool, count, addresses, &threads);
+
+    pool.Stop();
+    threadGroup.join_all();
+
+    BOOST_CHECK_EQUAL(serialPool.Size(), 0);
+    BOOST_CHECK(parallel == serial);
+    for (size_t i = 0; i < count; i++)
+        BOOST_CHECK_EQUAL(serial[i], (int) (i % addresses) + 1 - max(0, (int) (i % 3) - 1));
+
+    // Jobs of a parallel batch read the worker snapshots only, never the main connection
+    for (const auto& id : threads)
+        BOOST_CHECK(id != boost::this_thread::get_id());
+}
+
+BOOST_AUTO_TEST_CASE(workers_read_committed_snapshot)
+{
+    InsertPosts(1, 1);
+
+    ValidationPool pool;
+    boost::thread_group threadGroup;
+    pool.Start(threadGroup, 2);
+
+    BOOST_CHECK(CountPosts(pool, 2, 1) == vector<int>(2, 1));
+
+    BOOST_REQUIRE(SQLiteDbInst.BeginBatch());
+    BOOST_REQUIRE_EQUAL(sqlite3_exec(SQLiteDbInst.m_db,
+        "insert into Transactions (Type, Hash, Time, Height, Last, String1, String2) "
+        "values (200, 'post_uncommitted', 2, 2, 1, 'address_0', 'post_uncommitted')",
+        nullptr, nullptr, nullptr), SQLITE_OK);
+
+    // Bulk load batch is validated serially on the main connection and sees its own changes
+    auto inBatch = CountPosts(pool, 2, 1);
+    BOOST_CHECK(inBatch == vector<int>(2, 2));
+
+    BOOST_REQUIRE(SQLiteDbInst.CommitBatch());
+
+    // Next batch takes a new snapshot with the committed changes
+    auto committed = CountPosts(pool, 2, 1);
+    BOOST_CHECK(committed == vector<int>(2, 2));
+
+    pool.Stop();
+    threadGroup.join_all();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,77 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <pocketdb/pocketnet.h>
+#include <pocketdb/services/WebPostProcessing.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace PocketDb;
+using namespace PocketServices;
+
+BOOST_FIXTURE_TEST_SUITE(pocketdb_webpostprocessing_tests, TestingSetup)
+
+static void InsertHeights(int fromHeight, int toHeight)
+{
+    for (int height = fromHeight; height <= toHeight; height++)
+    {
+        auto sql = strprintf("insert into ChunkTest (Height) values (%d);", height);
+        BOOST_REQUIRE_EQUAL(sqlite3_exec(SQLiteDbInst.m_db, sql.c_str(), nullptr, nullptr, nullptr), SQLITE_OK);
+    }
+}
+
+static int CountHeights()
+{
+    sqlite3_stmt* stmt;
+    BOOST_REQUIRE_EQUAL(sqlite3_prepare_v2(SQLiteDbInst.m_db, "select count(*) from ChunkTest", -1, &stmt, nullptr), SQLITE_OK);
+    BOOST_REQUIRE_EQUAL(sqlite3_step(stmt), SQLITE_ROW);
+    int count = sqlite3_column_int(stmt, 0);
+    sqlite3_finalize(stmt);
+    return count;
+}
+
+BOOST_AUTO_TEST_CASE(chunk_retry_after_rollback)
+{
+    BOOST_REQUIRE_EQUAL(sqlite3_exec(SQLiteDbInst.m_db, "create table ChunkTest (Height int primary key);", nullptr, nullptr, nullptr), SQLITE_OK);
+
+    // First attempt fails after writing part of the chunk, second one would hit
+    // the primary key if the first one was not rolled back
+    int attempts = 0;
+    bool done = ApplyCatchupChunk(SQLiteDbInst, 10, 19, [&](int from, int to)
+    {
+        attempts++;
+        InsertHeights(from, to);
+
+        if (attempts == 1)
+            throw std::runtime_error("chunk failed");
+    });
+
+    BOOST_CHECK(done);
+    BOOST_CHECK_EQUAL(attempts, 2);
+    BOOST_CHECK_EQUAL(CountHeights(), 10);
+    BOOST_CHECK(!SQLiteDbInst.InBatch());
+}
+
+BOOST_AUTO_TEST_CASE(chunk_all_attempts_failed)
+{
+    BOOST_REQUIRE_EQUAL(sqlite3_exec(SQLiteDbInst.m_db, "create table ChunkTest (Height int primary key);", nullptr, nullptr, nullptr), SQLITE_OK);
+    InsertHeights(0, 9);
+
+    int attempts = 0;
+    bool done = ApplyCatchupChunk(SQLiteDbInst, 10, 19, [&](int from, int to)
+    {
+        attempts++;
+        InsertHeights(from, to);
+        throw std::runtime_error("chunk failed");
+    });
+
+    // Nothing of the failed chunk is left, earlier data is kept
+    BOOST_CHECK(!done);
+    BOOST_CHECK_EQUAL(attempts, WEB_CATCHUP_ATTEMPTS);
+    BOOST_CHECK_EQUAL(CountHeights(), 10);
+    BOOST_CHECK(!SQLiteDbInst.InBatch());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
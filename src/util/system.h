@@ -459,37 +459,8 @@ template <typename Callable> void TraceThread(const char* name,  Callable func)
     }
 }
 
-/**
- * Runs an arbitrary function TF in an independent thread 
- * and interrupts the execution of the function if 
- * the execution time exceeds the specified timeout TDuration
- */
-
-struct TimeoutException : public std::exception
-{
-	const char * what () const throw ()
-    {
-    	return "Timeout Exception";
-    }
-};
-
 using namespace std::chrono_literals;
 
-template <typename TF, typename TDuration, typename TOF, class... TArgs>
-std::result_of_t<TF&&(TArgs&&...)> run_with_timeout(TF&& f, TDuration timeout, TOF&& fout, TArgs&&... args)
-{
-    using R = std::result_of_t<TF&&(TArgs&&...)>;
-    std::packaged_task<R(TArgs...)> task(f);
-    auto future = task.get_future();
-    std::thread thr(std::move(task), std::forward<TArgs>(args)...);
-
-    while (future.wait_for(timeout) == std::future_status::timeout)
-        fout();
-    
-    thr.join();
-    return future.get(); // this will propagate exception from f() if any
-}
-
 
 std::string CopyrightHolders(const std::string& strPrefix);
 
@@ -58,6 +58,10 @@
 #include "pocketdb/services/ChainPostProcessing.h"
 #include "pocketdb/services/Accessor.h"
 #include "pocketdb/consensus/Helper.h"
+#include "pocketdb/consensus/MempoolValidationCache.h"
+#include "pocketdb/SQLiteConnectionPool.h"
+#include "pocketdb/services/BulkSync.h"
+#include <rpc/cache.h>
 
 using WsServer = SimpleWeb::SocketServer<SimpleWeb::WS>;
 
@@ -2522,7 +2526,7 @@ bool CChainState::ConnectBlock(const CBlock& block, const PocketBlockRef& pocket
     // -----------------------------------------------------------------------------------------------------------------
     // Extend WEB database
     if (gArgs.GetBoolArg("-api", true) && enablePocketConnect)
-        PocketServices::WebPostProcessorInst.Enqueue(block.GetHash().GetHex());
+        PocketServices::BulkSyncInst.EnqueueWebPost(block.GetHash().GetHex(), pindex->nHeight);
 
     // -----------------------------------------------------------------------------------------------------------------
     if (!WriteUndoDataForBlock(blockundo, state, pindex, chainparams))
@@ -2636,6 +2640,10 @@ bool CChainState::FlushStateToDisk(
         fDoFullFlush = (mode == FlushStateMode::ALWAYS) || fCacheLarge || fCacheCritical || fPeriodicFlush || fFlushForPrune;
         // Write blocks and block index to disk.
         if (fDoFullFlush || fPeriodicWrite) {
+            // Pocket DB must not stay behind the block index and chainstate on disk
+            if (!PocketServices::BulkSyncInst.Flush()) {
+                return AbortNode(state, "Failed to commit Pocket DB bulk load");
+            }
             // Depend on nMinDiskSpace to ensure we can write block index
             if (!CheckDiskSpace(GetBlocksDir())) {
                 return AbortNode(state, "Disk space is too low!", _("Disk space is too low!"));
@@ -2830,6 +2838,11 @@ bool CChainState::DisconnectTip(BlockValidationState& state, const CChainParams&
         if (!PocketServices::ChainPostProcessing::Rollback(::ChainActive().Height()))
             return error("DisconnectTip(): DisconnectBlock (Pocketnet part) %s failed", pindexDelete->GetBlockHash().ToString());
 
+        PocketServices::BlockPayloadCacheInst.Erase(pindexDelete->GetBlockHash());
+
+        // Tip returning to a block seen before must not reuse verdicts made before the reorg
+        PocketConsensus::MempoolValidationCacheInst.Clear();
+
         bool flushed = view.Flush();
         assert(flushed);
     }
@@ -2854,6 +2867,7 @@ bool CChainState::DisconnectTip(BlockValidationState& state, const CChainParams&
     m_chain.SetTip(pindexDelete->pprev);
 
     UpdateTip(m_mempool, pindexDelete->pprev, chainparams);
+    g_rpc_cache.Invalidate();
     // Let wallets know transactions went from 1-confirmed to
     // 0-confirmed or conflicted:
     GetMainSignals().BlockDisconnected(pblock, pindexDelete);
@@ -2971,6 +2985,11 @@ bool CChainState::ConnectTip(BlockValidationState& state, const CChainParams& ch
         }
         nTime3 = GetTimeMicros(); nTimeConnectTotal += nTime3 - nTime2;
         assert(nBlocksTotal > 0);
+
+        // Recent blocks are requested by syncing peers - keep serialized payload ready
+        if (!IsInitialBlockDownload())
+            PocketServices::Accessor::CacheBlock(blockConnecting, pocketBlock);
+
         LogPrint(BCLog::BENCH, "  - Connect total: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime3 - nTime2) * MILLI, nTimeConnectTotal * MICRO, nTimeConnectTotal * MILLI / nBlocksTotal);
         bool flushed = view.Flush();
         assert(flushed);
@@ -3001,13 +3020,20 @@ bool CChainState::ConnectTip(BlockValidationState& state, const CChainParams& ch
     uint256 _block_hash = blockConnecting.GetHash();
     std::string _block_hash_str = _block_hash.GetHex();
 
-    // Compute messages for sending by WebSocket
+    // Batch blocks indexed to Pocket DB while far behind the network
+    if (!PocketServices::BulkSyncInst.BlockConnected(pindexNew))
+        return AbortNode(state, "Failed to commit Pocket DB bulk load");
+
+    // Read-only RPC connections reopen on new chain state
+    if (!IsInitialBlockDownload())
+        PocketDb::SQLiteConnectionPoolInst.Recycle();
+
+    // Cached RPC results belong to the previous tip
+    g_rpc_cache.Invalidate();
+
+    // Compute and send messages for WebSocket clients in background
     if (!WSConnections.empty())
-    {
-        //std::thread server_thread(&NotifyWSClients, blockConnecting);
-        //server_thread.detach();
-        NotifyWSClients(blockConnecting, pindexNew);
-    }
+        PocketServices::WsNotifierInst.Enqueue(pthisBlock, pindexNew->nHeight);
 
     LogPrint(BCLog::SYNC, "+++ Block connected to chain: %d BH: %s\n", pindexNew->nHeight,
         pindexNew->GetBlockHash().GetHex());
@@ -3016,381 +3042,6 @@ bool CChainState::ConnectTip(BlockValidationState& state, const CChainParams& ch
     return true;
 }
 
-typedef std::map<std::string, std::string> custom_fields;
-void CChainState::NotifyWSClients(const CBlock& block, CBlockIndex* blockIndex)
-{
-     std::map<std::string, std::vector<UniValue>> messages;
-     uint256 _block_hash = block.GetHash();
-     int sharesCnt = 0;
-    std::map<std::string, std::map<std::string, int>> contentLangCnt;
-    std::string txidpocketnet;
-    std::string addrespocketnet = (Params().NetworkIDString() == CBaseChainParams::MAIN) ? "PEj7QNjKdDPqE9kMDRboKoCtp8V6vZeZPd" : "TAqR1ncH95eq9XKSDRR18DtpXqktxh74UU";
-    auto pocketnetaccinfo = PocketDb::NotifierRepoInst.GetAccountInfoByAddress(addrespocketnet);
-
-     for (const auto& tx : block.vtx) {
-         std::map<std::string, std::pair<int, int64_t>> addrs;
-         int64_t txtime = tx->nTime;
-         std::string txid = tx->GetHash().GetHex();
-         std::string optype;
-
-         // Get all addresses from tx outs and check OP_RETURN
-             for (int i = 0; i < tx->vout.size(); i++) {
-             const CTxOut& txout = tx->vout[i];
-             //-------------------------
-             if (txout.scriptPubKey[0] == OP_RETURN) {
-                 std::string asmstr = ScriptToAsmStr(txout.scriptPubKey);
-                 std::vector<std::string> spl;
-                 boost::split(spl, asmstr, boost::is_any_of("\t "));
-                 if (spl.size() >= 3) {
-                     if (spl[1] == OR_POST) {
-                         optype = "share";
-                         sharesCnt += 1;
-
-                         auto response = PocketDb::NotifierRepoInst.GetPostLang(txid);
-
-                         if (response.exists("lang"))
-                         {
-                             std::string lang = response["lang"].get_str();
-
-                             contentLangCnt[OR_POST][lang] += 1;
-                         }
-                     }
-                     else if (spl[1] == OR_VIDEO) {
-                         optype = "video";
-                         sharesCnt += 1;
-
-                         auto response = PocketDb::NotifierRepoInst.GetPostLang(txid);
-
-                         if (response.exists("lang"))
-                         {
-                             std::string lang = response["lang"].get_str();
-
-                             contentLangCnt[OR_VIDEO][lang] += 1;
-                         }
-                     }
-                     // else if (spl[1] == OR_POSTEDIT)
-                     // 	optype = "shareEdit";
-                     else if (spl[1] == OR_SCORE)
-                         optype = "upvoteShare";
-                     else if (spl[1] == OR_SUBSCRIBE)
-                         optype = "subscribe";
-                     else if (spl[1] == OR_SUBSCRIBEPRIVATE)
-                         optype = "subscribePrivate";
-                     else if (spl[1] == OR_USERINFO)
-                         optype = "userInfo";
-                     else if (spl[1] == OR_UNSUBSCRIBE)
-                         optype = "unsubscribe";
-                     else if (spl[1] == OR_COMMENT_SCORE)
-                         optype = "cScore";
-                     else if (spl[1] == OR_COMMENT)
-                         optype = "comment";
-                     else if (spl[1] == OR_COMMENT_EDIT)
-                         optype = "commentEdit";
-                     else if (spl[1] == OR_COMMENT_DELETE)
-                         optype = "commentDelete";
-                 }
-             }
-             //-------------------------
-             CTxDestination destAddress;
-             bool fValidAddress = ExtractDestination(txout.scriptPubKey, destAddress);
-             if (fValidAddress) {
-                 std::string encoded_address = EncodeDestination(destAddress);
-                 if (addrs.find(encoded_address) == addrs.end())
-                     addrs.emplace(encoded_address, std::make_pair(i, (int64_t)txout.nValue));
-             }
-         }
-
-         for (auto const& addr : addrs)
-         {
-             // Event for new transaction
-             custom_fields cTrFields{
-                 {"nout", std::to_string(addr.second.first)},
-                 {"amount", std::to_string(addr.second.second)},
-             };
-
-             if (!optype.empty()) cTrFields.emplace("type", optype);
-             PrepareWSMessage(messages, "transaction", addr.first, txid, txtime, cTrFields);
-
-             // Event for new PocketNET transaction
-             if (optype == "share" || optype == "video")
-             {
-                 auto response = PocketDb::NotifierRepoInst.GetPostInfo(txid);
-                 if (response.exists("hash") && response.exists("rootHash") && response["hash"].get_str() != response["rootHash"].get_str())
-                     continue;
-
-                 if (addr.first == addrespocketnet && txidpocketnet.find(txid) == std::string::npos)
-                 {
-                     txidpocketnet += txid + ",";
-                 }
-                 else
-                 {
-                     auto response = PocketDb::NotifierRepoInst.GetOriginalPostAddressByRepost(txid);
-                     if (response.exists("hash"))
-                     {
-                         std::string address = response["address"].get_str();
-
-                         custom_fields cFields
-                         {
-                             {"mesType",    "reshare"},
-                             {"txidRepost", response["hash"].get_str()},
-                             {"addrFrom",   response["addressRepost"].get_str()},
-                             {"nameFrom",   response["nameRepost"].get_str()}
-                         };
-                         if (response.exists("avatarRepost"))
-                             cFields.emplace("avatarFrom",response["avatarRepost"].get_str());
-
-                         PrepareWSMessage(messages, "event", address, txid, txtime, cFields);
-                     }
-                 }
-
-                 auto subscribesResponse = PocketDb::NotifierRepoInst.GetPrivateSubscribeAddressesByAddressTo(addr.first);
-                 for (size_t i = 0; i < subscribesResponse.size(); ++i)
-                 {
-                     auto address = subscribesResponse[i]["addressTo"].get_str();
-
-                     custom_fields cFields{
-                             {"mesType", "postfromprivate"},
-                             {"addrFrom", addr.first},
-                             {"nameFrom",   subscribesResponse[i]["nameFrom"].get_str()}
-                     };
-
-                     if (subscribesResponse[i].exists("avatarFrom"))
-                         cFields.emplace("avatarFrom",subscribesResponse[i]["avatarFrom"].get_str());
-
-                     PrepareWSMessage(messages, "event", address, txid, txtime, cFields);
-                 }
-             }
-             else if (optype == "userInfo")
-             {
-                 auto response = PocketDb::NotifierRepoInst.GetUserReferrerAddress(txid);
-                 if (response.exists("referrerAddress"))
-                 {
-                     custom_fields cFields
-                     {
-                         {"mesType", optype},
-                         {"addrFrom", addr.first},
-                         {"nameFrom", response["referralName"].get_str()}
-                     };
-                     if (response.exists("referralAvatar"))
-                         cFields.emplace("avatarFrom",response["referralAvatar"].get_str());
-
-                     PrepareWSMessage(messages, "event", response["referrerAddress"].get_str(), txid, txtime, cFields);
-                 }
-             }
-             else if (optype == "upvoteShare")
-             {
-                 auto response = PocketDb::NotifierRepoInst.GetPostInfoAddressByScore(txid);
-                 if (response.exists("postTxHash"))
-                 {
-                     custom_fields cFields
-                     {
-                         {"mesType", optype},
-                         {"addrFrom", addr.first},
-                         {"nameFrom", response["scoreName"].get_str()},
-                         {"posttxid", response["postTxHash"].get_str()},
-                         {"upvoteVal", response["value"].get_str()}
-                     };
-
-                     if (response.exists("scoreAvatar"))
-                         cFields.emplace("avatarFrom",response["scoreAvatar"].get_str());
-
-                     PrepareWSMessage(messages, "event", response["postAddress"].get_str(), txid, txtime, cFields);
-                 }
-             }
-             else if (optype == "subscribe" || optype == "subscribePrivate" || optype == "unsubscribe")
-             {
-                 auto response = PocketDb::NotifierRepoInst.GetSubscribeAddressTo(txid);
-                 if (response.exists("addressTo"))
-                 {
-                     custom_fields cFields
-                     {
-                         {"mesType", optype},
-                         {"addrFrom", addr.first},
-                         {"nameFrom", response["nameFrom"].get_str()}
-                     };
-
-                     if (response.exists("avatarFrom"))
-                         cFields.emplace("avatarFrom",response["avatarFrom"].get_str());
-
-                     PrepareWSMessage(messages, "event", response["addressTo"].get_str(), txid, txtime, cFields);
-                 }
-             }
-             else if (optype == "cScore")
-             {
-                 auto response = PocketDb::NotifierRepoInst.GetCommentInfoAddressByScore(txid);
-                 if (response.exists("commentHash"))
-                 {
-                     custom_fields cFields
-                     {
-                         {"mesType", optype},
-                         {"addrFrom", addr.first},
-                         {"nameFrom", response["scoreCommentName"].get_str()},
-                         {"commentid", response["commentHash"].get_str()},
-                         {"upvoteVal", response["value"].get_str()}
-                     };
-
-                     if (response.exists("scoreCommentAvatar"))
-                         cFields.emplace("avatarFrom",response["scoreCommentAvatar"].get_str());
-
-                     PrepareWSMessage(messages, "event", response["commentAddress"].get_str(), txid, txtime, cFields);
-                 }
-             }
-             else if (optype == "comment" || optype == "commentEdit" || optype == "commentDelete")
-             {
-                 auto response = PocketDb::NotifierRepoInst.GetFullCommentInfo(txid);
-                 if (response.exists("postHash"))
-                 {
-                     if (response.exists("answerAddress") && !response["answerAddress"].get_str().empty())
-                     {
-                         custom_fields c1Fields
-                             {
-                                 {"mesType", optype},
-                                 {"addrFrom", addr.first},
-                                 {"nameFrom", response["commentName"].get_str()},
-                                 {"posttxid", response["postHash"].get_str()},
-                                 {"parentid", response["parentHash"].get_str()},
-                                 {"answerid", response["answerHash"].get_str()},
-                                 {"reason", "answer"},
-                             };
-
-                         if (response.exists("commentAvatar"))
-                             c1Fields.emplace("avatarFrom",response["commentAvatar"].get_str());
-
-                         PrepareWSMessage(messages, "event", response["answerAddress"].get_str(), response["rootHash"].get_str(), txtime, c1Fields);
-                     }
-
-                     if(response["postAddress"].get_str() == addr.first)
-                         continue;
-
-                     custom_fields cFields
-                     {
-                         {"mesType", optype},
-                         {"addrFrom", addr.first},
-                         {"nameFrom", response["commentName"].get_str()},
-                         {"posttxid", response["postHash"].get_str()},
-                         {"parentid", response["parentHash"].get_str()},
-                         {"answerid", response["answerHash"].get_str()},
-                         {"reason", "post"},
-                     };
-
-                     if (response.exists("commentAvatar"))
-                         cFields.emplace("avatarFrom",response["commentAvatar"].get_str());
-
-                     if (response.exists("donation"))
-                     {
-                         cFields.emplace("donation", "true");
-                         cFields.emplace("amount", response["amount"].get_str());
-                     }
-
-                     PrepareWSMessage(messages, "event", response["postAddress"].get_str(), response["rootHash"].get_str(), txtime, cFields);
-                 }
-             }
-         }
-     }
-
-     // Send all WS clients messages
-    UniValue contentsLang(UniValue::VOBJ);
-    for (const auto& itemContent : contentLangCnt){
-        UniValue langContents(UniValue::VOBJ);
-        for (const auto& itemLang : itemContent.second) {
-            langContents.pushKV(itemLang.first, itemLang.second);
-        }
-        contentsLang.pushKV(TransactionHelper::TxStringType(PocketHelpers::TransactionHelper::ConvertOpReturnToType(itemContent.first)), langContents);
-    }
-
-
-     boost::lock_guard<boost::mutex> guard(WSMutex);
-     for (auto& connWS : WSConnections)
-     {
-         UniValue msg(UniValue::VOBJ);
-         msg.pushKV("addr", connWS.second.Address);
-         msg.pushKV("msg", "new block");
-         msg.pushKV("blockhash", _block_hash.GetHex());
-         msg.pushKV("time", std::to_string(block.nTime));
-         msg.pushKV("height", blockIndex->nHeight);
-         msg.pushKV("shares", sharesCnt);
-         msg.pushKV("contentsLang", contentsLang);
-
-         auto countResponse = PocketDb::NotifierRepoInst.GetPostCountFromMySubscribes(connWS.second.Address, blockIndex->nHeight);
-         if (countResponse.exists("count"))
-         {
-            msg.pushKV("sharesSubscr", countResponse["count"].get_int());
-         }
-
-         if (blockIndex->nHeight > connWS.second.Block)
-         {
-             try
-             {
-                 connWS.second.Connection->send(msg.write(), [](const SimpleWeb::error_code& ec) {});
-             }
-             catch (const std::exception& e)
-             {
-                 LogPrintf("Error: CChainState::NotifyWSClients (1) - %s\n", e.what());
-             }
-
-             if (txidpocketnet != "")
-             {
-                 try
-                 {
-                     UniValue m(UniValue::VOBJ);
-                     m.pushKV("msg", "sharepocketnet");
-                     m.pushKV("time", std::to_string(block.nTime));
-                     m.pushKV("addrFrom", addrespocketnet);
-                     if (pocketnetaccinfo.exists("name")) m.pushKV("nameFrom", pocketnetaccinfo["name"].get_str());
-                     if (pocketnetaccinfo.exists("avatar")) m.pushKV("avatarFrom", pocketnetaccinfo["avatar"].get_str());
-                     m.pushKV("txids", txidpocketnet.substr(0, txidpocketnet.size() - 1));
-                     connWS.second.Connection->send(m.write(), [](const SimpleWeb::error_code& ec) {});
-                 }
-                 catch (const std::exception& e)
-                 {
-                     LogPrintf("Error: CChainState::NotifyWSClients (1) - %s\n", e.what());
-                 }
-             }
-
-             if (messages.find(connWS.second.Address) != messages.end())
-             {
-                 for (auto m : messages[connWS.second.Address])
-                 {
-                     try
-                     {
-                         connWS.second.Connection->send(m.write(), [](const SimpleWeb::error_code& ec) {});
-                     }
-                     catch (const std::exception& e)
-                     {
-                         LogPrintf("Error: CChainState::NotifyWSClients (2) - %s\n", e.what());
-                     }
-                 }
-             }
-
-             connWS.second.Block = blockIndex->nHeight;
-         }
-     }
-}
-
-void CChainState::PrepareWSMessage(std::map<std::string, std::vector<UniValue>>& messages, std::string msg_type,
-    std::string addrTo, std::string txid, int64_t txtime, custom_fields cFields)
-{
-    UniValue msg(UniValue::VOBJ);
-    msg.pushKV("addr", addrTo);
-    msg.pushKV("msg", msg_type);
-    msg.pushKV("txid", txid);
-    msg.pushKV("time", txtime);
-
-    for (auto& it : cFields)
-    {
-        msg.pushKV(it.first, it.second);
-    }
-
-    if (messages.find(addrTo) == messages.end())
-    {
-        std::vector<UniValue> _list;
-        messages.insert(std::make_pair(addrTo, _list));
-    }
-
-    messages[addrTo].push_back(msg);
-}
-
-
 /**
  * Return the tip of the chain with the most work in it, that isn't
  * known to be invalid (it's however far from certain to be valid).
@@ -5221,6 +4872,9 @@ void CChainState::LoadMempool(const ArgsManager& args)
             LogPrintf("Clean SQLite mempool..\n");
             PocketDb::TransRepoInst.CleanMempool();
         }
+
+        // Payloads of mempool transactions are read again
+        PocketConsensus::MempoolValidationCacheInst.Clear();
     }
     m_mempool.SetIsLoaded(!ShutdownRequested());
 }